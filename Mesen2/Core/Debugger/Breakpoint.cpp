@@ -3,6 +3,20 @@
 #include "Debugger/DebugTypes.h"
 #include "Debugger/DebugUtilities.h"
 
+Breakpoint::Breakpoint(uint32_t id, CpuType cpuType, MemoryType memType, BreakpointTypeFlags type, int32_t startAddr, int32_t endAddr, bool enabled, bool markEvent)
+{
+	_id = id;
+	_cpuType = cpuType;
+	_memoryType = memType;
+	_type = type;
+	_startAddr = startAddr;
+	_endAddr = endAddr;
+	_enabled = enabled;
+	_markEvent = markEvent;
+	_ignoreDummyOperations = true;
+	_condition[0] = 0;
+}
+
 template<uint8_t accessWidth>
 bool Breakpoint::Matches(MemoryOperationInfo& operation, AddressInfo &info)
 {
@@ -56,6 +70,21 @@ CpuType Breakpoint::GetCpuType()
 	return _cpuType;
 }
 
+MemoryType Breakpoint::GetMemoryType()
+{
+	return _memoryType;
+}
+
+int32_t Breakpoint::GetStartAddress()
+{
+	return _startAddr;
+}
+
+int32_t Breakpoint::GetEndAddress()
+{
+	return _endAddr;
+}
+
 bool Breakpoint::IsEnabled()
 {
 	return _enabled;
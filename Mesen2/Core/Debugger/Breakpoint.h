@@ -12,6 +12,9 @@ struct MemoryOperationInfo;
 class Breakpoint
 {
 public:
+	Breakpoint() = default;
+	Breakpoint(uint32_t id, CpuType cpuType, MemoryType memType, BreakpointTypeFlags type, int32_t startAddr, int32_t endAddr, bool enabled, bool markEvent);
+
 	template<uint8_t accessWidth = 1> bool Matches(MemoryOperationInfo &opInfo, AddressInfo &info);
 	bool HasBreakpointType(BreakpointType type);
 	string GetCondition();
@@ -19,6 +22,9 @@ public:
 
 	uint32_t GetId();
 	CpuType GetCpuType();
+	MemoryType GetMemoryType();
+	int32_t GetStartAddress();
+	int32_t GetEndAddress();
 	bool IsEnabled();
 	bool IsMarked();
 	bool IsAllowedForOpType(MemoryOperationType opType);
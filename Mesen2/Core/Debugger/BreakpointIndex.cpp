@@ -0,0 +1,82 @@
+#include "pch.h"
+#include "Debugger/BreakpointIndex.h"
+#include "Debugger/Breakpoint.h"
+
+BreakpointIndex::BreakpointIndex()
+{
+	Clear();
+}
+
+void BreakpointIndex::Clear()
+{
+	_indexes.clear();
+	std::fill(std::begin(_indexByMemType), std::end(_indexByMemType), (int16_t)-1);
+}
+
+void BreakpointIndex::Build(vector<Breakpoint>& breakpoints)
+{
+	Clear();
+
+	//Group the breakpoints by memory type
+	vector<vector<uint32_t>> bpsByMemType;
+	for(uint32_t i = 0; i < (uint32_t)breakpoints.size(); i++) {
+		int memType = (int)breakpoints[i].GetMemoryType();
+		if(memType < 0 || memType >= DebugUtilities::GetMemoryTypeCount()) {
+			continue;
+		}
+
+		if(_indexByMemType[memType] < 0) {
+			_indexByMemType[memType] = (int16_t)bpsByMemType.size();
+			bpsByMemType.push_back({});
+		}
+		bpsByMemType[_indexByMemType[memType]].push_back(i);
+	}
+
+	_indexes.resize(bpsByMemType.size());
+	for(size_t i = 0; i < bpsByMemType.size(); i++) {
+		MemoryTypeIndex& index = _indexes[i];
+
+		//Ranges are [start, end) - the start is moved back so that wider accesses that start before the breakpoint's range are included
+		auto getStart = [&](uint32_t bpIndex) { return (int64_t)breakpoints[bpIndex].GetStartAddress() - (MaxAccessWidth - 1); };
+		auto getEnd = [&](uint32_t bpIndex) { return (int64_t)breakpoints[bpIndex].GetEndAddress() + 1; };
+
+		vector<int64_t>& bounds = index.SegmentStart;
+		int64_t maxAddress = 0;
+		for(uint32_t bpIndex : bpsByMemType[i]) {
+			if(getEnd(bpIndex) > getStart(bpIndex)) {
+				bounds.push_back(getStart(bpIndex));
+				bounds.push_back(getEnd(bpIndex));
+				maxAddress = std::max(maxAddress, getEnd(bpIndex) - 1);
+			}
+		}
+		std::sort(bounds.begin(), bounds.end());
+		bounds.erase(std::unique(bounds.begin(), bounds.end()), bounds.end());
+
+		//Breakpoints are added to each segment in list order, which is the order they are evaluated in
+		index.SegmentOffset.push_back(0);
+		for(size_t segment = 0; segment + 1 < bounds.size(); segment++) {
+			for(uint32_t bpIndex : bpsByMemType[i]) {
+				if(getStart(bpIndex) <= bounds[segment] && getEnd(bpIndex) >= bounds[segment + 1]) {
+					index.Candidates.push_back(bpIndex);
+				}
+			}
+			index.SegmentOffset.push_back((uint32_t)index.Candidates.size());
+		}
+
+		//Use larger pages for large address spaces to keep the bitmap small (8 KB max)
+		while(((uint64_t)maxAddress >> index.PageShift) >= MaxPageCount) {
+			index.PageShift++;
+		}
+		index.PageBitmap.resize((((uint64_t)maxAddress >> index.PageShift) / 64) + 1);
+		for(uint32_t bpIndex : bpsByMemType[i]) {
+			if(getEnd(bpIndex) <= 0 || getEnd(bpIndex) <= getStart(bpIndex)) {
+				continue;
+			}
+			uint32_t firstPage = (uint32_t)(std::max<int64_t>(getStart(bpIndex), 0) >> index.PageShift);
+			uint32_t lastPage = (uint32_t)((getEnd(bpIndex) - 1) >> index.PageShift);
+			for(uint32_t page = firstPage; page <= lastPage; page++) {
+				index.PageBitmap[page >> 6] |= (uint64_t)1 << (page & 0x3F);
+			}
+		}
+	}
+}
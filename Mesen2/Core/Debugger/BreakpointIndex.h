@@ -0,0 +1,77 @@
+#pragma once
+#include "pch.h"
+#include "Debugger/DebugUtilities.h"
+
+class Breakpoint;
+
+struct BreakpointCandidates
+{
+	const uint32_t* Start = nullptr;
+	const uint32_t* End = nullptr;
+};
+
+//Address index of the breakpoints of a given operation type, per memory type.
+//Returns the indexes (in breakpoint list order) of the breakpoints whose range may contain an address - the results
+//are a superset of the breakpoints that match, Breakpoint::Matches must still be called on each of them.
+class BreakpointIndex
+{
+private:
+	//Accesses can be up to 4 bytes wide, a breakpoint matches any access that overlaps its range
+	static constexpr int32_t MaxAccessWidth = 4;
+
+	static constexpr uint8_t MinPageShift = 8;
+	static constexpr uint32_t MaxPageCount = 0x10000;
+
+	struct MemoryTypeIndex
+	{
+		//One bit per page, set when at least one breakpoint covers an address in the page (used to reject most addresses without searching)
+		vector<uint64_t> PageBitmap;
+		uint8_t PageShift = MinPageShift;
+
+		//The breakpoint ranges are split into non-overlapping segments: segment i covers [SegmentStart[i], SegmentStart[i + 1])
+		//and its breakpoints are Candidates[SegmentOffset[i]] to Candidates[SegmentOffset[i + 1] - 1]
+		vector<int64_t> SegmentStart;
+		vector<uint32_t> SegmentOffset;
+		vector<uint32_t> Candidates;
+	};
+
+	vector<MemoryTypeIndex> _indexes;
+	int16_t _indexByMemType[DebugUtilities::GetMemoryTypeCount()] = {};
+
+public:
+	BreakpointIndex();
+
+	void Build(vector<Breakpoint>& breakpoints);
+	void Clear();
+
+	__forceinline BreakpointCandidates GetCandidates(MemoryType memType, int32_t address);
+};
+
+__forceinline BreakpointCandidates BreakpointIndex::GetCandidates(MemoryType memType, int32_t address)
+{
+	int16_t indexId = _indexByMemType[(int)memType];
+	if(indexId < 0) {
+		return {};
+	}
+
+	MemoryTypeIndex& index = _indexes[indexId];
+	if(address >= 0) {
+		uint32_t page = (uint32_t)address >> index.PageShift;
+		if(page >= index.PageBitmap.size() * 64 || !(index.PageBitmap[page >> 6] & ((uint64_t)1 << (page & 0x3F)))) {
+			return {};
+		}
+	}
+
+	//Find the last segment that starts at or before the address
+	auto it = std::upper_bound(index.SegmentStart.begin(), index.SegmentStart.end(), (int64_t)address);
+	if(it == index.SegmentStart.begin() || it == index.SegmentStart.end()) {
+		//Before the first segment, or after the end of the last one
+		return {};
+	}
+
+	size_t segment = (it - index.SegmentStart.begin()) - 1;
+	BreakpointCandidates result;
+	result.Start = index.Candidates.data() + index.SegmentOffset[segment];
+	result.End = index.Candidates.data() + index.SegmentOffset[segment + 1];
+	return result;
+}
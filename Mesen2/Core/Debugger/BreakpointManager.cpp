@@ -24,6 +24,7 @@ void BreakpointManager::SetBreakpoints(Breakpoint breakpoints[], uint32_t count)
 	for(int i = 0; i < BreakpointManager::BreakpointTypeCount; i++) {
 		_breakpoints[i].clear();
 		_rpnList[i].clear();
+		_index[i].Clear();
 		_hasBreakpointType[i] = false;
 	}
 
@@ -58,21 +59,26 @@ void BreakpointManager::SetBreakpoints(Breakpoint breakpoints[], uint32_t count)
 
 				if(bp.IsAllowedForOpType(opType)) {
 					_breakpoints[i].push_back(bp);
-				}
 
-				if(bp.HasCondition()) {
-					bool success = true;
-					ExpressionData data = _bpExpEval->GetRpnList(bp.GetCondition(), success);
-					_rpnList[i].push_back(success ? data : ExpressionData());
-				} else {
-					_rpnList[i].push_back(ExpressionData());
+					//_rpnList[i] must stay aligned with _breakpoints[i]
+					if(bp.HasCondition()) {
+						bool success = true;
+						ExpressionData data = _bpExpEval->GetRpnList(bp.GetCondition(), success);
+						_rpnList[i].push_back(success ? data : ExpressionData());
+					} else {
+						_rpnList[i].push_back(ExpressionData());
+					}
 				}
-				
+
 				_hasBreakpoint = true;
 				_hasBreakpointType[i] = true;
 			}
 		}
 	}
+
+	for(int i = 0; i < BreakpointManager::BreakpointTypeCount; i++) {
+		_index[i].Build(_breakpoints[i]);
+	}
 }
 
 bool BreakpointManager::IsForbidden(MemoryOperationInfo* memoryOpPtr, AddressInfo& relAddr, AddressInfo& absAddr)
@@ -124,7 +130,30 @@ int BreakpointManager::InternalCheckBreakpoint(MemoryOperationInfo operationInfo
 {
 	EvalResultType resultType;
 	vector<Breakpoint> &breakpoints = _breakpoints[(int)operationInfo.Type];
-	for(size_t i = 0, len = breakpoints.size(); i < len; i++) {
+	BreakpointIndex& index = _index[(int)operationInfo.Type];
+
+	//Breakpoints on relative memory types are matched against the operation's address, the others against the absolute address
+	//Only the breakpoints whose range covers the address are evaluated (both lists are sorted by breakpoint index)
+	BreakpointCandidates relCandidates = {};
+	BreakpointCandidates absCandidates = {};
+	bool isRelative = DebugUtilities::IsRelativeMemory(operationInfo.MemType);
+	if(isRelative) {
+		relCandidates = index.GetCandidates(operationInfo.MemType, (int32_t)operationInfo.Address);
+	}
+	if(!isRelative || address.Type != operationInfo.MemType) {
+		absCandidates = index.GetCandidates(address.Type, address.Address);
+	}
+
+	const uint32_t* relIndex = relCandidates.Start;
+	const uint32_t* absIndex = absCandidates.Start;
+	while(relIndex != relCandidates.End || absIndex != absCandidates.End) {
+		uint32_t i;
+		if(absIndex == absCandidates.End || (relIndex != relCandidates.End && *relIndex < *absIndex)) {
+			i = *relIndex++;
+		} else {
+			i = *absIndex++;
+		}
+
 		if(breakpoints[i].Matches<accessWidth>(operationInfo, address)) {
 			if(breakpoints[i].HasCondition() && !_bpExpEval->Evaluate(_rpnList[(int)operationInfo.Type][i], resultType, operationInfo, address)) {
 				continue;
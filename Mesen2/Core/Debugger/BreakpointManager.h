@@ -1,6 +1,7 @@
 #pragma once
 #include "pch.h"
 #include "Debugger/Breakpoint.h"
+#include "Debugger/BreakpointIndex.h"
 #include "Debugger/DebugTypes.h"
 #include "Debugger/DebugUtilities.h"
 
@@ -23,6 +24,7 @@ private:
 	
 	vector<Breakpoint> _breakpoints[BreakpointTypeCount];
 	vector<ExpressionData> _rpnList[BreakpointTypeCount];
+	BreakpointIndex _index[BreakpointTypeCount];
 	bool _hasBreakpoint;
 	bool _hasBreakpointType[BreakpointTypeCount] = {};
 
@@ -57,6 +57,8 @@
 #include "Utilities/FolderUtilities.h"
 #include "Utilities/Patches/IpsPatcher.h"
 #include "Utilities/PlatformUtilities.h"
+#include "Utilities/SpscRingBuffer.h"
+#include "Utilities/Lz4Codec.h"
 
 uint64_t ITraceLogger::NextRowId = 0;
 
@@ -128,6 +130,8 @@ Debugger::Debugger(Emulator* emu, IConsole* console)
 		ExpressionEvaluator eval(this, _debuggers[(int)CpuType::Snes].Debugger.get(), CpuType::Snes);
 		eval.RunTests();
 	}
+	SpscRingBuffer<int16_t, 16>::RunTests();
+	Lz4Codec::RunTests();
 #endif
 }
 
@@ -1103,6 +1107,11 @@ ITraceLogger* Debugger::GetTraceLogger(CpuType cpuType)
 	return nullptr;
 }
 
+ExpressionEvaluator* Debugger::GetExpressionEvaluator(CpuType cpuType)
+{
+	return _debuggers[(int)cpuType].Evaluator.get();
+}
+
 void Debugger::ClearExecutionTrace()
 {
 	DebugBreakHelper helper(this);
@@ -197,6 +197,7 @@ public:
 
 	FrozenAddressManager* GetFrozenAddressManager(CpuType cpuType);
 	ITraceLogger* GetTraceLogger(CpuType cpuType);
+	ExpressionEvaluator* GetExpressionEvaluator(CpuType cpuType);
 	PpuTools* GetPpuTools(CpuType cpuType);
 	BaseEventManager* GetEventManager(CpuType cpuType);
 	CallstackManager* GetCallstackManager(CpuType cpuType);
@@ -81,4 +81,36 @@ int64_t ExpressionEvaluator::GetCx4TokenValue(int64_t token, EvalResultType& res
 
 		default: return 0;
 	}
+}
+
+ExpressionEvaluator::RegisterReader ExpressionEvaluator::GetCx4RegisterReader(int64_t token)
+{
+	switch(token) {
+		case EvalValues::R0: return &ReadStateArray<&Cx4State::Regs, 0>;
+		case EvalValues::R1: return &ReadStateArray<&Cx4State::Regs, 1>;
+		case EvalValues::R2: return &ReadStateArray<&Cx4State::Regs, 2>;
+		case EvalValues::R3: return &ReadStateArray<&Cx4State::Regs, 3>;
+		case EvalValues::R4: return &ReadStateArray<&Cx4State::Regs, 4>;
+		case EvalValues::R5: return &ReadStateArray<&Cx4State::Regs, 5>;
+		case EvalValues::R6: return &ReadStateArray<&Cx4State::Regs, 6>;
+		case EvalValues::R7: return &ReadStateArray<&Cx4State::Regs, 7>;
+		case EvalValues::R8: return &ReadStateArray<&Cx4State::Regs, 8>;
+		case EvalValues::R9: return &ReadStateArray<&Cx4State::Regs, 9>;
+		case EvalValues::R10: return &ReadStateArray<&Cx4State::Regs, 10>;
+		case EvalValues::R11: return &ReadStateArray<&Cx4State::Regs, 11>;
+		case EvalValues::R12: return &ReadStateArray<&Cx4State::Regs, 12>;
+		case EvalValues::R13: return &ReadStateArray<&Cx4State::Regs, 13>;
+		case EvalValues::R14: return &ReadStateArray<&Cx4State::Regs, 14>;
+		case EvalValues::R15: return &ReadStateArray<&Cx4State::Regs, 15>;
+		case EvalValues::RegPB: return &ReadState<&Cx4State::PB>;
+		case EvalValues::RegPC: return &ReadState<&Cx4State::PC>;
+		case EvalValues::RegA: return &ReadState<&Cx4State::A>;
+		case EvalValues::RegP: return &ReadState<&Cx4State::P>;
+		case EvalValues::RegSP: return &ReadState<&Cx4State::SP>;
+		case EvalValues::RegMult: return &ReadState<&Cx4State::Mult>;
+		case EvalValues::RegMDR: return &ReadState<&Cx4State::MemoryDataReg>;
+		case EvalValues::RegMAR: return &ReadState<&Cx4State::MemoryAddressReg>;
+		case EvalValues::RegDPR: return &ReadState<&Cx4State::DataPointerReg>;
+		default: return nullptr;
+	}
 }
\ No newline at end of file
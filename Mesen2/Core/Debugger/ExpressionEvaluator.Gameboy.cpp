@@ -60,4 +60,21 @@ int64_t ExpressionEvaluator::GetGameboyTokenValue(int64_t token, EvalResultType&
 
 		default: return 0;
 	}
+}
+
+ExpressionEvaluator::RegisterReader ExpressionEvaluator::GetGameboyRegisterReader(int64_t token)
+{
+	switch(token) {
+		case EvalValues::RegA: return &ReadState<&GbCpuState::A>;
+		case EvalValues::RegB: return &ReadState<&GbCpuState::B>;
+		case EvalValues::RegC: return &ReadState<&GbCpuState::C>;
+		case EvalValues::RegD: return &ReadState<&GbCpuState::D>;
+		case EvalValues::RegE: return &ReadState<&GbCpuState::E>;
+		case EvalValues::RegF: return &ReadState<&GbCpuState::Flags>;
+		case EvalValues::RegH: return &ReadState<&GbCpuState::H>;
+		case EvalValues::RegL: return &ReadState<&GbCpuState::L>;
+		case EvalValues::RegSP: return &ReadState<&GbCpuState::SP>;
+		case EvalValues::RegPC: return &ReadState<&GbCpuState::PC>;
+		default: return nullptr;
+	}
 }
\ No newline at end of file
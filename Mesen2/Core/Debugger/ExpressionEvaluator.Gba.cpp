@@ -68,4 +68,27 @@ int64_t ExpressionEvaluator::GetGbaTokenValue(int64_t token, EvalResultType& res
 
 		default: return 0;
 	}
+}
+
+ExpressionEvaluator::RegisterReader ExpressionEvaluator::GetGbaRegisterReader(int64_t token)
+{
+	switch(token) {
+		case EvalValues::R0: return &ReadStateArray<&GbaCpuState::R, 0>;
+		case EvalValues::R1: return &ReadStateArray<&GbaCpuState::R, 1>;
+		case EvalValues::R2: return &ReadStateArray<&GbaCpuState::R, 2>;
+		case EvalValues::R3: return &ReadStateArray<&GbaCpuState::R, 3>;
+		case EvalValues::R4: return &ReadStateArray<&GbaCpuState::R, 4>;
+		case EvalValues::R5: return &ReadStateArray<&GbaCpuState::R, 5>;
+		case EvalValues::R6: return &ReadStateArray<&GbaCpuState::R, 6>;
+		case EvalValues::R7: return &ReadStateArray<&GbaCpuState::R, 7>;
+		case EvalValues::R8: return &ReadStateArray<&GbaCpuState::R, 8>;
+		case EvalValues::R9: return &ReadStateArray<&GbaCpuState::R, 9>;
+		case EvalValues::R10: return &ReadStateArray<&GbaCpuState::R, 10>;
+		case EvalValues::R11: return &ReadStateArray<&GbaCpuState::R, 11>;
+		case EvalValues::R12: return &ReadStateArray<&GbaCpuState::R, 12>;
+		case EvalValues::R13: return &ReadStateArray<&GbaCpuState::R, 13>;
+		case EvalValues::R14: return &ReadStateArray<&GbaCpuState::R, 14>;
+		case EvalValues::R15: return &ReadStateArray<&GbaCpuState::R, 15>;
+		default: return nullptr;
+	}
 }
\ No newline at end of file
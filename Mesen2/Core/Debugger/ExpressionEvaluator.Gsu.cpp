@@ -64,4 +64,32 @@ int64_t ExpressionEvaluator::GetGsuTokenValue(int64_t token, EvalResultType& res
 
 		default: return 0;
 	}
+}
+
+ExpressionEvaluator::RegisterReader ExpressionEvaluator::GetGsuRegisterReader(int64_t token)
+{
+	switch(token) {
+		case EvalValues::R0: return &ReadStateArray<&GsuState::R, 0>;
+		case EvalValues::R1: return &ReadStateArray<&GsuState::R, 1>;
+		case EvalValues::R2: return &ReadStateArray<&GsuState::R, 2>;
+		case EvalValues::R3: return &ReadStateArray<&GsuState::R, 3>;
+		case EvalValues::R4: return &ReadStateArray<&GsuState::R, 4>;
+		case EvalValues::R5: return &ReadStateArray<&GsuState::R, 5>;
+		case EvalValues::R6: return &ReadStateArray<&GsuState::R, 6>;
+		case EvalValues::R7: return &ReadStateArray<&GsuState::R, 7>;
+		case EvalValues::R8: return &ReadStateArray<&GsuState::R, 8>;
+		case EvalValues::R9: return &ReadStateArray<&GsuState::R, 9>;
+		case EvalValues::R10: return &ReadStateArray<&GsuState::R, 10>;
+		case EvalValues::R11: return &ReadStateArray<&GsuState::R, 11>;
+		case EvalValues::R12: return &ReadStateArray<&GsuState::R, 12>;
+		case EvalValues::R13: return &ReadStateArray<&GsuState::R, 13>;
+		case EvalValues::R14: return &ReadStateArray<&GsuState::R, 14>;
+		case EvalValues::R15: return &ReadStateArray<&GsuState::R, 15>;
+		case EvalValues::SrcReg: return &ReadState<&GsuState::SrcReg>;
+		case EvalValues::DstReg: return &ReadState<&GsuState::DestReg>;
+		case EvalValues::PBR: return &ReadState<&GsuState::ProgramBank>;
+		case EvalValues::RomBR: return &ReadState<&GsuState::RomBank>;
+		case EvalValues::RamBR: return &ReadState<&GsuState::RamBank>;
+		default: return nullptr;
+	}
 }
\ No newline at end of file
@@ -45,4 +45,25 @@ int64_t ExpressionEvaluator::GetNecDspTokenValue(int64_t token, EvalResultType&
 		case EvalValues::RegPC: return s.PC;
 		default: return 0;
 	}
+}
+
+ExpressionEvaluator::RegisterReader ExpressionEvaluator::GetNecDspRegisterReader(int64_t token)
+{
+	switch(token) {
+		case EvalValues::RegA: return &ReadState<&NecDspState::A>;
+		case EvalValues::RegB: return &ReadState<&NecDspState::B>;
+		case EvalValues::RegTR: return &ReadState<&NecDspState::TR>;
+		case EvalValues::RegTRB: return &ReadState<&NecDspState::TRB>;
+		case EvalValues::RegRP: return &ReadState<&NecDspState::RP>;
+		case EvalValues::RegDP: return &ReadState<&NecDspState::DP>;
+		case EvalValues::RegDR: return &ReadState<&NecDspState::DR>;
+		case EvalValues::RegSR: return &ReadState<&NecDspState::SR>;
+		case EvalValues::RegK: return &ReadState<&NecDspState::K>;
+		case EvalValues::RegL: return &ReadState<&NecDspState::L>;
+		case EvalValues::RegM: return &ReadState<&NecDspState::M>;
+		case EvalValues::RegN: return &ReadState<&NecDspState::N>;
+		case EvalValues::RegSP: return &ReadState<&NecDspState::SP>;
+		case EvalValues::RegPC: return &ReadState<&NecDspState::PC>;
+		default: return nullptr;
+	}
 }
\ No newline at end of file
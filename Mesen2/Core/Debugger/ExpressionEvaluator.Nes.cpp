@@ -72,4 +72,17 @@ int64_t ExpressionEvaluator::GetNesTokenValue(int64_t token, EvalResultType& res
 
 		default: return 0;
 	}
+}
+
+ExpressionEvaluator::RegisterReader ExpressionEvaluator::GetNesRegisterReader(int64_t token)
+{
+	switch(token) {
+		case EvalValues::RegA: return &ReadState<&NesCpuState::A>;
+		case EvalValues::RegX: return &ReadState<&NesCpuState::X>;
+		case EvalValues::RegY: return &ReadState<&NesCpuState::Y>;
+		case EvalValues::RegSP: return &ReadState<&NesCpuState::SP>;
+		case EvalValues::RegPS: return &ReadState<&NesCpuState::PS>;
+		case EvalValues::RegPC: return &ReadState<&NesCpuState::PC>;
+		default: return nullptr;
+	}
 }
\ No newline at end of file
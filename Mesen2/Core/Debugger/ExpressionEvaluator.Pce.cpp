@@ -87,3 +87,16 @@ int64_t ExpressionEvaluator::GetPceTokenValue(int64_t token, EvalResultType& res
 		default: return 0;
 	}
 }
+
+ExpressionEvaluator::RegisterReader ExpressionEvaluator::GetPceRegisterReader(int64_t token)
+{
+	switch(token) {
+		case EvalValues::RegA: return &ReadState<&PceCpuState::A>;
+		case EvalValues::RegX: return &ReadState<&PceCpuState::X>;
+		case EvalValues::RegY: return &ReadState<&PceCpuState::Y>;
+		case EvalValues::RegSP: return &ReadState<&PceCpuState::SP>;
+		case EvalValues::RegPS: return &ReadState<&PceCpuState::PS>;
+		case EvalValues::RegPC: return &ReadState<&PceCpuState::PC>;
+		default: return nullptr;
+	}
+}
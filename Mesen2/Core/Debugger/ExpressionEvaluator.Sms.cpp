@@ -103,4 +103,31 @@ int64_t ExpressionEvaluator::GetSmsTokenValue(int64_t token, EvalResultType& res
 
 		default: return 0;
 	}
+}
+
+ExpressionEvaluator::RegisterReader ExpressionEvaluator::GetSmsRegisterReader(int64_t token)
+{
+	switch(token) {
+		case EvalValues::RegA: return &ReadState<&SmsCpuState::A>;
+		case EvalValues::RegB: return &ReadState<&SmsCpuState::B>;
+		case EvalValues::RegC: return &ReadState<&SmsCpuState::C>;
+		case EvalValues::RegD: return &ReadState<&SmsCpuState::D>;
+		case EvalValues::RegE: return &ReadState<&SmsCpuState::E>;
+		case EvalValues::RegF: return &ReadState<&SmsCpuState::Flags>;
+		case EvalValues::RegH: return &ReadState<&SmsCpuState::H>;
+		case EvalValues::RegL: return &ReadState<&SmsCpuState::L>;
+		case EvalValues::RegAltA: return &ReadState<&SmsCpuState::AltA>;
+		case EvalValues::RegAltB: return &ReadState<&SmsCpuState::AltB>;
+		case EvalValues::RegAltC: return &ReadState<&SmsCpuState::AltC>;
+		case EvalValues::RegAltD: return &ReadState<&SmsCpuState::AltD>;
+		case EvalValues::RegAltE: return &ReadState<&SmsCpuState::AltE>;
+		case EvalValues::RegAltF: return &ReadState<&SmsCpuState::AltFlags>;
+		case EvalValues::RegAltH: return &ReadState<&SmsCpuState::AltH>;
+		case EvalValues::RegAltL: return &ReadState<&SmsCpuState::AltL>;
+		case EvalValues::RegI: return &ReadState<&SmsCpuState::I>;
+		case EvalValues::RegR: return &ReadState<&SmsCpuState::R>;
+		case EvalValues::RegSP: return &ReadState<&SmsCpuState::SP>;
+		case EvalValues::RegPC: return &ReadState<&SmsCpuState::PC>;
+		default: return nullptr;
+	}
 }
\ No newline at end of file
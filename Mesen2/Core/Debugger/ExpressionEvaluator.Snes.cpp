@@ -70,4 +70,18 @@ int64_t ExpressionEvaluator::GetSnesTokenValue(int64_t token, EvalResultType& re
 
 		default: return 0;
 	}
+}
+
+ExpressionEvaluator::RegisterReader ExpressionEvaluator::GetSnesRegisterReader(int64_t token)
+{
+	switch(token) {
+		case EvalValues::RegA: return &ReadState<&SnesCpuState::A>;
+		case EvalValues::RegX: return &ReadState<&SnesCpuState::X>;
+		case EvalValues::RegY: return &ReadState<&SnesCpuState::Y>;
+		case EvalValues::RegSP: return &ReadState<&SnesCpuState::SP>;
+		case EvalValues::RegPS: return &ReadState<&SnesCpuState::PS>;
+		case EvalValues::RegDB: return &ReadState<&SnesCpuState::DBR>;
+		case EvalValues::RegD: return &ReadState<&SnesCpuState::D>;
+		default: return nullptr;
+	}
 }
\ No newline at end of file
@@ -31,4 +31,18 @@ int64_t ExpressionEvaluator::GetSpcTokenValue(int64_t token, EvalResultType& res
 		case EvalValues::SpcDspReg: return s.DspReg;
 		default: return 0;
 	}
+}
+
+ExpressionEvaluator::RegisterReader ExpressionEvaluator::GetSpcRegisterReader(int64_t token)
+{
+	switch(token) {
+		case EvalValues::RegA: return &ReadState<&SpcState::A>;
+		case EvalValues::RegX: return &ReadState<&SpcState::X>;
+		case EvalValues::RegY: return &ReadState<&SpcState::Y>;
+		case EvalValues::RegSP: return &ReadState<&SpcState::SP>;
+		case EvalValues::RegPS: return &ReadState<&SpcState::PS>;
+		case EvalValues::RegPC: return &ReadState<&SpcState::PC>;
+		case EvalValues::SpcDspReg: return &ReadState<&SpcState::DspReg>;
+		default: return nullptr;
+	}
 }
\ No newline at end of file
@@ -55,4 +55,27 @@ int64_t ExpressionEvaluator::GetSt018TokenValue(int64_t token, EvalResultType& r
 
 		default: return 0;
 	}
+}
+
+ExpressionEvaluator::RegisterReader ExpressionEvaluator::GetSt018RegisterReader(int64_t token)
+{
+	switch(token) {
+		case EvalValues::R0: return &ReadStateArray<&ArmV3CpuState::R, 0>;
+		case EvalValues::R1: return &ReadStateArray<&ArmV3CpuState::R, 1>;
+		case EvalValues::R2: return &ReadStateArray<&ArmV3CpuState::R, 2>;
+		case EvalValues::R3: return &ReadStateArray<&ArmV3CpuState::R, 3>;
+		case EvalValues::R4: return &ReadStateArray<&ArmV3CpuState::R, 4>;
+		case EvalValues::R5: return &ReadStateArray<&ArmV3CpuState::R, 5>;
+		case EvalValues::R6: return &ReadStateArray<&ArmV3CpuState::R, 6>;
+		case EvalValues::R7: return &ReadStateArray<&ArmV3CpuState::R, 7>;
+		case EvalValues::R8: return &ReadStateArray<&ArmV3CpuState::R, 8>;
+		case EvalValues::R9: return &ReadStateArray<&ArmV3CpuState::R, 9>;
+		case EvalValues::R10: return &ReadStateArray<&ArmV3CpuState::R, 10>;
+		case EvalValues::R11: return &ReadStateArray<&ArmV3CpuState::R, 11>;
+		case EvalValues::R12: return &ReadStateArray<&ArmV3CpuState::R, 12>;
+		case EvalValues::R13: return &ReadStateArray<&ArmV3CpuState::R, 13>;
+		case EvalValues::R14: return &ReadStateArray<&ArmV3CpuState::R, 14>;
+		case EvalValues::R15: return &ReadStateArray<&ArmV3CpuState::R, 15>;
+		default: return nullptr;
+	}
 }
\ No newline at end of file
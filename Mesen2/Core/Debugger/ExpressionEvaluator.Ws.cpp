@@ -87,4 +87,24 @@ int64_t ExpressionEvaluator::GetWsTokenValue(int64_t token, EvalResultType& resu
 
 		default: return 0;
 	}
+}
+
+ExpressionEvaluator::RegisterReader ExpressionEvaluator::GetWsRegisterReader(int64_t token)
+{
+	switch(token) {
+		case EvalValues::RegAX: return &ReadState<&WsCpuState::AX>;
+		case EvalValues::RegBX: return &ReadState<&WsCpuState::BX>;
+		case EvalValues::RegCX: return &ReadState<&WsCpuState::CX>;
+		case EvalValues::RegDX: return &ReadState<&WsCpuState::DX>;
+		case EvalValues::RegCS: return &ReadState<&WsCpuState::CS>;
+		case EvalValues::RegDS: return &ReadState<&WsCpuState::DS>;
+		case EvalValues::RegES: return &ReadState<&WsCpuState::ES>;
+		case EvalValues::RegSS: return &ReadState<&WsCpuState::SS>;
+		case EvalValues::RegSI: return &ReadState<&WsCpuState::SI>;
+		case EvalValues::RegDI: return &ReadState<&WsCpuState::DI>;
+		case EvalValues::RegBP: return &ReadState<&WsCpuState::BP>;
+		case EvalValues::RegIP: return &ReadState<&WsCpuState::IP>;
+		case EvalValues::RegSP: return &ReadState<&WsCpuState::SP>;
+		default: return nullptr;
+	}
 }
\ No newline at end of file
@@ -369,7 +369,221 @@ bool ExpressionEvaluator::ToRpn(string expression, ExpressionData &data)
 	return true;
 }
 
-int64_t ExpressionEvaluator::Evaluate(ExpressionData &data, EvalResultType &resultType, MemoryOperationInfo &operationInfo, AddressInfo& addressInfo)
+bool ExpressionEvaluator::GetLabelValue(ExpressionData& data, int64_t token, int64_t& value, EvalResultType& resultType)
+{
+	int64_t labelIndex = token - EvalValues::FirstLabelIndex;
+	if((size_t)labelIndex < data.Labels.size()) {
+		value = _labelManager->GetLabelRelativeAddress(data.Labels[(uint32_t)labelIndex], _cpuType);
+	} else {
+		value = -2;
+	}
+	if(value < 0) {
+		//Label is no longer valid
+		resultType = value == -1 ? EvalResultType::OutOfScope : EvalResultType::Invalid;
+		return false;
+	}
+	return true;
+}
+
+__forceinline bool ExpressionEvaluator::ApplyOperator(EvalOperators op, int64_t left, int64_t right, int64_t& result, EvalResultType& resultType)
+{
+	resultType = EvalResultType::Numeric;
+	switch(op) {
+		case EvalOperators::Multiplication: result = left * right; break;
+		case EvalOperators::Division: 
+			if(right == 0) {
+				resultType = EvalResultType::DivideBy0;
+				return false;
+			}
+			result = left / right; break;
+		case EvalOperators::Modulo:
+			if(right == 0) {
+				resultType = EvalResultType::DivideBy0;
+				return false;
+			}
+			result = left % right;
+			break;
+		case EvalOperators::Addition: result = left + right; break;
+		case EvalOperators::Substration: result = left - right; break;
+		case EvalOperators::ShiftLeft: result = left << right; break;
+		case EvalOperators::ShiftRight: result = left >> right; break;
+		case EvalOperators::SmallerThan: result = left < right; resultType = EvalResultType::Boolean; break;
+		case EvalOperators::SmallerOrEqual: result = left <= right; resultType = EvalResultType::Boolean; break;
+		case EvalOperators::GreaterThan: result = left > right; resultType = EvalResultType::Boolean; break;
+		case EvalOperators::GreaterOrEqual: result = left >= right; resultType = EvalResultType::Boolean; break;
+		case EvalOperators::Equal: result = left == right; resultType = EvalResultType::Boolean; break;
+		case EvalOperators::NotEqual: result = left != right; resultType = EvalResultType::Boolean; break;
+		case EvalOperators::BinaryAnd: result = left & right; break;
+		case EvalOperators::BinaryXor: result = left ^ right; break;
+		case EvalOperators::BinaryOr: result = left | right; break;
+		case EvalOperators::LogicalAnd: result = (bool)(left && right); resultType = EvalResultType::Boolean; break;
+		case EvalOperators::LogicalOr: result = (bool)(left || right); resultType = EvalResultType::Boolean; break;
+
+		//Unary operators
+		case EvalOperators::Plus: result = right; break;
+		case EvalOperators::Minus: result = -right; break;
+		case EvalOperators::BinaryNot: result = ~right; break;
+		case EvalOperators::LogicalNot: result = (bool)!right; break;
+		case EvalOperators::AbsoluteAddress: result = right >= 0 ? _debugger->GetAbsoluteAddress({ (int32_t)right, _cpuMemory }).Address : -1; break;
+		case EvalOperators::ReadDword: result = _debugger->GetMemoryDumper()->GetMemoryValue32(_cpuMemory, (uint32_t)right); break;
+
+		case EvalOperators::Bracket: result = _debugger->GetMemoryDumper()->GetMemoryValue(_cpuMemory, (uint32_t)right); break;
+		case EvalOperators::Braces: result = _debugger->GetMemoryDumper()->GetMemoryValue16(_cpuMemory, (uint32_t)right); break;
+		default: throw std::runtime_error("Invalid operator");
+	}
+	return true;
+}
+
+void ExpressionEvaluator::Compile(ExpressionData& data)
+{
+	//Converts the RPN queue to a list of instructions that can be executed without decoding each token:
+	//-Operations that only use constants are evaluated once, here
+	//-Constant right operands are stored in the operator's instruction instead of being pushed on the stack
+	//-CPU registers are read directly from the CPU's state, other tokens are resolved to the CPU's token function
+	//Queues that the interpreter would reject (or that rely on its handling of missing operands) are not compiled
+	data.Program.clear();
+
+	vector<ExpressionInstruction> program;
+	int depth = 0;
+	for(int64_t token : data.RpnQueue) {
+		ExpressionInstruction inst = {};
+		inst.Value = token;
+
+		if(token >= EvalValues::RegA) {
+			if(token >= EvalValues::FirstLabelIndex) {
+				inst.Code = ExpressionOpCode::Label;
+			} else {
+				switch(token) {
+					case EvalValues::Value: inst.Code = ExpressionOpCode::OpValue; break;
+					case EvalValues::Address: inst.Code = ExpressionOpCode::OpAddress; break;
+					case EvalValues::MemoryAddress: inst.Code = ExpressionOpCode::MemAddress; break;
+					case EvalValues::IsWrite: inst.Code = ExpressionOpCode::IsWrite; break;
+					case EvalValues::IsRead: inst.Code = ExpressionOpCode::IsRead; break;
+					case EvalValues::IsDma: inst.Code = ExpressionOpCode::IsDma; break;
+					case EvalValues::IsDummy: inst.Code = ExpressionOpCode::IsDummy; break;
+					case EvalValues::OpProgramCounter: inst.Code = ExpressionOpCode::OpProgramCounter; break;
+					default:
+						inst.ReadRegister = (this->*_getRegisterReader)(token);
+						inst.Code = inst.ReadRegister ? ExpressionOpCode::CpuRegister : ExpressionOpCode::CpuToken;
+						break;
+				}
+			}
+			program.push_back(inst);
+			depth++;
+		} else if(token >= EvalOperators::Multiplication) {
+			if(token > EvalOperators::Braces) {
+				return;
+			}
+
+			EvalOperators op = (EvalOperators)token;
+			bool binary = token <= EvalOperators::LogicalOr;
+			if(depth < (binary ? 2 : 1)) {
+				return;
+			}
+			depth -= binary ? 1 : 0;
+
+			auto isConstant = [&](size_t offset) {
+				return program.size() > offset && (program[program.size() - 1 - offset].Code == ExpressionOpCode::Constant || program[program.size() - 1 - offset].Code == ExpressionOpCode::TypedConstant);
+			};
+
+			bool rightConstant = isConstant(0);
+			bool leftConstant = binary && rightConstant && isConstant(1);
+			bool readsMemory = op == EvalOperators::AbsoluteAddress || op == EvalOperators::ReadDword || op == EvalOperators::Bracket || op == EvalOperators::Braces;
+
+			int64_t result;
+			EvalResultType resultType;
+			if(rightConstant && (!binary || leftConstant) && !readsMemory) {
+				int64_t right = program.back().Value;
+				int64_t left = binary ? program[program.size() - 2].Value : 0;
+				if(ApplyOperator(op, left, right, result, resultType)) {
+					//Replace the operands with the result
+					program.resize(program.size() - (binary ? 2 : 1));
+					inst.Code = ExpressionOpCode::TypedConstant;
+					inst.Value = result;
+					inst.ResultType = resultType;
+					program.push_back(inst);
+					continue;
+				}
+			}
+
+			inst.Code = binary ? ExpressionOpCode::BinaryOperator : ExpressionOpCode::UnaryOperator;
+			inst.Operator = op;
+			inst.Value = 0;
+			if(rightConstant) {
+				inst.ImmediateOperand = true;
+				inst.Value = program.back().Value;
+				program.pop_back();
+			}
+			program.push_back(inst);
+		} else {
+			inst.Code = ExpressionOpCode::Constant;
+			program.push_back(inst);
+			depth++;
+		}
+
+		if(depth >= MaxStackSize) {
+			return;
+		}
+	}
+
+	if(depth == 1) {
+		data.Program = std::move(program);
+	}
+}
+
+int64_t ExpressionEvaluator::EvaluateProgram(ExpressionData& data, EvalResultType& resultType, MemoryOperationInfo& operationInfo, AddressInfo& addressInfo)
+{
+	int pos = 0;
+	int64_t operandStack[MaxStackSize];
+	resultType = EvalResultType::Numeric;
+
+	for(const ExpressionInstruction& inst : data.Program) {
+		int64_t value;
+		switch(inst.Code) {
+			default:
+			case ExpressionOpCode::Constant: value = inst.Value; break;
+			case ExpressionOpCode::TypedConstant: value = inst.Value; resultType = inst.ResultType; break;
+			case ExpressionOpCode::OpValue: value = operationInfo.Value; break;
+			case ExpressionOpCode::OpAddress: value = operationInfo.Address; break;
+			case ExpressionOpCode::MemAddress: value = addressInfo.Address; break;
+			case ExpressionOpCode::IsWrite: value = operationInfo.Type == MemoryOperationType::Write || operationInfo.Type == MemoryOperationType::DmaWrite || operationInfo.Type == MemoryOperationType::DummyWrite; break;
+			case ExpressionOpCode::IsRead: value = operationInfo.Type != MemoryOperationType::Write && operationInfo.Type != MemoryOperationType::DmaWrite && operationInfo.Type != MemoryOperationType::DummyWrite; break;
+			case ExpressionOpCode::IsDma: value = operationInfo.Type == MemoryOperationType::DmaRead || operationInfo.Type == MemoryOperationType::DmaWrite; break;
+			case ExpressionOpCode::IsDummy: value = operationInfo.Type == MemoryOperationType::DummyRead || operationInfo.Type == MemoryOperationType::DummyWrite; break;
+			case ExpressionOpCode::OpProgramCounter: value = _cpuDebugger->GetProgramCounter(true); break;
+			case ExpressionOpCode::CpuToken: value = _cpuDebugger ? (this->*_getTokenValue)(inst.Value, resultType) : 0; break;
+			case ExpressionOpCode::CpuRegister: value = _cpuDebugger ? inst.ReadRegister(_cpuDebugger->GetState()) : 0; break;
+
+			case ExpressionOpCode::Label:
+				if(!GetLabelValue(data, inst.Value, value, resultType)) {
+					return 0;
+				}
+				break;
+
+			case ExpressionOpCode::UnaryOperator:
+			case ExpressionOpCode::BinaryOperator: {
+				int64_t right = inst.ImmediateOperand ? inst.Value : operandStack[--pos];
+				int64_t left = inst.Code == ExpressionOpCode::BinaryOperator ? operandStack[--pos] : 0;
+				if(!ApplyOperator(inst.Operator, left, right, value, resultType)) {
+					return 0;
+				}
+				break;
+			}
+		}
+		operandStack[pos++] = value;
+	}
+	return std::clamp<int64_t>(operandStack[0], INT32_MIN, UINT32_MAX);
+}
+
+int64_t ExpressionEvaluator::Evaluate(ExpressionData& data, EvalResultType& resultType, MemoryOperationInfo& operationInfo, AddressInfo& addressInfo)
+{
+	if(!data.Program.empty()) {
+		return EvaluateProgram(data, resultType, operationInfo, addressInfo);
+	}
+	return EvaluateRpn(data, resultType, operationInfo, addressInfo);
+}
+
+int64_t ExpressionEvaluator::EvaluateRpn(ExpressionData &data, EvalResultType &resultType, MemoryOperationInfo &operationInfo, AddressInfo& addressInfo)
 {
 	if(data.RpnQueue.empty()) {
 		resultType = EvalResultType::Invalid;
@@ -379,7 +593,7 @@ int64_t ExpressionEvaluator::Evaluate(ExpressionData &data, EvalResultType &resu
 	int pos = 0;
 	int64_t right = 0;
 	int64_t left = 0;
-	int64_t operandStack[100];
+	int64_t operandStack[MaxStackSize];
 	resultType = EvalResultType::Numeric;
 
 	for(size_t i = 0, len = data.RpnQueue.size(); i < len; i++) {
@@ -388,15 +602,7 @@ int64_t ExpressionEvaluator::Evaluate(ExpressionData &data, EvalResultType &resu
 		if(token >= EvalValues::RegA) {
 			//Replace value with a special value
 			if(token >= EvalValues::FirstLabelIndex) {
-				int64_t labelIndex = token - EvalValues::FirstLabelIndex;
-				if((size_t)labelIndex < data.Labels.size()) {
-					token = _labelManager->GetLabelRelativeAddress(data.Labels[(uint32_t)labelIndex], _cpuType);
-				} else {
-					token = -2;
-				}
-				if(token < 0) {
-					//Label is no longer valid
-					resultType = token == -1 ? EvalResultType::OutOfScope : EvalResultType::Invalid;
+				if(!GetLabelValue(data, token, token, resultType)) {
 					return 0;
 				}
 			} else {
@@ -409,28 +615,7 @@ int64_t ExpressionEvaluator::Evaluate(ExpressionData &data, EvalResultType &resu
 					case EvalValues::IsDma: token = operationInfo.Type == MemoryOperationType::DmaRead || operationInfo.Type == MemoryOperationType::DmaWrite; break;
 					case EvalValues::IsDummy: token = operationInfo.Type == MemoryOperationType::DummyRead|| operationInfo.Type == MemoryOperationType::DummyWrite; break;
 					case EvalValues::OpProgramCounter: token = _cpuDebugger->GetProgramCounter(true); break;
-
-					default:
-						if(!_cpuDebugger) {
-							token = 0;
-						} else {
-							switch(_cpuType) {
-								case CpuType::Snes: token = GetSnesTokenValue(token, resultType); break;
-								case CpuType::Spc: token = GetSpcTokenValue(token, resultType); break;
-								case CpuType::NecDsp: token = GetNecDspTokenValue(token, resultType); break;
-								case CpuType::Sa1: token = GetSnesTokenValue(token, resultType); break;
-								case CpuType::Gsu: token = GetGsuTokenValue(token, resultType); break;
-								case CpuType::Cx4: token = GetCx4TokenValue(token, resultType); break;
-								case CpuType::St018: token = GetSt018TokenValue(token, resultType); break;
-								case CpuType::Gameboy: token = GetGameboyTokenValue(token, resultType); break;
-								case CpuType::Nes: token = GetNesTokenValue(token, resultType); break;
-								case CpuType::Pce: token = GetPceTokenValue(token, resultType); break;
-								case CpuType::Sms: token = GetSmsTokenValue(token, resultType); break;
-								case CpuType::Gba: token = GetGbaTokenValue(token, resultType); break;
-								case CpuType::Ws: token = GetWsTokenValue(token, resultType); break;
-							}
-						}
-						break;
+					default: token = _cpuDebugger ? (this->*_getTokenValue)(token, resultType) : 0; break;
 				}
 			}
 		} else if(token >= EvalOperators::Multiplication) {
@@ -445,53 +630,12 @@ int64_t ExpressionEvaluator::Evaluate(ExpressionData &data, EvalResultType &resu
 				left = operandStack[--pos];
 			}
 
-			resultType = EvalResultType::Numeric;
-			switch(token) {
-				case EvalOperators::Multiplication: token = left * right; break;
-				case EvalOperators::Division: 
-					if(right == 0) {
-						resultType = EvalResultType::DivideBy0;
-						return 0;
-					}
-					token = left / right; break;
-				case EvalOperators::Modulo:
-					if(right == 0) {
-						resultType = EvalResultType::DivideBy0;
-						return 0;
-					}
-					token = left % right;
-					break;
-				case EvalOperators::Addition: token = left + right; break;
-				case EvalOperators::Substration: token = left - right; break;
-				case EvalOperators::ShiftLeft: token = left << right; break;
-				case EvalOperators::ShiftRight: token = left >> right; break;
-				case EvalOperators::SmallerThan: token = left < right; resultType = EvalResultType::Boolean; break;
-				case EvalOperators::SmallerOrEqual: token = left <= right; resultType = EvalResultType::Boolean; break;
-				case EvalOperators::GreaterThan: token = left > right; resultType = EvalResultType::Boolean; break;
-				case EvalOperators::GreaterOrEqual: token = left >= right; resultType = EvalResultType::Boolean; break;
-				case EvalOperators::Equal: token = left == right; resultType = EvalResultType::Boolean; break;
-				case EvalOperators::NotEqual: token = left != right; resultType = EvalResultType::Boolean; break;
-				case EvalOperators::BinaryAnd: token = left & right; break;
-				case EvalOperators::BinaryXor: token = left ^ right; break;
-				case EvalOperators::BinaryOr: token = left | right; break;
-				case EvalOperators::LogicalAnd: token = (bool)(left && right); resultType = EvalResultType::Boolean; break;
-				case EvalOperators::LogicalOr: token = (bool)(left || right); resultType = EvalResultType::Boolean; break;
-
-				//Unary operators
-				case EvalOperators::Plus: token = right; break;
-				case EvalOperators::Minus: token = -right; break;
-				case EvalOperators::BinaryNot: token = ~right; break;
-				case EvalOperators::LogicalNot: token = (bool)!right; break;
-				case EvalOperators::AbsoluteAddress: token = right >= 0 ? _debugger->GetAbsoluteAddress({ (int32_t)right, _cpuMemory }).Address : -1; break;
-				case EvalOperators::ReadDword: token = _debugger->GetMemoryDumper()->GetMemoryValue32(_cpuMemory, (uint32_t)right); break;
-
-				case EvalOperators::Bracket: token = _debugger->GetMemoryDumper()->GetMemoryValue(_cpuMemory, (uint32_t)right); break;
-				case EvalOperators::Braces: token = _debugger->GetMemoryDumper()->GetMemoryValue16(_cpuMemory, (uint32_t)right); break;
-				default: throw std::runtime_error("Invalid operator");
+			if(!ApplyOperator((EvalOperators)token, left, right, token, resultType)) {
+				return 0;
 			}
 		}
 		operandStack[pos++] = token;
-		if(pos >= 100) {
+		if(pos >= MaxStackSize) {
 			resultType = EvalResultType::Invalid;
 			return 0;
 		}
@@ -506,6 +650,73 @@ ExpressionEvaluator::ExpressionEvaluator(Debugger* debugger, IDebugger* cpuDebug
 	_labelManager = debugger->GetLabelManager();
 	_cpuType = cpuType;
 	_cpuMemory = DebugUtilities::GetCpuMemoryType(cpuType);
+
+	switch(_cpuType) {
+		case CpuType::Snes:
+			_getTokenValue = &ExpressionEvaluator::GetSnesTokenValue;
+			_getRegisterReader = &ExpressionEvaluator::GetSnesRegisterReader;
+			break;
+
+		case CpuType::Spc:
+			_getTokenValue = &ExpressionEvaluator::GetSpcTokenValue;
+			_getRegisterReader = &ExpressionEvaluator::GetSpcRegisterReader;
+			break;
+
+		case CpuType::NecDsp:
+			_getTokenValue = &ExpressionEvaluator::GetNecDspTokenValue;
+			_getRegisterReader = &ExpressionEvaluator::GetNecDspRegisterReader;
+			break;
+
+		case CpuType::Sa1:
+			_getTokenValue = &ExpressionEvaluator::GetSnesTokenValue;
+			_getRegisterReader = &ExpressionEvaluator::GetSnesRegisterReader;
+			break;
+
+		case CpuType::Gsu:
+			_getTokenValue = &ExpressionEvaluator::GetGsuTokenValue;
+			_getRegisterReader = &ExpressionEvaluator::GetGsuRegisterReader;
+			break;
+
+		case CpuType::Cx4:
+			_getTokenValue = &ExpressionEvaluator::GetCx4TokenValue;
+			_getRegisterReader = &ExpressionEvaluator::GetCx4RegisterReader;
+			break;
+
+		case CpuType::St018:
+			_getTokenValue = &ExpressionEvaluator::GetSt018TokenValue;
+			_getRegisterReader = &ExpressionEvaluator::GetSt018RegisterReader;
+			break;
+
+		case CpuType::Gameboy:
+			_getTokenValue = &ExpressionEvaluator::GetGameboyTokenValue;
+			_getRegisterReader = &ExpressionEvaluator::GetGameboyRegisterReader;
+			break;
+
+		case CpuType::Nes:
+			_getTokenValue = &ExpressionEvaluator::GetNesTokenValue;
+			_getRegisterReader = &ExpressionEvaluator::GetNesRegisterReader;
+			break;
+
+		case CpuType::Pce:
+			_getTokenValue = &ExpressionEvaluator::GetPceTokenValue;
+			_getRegisterReader = &ExpressionEvaluator::GetPceRegisterReader;
+			break;
+
+		case CpuType::Sms:
+			_getTokenValue = &ExpressionEvaluator::GetSmsTokenValue;
+			_getRegisterReader = &ExpressionEvaluator::GetSmsRegisterReader;
+			break;
+
+		case CpuType::Gba:
+			_getTokenValue = &ExpressionEvaluator::GetGbaTokenValue;
+			_getRegisterReader = &ExpressionEvaluator::GetGbaRegisterReader;
+			break;
+
+		case CpuType::Ws:
+			_getTokenValue = &ExpressionEvaluator::GetWsTokenValue;
+			_getRegisterReader = &ExpressionEvaluator::GetWsRegisterReader;
+			break;
+	}
 }
 
 bool ExpressionEvaluator::ReturnBool(int64_t value, EvalResultType& resultType)
@@ -572,6 +783,7 @@ ExpressionData* ExpressionEvaluator::PrivateGetRpnList(string expression, bool&
 		ExpressionData data;
 		success = ToRpn(fixedExp, data);
 		if(success) {
+			Compile(data);
 			LockHandler lock = _cacheLock.AcquireSafe();
 			_cache[expression] = data;
 			cachedData = &_cache[expression];
@@ -631,6 +843,20 @@ bool ExpressionEvaluator::Validate(string expression)
 void ExpressionEvaluator::RunTests()
 {
 	//Some basic unit tests to run in debug mode
+	auto testCompiled = [=](ExpressionData& data, EvalResultType expectedType) {
+		//The compiled program must always produce the same result as the RPN interpreter
+		MemoryOperationInfo opInfo = {};
+		AddressInfo addrInfo = {};
+		EvalResultType compiledType;
+		EvalResultType rpnType;
+		int64_t compiledResult = Evaluate(data, compiledType, opInfo, addrInfo);
+		int64_t rpnResult = EvaluateRpn(data, rpnType, opInfo, addrInfo);
+
+		assert(compiledType == rpnType);
+		assert(compiledResult == rpnResult);
+		assert(compiledType == expectedType);
+	};
+
 	auto test = [=](string expr, EvalResultType expectedType, int64_t expectedResult) {
 		MemoryOperationInfo opInfo = {};
 		AddressInfo addrInfo = {};
@@ -639,6 +865,12 @@ void ExpressionEvaluator::RunTests()
 
 		assert(type == expectedType);
 		assert(result == expectedResult);
+
+		bool success;
+		ExpressionData data = GetRpnList(expr, success);
+		if(success) {
+			testCompiled(data, expectedType);
+		}
 	};
 	
 	test("1 - -1", EvalResultType::Numeric, 2);
@@ -705,5 +937,35 @@ void ExpressionEvaluator::RunTests()
 	test("#$4500", EvalResultType::Numeric, dword4500);
 	test("#$4500+1", EvalResultType::Numeric, dword4500 + 1);
 	test("#($4500+1)", EvalResultType::Numeric, dword4501);
+
+	//Compiled programs
+	bool success;
+	ExpressionData data = GetRpnList("1+3*3+10/(3+4)", success);
+	assert(data.Program.size() == 1 && data.Program[0].Code == ExpressionOpCode::TypedConstant); //Folded into a single constant
+	testCompiled(data, EvalResultType::Numeric);
+
+	data = GetRpnList("[$4500] == $20", success);
+	assert(data.Program.size() == 2 && data.Program[0].ImmediateOperand && data.Program[1].ImmediateOperand); //Both operators use their constant operand directly
+	testCompiled(data, EvalResultType::Boolean);
+
+	data = GetRpnList("x + 5", success);
+	assert(data.Program.size() == 2 && data.Program[0].Code == ExpressionOpCode::CpuRegister && data.Program[1].ImmediateOperand);
+	testCompiled(data, EvalResultType::Numeric);
+
+	data = GetRpnList("x / 0", success);
+	assert(!data.Program.empty());
+	testCompiled(data, EvalResultType::DivideBy0);
+
+	data = GetRpnList("10 / 0", success);
+	assert(!data.Program.empty()); //Can't be folded, the error must be reported when evaluated
+	testCompiled(data, EvalResultType::DivideBy0);
+
+	//Label that doesn't exist (e.g deleted after the expression was parsed)
+	data = {};
+	data.Labels.push_back("__InvalidTestLabel");
+	data.RpnQueue = { (int64_t)EvalValues::FirstLabelIndex, 1, (int64_t)EvalOperators::Addition };
+	Compile(data);
+	assert(data.Program.size() == 2 && data.Program[0].Code == ExpressionOpCode::Label);
+	testCompiled(data, EvalResultType::Invalid);
 }
 #endif
\ No newline at end of file
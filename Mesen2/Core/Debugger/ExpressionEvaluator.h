@@ -10,6 +10,7 @@
 class Debugger;
 class LabelManager;
 class IDebugger;
+struct BaseState;
 
 enum EvalOperators : int64_t
 {
@@ -224,10 +225,53 @@ public:
 	}
 };
 
+enum class ExpressionOpCode : uint8_t
+{
+	Constant,
+	TypedConstant, //Result of an operation that was evaluated at compile time, sets the result type like the operation does
+	OpValue,
+	OpAddress,
+	MemAddress,
+	IsWrite,
+	IsRead,
+	IsDma,
+	IsDummy,
+	OpProgramCounter,
+	CpuToken,
+	CpuRegister,
+	Label,
+	UnaryOperator,
+	BinaryOperator
+};
+
+struct ExpressionInstruction
+{
+	ExpressionOpCode Code;
+
+	//Operators only - when set, the (constant) right operand is Value instead of the top of the stack
+	bool ImmediateOperand;
+
+	EvalResultType ResultType;
+	EvalOperators Operator;
+	int64_t Value;
+
+	//CpuRegister only - reads the register from the CPU's state
+	int64_t (*ReadRegister)(BaseState& state);
+};
+
+template<typename T> struct ExpressionStateMember;
+template<typename StateType, typename ValueType> struct ExpressionStateMember<ValueType StateType::*>
+{
+	using State = StateType;
+};
+
 struct ExpressionData
 {
 	vector<int64_t> RpnQueue;
 	vector<string> Labels;
+
+	//RpnQueue compiled when the expression is parsed - empty if it could not be compiled, in which case RpnQueue is interpreted instead
+	vector<ExpressionInstruction> Program;
 };
 
 class ExpressionEvaluator
@@ -239,6 +283,8 @@ private:
 	static const vector<int> _unaryPrecedence;
 	static const unordered_set<string> _operators;
 
+	static constexpr int MaxStackSize = 100;
+
 	unordered_map<string, ExpressionData, StringHasher> _cache;
 	SimpleLock _cacheLock;
 	
@@ -247,6 +293,21 @@ private:
 	LabelManager* _labelManager;
 	CpuType _cpuType;
 	MemoryType _cpuMemory;
+	int64_t (ExpressionEvaluator::*_getTokenValue)(int64_t token, EvalResultType& resultType) = nullptr;
+
+	typedef int64_t (*RegisterReader)(BaseState& state);
+	RegisterReader (ExpressionEvaluator::*_getRegisterReader)(int64_t token) = nullptr;
+
+	//Reads a member of the CPU state returned by IDebugger::GetState (e.g ReadState<&NesCpuState::A>)
+	template<auto member> static int64_t ReadState(BaseState& state)
+	{
+		return ((typename ExpressionStateMember<decltype(member)>::State&)state).*member;
+	}
+
+	template<auto member, int index> static int64_t ReadStateArray(BaseState& state)
+	{
+		return (((typename ExpressionStateMember<decltype(member)>::State&)state).*member)[index];
+	}
 
 	bool IsOperator(string token, int &precedence, bool unaryOperator);
 	EvalOperators GetOperator(string token, bool unaryOperator);
@@ -255,47 +316,64 @@ private:
 
 	unordered_map<string, int64_t>& GetSnesTokens();
 	int64_t GetSnesTokenValue(int64_t token, EvalResultType& resultType);
+	RegisterReader GetSnesRegisterReader(int64_t token);
 
 	unordered_map<string, int64_t>& GetSpcTokens();
 	int64_t GetSpcTokenValue(int64_t token, EvalResultType& resultType);
+	RegisterReader GetSpcRegisterReader(int64_t token);
 
 	unordered_map<string, int64_t>& GetGsuTokens();
 	int64_t GetGsuTokenValue(int64_t token, EvalResultType& resultType);
+	RegisterReader GetGsuRegisterReader(int64_t token);
 
 	unordered_map<string, int64_t>& GetCx4Tokens();
 	int64_t GetCx4TokenValue(int64_t token, EvalResultType& resultType);
+	RegisterReader GetCx4RegisterReader(int64_t token);
 	
 	unordered_map<string, int64_t>& GetNecDspTokens();
 	int64_t GetNecDspTokenValue(int64_t token, EvalResultType& resultType);
+	RegisterReader GetNecDspRegisterReader(int64_t token);
 
 	unordered_map<string, int64_t>& GetSt018Tokens();
 	int64_t GetSt018TokenValue(int64_t token, EvalResultType& resultType);
+	RegisterReader GetSt018RegisterReader(int64_t token);
 
 	unordered_map<string, int64_t>& GetGameboyTokens();
 	int64_t GetGameboyTokenValue(int64_t token, EvalResultType& resultType);
+	RegisterReader GetGameboyRegisterReader(int64_t token);
 
 	unordered_map<string, int64_t>& GetNesTokens();
 	int64_t GetNesTokenValue(int64_t token, EvalResultType& resultType);
+	RegisterReader GetNesRegisterReader(int64_t token);
 
 	unordered_map<string, int64_t>& GetPceTokens();
 	int64_t GetPceTokenValue(int64_t token, EvalResultType& resultType);
+	RegisterReader GetPceRegisterReader(int64_t token);
 
 	unordered_map<string, int64_t>& GetSmsTokens();
 	int64_t GetSmsTokenValue(int64_t token, EvalResultType& resultType);
+	RegisterReader GetSmsRegisterReader(int64_t token);
 
 	unordered_map<string, int64_t>& GetGbaTokens();
 	int64_t GetGbaTokenValue(int64_t token, EvalResultType& resultType);
+	RegisterReader GetGbaRegisterReader(int64_t token);
 
 	unordered_map<string, int64_t>& GetWsTokens();
 	int64_t GetWsTokenValue(int64_t token, EvalResultType& resultType);
+	RegisterReader GetWsRegisterReader(int64_t token);
 
 	bool ReturnBool(int64_t value, EvalResultType& resultType);
+	bool GetLabelValue(ExpressionData& data, int64_t token, int64_t& value, EvalResultType& resultType);
+	__forceinline bool ApplyOperator(EvalOperators op, int64_t left, int64_t right, int64_t& result, EvalResultType& resultType);
 
 	int64_t ProcessSharedTokens(string token);
 	
 	string GetNextToken(string expression, size_t &pos, ExpressionData &data, bool &success, bool previousTokenIsOp);
 	bool ProcessSpecialOperator(EvalOperators evalOp, std::stack<EvalOperators> &opStack, std::stack<int> &precedenceStack, vector<int64_t> &outputQueue);
 	bool ToRpn(string expression, ExpressionData &data);
+	void Compile(ExpressionData& data);
+	int64_t EvaluateProgram(ExpressionData& data, EvalResultType& resultType, MemoryOperationInfo& operationInfo, AddressInfo& addressInfo);
+	int64_t EvaluateRpn(ExpressionData& data, EvalResultType& resultType, MemoryOperationInfo& operationInfo, AddressInfo& addressInfo);
 	int64_t PrivateEvaluate(string expression, EvalResultType &resultType, MemoryOperationInfo &operationInfo, AddressInfo& addressInfo, bool &success);
 	ExpressionData* PrivateGetRpnList(string expression, bool& success);
 
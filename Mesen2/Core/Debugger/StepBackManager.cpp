@@ -72,7 +72,7 @@ bool StepBackManager::CheckStepBack()
 		//Create a save state every instruction for the last X clocks
 		_cache.push_back(StepBackCacheEntry());
 		_cache.back().Clock = clock;
-		_emu->Serialize(_cache.back().SaveState, true, 0);
+		_emu->Serialize(_cache.back().SaveState, true, CompressionCodec::Uncompressed);
 	}
 
 	if(clock >= _targetClock) {
@@ -8,12 +8,12 @@
 #include "NES/NesConsole.h"
 #include "NES/NesDefaultVideoFilter.h"
 #include "Shared/EmuSettings.h"
+#include "Shared/Video/VideoDecoder.h"
+#include "Shared/Video/FrameFilterScheduler.h"
 
 BisqwitNtscFilter::BisqwitNtscFilter(Emulator* emu) : BaseVideoFilter(emu)
 {
 	_resDivider = 1;
-	_stopThread = false;
-	_workDone = false;
 
 	// from https ://forums.nesdev.org/viewtopic.php?p=159266#p159266
 	const double signalLumaLow[2][4] = {
@@ -50,34 +50,10 @@ BisqwitNtscFilter::BisqwitNtscFilter(Emulator* emu) : BaseVideoFilter(emu)
 			_signalHigh[(h ? 0x40 : 0) | i] = int8_t(std::floor(((q - signal_blank) / (signal_white - signal_blank)) * 100));
 		}
 	}
-
-	_extraThread = std::thread([=]() {
-		//Worker thread to improve decode speed
-		while(!_stopThread) {
-			_waitWork.Wait();
-			if(_stopThread) {
-				break;
-			}
-
-			uint32_t* outputBuffer = GetOutputBuffer();
-			FrameInfo frameInfo = _frameInfo;
-
-			//Adjust outputbuffer to start at the middle of the picture
-			int scale = 8 / _resDivider;
-			outputBuffer += frameInfo.Width * ((120 - GetOverscan().Top) * scale);
-
-			DecodeFrame(120, 239 - GetOverscan().Bottom, _ppuOutputBuffer, outputBuffer, (GetVideoPhase() * 4) + 327360);
-
-			_workDone = true;
-		}
-	});
 }
 
 BisqwitNtscFilter::~BisqwitNtscFilter()
 {
-	_stopThread = true;
-	_waitWork.Signal();
-	_extraThread.join();
 }
 
 void BisqwitNtscFilter::ApplyFilter(uint16_t *ppuOutputBuffer)
@@ -88,10 +64,24 @@ void BisqwitNtscFilter::ApplyFilter(uint16_t *ppuOutputBuffer)
 		NesDefaultVideoFilter::ApplyPalBorder(ppuOutputBuffer);
 	}
 
-	_workDone = false;
-	_waitWork.Signal();
-	DecodeFrame(GetOverscan().Top, 120, ppuOutputBuffer, GetOutputBuffer(), (GetVideoPhase() * 4) + GetOverscan().Top*341*8);
-	while(!_workDone) {}
+	//Rows are decoded independently, split the picture into bands that are decoded in parallel
+	int firstRow = GetOverscan().Top;
+	int lastRow = 239 - GetOverscan().Bottom;
+	int scale = 8 / _resDivider;
+	uint32_t* outputBuffer = GetOutputBuffer();
+	uint32_t width = _frameInfo.Width;
+	int startPhase = GetVideoPhase() * 4;
+
+	FrameFilterScheduler* scheduler = _emu->GetVideoDecoder()->GetFilterScheduler();
+	scheduler->ProcessBands(lastRow - firstRow + 1, 8, [=](uint32_t start, uint32_t end) {
+		int startRow = firstRow + (int)start;
+		DecodeRows(startRow, firstRow + (int)end - 1, ppuOutputBuffer, outputBuffer + width * (start * scale), startPhase + startRow * 341 * 8);
+	});
+
+	//The blend for a band's last row reads the first row of the next band, so it can only start once every row is decoded
+	scheduler->ProcessBands(lastRow - firstRow + 1, 8, [=](uint32_t start, uint32_t end) {
+		BlendRows(firstRow + (int)start, firstRow + (int)end - 1, outputBuffer + width * (start * scale));
+	});
 }
 
 FrameInfo BisqwitNtscFilter::GetFrameInfo()
@@ -213,15 +203,13 @@ void BisqwitNtscFilter::GenerateNtscSignal(int8_t *ntscSignal, int &phase, int r
 	phase += (341 - 256) * _signalsPerPixel;
 }
 
-void BisqwitNtscFilter::DecodeFrame(int startRow, int endRow, uint16_t *ppuOutputBuffer, uint32_t* outputBuffer, int startPhase)
+void BisqwitNtscFilter::DecodeRows(int startRow, int endRow, uint16_t *ppuOutputBuffer, uint32_t* outputBuffer, int startPhase)
 {
 	int pixelsPerCycle = 8 / _resDivider;
 	int phase = startPhase;
 	constexpr int lineWidth = 256;
 	int8_t rowSignal[lineWidth * _signalsPerPixel];
 	uint32_t rowPixelGap = _frameInfo.Width * pixelsPerCycle;
-	
-	uint32_t* orgBuffer = outputBuffer;
 
 	for(int y = startRow; y <= endRow; y++) {
 		int startCycle = phase % 12;
@@ -234,9 +222,13 @@ void BisqwitNtscFilter::DecodeFrame(int startRow, int endRow, uint16_t *ppuOutpu
 
 		outputBuffer += rowPixelGap;
 	}
+}
 
+void BisqwitNtscFilter::BlendRows(int startRow, int endRow, uint32_t* outputBuffer)
+{
 	//Generate the missing vertical lines
-	outputBuffer = orgBuffer;
+	int pixelsPerCycle = 8 / _resDivider;
+	uint32_t rowPixelGap = _frameInfo.Width * pixelsPerCycle;
 	int lastRow = 239 - GetOverscan().Bottom;
 	bool verticalBlend = false; //_emu->GetSettings()->GetVideoConfig();
 	for(int y = startRow; y <= endRow; y++) {
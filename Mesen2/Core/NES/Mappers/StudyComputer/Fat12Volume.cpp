@@ -0,0 +1,793 @@
+﻿#include "pch.h"
+#include "NES/Mappers/StudyComputer/Fat12Volume.h"
+
+namespace
+{
+static string TrimTrailingSpaces(const string& value)
+{
+	size_t endPos = value.find_last_not_of(' ');
+	if(endPos == string::npos) {
+		return "";
+	}
+	return value.substr(0, endPos + 1);
+}
+
+static std::u16string ExtractLongNameSegment(const uint8_t* entry)
+{
+	std::u16string segment;
+	auto appendRange = [&](int offset, int count) {
+		for(int i = 0; i < count; i++) {
+			char16_t ch = (char16_t)(entry[offset + i * 2] | (entry[offset + i * 2 + 1] << 8));
+			if(ch == 0x0000 || ch == (char16_t)0xFFFF) {
+				return false;
+			}
+			segment.push_back(ch);
+		}
+		return true;
+	};
+
+	bool cont = appendRange(1, 5);
+	if(cont) cont = appendRange(14, 6);
+	if(cont) appendRange(28, 2);
+	return segment;
+}
+
+static string BuildLongName(const vector<std::u16string>& segments)
+{
+	if(segments.empty()) {
+		return "";
+	}
+	std::u16string combined;
+	for(const auto& part : segments) {
+		combined += part;
+	}
+	return utf8::utf8::encode(combined);
+}
+
+static std::u16string Utf8ToUtf16(const string& text)
+{
+	std::u16string result;
+	for(size_t i = 0; i < text.size();) {
+		uint8_t ch = (uint8_t)text[i];
+		uint32_t codePoint;
+		size_t length;
+		if(ch < 0x80) {
+			codePoint = ch;
+			length = 1;
+		} else if((ch & 0xE0) == 0xC0) {
+			codePoint = ch & 0x1F;
+			length = 2;
+		} else if((ch & 0xF0) == 0xE0) {
+			codePoint = ch & 0x0F;
+			length = 3;
+		} else if((ch & 0xF8) == 0xF0) {
+			codePoint = ch & 0x07;
+			length = 4;
+		} else {
+			//无效的起始字节
+			codePoint = '_';
+			length = 1;
+		}
+		if(i + length > text.size()) {
+			codePoint = '_';
+			length = text.size() - i;
+		} else {
+			for(size_t j = 1; j < length; j++) {
+				codePoint = (codePoint << 6) | ((uint8_t)text[i + j] & 0x3F);
+			}
+		}
+		i += length;
+
+		if(codePoint >= 0x10000) {
+			codePoint -= 0x10000;
+			result.push_back((char16_t)(0xD800 + (codePoint >> 10)));
+			result.push_back((char16_t)(0xDC00 + (codePoint & 0x3FF)));
+		} else {
+			result.push_back((char16_t)codePoint);
+		}
+	}
+	return result;
+}
+
+static bool EqualsIgnoreCase(const string& a, const string& b)
+{
+	if(a.size() != b.size()) {
+		return false;
+	}
+	for(size_t i = 0; i < a.size(); i++) {
+		if(toupper((uint8_t)a[i]) != toupper((uint8_t)b[i])) {
+			return false;
+		}
+	}
+	return true;
+}
+
+//8.3 短文件名中允许出现的字符（大写字母与数字之外）
+static bool IsValidShortNameChar(char ch)
+{
+	if((ch >= 'A' && ch <= 'Z') || (ch >= '0' && ch <= '9')) {
+		return true;
+	}
+	return strchr("$%'-_@~`!(){}^#&", ch) != nullptr && ch != 0;
+}
+
+static void JsonEscape(const string& text, string& builder)
+{
+	for(char ch : text) {
+		switch(ch) {
+			case '\\': builder += "\\\\"; break;
+			case '\"': builder += "\\\""; break;
+			case '\b': builder += "\\b"; break;
+			case '\f': builder += "\\f"; break;
+			case '\n': builder += "\\n"; break;
+			case '\r': builder += "\\r"; break;
+			case '\t': builder += "\\t"; break;
+			default:
+				if(static_cast<unsigned char>(ch) < 0x20) {
+					char buffer[7];
+					snprintf(buffer, sizeof(buffer), "\\u%04X", (unsigned)(unsigned char)ch);
+					builder += buffer;
+				} else {
+					builder += ch;
+				}
+				break;
+		}
+	}
+}
+}
+
+string Fat12Volume::BuildShortName(const uint8_t* entry)
+{
+	string baseName(reinterpret_cast<const char*>(entry), 8);
+	if(!baseName.empty() && (uint8_t)baseName[0] == 0x05) {
+		baseName[0] = (char)0xE5;
+	}
+	baseName = TrimTrailingSpaces(baseName);
+	string extension(reinterpret_cast<const char*>(entry + 8), 3);
+	extension = TrimTrailingSpaces(extension);
+	if(extension.empty()) {
+		return baseName;
+	}
+	if(baseName.empty()) {
+		return extension;
+	}
+	return baseName + "." + extension;
+}
+
+void Fat12Volume::Invalidate()
+{
+	if(_valid) {
+		_valid = false;
+		_version++;
+	}
+}
+
+bool Fat12Volume::LoadLayout(const vector<uint8_t>& image)
+{
+	if(image.size() < 512) {
+		return false;
+	}
+	const uint8_t* sector = image.data();
+	uint32_t diskSize = (uint32_t)image.size();
+
+	uint16_t bytesPerSector = (uint16_t)(sector[11] | (sector[12] << 8));
+	uint8_t sectorsPerCluster = sector[13];
+	uint16_t reservedSectors = (uint16_t)(sector[14] | (sector[15] << 8));
+	uint8_t fatCount = sector[16];
+	uint16_t rootEntryCount = (uint16_t)(sector[17] | (sector[18] << 8));
+	uint16_t totalSectors16 = (uint16_t)(sector[19] | (sector[20] << 8));
+	uint16_t sectorsPerFat = (uint16_t)(sector[22] | (sector[23] << 8));
+	uint32_t totalSectors32 = (uint32_t)(sector[32] | (sector[33] << 8) | (sector[34] << 16) | (sector[35] << 24));
+
+	uint32_t totalSectors = totalSectors16 != 0 ? totalSectors16 : totalSectors32;
+	if(totalSectors == 0 && bytesPerSector != 0) {
+		totalSectors = diskSize / bytesPerSector;
+	}
+
+	if(bytesPerSector == 0 || sectorsPerCluster == 0 || fatCount == 0 || sectorsPerFat == 0) {
+		return false;
+	}
+
+	Fat12Layout& ctx = _layout;
+	ctx.bytesPerSector = bytesPerSector;
+	ctx.sectorsPerCluster = sectorsPerCluster;
+	ctx.reservedSectors = reservedSectors;
+	ctx.fatCount = fatCount;
+	ctx.rootEntryCount = rootEntryCount;
+	ctx.sectorsPerFat = sectorsPerFat;
+	ctx.rootDirSectors = (uint32_t)((rootEntryCount * 32 + bytesPerSector - 1) / bytesPerSector);
+	ctx.fatOffset = ctx.reservedSectors * ctx.bytesPerSector;
+	ctx.rootDirOffset = (ctx.reservedSectors + ctx.fatCount * ctx.sectorsPerFat) * ctx.bytesPerSector;
+	ctx.dataOffset = (ctx.reservedSectors + ctx.fatCount * ctx.sectorsPerFat + ctx.rootDirSectors) * ctx.bytesPerSector;
+	ctx.bytesPerCluster = ctx.bytesPerSector * ctx.sectorsPerCluster;
+	ctx.totalSectors = totalSectors;
+	uint32_t dataSectors = (totalSectors > (ctx.reservedSectors + ctx.fatCount * ctx.sectorsPerFat + ctx.rootDirSectors)) ?
+		(totalSectors - (ctx.reservedSectors + ctx.fatCount * ctx.sectorsPerFat + ctx.rootDirSectors)) : 0;
+	ctx.totalClusters = (ctx.sectorsPerCluster > 0) ? dataSectors / ctx.sectorsPerCluster : 0;
+
+	// 12 位簇号最多只能表示到 0xFEF
+	ctx.totalClusters = std::min<uint32_t>(ctx.totalClusters, 0xFF0 - 2);
+
+	uint32_t fatSize = ctx.sectorsPerFat * ctx.bytesPerSector;
+	if(ctx.fatOffset > image.size() || fatSize > image.size() - ctx.fatOffset) {
+		return false;
+	}
+	if(ctx.rootDirOffset > image.size() || (size_t)ctx.rootEntryCount * 32 > image.size() - ctx.rootDirOffset) {
+		return false;
+	}
+	_fatData.assign(image.begin() + ctx.fatOffset, image.begin() + ctx.fatOffset + fatSize);
+
+	return ctx.bytesPerSector > 0 && ctx.bytesPerCluster > 0;
+}
+
+bool Fat12Volume::Load(const vector<uint8_t>& image)
+{
+	_valid = false;
+	_version++;
+	_layout = {};
+	_fatData.clear();
+	_freeBitmap.clear();
+	_freeClusterCount = 0;
+	_metadataSectors.clear();
+	_entries.clear();
+	_rootEntries.clear();
+	_fileIndex.clear();
+	_imageSize = (uint32_t)image.size();
+
+	if(!LoadLayout(image)) {
+		return false;
+	}
+
+	// 引导扇区、保留扇区、所有 FAT 副本与根目录区都属于元数据
+	_metadataSectors.assign((image.size() + _layout.bytesPerSector - 1) / _layout.bytesPerSector, 0);
+	MarkMetadata(0, _layout.dataOffset);
+
+	_freeBitmap.assign((_layout.totalClusters + 2 + 63) / 64, 0);
+	for(uint32_t c = 2; c < _layout.totalClusters + 2; c++) {
+		if(GetFatValue((uint16_t)c) == 0) {
+			SetClusterFree((uint16_t)c, true);
+		}
+	}
+
+	vector<uint32_t> rootOffsets;
+	rootOffsets.reserve(_layout.rootEntryCount);
+	for(uint32_t i = 0; i < _layout.rootEntryCount; i++) {
+		rootOffsets.push_back(_layout.rootDirOffset + i * 32);
+	}
+
+	unordered_set<uint16_t> visitedClusters;
+	ParseDirectory(image, RootIndex, rootOffsets, visitedClusters);
+	RebuildFileIndex();
+
+	_valid = true;
+	return true;
+}
+
+void Fat12Volume::ParseDirectory(const vector<uint8_t>& image, int32_t parent, const vector<uint32_t>& entryOffsets, unordered_set<uint16_t>& visitedClusters)
+{
+	vector<std::u16string> longNameParts;
+	vector<uint32_t> lfnOffsets;
+	for(uint32_t entryOffset : entryOffsets) {
+		const uint8_t* entry = image.data() + entryOffset;
+		uint8_t firstByte = entry[0];
+		if(firstByte == 0x00) {
+			break;
+		}
+		uint8_t attr = entry[11];
+		if(attr == 0x0F) {
+			uint8_t sequence = entry[0] & 0x1F;
+			if((entry[0] & 0x40) != 0) {
+				longNameParts.clear();
+				longNameParts.resize(sequence);
+				lfnOffsets.clear();
+			}
+			if(sequence >= 1 && sequence <= longNameParts.size()) {
+				longNameParts[sequence - 1] = ExtractLongNameSegment(entry);
+				lfnOffsets.push_back(entryOffset);
+			}
+			continue;
+		}
+		if(firstByte == 0xE5 || (attr & 0x08)) {
+			// 已删除的项或卷标
+			longNameParts.clear();
+			lfnOffsets.clear();
+			continue;
+		}
+
+		Entry node;
+		node.ShortName = BuildShortName(entry);
+		if(!longNameParts.empty()) {
+			node.Name = BuildLongName(longNameParts);
+			node.LfnOffsets = std::move(lfnOffsets);
+		}
+		if(node.Name.empty()) {
+			node.Name = node.ShortName;
+			node.LfnOffsets.clear();
+		}
+		longNameParts.clear();
+		lfnOffsets.clear();
+		if(node.Name.empty()) {
+			continue;
+		}
+
+		node.IsDirectory = (attr & 0x10) != 0;
+		if(node.IsDirectory && (node.Name == "." || node.Name == "..")) {
+			continue;
+		}
+
+		node.FirstCluster = (uint16_t)(entry[26] | (entry[27] << 8));
+		node.Size = (uint32_t)(entry[28] | (entry[29] << 8) | (entry[30] << 16) | (entry[31] << 24));
+		node.WriteTime = (uint16_t)(entry[22] | (entry[23] << 8));
+		node.WriteDate = (uint16_t)(entry[24] | (entry[25] << 8));
+		node.EntryOffset = entryOffset;
+		node.Parent = parent;
+
+		int32_t index = (int32_t)_entries.size();
+		_entries.push_back(std::move(node));
+		if(parent == RootIndex) {
+			_rootEntries.push_back(index);
+		} else {
+			_entries[parent].Children.push_back(index);
+		}
+
+		uint16_t firstCluster = _entries[index].FirstCluster;
+		if(_entries[index].IsDirectory && firstCluster >= 2 && visitedClusters.insert(firstCluster).second) {
+			vector<uint32_t> clusterOffsets;
+			if(GetClusterChainOffsets(firstCluster, clusterOffsets)) {
+				vector<uint32_t> childOffsets;
+				uint32_t entriesPerCluster = _layout.bytesPerCluster / 32;
+				for(uint32_t clusterOffset : clusterOffsets) {
+					MarkMetadata(clusterOffset, _layout.bytesPerCluster);
+					for(uint32_t i = 0; i < entriesPerCluster; i++) {
+						childOffsets.push_back(clusterOffset + i * 32);
+					}
+				}
+				ParseDirectory(image, index, childOffsets, visitedClusters);
+			}
+		}
+	}
+}
+
+bool Fat12Volume::GetClusterChainOffsets(uint16_t firstCluster, vector<uint32_t>& offsets) const
+{
+	offsets.clear();
+	uint32_t maxIterations = _layout.totalClusters + 2;
+	uint32_t iteration = 0;
+	uint16_t cluster = firstCluster;
+	while(cluster >= 2 && cluster < 0xFF0) {
+		if(iteration++ > maxIterations) {
+			break;
+		}
+		uint32_t offset = GetClusterOffset(cluster);
+		if(offset == 0) {
+			return false;
+		}
+		offsets.push_back(offset);
+		uint16_t nextCluster = GetFatValue(cluster);
+		if(nextCluster >= 0xFF8 || nextCluster == 0) {
+			break;
+		}
+		cluster = nextCluster;
+	}
+	return true;
+}
+
+void Fat12Volume::MarkMetadata(uint32_t offset, uint32_t length)
+{
+	if(length == 0) {
+		return;
+	}
+	uint32_t first = offset / _layout.bytesPerSector;
+	uint32_t last = (offset + length - 1) / _layout.bytesPerSector;
+	for(uint32_t i = first; i <= last && i < _metadataSectors.size(); i++) {
+		_metadataSectors[i] = 1;
+	}
+}
+
+uint32_t Fat12Volume::GetClusterOffset(uint16_t cluster) const
+{
+	if(cluster < 2 || (uint32_t)(cluster - 2) >= _layout.totalClusters) {
+		return 0;
+	}
+	uint64_t offset = _layout.dataOffset + (uint64_t)(cluster - 2) * _layout.bytesPerCluster;
+	if(offset + _layout.bytesPerCluster > _imageSize) {
+		return 0;
+	}
+	return (uint32_t)offset;
+}
+
+uint16_t Fat12Volume::GetFatValue(uint16_t cluster) const
+{
+	uint32_t index = cluster + cluster / 2;
+	if(index + 1 >= _fatData.size()) {
+		return 0xFFF;
+	}
+	uint16_t value = (uint16_t)(_fatData[index] | (_fatData[index + 1] << 8));
+	if(cluster & 1) {
+		value >>= 4;
+	} else {
+		value &= 0x0FFF;
+	}
+	return value;
+}
+
+bool Fat12Volume::SetFatValue(uint16_t cluster, uint16_t value)
+{
+	uint32_t index = cluster + cluster / 2;
+	if(index + 1 >= _fatData.size()) {
+		return false;
+	}
+	uint16_t orig = (uint16_t)(_fatData[index] | (_fatData[index + 1] << 8));
+	if(cluster & 1) {
+		// odd cluster: store high 12 bits
+		orig &= 0x000F;
+		orig |= (uint16_t)((value & 0x0FFF) << 4);
+	} else {
+		// even cluster: store low 12 bits
+		orig &= 0xF000;
+		orig |= (uint16_t)(value & 0x0FFF);
+	}
+	_fatData[index] = (uint8_t)(orig & 0xFF);
+	_fatData[index + 1] = (uint8_t)((orig >> 8) & 0xFF);
+
+	if(cluster >= 2 && (uint32_t)(cluster - 2) < _layout.totalClusters) {
+		SetClusterFree(cluster, value == 0);
+	}
+	_version++;
+	return true;
+}
+
+void Fat12Volume::SetClusterFree(uint16_t cluster, bool free)
+{
+	uint64_t& word = _freeBitmap[cluster >> 6];
+	uint64_t bit = 1ULL << (cluster & 63);
+	if(free && !(word & bit)) {
+		word |= bit;
+		_freeClusterCount++;
+	} else if(!free && (word & bit)) {
+		word &= ~bit;
+		_freeClusterCount--;
+	}
+}
+
+bool Fat12Volume::FindFreeClusters(uint32_t count, vector<uint16_t>& clusters) const
+{
+	clusters.clear();
+	if(count > _freeClusterCount) {
+		return false;
+	}
+	for(size_t w = 0; w < _freeBitmap.size() && clusters.size() < count; w++) {
+		uint64_t word = _freeBitmap[w];
+		while(word && clusters.size() < count) {
+			uint32_t bit = 0;
+			while(!(word & (1ULL << bit))) {
+				bit++;
+			}
+			word &= ~(1ULL << bit);
+			clusters.push_back((uint16_t)(w * 64 + bit));
+		}
+	}
+	return clusters.size() == count;
+}
+
+void Fat12Volume::FreeClusterChain(uint16_t firstCluster)
+{
+	uint16_t cluster = firstCluster;
+	uint32_t maxIter = _layout.totalClusters + 2;
+	uint32_t iter = 0;
+	while(cluster >= 2 && cluster < 0xFF0 && iter++ < maxIter) {
+		uint16_t next = GetFatValue(cluster);
+		if(!SetFatValue(cluster, 0)) {
+			break;
+		}
+		if(next >= 0xFF8 || next == 0) {
+			break;
+		}
+		cluster = next;
+	}
+}
+
+uint32_t Fat12Volume::ReadFile(const vector<uint8_t>& image, const Entry& entry, uint8_t* outBuffer, uint32_t maxLength) const
+{
+	uint32_t toCopy = std::min(entry.Size, maxLength);
+	uint32_t copied = 0;
+	uint32_t maxIterations = _layout.totalClusters + 2;
+	uint32_t iteration = 0;
+	uint16_t cluster = entry.FirstCluster;
+	while(copied < toCopy && cluster >= 2 && cluster < 0xFF0 && iteration++ <= maxIterations) {
+		uint32_t offset = GetClusterOffset(cluster);
+		if(offset == 0) {
+			break;
+		}
+		uint32_t length = std::min(_layout.bytesPerCluster, toCopy - copied);
+		memcpy(outBuffer + copied, image.data() + offset, length);
+		copied += length;
+
+		uint16_t nextCluster = GetFatValue(cluster);
+		if(nextCluster >= 0xFF8 || nextCluster == 0) {
+			break;
+		}
+		cluster = nextCluster;
+	}
+	return copied;
+}
+
+int32_t Fat12Volume::FindFile(const string& name) const
+{
+	auto result = _fileIndex.find(name);
+	return result != _fileIndex.end() ? result->second : -1;
+}
+
+int32_t Fat12Volume::FindChild(int32_t dirIndex, const string& name) const
+{
+	for(int32_t index : GetChildren(dirIndex)) {
+		const Entry& entry = _entries[index];
+		if(EqualsIgnoreCase(entry.Name, name) || EqualsIgnoreCase(entry.ShortName, name)) {
+			return index;
+		}
+	}
+	return -1;
+}
+
+bool Fat12Volume::GetDirectorySlots(int32_t dirIndex, vector<uint32_t>& offsets) const
+{
+	offsets.clear();
+	if(dirIndex == RootIndex) {
+		for(uint32_t i = 0; i < _layout.rootEntryCount; i++) {
+			offsets.push_back(_layout.rootDirOffset + i * 32);
+		}
+		return true;
+	}
+
+	vector<uint32_t> clusterOffsets;
+	if(_entries[dirIndex].FirstCluster < 2 || !GetClusterChainOffsets(_entries[dirIndex].FirstCluster, clusterOffsets)) {
+		return false;
+	}
+	for(uint32_t clusterOffset : clusterOffsets) {
+		for(uint32_t i = 0; i < _layout.bytesPerCluster / 32; i++) {
+			offsets.push_back(clusterOffset + i * 32);
+		}
+	}
+	return true;
+}
+
+void Fat12Volume::AddDirectoryCluster(uint16_t cluster)
+{
+	uint32_t offset = GetClusterOffset(cluster);
+	if(offset != 0) {
+		MarkMetadata(offset, _layout.bytesPerCluster);
+	}
+}
+
+bool Fat12Volume::GenerateShortName(int32_t dirIndex, const string& longName, uint8_t shortName[11], bool& needLongName) const
+{
+	// 去掉所有空格与开头的 '.'，其余字符转为大写，非法字符替换为 '_'（有损）
+	bool lossy = false;
+	string name;
+	for(char ch : longName) {
+		if(ch == ' ' || (ch == '.' && name.empty())) {
+			lossy = true;
+			continue;
+		}
+		char upper = (char)toupper((uint8_t)ch);
+		if(upper != '.' && !IsValidShortNameChar(upper)) {
+			// 非 ASCII 字符按 UTF-8 的每个起始字节替换为一个 '_'
+			if(((uint8_t)ch & 0xC0) == 0x80) {
+				lossy = true;
+				continue;
+			}
+			upper = '_';
+			lossy = true;
+		}
+		name.push_back(upper);
+	}
+	if(name.empty() || name == ".") {
+		return false;
+	}
+
+	size_t dot = name.find_last_of('.');
+	string base = dot == string::npos ? name : name.substr(0, dot);
+	string ext = dot == string::npos ? "" : name.substr(dot + 1);
+	string cleanBase;
+	for(char ch : base) {
+		if(ch == '.') {
+			lossy = true;
+		} else {
+			cleanBase.push_back(ch);
+		}
+	}
+	if(cleanBase.empty()) {
+		cleanBase = "_";
+		lossy = true;
+	}
+	if(cleanBase.size() > 8) {
+		cleanBase.resize(8);
+		lossy = true;
+	}
+	if(ext.size() > 3) {
+		ext.resize(3);
+		lossy = true;
+	}
+
+	memset(shortName, ' ', 11);
+	memcpy(shortName, cleanBase.data(), cleanBase.size());
+	memcpy(shortName + 8, ext.data(), ext.size());
+
+	unordered_set<string> siblings;
+	for(int32_t index : GetChildren(dirIndex)) {
+		siblings.insert(_entries[index].ShortName);
+	}
+
+	// 短名与原名完全一致（含大小写）时不需要 LFN
+	needLongName = lossy || BuildShortName(shortName) != longName;
+	if(!lossy && siblings.find(BuildShortName(shortName)) == siblings.end()) {
+		return true;
+	}
+
+	// 有损转换或短名冲突时加数字后缀 ~N
+	for(uint32_t n = 1; n <= 999999; n++) {
+		string tail = "~" + std::to_string(n);
+		size_t baseLength = std::min(cleanBase.size(), 8 - tail.size());
+		memset(shortName, ' ', 8);
+		memcpy(shortName, cleanBase.data(), baseLength);
+		memcpy(shortName + baseLength, tail.data(), tail.size());
+		if(siblings.find(BuildShortName(shortName)) == siblings.end()) {
+			needLongName = true;
+			return true;
+		}
+	}
+	return false;
+}
+
+bool Fat12Volume::BuildLongNameEntries(const string& longName, const uint8_t shortName[11], vector<uint8_t>& entries)
+{
+	std::u16string name = Utf8ToUtf16(longName);
+	entries.clear();
+	if(name.empty() || name.size() > 255) {
+		return false;
+	}
+
+	uint8_t checksum = 0;
+	for(int i = 0; i < 11; i++) {
+		checksum = (uint8_t)(((checksum & 1) << 7) + (checksum >> 1) + shortName[i]);
+	}
+
+	// 每个 LFN 项保存 13 个 UTF-16 字符，最后一项在目录中位于最前面
+	static constexpr int charOffsets[13] = { 1, 3, 5, 7, 9, 14, 16, 18, 20, 22, 24, 28, 30 };
+	uint32_t count = (uint32_t)((name.size() + 12) / 13);
+	entries.assign(count * 32, 0);
+	for(uint32_t seq = 1; seq <= count; seq++) {
+		uint8_t* entry = entries.data() + (count - seq) * 32;
+		entry[0] = (uint8_t)(seq | (seq == count ? 0x40 : 0));
+		entry[11] = 0x0F;
+		entry[13] = checksum;
+		for(int i = 0; i < 13; i++) {
+			size_t pos = (seq - 1) * 13 + i;
+			// 名称结束后先写一个 0x0000，其余填充 0xFFFF
+			uint16_t ch = pos < name.size() ? (uint16_t)name[pos] : (pos == name.size() ? 0x0000 : 0xFFFF);
+			entry[charOffsets[i]] = (uint8_t)(ch & 0xFF);
+			entry[charOffsets[i] + 1] = (uint8_t)(ch >> 8);
+		}
+	}
+	return true;
+}
+
+void Fat12Volume::RebuildFileIndex()
+{
+	_fileIndex.clear();
+
+	// 先序遍历：与按目录顺序逐层查找的结果一致，同名时保留先出现的文件
+	vector<int32_t> stack(_rootEntries.rbegin(), _rootEntries.rend());
+	while(!stack.empty()) {
+		int32_t index = stack.back();
+		stack.pop_back();
+		const Entry& entry = _entries[index];
+		if(entry.IsDirectory) {
+			stack.insert(stack.end(), entry.Children.rbegin(), entry.Children.rend());
+		} else {
+			_fileIndex.emplace(entry.Name, index);
+			_fileIndex.emplace(entry.ShortName, index);
+		}
+	}
+}
+
+int32_t Fat12Volume::AddEntry(int32_t parent, Entry entry)
+{
+	entry.Parent = parent;
+	int32_t index = (int32_t)_entries.size();
+	uint32_t entryOffset = entry.EntryOffset;
+	_entries.push_back(std::move(entry));
+
+	// 目录内按目录项在镜像中的位置排序，与重新解析得到的顺序一致
+	vector<int32_t>& children = parent == RootIndex ? _rootEntries : _entries[parent].Children;
+	auto pos = std::find_if(children.begin(), children.end(), [&](int32_t i) { return _entries[i].EntryOffset > entryOffset; });
+	children.insert(pos, index);
+
+	RebuildFileIndex();
+	_version++;
+	return index;
+}
+
+void Fat12Volume::UpdateEntry(int32_t index, uint32_t size, uint16_t firstCluster, uint16_t writeTime, uint16_t writeDate)
+{
+	Entry& entry = _entries[index];
+	entry.Size = size;
+	entry.FirstCluster = firstCluster;
+	entry.WriteTime = writeTime;
+	entry.WriteDate = writeDate;
+	_version++;
+}
+
+void Fat12Volume::RemoveEntry(int32_t index)
+{
+	Entry& entry = _entries[index];
+	if(entry.Deleted) {
+		return;
+	}
+	entry.Deleted = true;
+	vector<int32_t>& children = entry.Parent == RootIndex ? _rootEntries : _entries[entry.Parent].Children;
+	children.erase(std::remove(children.begin(), children.end(), index), children.end());
+
+	RebuildFileIndex();
+	_version++;
+}
+
+void Fat12Volume::AppendJson(int32_t index, string& builder) const
+{
+	const Entry& node = _entries[index];
+	builder += "{\"name\":\"";
+	JsonEscape(node.Name, builder);
+	builder += node.IsDirectory ? "\",\"type\":\"dir\"" : "\",\"type\":\"file\"";
+	builder += ",\"size\":";
+	builder += std::to_string(node.Size);
+
+	// 修改时间（写入时间）：时间位于目录项偏移 22-23，日期位于 24-25
+	if(node.WriteDate != 0 || node.WriteTime != 0) {
+		int hour = (node.WriteTime >> 11) & 0x1F;
+		int minute = (node.WriteTime >> 5) & 0x3F;
+		int second = (node.WriteTime & 0x1F) * 2;
+		int day = node.WriteDate & 0x1F;
+		int month = (node.WriteDate >> 5) & 0x0F;
+		int year = ((node.WriteDate >> 9) & 0x7F) + 1980;
+		char buf[32];
+		snprintf(buf, sizeof(buf), "%04d-%02d-%02d %02d:%02d:%02d", year, month, day, hour, minute, second);
+		builder += ",\"modified\":\"";
+		builder += buf;
+		builder += "\"";
+	}
+
+	if(node.IsDirectory) {
+		builder += ",\"children\":[";
+		for(size_t i = 0; i < node.Children.size(); i++) {
+			if(i > 0) {
+				builder += ",";
+			}
+			AppendJson(node.Children[i], builder);
+		}
+		builder += "]";
+	}
+	builder += "}";
+}
+
+void Fat12Volume::BuildJson(const string& diskName, uint32_t diskSize, string& outJson) const
+{
+	string json;
+	json.reserve(4096);
+	json += "{\"name\":\"";
+	JsonEscape(diskName, json);
+	json += "\",\"type\":\"disk\",\"size\":";
+	json += std::to_string(diskSize);
+	json += ",\"capacity\":";
+	json += std::to_string(_layout.totalClusters * _layout.bytesPerCluster);
+	json += ",\"free\":";
+	json += std::to_string(_freeClusterCount * _layout.bytesPerCluster);
+	json += ",\"children\":[";
+	for(size_t i = 0; i < _rootEntries.size(); i++) {
+		if(i > 0) {
+			json += ",";
+		}
+		AppendJson(_rootEntries[i], json);
+	}
+	json += "]}";
+	outJson = std::move(json);
+}
@@ -0,0 +1,158 @@
+﻿#pragma once
+#include "pch.h"
+
+// FAT12 卷的引导扇区参数（由 BPB 解析得到的各区域偏移与大小，单位为字节或簇）
+struct Fat12Layout
+{
+	uint32_t bytesPerSector = 0;
+	uint32_t sectorsPerCluster = 0;
+	uint32_t reservedSectors = 0;
+	uint32_t fatCount = 0;
+	uint32_t rootEntryCount = 0;
+	uint32_t sectorsPerFat = 0;
+	uint32_t rootDirSectors = 0;
+	uint32_t fatOffset = 0;
+	uint32_t rootDirOffset = 0;
+	uint32_t dataOffset = 0;
+	uint32_t bytesPerCluster = 0;
+	uint32_t totalSectors = 0;
+	uint32_t totalClusters = 0;
+};
+
+/**
+ * 常驻内存的 FAT12 卷索引，供软驱的文件管理接口使用。
+ * 加载时一次性解析引导扇区、FAT 表与整个目录树，建立按长/短文件名的哈希索引与空闲簇位图，
+ * 之后的查询与增删文件只更新索引，不再重新扫描整张磁盘。
+ * 模拟器中的程序写入引导扇区、FAT、根目录或任意目录簇时，索引失效并在下次使用时重新加载。
+ * 索引本身不持有镜像数据，读取文件内容时由调用方传入镜像。
+ */
+class Fat12Volume
+{
+public:
+	struct Entry
+	{
+		// 长文件名（若存在），否则与 ShortName 相同
+		string Name;
+		// 8.3 短文件名（"NAME.EXT"）
+		string ShortName;
+		bool IsDirectory = false;
+		bool Deleted = false;
+		uint32_t Size = 0;
+		uint16_t FirstCluster = 0;
+		uint16_t WriteTime = 0;
+		uint16_t WriteDate = 0;
+		// 短目录项在镜像中的偏移
+		uint32_t EntryOffset = 0;
+		// 属于该文件的 LFN 目录项在镜像中的偏移
+		vector<uint32_t> LfnOffsets;
+		// 父目录在 Entries 中的索引，RootIndex 表示根目录
+		int32_t Parent = -1;
+		vector<int32_t> Children;
+	};
+
+	static constexpr int32_t RootIndex = -1;
+
+	// 描述：解析镜像并重建整个索引。
+	// 返回：镜像不是有效的 FAT12 卷时返回 false（索引保持失效状态）。
+	bool Load(const vector<uint8_t>& image);
+	void Invalidate();
+	bool IsValid() const { return _valid; }
+
+	// 每次索引内容发生变化都会递增（跨多次 Load 单调递增），用于判断缓存的目录树 JSON 是否过期
+	uint32_t GetVersion() const { return _version; }
+
+	// 描述：镜像被模拟器中的程序写入时调用，写入范围包含元数据扇区（引导扇区/FAT/根目录/目录簇）时使索引失效。
+	void NotifyImageWrite(uint32_t offset, size_t length)
+	{
+		if(!_valid) {
+			return;
+		}
+		uint32_t first = offset / _layout.bytesPerSector;
+		uint32_t last = (uint32_t)((offset + (length ? length - 1 : 0)) / _layout.bytesPerSector);
+		for(uint32_t i = first; i <= last && i < _metadataSectors.size(); i++) {
+			if(_metadataSectors[i]) {
+				Invalidate();
+				return;
+			}
+		}
+	}
+
+	const Fat12Layout& GetLayout() const { return _layout; }
+	const Entry& GetEntry(int32_t index) const { return _entries[index]; }
+	const vector<int32_t>& GetChildren(int32_t dirIndex) const { return dirIndex == RootIndex ? _rootEntries : _entries[dirIndex].Children; }
+
+	// 描述：按长文件名或短文件名查找文件（不含目录），同名时返回目录树先序遍历中的第一个。
+	// 返回：Entries 中的索引，未找到返回 -1。
+	int32_t FindFile(const string& name) const;
+	// 描述：在指定目录下按长/短文件名查找文件或子目录（ASCII 字母不区分大小写）。
+	// 返回：Entries 中的索引，未找到返回 -1。
+	int32_t FindChild(int32_t dirIndex, const string& name) const;
+
+	// 描述：获取目录的所有 32 字节目录项在镜像中的偏移（根目录为固定区域，子目录沿簇链展开）。
+	bool GetDirectorySlots(int32_t dirIndex, vector<uint32_t>& offsets) const;
+	// 描述：宿主侧为子目录分配新簇后调用，把该簇登记为元数据（模拟器写入时使索引失效）。
+	void AddDirectoryCluster(uint16_t cluster);
+
+	// 描述：按 VFAT 规则为 longName 生成目录 dirIndex 下唯一的 8.3 短文件名（必要时加 ~N 后缀）。
+	// 参数：shortName - 输出 11 字节的目录项名称；needLongName - 输出是否需要 LFN 目录项保存原名。
+	// 返回：名称为空/非法或无法生成唯一短名时返回 false。
+	bool GenerateShortName(int32_t dirIndex, const string& longName, uint8_t shortName[11], bool& needLongName) const;
+	// 描述：生成保存 longName（UTF-8）的 LFN 目录项，按在目录中的先后顺序排列（每项 32 字节）。
+	// 返回：名称超过 255 个 UTF-16 字符时返回 false。
+	static bool BuildLongNameEntries(const string& longName, const uint8_t shortName[11], vector<uint8_t>& entries);
+
+	uint16_t GetFatValue(uint16_t cluster) const;
+	// 描述：修改内存中的 FAT 表项并同步空闲簇位图，写回镜像由调用方通过 GetFatData 完成。
+	bool SetFatValue(uint16_t cluster, uint16_t value);
+	const vector<uint8_t>& GetFatData() const { return _fatData; }
+
+	uint32_t GetFreeClusterCount() const { return _freeClusterCount; }
+	// 描述：按簇号从小到大查找 count 个空闲簇（不修改 FAT）。
+	// 返回：空闲簇不足时返回 false。
+	bool FindFreeClusters(uint32_t count, vector<uint16_t>& clusters) const;
+	// 描述：释放以 firstCluster 开头的簇链（FAT 表项置 0）。
+	void FreeClusterChain(uint16_t firstCluster);
+
+	// 返回簇在镜像中的偏移，簇号无效时返回 0
+	uint32_t GetClusterOffset(uint16_t cluster) const;
+
+	// 描述：沿簇链把文件内容直接读入 outBuffer，最多 min(文件大小, maxLength) 字节。
+	// 返回：实际读取的字节数（簇链不完整时可能小于文件大小）。
+	uint32_t ReadFile(const vector<uint8_t>& image, const Entry& entry, uint8_t* outBuffer, uint32_t maxLength) const;
+
+	// 以下用于宿主侧文件操作在写入镜像后同步更新索引（不会使索引失效）
+	int32_t AddEntry(int32_t parent, Entry entry);
+	void UpdateEntry(int32_t index, uint32_t size, uint16_t firstCluster, uint16_t writeTime, uint16_t writeDate);
+	void RemoveEntry(int32_t index);
+
+	// 描述：生成目录树 JSON（根节点为磁盘，格式与 UI 的 Floppy_GetDirectoryTree 约定一致）。
+	void BuildJson(const string& diskName, uint32_t diskSize, string& outJson) const;
+
+	// 描述：从目录项中解析 8.3 短文件名。
+	static string BuildShortName(const uint8_t* entry);
+
+private:
+	bool _valid = false;
+	uint32_t _version = 0;
+
+	Fat12Layout _layout;
+	uint32_t _imageSize = 0;
+	vector<uint8_t> _fatData;
+	// 每个数据簇一位，置位表示空闲（FAT 表项为 0）
+	vector<uint64_t> _freeBitmap;
+	uint32_t _freeClusterCount = 0;
+	// 引导扇区、FAT、根目录与所有目录簇所在的扇区
+	vector<uint8_t> _metadataSectors;
+
+	vector<Entry> _entries;
+	vector<int32_t> _rootEntries;
+	unordered_map<string, int32_t> _fileIndex;
+
+	bool LoadLayout(const vector<uint8_t>& image);
+	void ParseDirectory(const vector<uint8_t>& image, int32_t parent, const vector<uint32_t>& entryOffsets, unordered_set<uint16_t>& visitedClusters);
+	bool GetClusterChainOffsets(uint16_t firstCluster, vector<uint32_t>& offsets) const;
+	void MarkMetadata(uint32_t offset, uint32_t length);
+	void SetClusterFree(uint16_t cluster, bool free);
+	void RebuildFileIndex();
+	void AppendJson(int32_t index, string& builder) const;
+};
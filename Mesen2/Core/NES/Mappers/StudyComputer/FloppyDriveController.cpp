@@ -16,6 +16,8 @@
 #include "Core/Shared/Interfaces/INotificationListener.h"
 #include "Core/Shared/NotificationManager.h"
 #include "Utilities/StringUtilities.h"
+#include "Utilities/Serializer.h"
+#include "Utilities/CRC32.h"
 
 // https://www.cpcwiki.eu/index.php/765_FDC
 
@@ -57,220 +59,6 @@ static const FloppyDriveController::FDC_CMD_DESC FdcCmdTable[32] =
 
 namespace
 {
-struct FilePositionGuard
-{
-	FILE* handle;
-	long position;
-	FilePositionGuard(FILE* fp) : handle(fp), position(fp ? ::ftell(fp) : -1) { }
-	~FilePositionGuard()
-	{
-		if(handle && position >= 0) {
-			::fseek(handle, position, SEEK_SET);
-		}
-	}
-};
-
-struct Fat12Context
-{
-	uint32_t bytesPerSector = 0;
-	uint32_t sectorsPerCluster = 0;
-	uint32_t reservedSectors = 0;
-	uint32_t fatCount = 0;
-	uint32_t rootEntryCount = 0;
-	uint32_t sectorsPerFat = 0;
-	uint32_t rootDirSectors = 0;
-	uint32_t fatOffset = 0;
-	uint32_t rootDirOffset = 0;
-	uint32_t dataOffset = 0;
-	uint32_t bytesPerCluster = 0;
-	uint32_t totalSectors = 0;
-	uint32_t totalClusters = 0;
-};
-
-enum class FdcNodeType
-{
-	Disk,
-	Directory,
-	File
-};
-
-struct FdcFileNode
-{
-	FdcNodeType type = FdcNodeType::File;
-	string name;
-	uint32_t size = 0;
-	vector<FdcFileNode> children;
-	// 首簇编号（用于读取文件内容），仅对文件/目录项有意义
-	uint16_t firstCluster = 0;
-	// 总容量（数据区可用字节数），仅对磁盘类型有意义
-	uint32_t capacity = 0;
-	// 可用空间（字节）
-	uint32_t freeBytes = 0;
-	// 修改时间的字符串表示，如果可用格式为 "YYYY-MM-DD HH:MM:SS"
-	string modified;
-};
-
-static bool ReadBytes(FILE* file, long offset, void* buffer, size_t length)
-{
-	if(!file || !buffer || length == 0) {
-		return false;
-	}
-	if(::fseek(file, offset, SEEK_SET) != 0) {
-		return false;
-	}
-	return ::fread(buffer, 1, length, file) == length;
-}
-
-static bool LoadFat12Context(FILE* file, int diskSize, Fat12Context& ctx)
-{
-	std::array<uint8_t, 512> sector{};
-	if(!ReadBytes(file, 0, sector.data(), sector.size())) {
-		return false;
-	}
-
-	uint16_t bytesPerSector = (uint16_t)(sector[11] | (sector[12] << 8));
-	uint8_t sectorsPerCluster = sector[13];
-	uint16_t reservedSectors = (uint16_t)(sector[14] | (sector[15] << 8));
-	uint8_t fatCount = sector[16];
-	uint16_t rootEntryCount = (uint16_t)(sector[17] | (sector[18] << 8));
-	uint16_t totalSectors16 = (uint16_t)(sector[19] | (sector[20] << 8));
-	uint16_t sectorsPerFat = (uint16_t)(sector[22] | (sector[23] << 8));
-	uint32_t totalSectors32 = (uint32_t)(sector[32] | (sector[33] << 8) | (sector[34] << 16) | (sector[35] << 24));
-
-	uint32_t totalSectors = totalSectors16 != 0 ? totalSectors16 : totalSectors32;
-	if(totalSectors == 0 && bytesPerSector != 0) {
-		totalSectors = diskSize > 0 ? (uint32_t)(diskSize / bytesPerSector) : 0;
-	}
-
-	if(bytesPerSector == 0 || sectorsPerCluster == 0 || fatCount == 0 || sectorsPerFat == 0) {
-		return false;
-	}
-
-	ctx.bytesPerSector = bytesPerSector;
-	ctx.sectorsPerCluster = sectorsPerCluster;
-	ctx.reservedSectors = reservedSectors;
-	ctx.fatCount = fatCount;
-	ctx.rootEntryCount = rootEntryCount;
-	ctx.sectorsPerFat = sectorsPerFat;
-	ctx.rootDirSectors = (uint32_t)((rootEntryCount * 32 + bytesPerSector - 1) / bytesPerSector);
-	ctx.fatOffset = ctx.reservedSectors * ctx.bytesPerSector;
-	ctx.rootDirOffset = (ctx.reservedSectors + ctx.fatCount * ctx.sectorsPerFat) * ctx.bytesPerSector;
-	ctx.dataOffset = (ctx.reservedSectors + ctx.fatCount * ctx.sectorsPerFat + ctx.rootDirSectors) * ctx.bytesPerSector;
-	ctx.bytesPerCluster = ctx.bytesPerSector * ctx.sectorsPerCluster;
-	ctx.totalSectors = totalSectors;
-	uint32_t dataSectors = (totalSectors > (ctx.reservedSectors + ctx.fatCount * ctx.sectorsPerFat + ctx.rootDirSectors)) ?
-		(totalSectors - (ctx.reservedSectors + ctx.fatCount * ctx.sectorsPerFat + ctx.rootDirSectors)) : 0;
-	ctx.totalClusters = (ctx.sectorsPerCluster > 0) ? dataSectors / ctx.sectorsPerCluster : 0;
-
-	return ctx.bytesPerSector > 0 && ctx.bytesPerCluster > 0;
-}
-
-static bool LoadFatTable(FILE* file, const Fat12Context& ctx, vector<uint8_t>& fatData)
-{
-	uint32_t fatSize = ctx.sectorsPerFat * ctx.bytesPerSector;
-	if(fatSize == 0) {
-		return false;
-	}
-	fatData.resize(fatSize);
-	return ReadBytes(file, (long)ctx.fatOffset, fatData.data(), fatData.size());
-}
-
-static string TrimTrailingSpaces(const string& value)
-{
-	size_t endPos = value.find_last_not_of(' ');
-	if(endPos == string::npos) {
-		return "";
-	}
-	return value.substr(0, endPos + 1);
-}
-
-static string BuildShortName(const uint8_t* namePart, const uint8_t* extPart)
-{
-	string baseName(reinterpret_cast<const char*>(namePart), 8);
-	if(!baseName.empty() && (uint8_t)baseName[0] == 0x05) {
-		baseName[0] = (char)0xE5;
-	}
-	baseName = TrimTrailingSpaces(baseName);
-	string extension(reinterpret_cast<const char*>(extPart), 3);
-	extension = TrimTrailingSpaces(extension);
-	if(extension.empty()) {
-		return baseName;
-	}
-	if(baseName.empty()) {
-		return extension;
-	}
-	return baseName + "." + extension;
-}
-
-static std::u16string ExtractLongNameSegment(const uint8_t* entry)
-{
-	std::u16string segment;
-	auto appendRange = [&](int offset, int count) {
-		for(int i = 0; i < count; i++) {
-			char16_t ch = (char16_t)(entry[offset + i * 2] | (entry[offset + i * 2 + 1] << 8));
-			if(ch == 0x0000 || ch == (char16_t)0xFFFF) {
-				return false;
-			}
-			segment.push_back(ch);
-		}
-		return true;
-	};
-
-	bool cont = appendRange(1, 5);
-	if(cont) cont = appendRange(14, 6);
-	if(cont) appendRange(28, 2);
-	return segment;
-}
-
-static string BuildLongName(const vector<std::u16string>& segments)
-{
-	if(segments.empty()) {
-		return "";
-	}
-	std::u16string combined;
-	for(const auto& part : segments) {
-		combined += part;
-	}
-	return utf8::utf8::encode(combined);
-}
-
-static uint16_t ReadFatValue(const vector<uint8_t>& fat, uint16_t cluster)
-{
-	uint32_t index = cluster + cluster / 2;
-	if(index + 1 >= fat.size()) {
-		return 0xFFF;
-	}
-	uint16_t value = (uint16_t)(fat[index] | (fat[index + 1] << 8));
-	if(cluster & 1) {
-		value >>= 4;
-	} else {
-		value &= 0x0FFF;
-	}
-	return value;
-}
-
-static bool WriteFatValue(vector<uint8_t>& fat, uint16_t cluster, uint16_t value)
-{
-	uint32_t index = cluster + cluster / 2;
-	if(index + 1 >= fat.size()) {
-		return false;
-	}
-	uint16_t orig = (uint16_t)(fat[index] | (fat[index + 1] << 8));
-	if(cluster & 1) {
-		// odd cluster: store high 12 bits
-		// keep low 4 bits
-		orig &= 0x000F;
-		orig |= (uint16_t)((value & 0x0FFF) << 4);
-	} else {
-		// even cluster: store low 12 bits
-		orig &= 0xF000;
-		orig |= (uint16_t)(value & 0x0FFF);
-	}
-	fat[index] = (uint8_t)(orig & 0xFF);
-	fat[index + 1] = (uint8_t)((orig >> 8) & 0xFF);
-	return true;
-}
-
 static void SetFatTimestampFields(uint8_t* entry)
 {
 	if(!entry) {
@@ -323,215 +111,6 @@ static void SetFatTimestampFields(uint8_t* entry)
 	entry[19] = entry[25];
 	entry[13] = 0;
 }
-
-static bool ReadClusterChain(FILE* file, const Fat12Context& ctx, const vector<uint8_t>& fat, uint16_t startCluster, vector<uint8_t>& outData)
-{
-	outData.clear();
-	if(startCluster < 2 || ctx.bytesPerCluster == 0) {
-		return true;
-	}
-
-	vector<uint8_t> buffer(ctx.bytesPerCluster);
-	uint32_t maxIterations = ctx.totalClusters + 2;
-	uint32_t iteration = 0;
-	uint16_t cluster = startCluster;
-	while(cluster >= 2 && cluster < 0xFF0) {
-		if(iteration++ > maxIterations) {
-			break;
-		}
-		if((cluster - 2) >= ctx.totalClusters) {
-			break;
-		}
-		long offset = (long)(ctx.dataOffset + (uint32_t)(cluster - 2) * ctx.bytesPerCluster);
-		if(!ReadBytes(file, offset, buffer.data(), buffer.size())) {
-			return false;
-		}
-		outData.insert(outData.end(), buffer.begin(), buffer.end());
-		uint16_t nextCluster = ReadFatValue(fat, cluster);
-		if(nextCluster >= 0xFF8) {
-			break;
-		}
-		if(nextCluster == 0) {
-			break;
-		}
-		cluster = nextCluster;
-	}
-	return true;
-}
-
-static void ParseDirectoryData(FILE* file, const Fat12Context& ctx, const vector<uint8_t>& fat, const uint8_t* data, size_t byteCount, vector<FdcFileNode>& output)
-{
-	output.clear();
-	if(!data || byteCount == 0) {
-		return;
-	}
-
-	vector<std::u16string> longNameParts;
-	size_t entryCount = byteCount / 32;
-	for(size_t i = 0; i < entryCount; i++) {
-		const uint8_t* entry = data + i * 32;
-		uint8_t firstByte = entry[0];
-		if(firstByte == 0x00) {
-			break;
-		}
-		uint8_t attr = entry[11];
-		if(attr == 0x0F) {
-			uint8_t sequence = entry[0] & 0x1F;
-			if((entry[0] & 0x40) != 0) {
-				longNameParts.clear();
-				longNameParts.resize(sequence);
-			}
-			if(sequence >= 1 && sequence <= longNameParts.size()) {
-				longNameParts[sequence - 1] = ExtractLongNameSegment(entry);
-			}
-			continue;
-		}
-		if(firstByte == 0xE5) {
-			longNameParts.clear();
-			continue;
-		}
-		if(attr & 0x08) {
-			longNameParts.clear();
-			continue;
-		}
-
-		string name;
-		if(!longNameParts.empty()) {
-			name = BuildLongName(longNameParts);
-		}
-		if(name.empty()) {
-			name = BuildShortName(entry, entry + 8);
-		}
-		longNameParts.clear();
-		if(name.empty()) {
-			continue;
-		}
-
-		bool isDirectory = (attr & 0x10) != 0;
-		if(isDirectory && (name == "." || name == "..")) {
-			continue;
-		}
-
-		uint16_t firstClusterLow = (uint16_t)(entry[26] | (entry[27] << 8));
-		uint16_t firstClusterHigh = (uint16_t)(entry[20] | (entry[21] << 8));
-		uint32_t firstClusterCombined = (uint32_t)firstClusterLow | ((uint32_t)firstClusterHigh << 16);
-		uint16_t firstCluster = (uint16_t)firstClusterCombined;
-		uint32_t fileSize = (uint32_t)(entry[28] | (entry[29] << 8) | (entry[30] << 16) | (entry[31] << 24));
-
-		FdcFileNode node;
-		node.type = isDirectory ? FdcNodeType::Directory : FdcNodeType::File;
-		node.name = name;
-		node.size = fileSize;
-			// 解析目录项中的修改时间（写入时间）。FAT 目录项的写入时间位于偏移 22-25。
-			// 时间：entry[22..23]，日期：entry[24..25]
-			{
-				uint16_t writeTime = (uint16_t)(entry[22] | (entry[23] << 8));
-				uint16_t writeDate = (uint16_t)(entry[24] | (entry[25] << 8));
-				if(writeDate != 0 || writeTime != 0) {
-					int hour = (writeTime >> 11) & 0x1F;
-					int minute = (writeTime >> 5) & 0x3F;
-					int second = (writeTime & 0x1F) * 2;
-					int day = writeDate & 0x1F;
-					int month = (writeDate >> 5) & 0x0F;
-					int year = ((writeDate >> 9) & 0x7F) + 1980;
-					char buf[32];
-					snprintf(buf, sizeof(buf), "%04d-%02d-%02d %02d:%02d:%02d", year, month, day, hour, minute, second);
-					node.modified = buf;
-				}
-			}
-		// 记录首簇，供后续读取文件数据使用
-		node.firstCluster = firstCluster;
-
-		if(isDirectory && firstCluster >= 2) {
-			vector<uint8_t> dirData;
-			if(ReadClusterChain(file, ctx, fat, firstCluster, dirData)) {
-				ParseDirectoryData(file, ctx, fat, dirData.data(), dirData.size(), node.children);
-			}
-		}
-
-		output.push_back(std::move(node));
-	}
-}
-
-// 在节点树中查找指定名称的文件，若找到返回 true 并填充首簇与大小
-static bool FindFileNodeByName(const vector<FdcFileNode>& nodes, const string& filename, uint16_t& outFirstCluster, uint32_t& outSize)
-{
-	for(const auto& n : nodes) {
-		if(n.type == FdcNodeType::File && n.name == filename) {
-			outFirstCluster = n.firstCluster;
-			outSize = n.size;
-			return true;
-		}
-		if(!n.children.empty()) {
-			if(FindFileNodeByName(n.children, filename, outFirstCluster, outSize)) return true;
-		}
-	}
-	return false;
-}
-
-static void JsonEscape(const string& text, string& builder)
-{
-	for(char ch : text) {
-		switch(ch) {
-			case '\\': builder += "\\\\"; break;
-			case '\"': builder += "\\\""; break;
-			case '\b': builder += "\\b"; break;
-			case '\f': builder += "\\f"; break;
-			case '\n': builder += "\\n"; break;
-			case '\r': builder += "\\r"; break;
-			case '\t': builder += "\\t"; break;
-			default:
-				if(static_cast<unsigned char>(ch) < 0x20) {
-					char buffer[7];
-					snprintf(buffer, sizeof(buffer), "\\u%04X", (unsigned)(unsigned char)ch);
-					builder += buffer;
-				} else {
-					builder += ch;
-				}
-				break;
-		}
-	}
-}
-
-static void AppendJson(const FdcFileNode& node, string& builder)
-{
-	builder += "{";
-	builder += "\"name\":\"";
-	JsonEscape(node.name, builder);
-	builder += "\"";
-	builder += ",\"type\":\"";
-	switch(node.type) {
-		case FdcNodeType::Disk: builder += "disk"; break;
-		case FdcNodeType::Directory: builder += "dir"; break;
-		case FdcNodeType::File: builder += "file"; break;
-	}
-	builder += "\"";
-	builder += ",\"size\":";
-	builder += std::to_string(node.size);
-	// 如果存在修改时间，则以字符串形式输出（YYYY-MM-DD HH:MM:SS）
-	if(!node.modified.empty()) {
-		builder += ",\"modified\":\"";
-		JsonEscape(node.modified, builder);
-		builder += "\"";
-	}
-	if(node.type == FdcNodeType::Disk) {
-		builder += ",\"capacity\":";
-		builder += std::to_string(node.capacity);
-		builder += ",\"free\":";
-		builder += std::to_string(node.freeBytes);
-	}
-	if(node.type != FdcNodeType::File) {
-		builder += ",\"children\":[";
-		for(size_t i = 0; i < node.children.size(); i++) {
-			AppendJson(node.children[i], builder);
-			if(i + 1 < node.children.size()) {
-				builder += ",";
-			}
-		}
-		builder += "]";
-	}
-	builder += "}";
-}
 }
 
 /*
@@ -605,41 +184,111 @@ FloppyDriveController::FloppyDriveController(Emulator* emu)
 
 FloppyDriveController::~FloppyDriveController()
 {
-	if(pDiskFile) fclose(pDiskFile);
+	CloseDiskFiles();
 }
 
-int FloppyDriveController::LoadDiskImage(const char* filePath)
+// 描述：打开镜像文件（不截断）。writable 为 false 时只读打开，多个进程可以共享同一个基础镜像。
+static FILE* OpenImageFile(const char* filePath, bool writable)
 {
-	// 更新活动状态（可能从无盘->有盘）
-	UpdateActiveState();
-
 	FILE* fp;
-
-	// try to open disk image for read/write (do not truncate)
 #if defined(_MSC_VER)
 	// 使用 _sopen_s 并传入 _SH_DENYNO，避免独占打开（允许共享读写）
 	int fd;
-	errno_t err = _sopen_s(&fd, filePath, _O_RDWR | _O_BINARY, _SH_DENYNO, _S_IREAD | _S_IWRITE);
+	errno_t err = _sopen_s(&fd, filePath, (writable ? _O_RDWR : _O_RDONLY) | _O_BINARY, _SH_DENYNO, _S_IREAD | _S_IWRITE);
 	if(err != 0 || fd == -1) {
-		return 0;
+		return nullptr;
 	}
-	if(!(fp = _fdopen(fd, "rb+"))) {
+	if(!(fp = _fdopen(fd, writable ? "rb+" : "rb"))) {
 		_close(fd);
-		return 0;
+		return nullptr;
 	}
 #else
-	if(!(fp = ::fopen(filePath, "rb+"))) {
-		return 0;
+	if(!(fp = ::fopen(filePath, writable ? "rb+" : "rb"))) {
+		return nullptr;
 	}
 #endif
+	return fp;
+}
+
+int FloppyDriveController::LoadDiskImage(const char* filePath)
+{
+	return OpenDiskImage(filePath, false, nullptr);
+}
 
-	::fseek(fp, 0, SEEK_END);
-	nDiskSize = ::ftell(fp);
-	::fseek(fp, 0, SEEK_SET);
+int FloppyDriveController::LoadDiskImageOverlay(const char* basePath, const char* deltaPath)
+{
+	return OpenDiskImage(basePath, true, deltaPath);
+}
+
+int FloppyDriveController::OpenDiskImage(const char* filePath, bool overlay, const char* deltaPath)
+{
+	// 更新活动状态（可能从无盘->有盘）
+	UpdateActiveState();
 
-	// close previous file if any
-	if(pDiskFile) fclose(pDiskFile);
+	// 一次性将整个镜像解码（必要时解压）到内存，之后的扇区读写均为内存拷贝
+	FloppyImage source;
+	if(!filePath || !FloppyImageLoader::Load(filePath, source)) {
+		return 0;
+	}
+	bool writable = source.IsWritable();
+	if(!writable) {
+		// 不能原样写回的格式总是以覆盖层方式加载
+		overlay = true;
+	}
+
+	// 普通模式以读写方式打开镜像，覆盖层模式下基础镜像只读
+	FILE* fp = OpenImageFile(source.FilePath.c_str(), !overlay);
+	if(!fp) {
+		return 0;
+	}
+
+	vector<uint8_t> image = std::move(source.Data);
+	vector<uint8_t> baseImage;
+	if(!writable) {
+		baseImage = image;
+	}
+
+	uint32_t sectorCount = (uint32_t)((image.size() + SectorSize - 1) / SectorSize);
+	uint32_t baseCrc = 0;
+	FILE* overlayFile = nullptr;
+	vector<int32_t> overlayRecords;
+	vector<uint8_t> overlaySectors;
+	uint32_t overlayRecordCount = 0;
+	if(overlay) {
+		baseCrc = CRC32::GetCRC(image);
+		overlayRecords.assign(sectorCount, -1);
+		overlaySectors.assign(sectorCount, 0);
+		if(deltaPath && deltaPath[0]) {
+			// 差异文件已存在时把其中的扇区应用到内存镜像，继续上一次会话
+			overlayFile = OpenOverlayFile(deltaPath, baseCrc, image, overlayRecords, overlaySectors, overlayRecordCount);
+			if(!overlayFile) {
+				fclose(fp);
+				return 0;
+			}
+		}
+	}
+
+	// close previous file if any (写回其未保存的扇区)
+	CloseDiskFiles();
 	pDiskFile = fp;
+	nDiskSize = (int)image.size();
+	_diskImage = std::move(image);
+	_dirtySectors.assign(sectorCount, 0);
+	_dirtySectorCount = 0;
+	_overlayMode = overlay;
+	_overlayFile = overlayFile;
+	_overlayPath = overlayFile ? deltaPath : "";
+	_overlayBaseCrc = baseCrc;
+	_overlayRecords = std::move(overlayRecords);
+	_overlaySectors = std::move(overlaySectors);
+	_overlayRecordCount = overlayRecordCount;
+	_geometry = source.Geometry;
+	_sourceWritable = writable;
+	_baseImage = std::move(baseImage);
+	_originalImage = _diskImage;
+	_originalImageCrc = CRC32::GetCRC(_originalImage);
+	_modifiedSectors.assign(_dirtySectors.size(), 0);
+	_fatVolume.Invalidate();
 #if defined(_MSC_VER)
 	strcpy_s(szDiskName, sizeof(szDiskName), filePath);
 #else
@@ -678,10 +327,19 @@ int FloppyDriveController::Eject()
 		return 0;
 	}
 
-	// 关闭文件句柄
-	fclose(pDiskFile);
-	pDiskFile = nullptr;
+	// 回写已修改的扇区后关闭文件句柄
+	CloseDiskFiles();
 	nDiskSize = 0;
+	_diskImage.clear();
+	_diskImage.shrink_to_fit();
+	_dirtySectors.clear();
+	_dirtySectorCount = 0;
+	_originalImage.clear();
+	_originalImage.shrink_to_fit();
+	_originalImageCrc = 0;
+	_modifiedSectors.clear();
+	_fatVolume.Invalidate();
+	_geometry = FloppyGeometry();
 	szDiskName[0] = '\0';
 
 	// 重置状态
@@ -709,16 +367,422 @@ int FloppyDriveController::Eject()
 	return 1;
 }
 
+// 描述：将内存镜像中被修改过的扇区写回镜像文件（连续的脏扇区合并为一次写入）。
+//       覆盖层模式下写入差异文件（或仅保留在内存中），基础镜像不会被修改。
+// 返回 0 表示无磁盘或写入失败，1 表示成功。
 int FloppyDriveController::SaveDiskImage()
 {
-	// 直接对打开的镜像文件执行刷新
 	if(!pDiskFile) return 0;
+	if(_dirtySectorCount == 0) return 1;
+	if(_overlayMode) return SaveOverlay();
+
+	uint32_t sectorCount = (uint32_t)_dirtySectors.size();
+	uint32_t sector = 0;
+	while(sector < sectorCount) {
+		if(!_dirtySectors[sector]) {
+			sector++;
+			continue;
+		}
+
+		uint32_t runEnd = sector;
+		while(runEnd < sectorCount && _dirtySectors[runEnd]) {
+			runEnd++;
+		}
+
+		size_t offset = (size_t)sector * SectorSize;
+		size_t length = std::min((size_t)(runEnd - sector) * SectorSize, _diskImage.size() - offset);
+		if(::fseek(pDiskFile, (long)offset, SEEK_SET) != 0 || ::fwrite(_diskImage.data() + offset, 1, length, pDiskFile) != length) {
+			return 0;
+		}
+		memset(_dirtySectors.data() + sector, 0, runEnd - sector);
+		_dirtySectorCount -= runEnd - sector;
+		sector = runEnd;
+	}
+
+	if(::fflush(pDiskFile) != 0) {
+		return 0;
+	}
+
+	return 1;
+}
+
+// 描述：回写未保存的扇区后关闭镜像文件与差异文件。
+void FloppyDriveController::CloseDiskFiles()
+{
+	if(pDiskFile) {
+		SaveDiskImage();
+		fclose(pDiskFile);
+		pDiskFile = nullptr;
+	}
+	if(_overlayFile) {
+		fclose(_overlayFile);
+		_overlayFile = nullptr;
+	}
+	_overlayMode = false;
+	_overlayPath.clear();
+	_overlayRecords.clear();
+	_overlaySectors.clear();
+	_overlayRecordCount = 0;
+	_baseImage.clear();
+	_baseImage.shrink_to_fit();
+	_sourceWritable = false;
+}
+
+// 差异文件格式：16 字节文件头（"BBKOVLY1"、镜像大小、基础镜像 CRC32，均为小端），
+// 之后是若干条扇区记录（4 字节扇区号 + 512 字节数据）。同一扇区只占一条记录，再次写入时原地覆盖。
+static constexpr char OverlayMagic[8] = { 'B', 'B', 'K', 'O', 'V', 'L', 'Y', '1' };
+static constexpr uint32_t OverlayHeaderSize = 16;
+
+static void WriteLe32(uint8_t* dst, uint32_t value)
+{
+	dst[0] = (uint8_t)value;
+	dst[1] = (uint8_t)(value >> 8);
+	dst[2] = (uint8_t)(value >> 16);
+	dst[3] = (uint8_t)(value >> 24);
+}
+
+static uint32_t ReadLe32(const uint8_t* src)
+{
+	return (uint32_t)(src[0] | (src[1] << 8) | (src[2] << 16) | (src[3] << 24));
+}
+
+static bool WriteOverlayHeader(FILE* fp, uint32_t imageSize, uint32_t baseCrc)
+{
+	uint8_t header[OverlayHeaderSize];
+	memcpy(header, OverlayMagic, sizeof(OverlayMagic));
+	WriteLe32(header + 8, imageSize);
+	WriteLe32(header + 12, baseCrc);
+	return ::fseek(fp, 0, SEEK_SET) == 0 && ::fwrite(header, 1, sizeof(header), fp) == sizeof(header) && ::fflush(fp) == 0;
+}
+
+// 描述：打开（或创建）差异文件。文件已存在时校验文件头，并把其中的扇区记录应用到 image。
+// 返回：差异文件与基础镜像不匹配或无法打开时返回 nullptr。
+FILE* FloppyDriveController::OpenOverlayFile(const char* deltaPath, uint32_t baseCrc, vector<uint8_t>& image, vector<int32_t>& records, vector<uint8_t>& overlaySectors, uint32_t& recordCount)
+{
+	recordCount = 0;
+	FILE* fp = ::fopen(deltaPath, "rb+");
+	if(!fp) {
+		fp = ::fopen(deltaPath, "wb+");
+		if(fp && !WriteOverlayHeader(fp, (uint32_t)image.size(), baseCrc)) {
+			fclose(fp);
+			return nullptr;
+		}
+		return fp;
+	}
+
+	uint8_t header[OverlayHeaderSize];
+	if(::fread(header, 1, sizeof(header), fp) != sizeof(header) || memcmp(header, OverlayMagic, sizeof(OverlayMagic)) != 0
+		|| ReadLe32(header + 8) != image.size() || ReadLe32(header + 12) != baseCrc) {
+		// 不是差异文件，或者对应的是另一个（或已被修改的）基础镜像
+		fclose(fp);
+		return nullptr;
+	}
+
+	// 末尾不完整的记录（写入过程中断）被忽略，之后会被新记录覆盖
+	uint8_t record[OverlayRecordSize];
+	while(::fread(record, 1, sizeof(record), fp) == sizeof(record)) {
+		uint32_t sector = ReadLe32(record);
+		if(sector < records.size()) {
+			size_t offset = (size_t)sector * SectorSize;
+			memcpy(image.data() + offset, record + 4, std::min((size_t)SectorSize, image.size() - offset));
+			records[sector] = (int32_t)recordCount;
+			overlaySectors[sector] = 1;
+		}
+		recordCount++;
+	}
+	return fp;
+}
+
+// 描述：覆盖层模式下的回写：脏扇区并入覆盖层，有差异文件时写入对应的扇区记录。
+int FloppyDriveController::SaveOverlay()
+{
+	uint8_t record[OverlayRecordSize];
+	for(uint32_t sector = 0; sector < (uint32_t)_dirtySectors.size(); sector++) {
+		if(!_dirtySectors[sector]) {
+			continue;
+		}
+
+		if(_overlayFile) {
+			int32_t& recordIndex = _overlayRecords[sector];
+			if(recordIndex < 0) {
+				recordIndex = (int32_t)_overlayRecordCount++;
+			}
+			size_t offset = (size_t)sector * SectorSize;
+			size_t length = std::min((size_t)SectorSize, _diskImage.size() - offset);
+			memset(record, 0, sizeof(record));
+			WriteLe32(record, sector);
+			memcpy(record + 4, _diskImage.data() + offset, length);
+			long fileOffset = (long)(OverlayHeaderSize + (size_t)recordIndex * OverlayRecordSize);
+			if(::fseek(_overlayFile, fileOffset, SEEK_SET) != 0 || ::fwrite(record, 1, sizeof(record), _overlayFile) != sizeof(record)) {
+				return 0;
+			}
+		}
+
+		_overlaySectors[sector] = 1;
+		_dirtySectors[sector] = 0;
+		_dirtySectorCount--;
+	}
+
+	if(_overlayFile && ::fflush(_overlayFile) != 0) {
+		return 0;
+	}
+	return 1;
+}
+
+// 描述：清空覆盖层（差异文件截断为只有文件头），baseCrc 为此后基础镜像内容的 CRC32。
+bool FloppyDriveController::ResetOverlay(uint32_t baseCrc)
+{
+	std::fill(_overlayRecords.begin(), _overlayRecords.end(), -1);
+	std::fill(_overlaySectors.begin(), _overlaySectors.end(), 0);
+	_overlayRecordCount = 0;
+	_overlayBaseCrc = baseCrc;
+
+	if(_overlayFile) {
+		_overlayFile = ::freopen(_overlayPath.c_str(), "wb+", _overlayFile);
+		if(!_overlayFile || !WriteOverlayHeader(_overlayFile, (uint32_t)_diskImage.size(), baseCrc)) {
+			return false;
+		}
+	}
+	return true;
+}
+
+int FloppyDriveController::CommitOverlay()
+{
+	if(!pDiskFile || !_overlayMode || !_sourceWritable) return 0;
+	if(IsActive()) return 0;
+	if(!SaveDiskImage()) return 0;
+
+	FILE* fp = OpenImageFile(szDiskName, true);
+	if(!fp) return 0;
+
+	// 把覆盖层中的扇区写入基础镜像（连续的扇区合并为一次写入）
+	uint32_t sectorCount = (uint32_t)_overlaySectors.size();
+	uint32_t sector = 0;
+	bool result = true;
+	while(sector < sectorCount && result) {
+		if(!_overlaySectors[sector]) {
+			sector++;
+			continue;
+		}
+		uint32_t runEnd = sector;
+		while(runEnd < sectorCount && _overlaySectors[runEnd]) {
+			runEnd++;
+		}
+		size_t offset = (size_t)sector * SectorSize;
+		size_t length = std::min((size_t)(runEnd - sector) * SectorSize, _diskImage.size() - offset);
+		result = ::fseek(fp, (long)offset, SEEK_SET) == 0 && ::fwrite(_diskImage.data() + offset, 1, length, fp) == length;
+		sector = runEnd;
+	}
+	result = ::fflush(fp) == 0 && result;
+	fclose(fp);
+
+	// 写入失败时保留覆盖层，可以再次提交
+	if(!result) return 0;
+	return ResetOverlay(CRC32::GetCRC(_diskImage)) ? 1 : 0;
+}
+
+int FloppyDriveController::DiscardOverlay()
+{
+	if(!pDiskFile || !_overlayMode) return 0;
+	if(IsActive()) return 0;
+
+	// 从只读的基础镜像重新读入所有被覆盖或尚未保存的扇区
+	for(uint32_t sector = 0; sector < (uint32_t)_overlaySectors.size(); sector++) {
+		if(!_overlaySectors[sector] && !_dirtySectors[sector]) {
+			continue;
+		}
+		size_t offset = (size_t)sector * SectorSize;
+		size_t length = std::min((size_t)SectorSize, _diskImage.size() - offset);
+		if(!_baseImage.empty()) {
+			memcpy(_diskImage.data() + offset, _baseImage.data() + offset, length);
+		} else if(::fseek(pDiskFile, (long)offset, SEEK_SET) != 0 || ::fread(_diskImage.data() + offset, 1, length, pDiskFile) != length) {
+			return 0;
+		}
+		_fatVolume.NotifyImageWrite((uint32_t)offset, length);
+		_modifiedSectors[sector] = 1;
+		_overlaySectors[sector] = 0;
+		if(_dirtySectors[sector]) {
+			_dirtySectors[sector] = 0;
+			_dirtySectorCount--;
+		}
+	}
+
+	// 磁盘内容整体改变，通知模拟器中的程序重新读取
+	bDiskChanged = 1;
+	return ResetOverlay(_overlayBaseCrc) ? 1 : 0;
+}
+
+int FloppyDriveController::ExportDiskImage(const char* filePath)
+{
+	if(!pDiskFile || !filePath) return 0;
+
+	FILE* fp = ::fopen(filePath, "wb");
+	if(!fp) return 0;
+	bool result = ::fwrite(_diskImage.data(), 1, _diskImage.size(), fp) == _diskImage.size();
+	result = ::fclose(fp) == 0 && result;
+	return result ? 1 : 0;
+}
+
+uint8_t FloppyDriveController::ReadImageByte(uint32_t offset)
+{
+	return offset < _diskImage.size() ? _diskImage[offset] : 0;
+}
+
+void FloppyDriveController::WriteImageByte(uint32_t offset, uint8_t value)
+{
+	if(offset >= _diskImage.size()) {
+		return;
+	}
+	_diskImage[offset] = value;
+	_fatVolume.NotifyImageWrite(offset, 1);
+	uint8_t& dirty = _dirtySectors[offset / SectorSize];
+	if(!dirty) {
+		dirty = 1;
+		_dirtySectorCount++;
+		_modifiedSectors[offset / SectorSize] = 1;
+	}
+}
+
+bool FloppyDriveController::WriteImageBytes(uint32_t offset, const void* data, size_t length)
+{
+	if(offset >= _diskImage.size()) {
+		return false;
+	}
+	length = std::min(length, _diskImage.size() - offset);
+	memcpy(_diskImage.data() + offset, data, length);
+	MarkSectorsDirty(offset, length);
+	return true;
+}
+
+void FloppyDriveController::MarkSectorsDirty(uint32_t offset, size_t length)
+{
+	if(length == 0) {
+		return;
+	}
+	uint32_t first = offset / SectorSize;
+	uint32_t last = std::min((uint32_t)((offset + length - 1) / SectorSize), (uint32_t)_dirtySectors.size() - 1);
+	for(uint32_t i = first; i <= last; i++) {
+		if(!_dirtySectors[i]) {
+			_dirtySectors[i] = 1;
+			_dirtySectorCount++;
+		}
+		_modifiedSectors[i] = 1;
+	}
+}
+
+void FloppyDriveController::Serialize(Serializer& s)
+{
+	SV(bFdcIrq);
+	SV(bFdcHwReset);
+	SV(bFdcSoftReset);
+	SV(bFdcDataBytes);
+	SV(bFdcDmaInt);
+	SV(nFdcDrvSel);
+	SV(nFdcMotor);
+	SV(nFdcSpeed);
+	SV(nFdcMainStatus);
+	SVArray(nFDCStatus, 4);
+	SV(bFdcCycle);
+	SV(bFdcLastCommand);
+	SVArray(bFdcCommands, 10);
+	SVArray(bFdcResults, 8);
+	SV(bFdcPhase);
+	SV(nFdcCylinder);
+	SV(nFdcDataOffset);
+	SV(nCurrentLBA);
+	SV(bDiskChanged);
+	SV(_cycle);
+	SV(_dataReadyCycle);
+	SV(_seekEndCycle);
+	SV(_headUnloadCycle);
+	SV(_headCylinder);
+	SV(_stepRateTime);
+	SV(_headUnloadTime);
+	SV(_headLoadTime);
+
+	SerializeDiskDelta(s);
+
+	if(!s.IsSaving()) {
+		// pFdcCmd 总是指向当前命令首字节对应的表项
+		pFdcCmd = &FdcCmdTable[bFdcCommands[0] & FDC_CC_MASK];
+		// 读档可能使控制器进入/离开活动状态，同步通知 UI
+		UpdateActiveState();
+	}
+}
+
+// 描述：存档时只保存内容与加载时不同的扇区（扇区号列表 + 扇区数据），读档时把镜像恢复为
+//       “加载时内容 + 存档差异”，只有内容确实改变的扇区会被标记为脏并在之后回写文件。
+void FloppyDriveController::SerializeDiskDelta(Serializer& s)
+{
+	if(s.GetFormat() != SerializeFormat::Binary) {
+		//Lua 状态读写不包含磁盘内容
+		return;
+	}
+
+	uint32_t imageSize = (uint32_t)_diskImage.size();
+	uint32_t imageCrc = _originalImageCrc;
+	SV(imageSize);
+	SV(imageCrc);
+
+	vector<uint32_t> deltaSectors;
+	vector<uint8_t> deltaData;
+	uint32_t sectorCount = (uint32_t)_modifiedSectors.size();
+
+	if(s.IsSaving()) {
+		for(uint32_t i = 0; i < sectorCount; i++) {
+			if(!_modifiedSectors[i]) {
+				continue;
+			}
+			size_t offset = (size_t)i * SectorSize;
+			size_t length = std::min((size_t)SectorSize, _diskImage.size() - offset);
+			if(memcmp(_diskImage.data() + offset, _originalImage.data() + offset, length) != 0) {
+				deltaSectors.push_back(i);
+				deltaData.insert(deltaData.end(), _diskImage.begin() + offset, _diskImage.begin() + offset + length);
+			}
+		}
+		SVVector(deltaSectors);
+		SVVector(deltaData);
+		return;
+	}
+
+	SVVector(deltaSectors);
+	SVVector(deltaData);
+
+	if(!pDiskFile || imageSize != _diskImage.size() || imageCrc != _originalImageCrc) {
+		// 存档对应的是另一张磁盘（或当前无盘），保留当前镜像内容
+		return;
+	}
+
+	// 先把目标内容整理为每个扇区的数据来源：存档差异中的扇区取存档数据，其余取加载时内容
+	vector<const uint8_t*> target(sectorCount, nullptr);
+	size_t dataPos = 0;
+	for(uint32_t sector : deltaSectors) {
+		if(sector >= sectorCount) {
+			break;
+		}
+		size_t length = std::min((size_t)SectorSize, _diskImage.size() - (size_t)sector * SectorSize);
+		if(dataPos + length > deltaData.size()) {
+			break;
+		}
+		target[sector] = deltaData.data() + dataPos;
+		dataPos += length;
+	}
+
+	for(uint32_t i = 0; i < sectorCount; i++) {
+		if(!_modifiedSectors[i] && !target[i]) {
+			continue;
+		}
 
-	if(::fflush(pDiskFile) != 0) {
-		return 0;
+		size_t offset = (size_t)i * SectorSize;
+		size_t length = std::min((size_t)SectorSize, _diskImage.size() - offset);
+		const uint8_t* src = target[i] ? target[i] : _originalImage.data() + offset;
+		if(memcmp(_diskImage.data() + offset, src, length) != 0) {
+			memcpy(_diskImage.data() + offset, src, length);
+			MarkSectorsDirty((uint32_t)offset, length);
+			_fatVolume.NotifyImageWrite((uint32_t)offset, length);
+		}
+		_modifiedSectors[i] = target[i] ? 1 : 0;
 	}
-
-	return 1;
 }
 
 /// <summary>
@@ -727,75 +791,142 @@ int FloppyDriveController::SaveDiskImage()
 int FloppyDriveController::GetDirectoryTreeJson(string& outJson)
 {
 	outJson = "[]";
-	if(!pDiskFile) {
+	if(!EnsureFatVolume()) {
 		return 0;
 	}
 
-	FilePositionGuard guard(pDiskFile);
+	// 索引未变化时直接返回上次生成的 JSON
+	if(_dirTreeJson.empty() || _dirTreeJsonVersion != _fatVolume.GetVersion()) {
+		string diskName = szDiskName;
+		if(diskName.empty()) {
+			diskName = "Floppy";
+		}
+		size_t pos = diskName.find_last_of("/\\");
+		if(pos != string::npos) {
+			diskName = diskName.substr(pos + 1);
+		}
 
-	Fat12Context ctx;
-	if(!LoadFat12Context(pDiskFile, nDiskSize, ctx)) {
-		return 0;
+		_fatVolume.BuildJson(diskName, (uint32_t)(nDiskSize > 0 ? nDiskSize : 0), _dirTreeJson);
+		_dirTreeJsonVersion = _fatVolume.GetVersion();
 	}
 
-	vector<uint8_t> fatData;
-	if(!LoadFatTable(pDiskFile, ctx, fatData)) {
-		return 0;
+	outJson = _dirTreeJson;
+	return 1;
+}
+
+// 描述：确保 FAT12 卷索引可用，索引失效（或尚未建立）时重新解析内存镜像。
+// 返回：无磁盘或镜像不是有效的 FAT12 卷时返回 false。
+bool FloppyDriveController::EnsureFatVolume()
+{
+	if(!pDiskFile) {
+		return false;
 	}
+	return _fatVolume.IsValid() || _fatVolume.Load(_diskImage);
+}
 
-	vector<uint8_t> rootBuffer;
-	if(ctx.rootEntryCount > 0) {
-		rootBuffer.resize((size_t)ctx.rootEntryCount * 32);
-		if(!ReadBytes(pDiskFile, (long)ctx.rootDirOffset, rootBuffer.data(), rootBuffer.size())) {
-			return 0;
+// 描述：把索引中的 FAT 表写入镜像中的所有 FAT 副本，只有内容变化的扇区会被标记为脏。
+bool FloppyDriveController::WriteFatCopies()
+{
+	const Fat12Layout& ctx = _fatVolume.GetLayout();
+	const vector<uint8_t>& fatData = _fatVolume.GetFatData();
+	uint32_t fatSize = ctx.sectorsPerFat * ctx.bytesPerSector;
+	for(uint32_t copy = 0; copy < ctx.fatCount; ++copy) {
+		uint32_t fatOffset = ctx.fatOffset + copy * fatSize;
+		for(uint32_t pos = 0; pos < fatData.size(); pos += ctx.bytesPerSector) {
+			uint32_t length = std::min<uint32_t>(ctx.bytesPerSector, (uint32_t)fatData.size() - pos);
+			if(fatOffset + pos + length > _diskImage.size()) {
+				return false;
+			}
+			if(memcmp(_diskImage.data() + fatOffset + pos, fatData.data() + pos, length) != 0) {
+				WriteImageBytes(fatOffset + pos, fatData.data() + pos, length);
+			}
 		}
 	}
+	return true;
+}
 
-	vector<FdcFileNode> children;
-	if(!rootBuffer.empty()) {
-		ParseDirectoryData(pDiskFile, ctx, fatData, rootBuffer.data(), rootBuffer.size(), children);
+void FloppyDriveController::SetTimingMode(bool accurate, uint32_t clockRate)
+{
+	_accurateTiming = accurate;
+	if(clockRate) {
+		_clockRate = clockRate;
 	}
+}
 
-	FdcFileNode rootNode;
-	rootNode.type = FdcNodeType::Disk;
-	rootNode.size = (uint32_t)(nDiskSize > 0 ? nDiskSize : 0);
-	rootNode.children = std::move(children);
-
-	// 计算并填充容量与可用空间信息（以字节为单位）
-	if(ctx.bytesPerCluster > 0 && ctx.totalClusters > 0) {
-		uint32_t capacity = ctx.totalClusters * ctx.bytesPerCluster;
-		uint32_t freeClusters = 0;
-		for(uint16_t c = 2; c < (uint16_t)(ctx.totalClusters + 2); ++c) {
-			uint16_t val = ReadFatValue(fatData, c);
-			if(val == 0) freeClusters++;
-		}
-		uint32_t freeBytes = freeClusters * ctx.bytesPerCluster;
-		rootNode.capacity = capacity;
-		rootNode.freeBytes = freeBytes;
-	} else {
-		rootNode.capacity = 0;
-		rootNode.freeBytes = 0;
+void FloppyDriveController::SyncClock(uint64_t cycle)
+{
+	if(cycle < _cycle) {
+		// CPU 周期计数回退（重新上电等），旧的截止时间已无意义
+		_dataReadyCycle = 0;
+		_seekEndCycle = 0;
+		_headUnloadCycle = 0;
 	}
+	_cycle = cycle;
+}
+
+uint32_t FloppyDriveController::GetDataRate() const
+{
+	// 端口 0x3F7: 00 500kbps, 01 300kbps, 10 250kbps, 11 1Mbps
+	static constexpr uint32_t rates[4] = { 500000, 300000, 250000, 1000000 };
+	return rates[nFdcSpeed & 3];
+}
+
+uint64_t FloppyDriveController::GetScaledCycles(uint32_t msAt500k) const
+{
+	return (uint64_t)msAt500k * _clockRate / 1000 * 500000 / GetDataRate();
+}
+
+uint64_t FloppyDriveController::GetByteCycles() const
+{
+	// MFM 每字节 8 个数据位
+	return std::max<uint64_t>(1, (uint64_t)_clockRate * 8 / GetDataRate());
+}
+
+uint64_t FloppyDriveController::GetStepCycles() const
+{
+	// SRT: 500kbps 下步进时间为 (16 - SRT) ms
+	return GetScaledCycles(16 - (_stepRateTime & 0x0F));
+}
+
+uint64_t FloppyDriveController::ScheduleSectorAccess(uint8_t cylinder, uint8_t sector)
+{
+	// 未等待 Seek 完成就发出读写命令时，从寻道结束开始计算
+	uint64_t start = std::max(_cycle, _seekEndCycle);
 
-	string diskName = szDiskName;
-	if(diskName.empty()) {
-		diskName = "Floppy";
+	uint32_t steps = std::abs((int)cylinder - (int)_headCylinder);
+	if(steps) {
+		start += steps * GetStepCycles() + (uint64_t)HeadSettleMs * _clockRate / 1000;
+		_headCylinder = cylinder;
 	}
-	size_t pos = diskName.find_last_of("/\\");
-	if(pos != string::npos) {
-		diskName = diskName.substr(pos + 1);
+
+	if(start >= _headUnloadCycle) {
+		// HLT: 500kbps 下为 HLT * 2ms，0 表示 256ms
+		start += GetScaledCycles((_headLoadTime ? _headLoadTime : 128) * 2);
 	}
-	rootNode.name = diskName;
 
-	string json;
-	json.reserve(4096);
-	AppendJson(rootNode, json);
-	outJson = std::move(json);
-	return 1;
+	// 盘片角度由绝对周期计数得出，扇区在磁道上均匀分布（忽略间隙长度的差异）
+	uint64_t revolution = (uint64_t)_clockRate * 60 / DiskRpm;
+	uint32_t sectorsPerTrack = std::max<uint32_t>(1, _geometry.SectorsPerTrack);
+	uint64_t sectorStart = revolution * ((sector ? sector - 1 : 0) % sectorsPerTrack) / sectorsPerTrack;
+	uint64_t position = start % revolution;
+	uint64_t ready = start + (sectorStart + revolution - position) % revolution;
+
+	// HUT: 500kbps 下为 HUT * 16ms，0 表示 256ms
+	_headUnloadCycle = ready + SectorSize * GetByteCycles() + GetScaledCycles((_headUnloadTime ? _headUnloadTime : 16) * 16);
+	return ready;
+}
+
+void FloppyDriveController::AdvanceDataByte()
+{
+	if(_accurateTiming) {
+		// 数据以固定速率从盘片流出；主机跟不上时不模拟溢出（Over Run），从当前时刻继续传输
+		_dataReadyCycle = std::max(_dataReadyCycle + GetByteCycles(), _cycle);
+	}
 }
 
-unsigned char FloppyDriveController::Read(unsigned char nPort)
+unsigned char FloppyDriveController::Read(unsigned char nPort, uint64_t cycle)
 {
+	SyncClock(cycle);
 	UpdateActiveState();
 
 	unsigned char nData;
@@ -804,14 +935,9 @@ unsigned char FloppyDriveController::Read(unsigned char nPort)
 		case 0: // 3F0: FDCDMADackIO
 		case 1: // 3F1: FDCDMATcIO
 			if(pDiskFile) {
-				unsigned char tmp = 0;
-				::fseek(pDiskFile, nFdcDataOffset, SEEK_SET);
-				if(::fread(&tmp, 1, 1, pDiskFile) == 1) {
-					nData = tmp;
-				} else {
-					nData = 0;
-				}
+				nData = ReadImageByte(nFdcDataOffset);
 				nFdcDataOffset++;
+				AdvanceDataByte();
 				bFdcDataBytes--;
 				if(0 == bFdcDataBytes)
 					bFdcPhase = FDC_PH_RESULT;
@@ -822,11 +948,11 @@ unsigned char FloppyDriveController::Read(unsigned char nPort)
 			break;
 		case 2: // 3F2: FDCDRQPortI/FDCCtrlPortO
 			// I: D6 : FDC DRQ
-			nData = 0x40;
+			nData = IsTimingPending(_dataReadyCycle) ? 0 : 0x40;
 			break;
 		case 3: // 3F3: FDCIRQPortI/FDCDMADackIO
 			// I: D6 : IRQ
-			if(bFdcIrq)
+			if(bFdcIrq && !IsTimingPending(_dataReadyCycle) && !IsTimingPending(_seekEndCycle))
 				nData = 0x40;
 			else
 				nData = 0;
@@ -837,6 +963,12 @@ unsigned char FloppyDriveController::Read(unsigned char nPort)
 			// I: D6 : FDC dir
 			// I: D5 : FDC busy
 			nData = nFdcMainStatus;
+			if(IsTimingPending(_dataReadyCycle)) {
+				nData = (nData & ~FDC_MS_RQM) | FDC_MS_BUSYRW;
+			}
+			if(IsTimingPending(_seekEndCycle)) {
+				nData |= FDC_MS_BUSYS0;
+			}
 			break;
 		case 5: // 3F5: FDCDataPortIO
 			if(FDC_PH_EXECUTION == bFdcPhase) {
@@ -847,9 +979,9 @@ unsigned char FloppyDriveController::Read(unsigned char nPort)
 					{
 						unsigned char tmp = 0;
 						if(pDiskFile) {
-							::fseek(pDiskFile, nFdcDataOffset, SEEK_SET);
-							if(::fread(&tmp, 1, 1, pDiskFile) != 1) tmp = 0;
+							tmp = ReadImageByte(nFdcDataOffset);
 							nFdcDataOffset++;
+							AdvanceDataByte();
 						} else {
 							bDiskChanged = 1;
 							tmp = 0;
@@ -900,25 +1032,24 @@ unsigned char FloppyDriveController::Read(unsigned char nPort)
 	return nData;
 }
 
-void FloppyDriveController::Write(unsigned char nPort, unsigned nData)
+void FloppyDriveController::Write(unsigned char nPort, unsigned nData, uint64_t cycle)
 {
+	SyncClock(cycle);
 	UpdateActiveState();
 
 	switch(nPort) {
 		case 0: // 3F0: FDCDMADackIO
 		case 1: // 3F1: FDCDMATcIO
 			if(pDiskFile) {
-				unsigned char tmp = (unsigned char)nData;
-				::fseek(pDiskFile, nFdcDataOffset, SEEK_SET);
-				::fwrite(&tmp, 1, 1, pDiskFile);
+				WriteImageByte(nFdcDataOffset, (uint8_t)nData);
 				nFdcDataOffset++;
 			} else {
 				bDiskChanged = 1;
 			}
+			AdvanceDataByte();
 			bFdcDataBytes--;
 			if(0 == bFdcDataBytes) {
-				// 扇区写入完成，刷新 stdio 缓冲以便其它进程能看到变化
-				if(pDiskFile) ::fflush(pDiskFile);
+				// 扇区写入完成，脏扇区在 FDC 回到空闲时统一回写
 				bFdcCycle = 0;
 				bFdcPhase = FDC_PH_RESULT;
 				nFdcMainStatus |= FDC_MS_DATA_IN; // fdc to host
@@ -982,17 +1113,15 @@ void FloppyDriveController::Write(unsigned char nPort, unsigned nData)
 					switch(bFdcLastCommand) {
 						case 0x05: // WriteData
 							if(pDiskFile) {
-								unsigned char tmp = (unsigned char)nData;
-								::fseek(pDiskFile, nFdcDataOffset, SEEK_SET);
-								::fwrite(&tmp, 1, 1, pDiskFile);
+								WriteImageByte(nFdcDataOffset, (uint8_t)nData);
 								nFdcDataOffset++;
 							} else {
 								bDiskChanged = 1;
 							}
+							AdvanceDataByte();
 							bFdcDataBytes--;
 							if(0 == bFdcDataBytes) {
-								// 扇区写入完成，刷新缓冲，通知 host
-								if(pDiskFile) ::fflush(pDiskFile);
+								// 扇区写入完成，通知 host
 								bFdcCycle = 0;
 								bFdcPhase = FDC_PH_RESULT;
 								nFdcMainStatus |= FDC_MS_DATA_IN; // fdc to host
@@ -1068,6 +1197,9 @@ void FloppyDriveController::FdcHardReset(void)
 	bFdcIrq = 0;
 	bFdcCycle = 0;
 	bFdcPhase = FDC_PH_IDLE;
+
+	_dataReadyCycle = 0;
+	_seekEndCycle = 0;
 }
 
 void FloppyDriveController::FdcSoftReset(void)
@@ -1085,6 +1217,9 @@ void FloppyDriveController::FdcSoftReset(void)
 
 	bFdcCycle = 0;
 	bFdcPhase = FDC_PH_IDLE;
+
+	_dataReadyCycle = 0;
+	_seekEndCycle = 0;
 }
 
 void FloppyDriveController::FdcNop(FloppyDriveController* thiz)
@@ -1117,6 +1252,10 @@ void FloppyDriveController::FdcSpecify(FloppyDriveController* thiz)
 	// [2] HLT/ND
 	int ND = thiz->bFdcCommands[2] & 1;
 
+	thiz->_stepRateTime = thiz->bFdcCommands[1] >> 4;
+	thiz->_headUnloadTime = thiz->bFdcCommands[1] & 0x0F;
+	thiz->_headLoadTime = thiz->bFdcCommands[2] >> 1;
+
 	if(ND)
 		thiz->nFdcMainStatus |= FDC_MS_EXECUTION;
 	else
@@ -1145,19 +1284,22 @@ void FloppyDriveController::FdcWriteData(FloppyDriveController* thiz)
 
 	int LBA;
 
-	LBA = C * 36 + H * 18 + (R - 1);
+	const FloppyGeometry& geometry = thiz->_geometry;
+	LBA = (int)geometry.GetLba(C, H, R);
+
+	thiz->_dataReadyCycle = thiz->ScheduleSectorAccess(C, R);
 
 	thiz->nCurrentLBA = LBA;
 	thiz->nFdcDataOffset = LBA * 512;
 	thiz->bFdcDataBytes = 512;
 
 	R++;
-	if(19 == R) {
+	if(geometry.SectorsPerTrack + 1 == R) {
 		R = 1;
 		H++;
-		if(2 == H) {
+		if(geometry.Heads == H) {
 			C++;
-			if(80 == C)
+			if(geometry.Cylinders == C)
 				C = 0;
 		}
 	}
@@ -1193,20 +1335,23 @@ void FloppyDriveController::FdcReadData(FloppyDriveController* thiz)
 
 	int LBA;
 
-	LBA = C * 36 + H * 18 + (R - 1);
-	if(LBA > 2879) LBA = 2879;
+	const FloppyGeometry& geometry = thiz->_geometry;
+	LBA = (int)geometry.GetLba(C, H, R);
+	if(LBA >= (int)geometry.GetSectorCount()) LBA = (int)geometry.GetSectorCount() - 1;
+
+	thiz->_dataReadyCycle = thiz->ScheduleSectorAccess(C, R);
 
 	thiz->nCurrentLBA = LBA;
 	thiz->nFdcDataOffset = LBA * 512;
 	thiz->bFdcDataBytes = 512;
 
 	R++;
-	if(19 == R) {
+	if(geometry.SectorsPerTrack + 1 == R) {
 		R = 1;
 		H++;
-		if(2 == H) {
+		if(geometry.Heads == H) {
 			C++;
-			if(80 == C)
+			if(geometry.Cylinders == C)
 				C = 0;
 		}
 	}
@@ -1239,6 +1384,9 @@ void FloppyDriveController::FdcRecalibrate(FloppyDriveController* thiz)
 
 	thiz->nFDCStatus[0] = US ? (FDC_S0_SE | FDC_S0_IC0) : FDC_S0_SE;
 
+	thiz->_seekEndCycle = thiz->_cycle + thiz->_headCylinder * thiz->GetStepCycles();
+	thiz->_headCylinder = 0;
+
 	thiz->bFdcIrq = 1;
 	thiz->bFdcPhase = FDC_PH_IDLE;
 }
@@ -1323,14 +1471,12 @@ void FloppyDriveController::FdcFormatTrack(FloppyDriveController* thiz)
 	unsigned char GPL = thiz->bFdcCommands[4]; // GPL: gap 3 length
 	unsigned char D = thiz->bFdcCommands[5]; // D: filler pattern to write in each byte
 
-	// 直接将填充字节写入磁盘镜像文件（扇区 512 字节）
+	// 将填充字节写入内存镜像（扇区 512 字节），回写时机与普通扇区写入相同
 	if(thiz->pDiskFile) {
-		unsigned char buf[512];
-		memset(buf, D, 512);
-		::fseek(thiz->pDiskFile, thiz->nCurrentLBA * 512, SEEK_SET);
-		::fwrite(buf, 512, 1, thiz->pDiskFile);
-		// 格式化写入后立即刷新以便其它程序能看到变化
-		::fflush(thiz->pDiskFile);
+		unsigned char buf[SectorSize];
+		memset(buf, D, SectorSize);
+		thiz->WriteImageBytes(thiz->nCurrentLBA * SectorSize, buf, SectorSize);
+		thiz->_fatVolume.NotifyImageWrite(thiz->nCurrentLBA * SectorSize, SectorSize);
 	} else {
 		// 没有磁盘，忽略
 	}
@@ -1345,6 +1491,9 @@ void FloppyDriveController::FdcFormatTrack(FloppyDriveController* thiz)
 	thiz->bFdcResults[5] = 0;
 	thiz->bFdcResults[6] = N; // bytes per sector
 
+	// 格式化从索引孔开始，持续一整圈
+	thiz->_dataReadyCycle = thiz->_cycle + (uint64_t)thiz->_clockRate * 60 / DiskRpm;
+
 	thiz->bFdcIrq = 1;
 
 	thiz->bFdcPhase = FDC_PH_RESULT;
@@ -1366,6 +1515,9 @@ void FloppyDriveController::FdcSeek(FloppyDriveController* thiz)
 
 	thiz->nFdcCylinder = NCN;
 
+	thiz->_seekEndCycle = thiz->_cycle + std::abs((int)NCN - (int)thiz->_headCylinder) * thiz->GetStepCycles();
+	thiz->_headCylinder = NCN;
+
 	//	thiz->nCurrentLBA = NCN * 36 + HD * 18; for format_track command
 
 	thiz->nFDCStatus[0] = FDC_S0_SE;
@@ -1404,6 +1556,10 @@ void FloppyDriveController::UpdateActiveState()
 	int active = (pDiskFile && (bFdcPhase != FDC_PH_IDLE || bFdcDataBytes > 0)) ? 1 : 0;
 	if(active != bFdcActiveState) {
 		bFdcActiveState = active;
+		if(!active && _dirtySectorCount > 0) {
+			// 一次读/写操作结束，回写本次被修改的扇区，以便其它进程能看到变化
+			SaveDiskImage();
+		}
 		if(_emu) {
 			_emu->GetNotificationManager()->SendNotification(active ? ConsoleNotificationType::FloppyIoStarted : ConsoleNotificationType::FloppyIoStopped);
 		}
@@ -1421,181 +1577,22 @@ int FloppyDriveController::IsActive()
 }
 
 /**
- * 将主机缓冲区写入当前加载的 FAT12 镜像（写入根目录）。
- * 简化实现：仅支持写入根目录（不处理长文件名 LFN），目标文件名会被转换为短名 8.3，
- * 若镜像中存在同名短名文件则覆盖其内容。
+ * 将主机缓冲区写入当前加载的 FAT12 镜像（写入根目录，filename 中的路径部分被忽略）。
+ * 根目录中存在同名（长名或短名）文件时覆盖其内容，否则新建目录项。
  */
 int FloppyDriveController::AddFileFromBuffer(const char* filename, const unsigned char* data, unsigned int length)
 {
-	if(!pDiskFile || !filename) return 0;
-	// 不在 I/O 活动期间写入，以避免与正在运行的 FDC 操作冲突
-	if(IsActive()) return 0;
-
-	FilePositionGuard guard(pDiskFile);
-
-	Fat12Context ctx;
-	if(!LoadFat12Context(pDiskFile, nDiskSize, ctx)) {
-		return 0;
-	}
+	if(!filename || (!data && length > 0)) return 0;
 
-	vector<uint8_t> fatData;
-	if(!LoadFatTable(pDiskFile, ctx, fatData)) {
-		return 0;
-	}
-
-	// 读取根目录表
-	if(ctx.rootEntryCount == 0) return 0;
-	vector<uint8_t> rootBuffer((size_t)ctx.rootEntryCount * 32);
-	if(!ReadBytes(pDiskFile, (long)ctx.rootDirOffset, rootBuffer.data(), rootBuffer.size())) {
-		return 0;
-	}
-
-	// 计算短文件名（简单实现：取文件名部分，转大写，非字母数字替换为 '_'，截断）
 	string name(filename);
 	size_t pos = name.find_last_of("/\\");
 	if(pos != string::npos) name = name.substr(pos + 1);
-	// 转为 UTF-8 的 ASCII 子集（简单处理）并大写
-	string up;
-	for(char ch : name) up.push_back((char)toupper((unsigned char)ch));
-
-	string base = up;
-	string ext = "";
-	size_t dot = up.find_last_of('.');
-	if(dot != string::npos) {
-		ext = base.substr(dot + 1);
-		base = base.substr(0, dot);
-	}
-
-	string shortName(8, ' ');
-	string shortExt(3, ' ');
-	int idx = 0;
-	for(char ch : base) {
-		if(idx >= 8) break;
-		char c = ch;
-		if(!((c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9'))) c = '_';
-		shortName[idx++] = c;
-	}
-	idx = 0;
-	for(char ch : ext) {
-		if(idx >= 3) break;
-		char c = ch;
-		if(!((c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9'))) c = '_';
-		shortExt[idx++] = c;
-	}
-
-	// 查找可用目录项或者同名项以便覆盖
-	int freeEntryIndex = -1;
-	for(uint32_t i = 0; i < ctx.rootEntryCount; i++) {
-		uint8_t first = rootBuffer[i * 32];
-		if(first == 0x00) {
-			if(freeEntryIndex == -1) freeEntryIndex = (int)i;
-			break; // 后续均为空
-		}
-		if(first == 0xE5) {
-			if(freeEntryIndex == -1) freeEntryIndex = (int)i;
-			continue;
-		}
-		uint8_t attr = rootBuffer[i * 32 + 11];
-		if(attr == 0x0F) continue; // LFN
-
-		bool match = true;
-		for(int k = 0; k < 8; k++) {
-			if(rootBuffer[i * 32 + k] != (uint8_t)shortName[k]) { match = false; break; }
-		}
-		for(int k = 0; k < 3 && match; k++) {
-			if(rootBuffer[i * 32 + 8 + k] != (uint8_t)shortExt[k]) { match = false; break; }
-		}
-		if(match) {
-			freeEntryIndex = (int)i; // 覆盖该条目
-			// 释放原有簇链
-			uint16_t firstCluster = (uint16_t)(rootBuffer[i * 32 + 26] | (rootBuffer[i * 32 + 27] << 8));
-			if(firstCluster >= 2) {
-				uint16_t cluster = firstCluster;
-				uint32_t maxIter = ctx.totalClusters + 2;
-				uint32_t iter = 0;
-				while(cluster >= 2 && cluster < 0xFF0 && iter++ < maxIter) {
-					uint16_t next = ReadFatValue(fatData, cluster);
-					WriteFatValue(fatData, cluster, 0);
-					if(next >= 0xFF8 || next == 0) break;
-					cluster = next;
-				}
-			}
-			break;
-		}
-	}
-	if(freeEntryIndex == -1) return 0; // 没有可用目录项
-
-	// 计算需要的簇数并寻找空闲簇
-	uint32_t clustersNeeded = 0;
-	if(length > 0) clustersNeeded = (length + ctx.bytesPerCluster - 1) / ctx.bytesPerCluster;
-
-	vector<uint16_t> freeClusters;
-	for(uint16_t c = 2; c < (uint16_t)(ctx.totalClusters + 2) && freeClusters.size() < clustersNeeded; ++c) {
-		if(ReadFatValue(fatData, c) == 0) freeClusters.push_back(c);
-	}
-	if(freeClusters.size() < clustersNeeded) return 0; // 空间不足
-
-	// 将簇链写入 FAT（12-bit 编码）
-	for(size_t i = 0; i < freeClusters.size(); ++i) {
-		uint16_t cur = freeClusters[i];
-		uint16_t val = (uint16_t)((i + 1 < freeClusters.size()) ? freeClusters[i + 1] : 0xFFF);
-		if(!WriteFatValue(fatData, cur, val)) return 0;
-	}
-
-	// 将文件数据写到相应簇
-	const unsigned char* ptr = data;
-	size_t remaining = length;
-	for(size_t i = 0; i < freeClusters.size(); ++i) {
-		uint16_t cluster = freeClusters[i];
-		long offset = (long)(ctx.dataOffset + (uint32_t)(cluster - 2) * ctx.bytesPerCluster);
-		if(::fseek(pDiskFile, offset, SEEK_SET) != 0) return 0;
-		size_t toWrite = remaining > ctx.bytesPerCluster ? ctx.bytesPerCluster : remaining;
-		if(toWrite > 0) {
-			if(::fwrite(ptr, 1, toWrite, pDiskFile) != toWrite) return 0;
-			ptr += toWrite;
-			remaining -= toWrite;
-		}
-		// 若簇未被填满，补零
-		if(toWrite < ctx.bytesPerCluster) {
-			uint32_t fill = ctx.bytesPerCluster - (uint32_t)toWrite;
-			static vector<uint8_t> zeroBuf;
-			if(zeroBuf.size() < fill) zeroBuf.resize(fill);
-			if(::fwrite(zeroBuf.data(), 1, fill, pDiskFile) != fill) return 0;
-		}
-	}
-
-	// 将修改后的 FAT 写回磁盘（所有 FAT 副本）
-	uint32_t fatSize = ctx.sectorsPerFat * ctx.bytesPerSector;
-	for(uint32_t copy = 0; copy < ctx.fatCount; ++copy) {
-		long fatPos = (long)(ctx.fatOffset + copy * fatSize);
-		if(::fseek(pDiskFile, fatPos, SEEK_SET) != 0) return 0;
-		if(::fwrite(fatData.data(), 1, fatData.size(), pDiskFile) != fatData.size()) return 0;
-	}
-
-	// 写入或覆盖根目录项
-	uint8_t entry[32];
-	memset(entry, 0, sizeof(entry));
-	memcpy(entry, shortName.c_str(), 8);
-	memcpy(entry + 8, shortExt.c_str(), 3);
-	entry[11] = 0x20; // Archive
-	uint16_t firstClusterAssigned = freeClusters.empty() ? 0 : freeClusters[0];
-	entry[26] = (uint8_t)(firstClusterAssigned & 0xFF);
-	entry[27] = (uint8_t)((firstClusterAssigned >> 8) & 0xFF);
-	entry[28] = (uint8_t)(length & 0xFF);
-	entry[29] = (uint8_t)((length >> 8) & 0xFF);
-	entry[30] = (uint8_t)((length >> 16) & 0xFF);
-	entry[31] = (uint8_t)((length >> 24) & 0xFF);
-	SetFatTimestampFields(entry);
-
-	memcpy(rootBuffer.data() + freeEntryIndex * 32, entry, 32);
-
-	// 将根目录写回文件
-	if(::fseek(pDiskFile, ctx.rootDirOffset, SEEK_SET) != 0) return 0;
-	if(::fwrite(rootBuffer.data(), 1, rootBuffer.size(), pDiskFile) != rootBuffer.size()) return 0;
-
-	::fflush(pDiskFile);
 
-	return 1;
+	vector<FileBatchOp> ops(1);
+	ops[0].Type = FileBatchOpType::WriteFile;
+	ops[0].Path = name;
+	ops[0].Data.assign(data, data + length);
+	return ApplyFileOps(ops);
 }
 
 /**
@@ -1605,29 +1602,11 @@ int FloppyDriveController::AddFileFromBuffer(const char* filename, const unsigne
  */
 int FloppyDriveController::GetFileSize(const char* filename)
 {
-	if(!pDiskFile || !filename) return 0;
-
-	FilePositionGuard guard(pDiskFile);
-
-	Fat12Context ctx;
-	if(!LoadFat12Context(pDiskFile, nDiskSize, ctx)) return 0;
-
-	vector<uint8_t> fatData;
-	if(!LoadFatTable(pDiskFile, ctx, fatData)) return 0;
+	if(!filename || !EnsureFatVolume()) return 0;
 
-	if(ctx.rootEntryCount == 0) return 0;
-	vector<uint8_t> rootBuffer((size_t)ctx.rootEntryCount * 32);
-	if(!ReadBytes(pDiskFile, (long)ctx.rootDirOffset, rootBuffer.data(), rootBuffer.size())) return 0;
-
-	vector<FdcFileNode> children;
-	ParseDirectoryData(pDiskFile, ctx, fatData, rootBuffer.data(), rootBuffer.size(), children);
-
-	uint16_t firstCluster = 0;
-	uint32_t size = 0;
-	if(FindFileNodeByName(children, filename, firstCluster, size)) {
-		return (int)size;
-	}
-	return 0;
+	int32_t index = _fatVolume.FindFile(filename);
+	if(index < 0) return 0;
+	return (int)_fatVolume.GetEntry(index).Size;
 }
 
 /**
@@ -1639,164 +1618,459 @@ int FloppyDriveController::GetFileSize(const char* filename)
  */
 int FloppyDriveController::ReadFileToBuffer(const char* filename, unsigned char* outBuffer, uint32_t maxLength)
 {
-	if(!pDiskFile || !filename || !outBuffer || maxLength == 0) return 0;
+	if(!filename || !outBuffer || maxLength == 0 || !EnsureFatVolume()) return 0;
+
+	int32_t index = _fatVolume.FindFile(filename);
+	if(index < 0) return 0;
+
+	// 数据不完整时仅拷贝可用部分
+	return (int)_fatVolume.ReadFile(_diskImage, _fatVolume.GetEntry(index), outBuffer, maxLength);
+}
 
-	FilePositionGuard guard(pDiskFile);
+/**
+ * 从镜像中删除指定文件。
+ * filename 可以是相对根目录的路径；不含路径且根目录中没有该文件时，按目录树中第一个同名文件处理（与 JSON 中的名称一致）。
+ * 释放文件的簇链，并把短目录项及其 LFN 目录项标记为 0xE5（已删除）。不删除目录。
+ */
+int FloppyDriveController::DeleteFileByName(const char* filename)
+{
+	if(!filename) return 0;
 
-	Fat12Context ctx;
-	if(!LoadFat12Context(pDiskFile, nDiskSize, ctx)) return 0;
+	vector<FileBatchOp> ops(1);
+	ops[0].Type = FileBatchOpType::DeleteFile;
+	ops[0].Path = filename;
+	return ApplyFileOps(ops);
+}
 
-	vector<uint8_t> fatData;
-	if(!LoadFatTable(pDiskFile, ctx, fatData)) return 0;
+int FloppyDriveController::BeginFileBatch()
+{
+	_fileBatch.clear();
+	_fileBatchOpen = true;
+	return 1;
+}
 
-	if(ctx.rootEntryCount == 0) return 0;
-	vector<uint8_t> rootBuffer((size_t)ctx.rootEntryCount * 32);
-	if(!ReadBytes(pDiskFile, (long)ctx.rootDirOffset, rootBuffer.data(), rootBuffer.size())) return 0;
+int FloppyDriveController::QueueWriteFile(const char* path, const unsigned char* data, unsigned int length)
+{
+	if(!_fileBatchOpen || !path || (!data && length > 0)) return 0;
 
-	vector<FdcFileNode> children;
-	ParseDirectoryData(pDiskFile, ctx, fatData, rootBuffer.data(), rootBuffer.size(), children);
+	FileBatchOp op;
+	op.Type = FileBatchOpType::WriteFile;
+	op.Path = path;
+	op.Data.assign(data, data + length);
+	_fileBatch.push_back(std::move(op));
+	return 1;
+}
 
-	uint16_t firstCluster = 0;
-	uint32_t size = 0;
-	if(!FindFileNodeByName(children, filename, firstCluster, size)) return 0;
+int FloppyDriveController::QueueDeleteFile(const char* path)
+{
+	if(!_fileBatchOpen || !path) return 0;
 
-	vector<uint8_t> fileData;
-	if(firstCluster >= 2) {
-		if(!ReadClusterChain(pDiskFile, ctx, fatData, firstCluster, fileData)) return 0;
+	FileBatchOp op;
+	op.Type = FileBatchOpType::DeleteFile;
+	op.Path = path;
+	_fileBatch.push_back(std::move(op));
+	return 1;
+}
+
+int FloppyDriveController::QueueCreateDirectory(const char* path)
+{
+	if(!_fileBatchOpen || !path) return 0;
+
+	FileBatchOp op;
+	op.Type = FileBatchOpType::CreateDirectory;
+	op.Path = path;
+	_fileBatch.push_back(std::move(op));
+	return 1;
+}
+
+int FloppyDriveController::CommitFileBatch()
+{
+	if(!_fileBatchOpen) return 0;
+
+	vector<FileBatchOp> ops = std::move(_fileBatch);
+	_fileBatch.clear();
+	_fileBatchOpen = false;
+	return ApplyFileOps(ops);
+}
+
+void FloppyDriveController::CancelFileBatch()
+{
+	_fileBatch.clear();
+	_fileBatchOpen = false;
+}
+
+// 描述：按顺序执行一组文件操作。所有操作只修改内存镜像与卷索引，FAT 在最后统一写回一次，再回写一次镜像文件。
+//       任意一步失败时恢复到执行前的状态，镜像文件不会被修改。
+int FloppyDriveController::ApplyFileOps(const vector<FileBatchOp>& ops)
+{
+	if(!pDiskFile) return 0;
+	// 不在 I/O 活动期间写入，以避免与正在运行的 FDC 操作冲突
+	if(IsActive()) return 0;
+	if(!EnsureFatVolume()) return 0;
+
+	// 软盘镜像只有 1-2MB，直接保存副本用于回滚
+	vector<uint8_t> imageBackup = _diskImage;
+	vector<uint8_t> dirtyBackup = _dirtySectors;
+	uint32_t dirtyCountBackup = _dirtySectorCount;
+	vector<uint8_t> modifiedBackup = _modifiedSectors;
+	Fat12Volume volumeBackup = _fatVolume;
+
+	bool result = true;
+	for(const FileBatchOp& op : ops) {
+		vector<string> parts;
+		if(!SplitImagePath(op.Path, parts)) {
+			result = false;
+			break;
+		}
+
+		switch(op.Type) {
+			case FileBatchOpType::WriteFile: result = ApplyWriteFile(parts, op.Data); break;
+			case FileBatchOpType::DeleteFile: result = ApplyDeleteFile(parts); break;
+			case FileBatchOpType::CreateDirectory: result = ResolveDirectory(parts, parts.size(), true) != InvalidDirectory; break;
+		}
+		if(!result) {
+			break;
+		}
+	}
+
+	// 所有操作完成后才把 FAT 写回镜像，每个内容变化的 FAT 扇区只写一次
+	if(result) {
+		result = WriteFatCopies();
+	}
+
+	if(!result) {
+		_diskImage = std::move(imageBackup);
+		_dirtySectors = std::move(dirtyBackup);
+		_dirtySectorCount = dirtyCountBackup;
+		_modifiedSectors = std::move(modifiedBackup);
+		_fatVolume = std::move(volumeBackup);
+		return 0;
+	}
+
+	// 把本次修改的扇区回写到文件
+	return SaveDiskImage();
+}
+
+// 描述：把路径按 '/' 或 '\' 拆分为各级名称，忽略空名称与 "."。
+// 返回：路径为空或包含 ".." 时返回 false。
+bool FloppyDriveController::SplitImagePath(const string& path, vector<string>& parts)
+{
+	parts.clear();
+	size_t start = 0;
+	while(start <= path.size()) {
+		size_t end = path.find_first_of("/\\", start);
+		if(end == string::npos) {
+			end = path.size();
+		}
+		string part = path.substr(start, end - start);
+		if(part == "..") {
+			return false;
+		}
+		if(!part.empty() && part != ".") {
+			parts.push_back(part);
+		}
+		start = end + 1;
 	}
+	return !parts.empty();
+}
 
-	uint32_t toCopy = size <= maxLength ? (uint32_t)size : maxLength;
-	if(toCopy > 0) {
-		if(fileData.size() < toCopy) {
-			// 数据不完整，仅拷贝可用部分
-			toCopy = (uint32_t)fileData.size();
+// 描述：从根目录开始逐级查找 parts 的前 count 级目录，create 为 true 时创建不存在的目录。
+// 返回：目录的索引（根目录为 Fat12Volume::RootIndex），路径中有同名文件或创建失败时返回 InvalidDirectory。
+int32_t FloppyDriveController::ResolveDirectory(const vector<string>& parts, size_t count, bool create)
+{
+	int32_t dirIndex = Fat12Volume::RootIndex;
+	for(size_t i = 0; i < count; i++) {
+		int32_t child = _fatVolume.FindChild(dirIndex, parts[i]);
+		if(child < 0) {
+			if(!create) {
+				return InvalidDirectory;
+			}
+			child = CreateSubdirectory(dirIndex, parts[i]);
+			if(child < 0) {
+				return InvalidDirectory;
+			}
+		} else if(!_fatVolume.GetEntry(child).IsDirectory) {
+			return InvalidDirectory;
 		}
-		if(toCopy > 0) memcpy(outBuffer, fileData.data(), toCopy);
+		dirIndex = child;
+	}
+	return dirIndex;
+}
+
+bool FloppyDriveController::ApplyWriteFile(const vector<string>& parts, const vector<uint8_t>& data)
+{
+	int32_t dirIndex = ResolveDirectory(parts, parts.size() - 1, true);
+	if(dirIndex == InvalidDirectory) {
+		return false;
 	}
 
-	return (int)toCopy;
+	const string& name = parts.back();
+	int32_t existingIndex = _fatVolume.FindChild(dirIndex, name);
+	if(existingIndex >= 0 && _fatVolume.GetEntry(existingIndex).IsDirectory) {
+		return false; // 不覆盖同名目录
+	}
+
+	// 覆盖时先释放原有簇链，新数据可以重用这些簇
+	if(existingIndex >= 0 && _fatVolume.GetEntry(existingIndex).FirstCluster >= 2) {
+		_fatVolume.FreeClusterChain(_fatVolume.GetEntry(existingIndex).FirstCluster);
+	}
+
+	uint16_t firstCluster = 0;
+	if(!WriteClusterChain(data.data(), (uint32_t)data.size(), firstCluster)) {
+		return false;
+	}
+
+	if(existingIndex < 0) {
+		return CreateDirectoryEntry(dirIndex, name, 0x20, firstCluster, (uint32_t)data.size()) >= 0;
+	}
+
+	// 保留原有的名称与属性，只更新首簇、大小与修改时间
+	uint32_t entryOffset = _fatVolume.GetEntry(existingIndex).EntryOffset;
+	uint8_t entry[32];
+	memcpy(entry, _diskImage.data() + entryOffset, sizeof(entry));
+	entry[26] = (uint8_t)(firstCluster & 0xFF);
+	entry[27] = (uint8_t)((firstCluster >> 8) & 0xFF);
+	entry[28] = (uint8_t)(data.size() & 0xFF);
+	entry[29] = (uint8_t)((data.size() >> 8) & 0xFF);
+	entry[30] = (uint8_t)((data.size() >> 16) & 0xFF);
+	entry[31] = (uint8_t)((data.size() >> 24) & 0xFF);
+	SetFatTimestampFields(entry);
+	WriteImageBytes(entryOffset, entry, sizeof(entry));
+
+	uint16_t writeTime = (uint16_t)(entry[22] | (entry[23] << 8));
+	uint16_t writeDate = (uint16_t)(entry[24] | (entry[25] << 8));
+	_fatVolume.UpdateEntry(existingIndex, (uint32_t)data.size(), firstCluster, writeTime, writeDate);
+	return true;
 }
 
-	/**
-	 * 从镜像根目录中删除指定文件的实现（仅限根目录）。
-	 * 实现策略：
-	 * 1) 根据 ParseDirectoryData/FindFileNodeByName 查找文件的首簇和大小；
-	 * 2) 在根目录表中找到对应的目录项并将首字节标记为 0xE5（已删除）；
-	 * 3) 释放该文件占用的 FAT 簇链（将 FAT 条目置 0），并写回所有 FAT 副本；
-	 * 4) 将根目录表写回镜像并刷新。
-	 * 仅针对根目录项执行删除（不递归），并在出现 I/O 活动或错误时返回失败。
-	 */
-	int FloppyDriveController::DeleteFileByName(const char* filename)
-	{
-		if(!pDiskFile || !filename) return 0;
-		if(IsActive()) return 0; // 正在 I/O 时拒绝修改
+bool FloppyDriveController::ApplyDeleteFile(const vector<string>& parts)
+{
+	int32_t index = -1;
+	int32_t dirIndex = ResolveDirectory(parts, parts.size() - 1, false);
+	if(dirIndex != InvalidDirectory) {
+		index = _fatVolume.FindChild(dirIndex, parts.back());
+	}
+	if(index < 0 && parts.size() == 1) {
+		index = _fatVolume.FindFile(parts[0]);
+	}
+	if(index < 0 || _fatVolume.GetEntry(index).IsDirectory) {
+		return false;
+	}
+
+	Fat12Volume::Entry entry = _fatVolume.GetEntry(index);
+	if(entry.FirstCluster >= 2) {
+		_fatVolume.FreeClusterChain(entry.FirstCluster);
+	}
 
-		FilePositionGuard guard(pDiskFile);
+	// 标记目录项（包括长文件名项）为已删除
+	uint8_t deletedMark = 0xE5;
+	for(uint32_t lfnOffset : entry.LfnOffsets) {
+		WriteImageBytes(lfnOffset, &deletedMark, 1);
+	}
+	WriteImageBytes(entry.EntryOffset, &deletedMark, 1);
 
-		Fat12Context ctx;
-		if(!LoadFat12Context(pDiskFile, nDiskSize, ctx)) return 0;
+	_fatVolume.RemoveEntry(index);
+	return true;
+}
 
-		vector<uint8_t> fatData;
-		if(!LoadFatTable(pDiskFile, ctx, fatData)) return 0;
+// 描述：在 FAT 中分配 count 个簇并串成一条簇链（以 0xFFF 结尾）。
+bool FloppyDriveController::AllocateClusters(uint32_t count, vector<uint16_t>& clusters)
+{
+	if(!_fatVolume.FindFreeClusters(count, clusters)) {
+		return false;
+	}
+	for(size_t i = 0; i < clusters.size(); i++) {
+		_fatVolume.SetFatValue(clusters[i], (uint16_t)(i + 1 < clusters.size() ? clusters[i + 1] : 0xFFF));
+	}
+	return true;
+}
 
-		if(ctx.rootEntryCount == 0) return 0;
-		vector<uint8_t> rootBuffer((size_t)ctx.rootEntryCount * 32);
-		if(!ReadBytes(pDiskFile, (long)ctx.rootDirOffset, rootBuffer.data(), rootBuffer.size())) return 0;
+// 描述：分配簇链并写入数据，簇中未填满的部分补零。长度为 0 时不分配簇，firstCluster 为 0。
+bool FloppyDriveController::WriteClusterChain(const uint8_t* data, uint32_t length, uint16_t& firstCluster)
+{
+	const Fat12Layout& ctx = _fatVolume.GetLayout();
+	firstCluster = 0;
 
-		// 使用现有解析逻辑寻找文件的首簇与大小
-		vector<FdcFileNode> children;
-		ParseDirectoryData(pDiskFile, ctx, fatData, rootBuffer.data(), rootBuffer.size(), children);
+	vector<uint16_t> clusters;
+	if(!AllocateClusters((length + ctx.bytesPerCluster - 1) / ctx.bytesPerCluster, clusters)) {
+		return false; // 空间不足
+	}
 
-		uint16_t firstCluster = 0;
-		uint32_t size = 0;
-		if(!FindFileNodeByName(children, filename, firstCluster, size)) {
-			return 0; // 未找到
+	uint32_t written = 0;
+	for(uint16_t cluster : clusters) {
+		uint32_t offset = _fatVolume.GetClusterOffset(cluster);
+		if(offset == 0) {
+			return false;
+		}
+		uint32_t toWrite = std::min(ctx.bytesPerCluster, length - written);
+		memcpy(_diskImage.data() + offset, data + written, toWrite);
+		if(toWrite < ctx.bytesPerCluster) {
+			memset(_diskImage.data() + offset + toWrite, 0, ctx.bytesPerCluster - toWrite);
 		}
+		MarkSectorsDirty(offset, ctx.bytesPerCluster);
+		written += toWrite;
+	}
 
-		// 在根目录原始表中定位对应的短目录项索引（跳过 LFN 条目）
-		int entryIndex = -1;
-		for(uint32_t i = 0; i < ctx.rootEntryCount; ++i) {
-			uint8_t first = rootBuffer[i * 32];
-			if(first == 0x00) break;
-			uint8_t attr = rootBuffer[i * 32 + 11];
-			if(attr == 0x0F) continue; // LFN
-			uint16_t fc = (uint16_t)(rootBuffer[i * 32 + 26] | (rootBuffer[i * 32 + 27] << 8));
-			uint32_t fsize = (uint32_t)(rootBuffer[i * 32 + 28] | (rootBuffer[i * 32 + 29] << 8) | (rootBuffer[i * 32 + 30] << 16) | (rootBuffer[i * 32 + 31] << 24));
-			if(fc == firstCluster && fsize == size) {
-				entryIndex = (int)i;
-				break;
+	if(!clusters.empty()) {
+		firstCluster = clusters[0];
+	}
+	return true;
+}
+
+// 描述：在目录中查找 count 个连续的空闲目录项（0x00 或 0xE5），子目录空间不足时追加新簇。
+bool FloppyDriveController::FindFreeDirectorySlots(int32_t dirIndex, uint32_t count, vector<uint32_t>& slots)
+{
+	vector<uint32_t> offsets;
+	if(!_fatVolume.GetDirectorySlots(dirIndex, offsets)) {
+		return false;
+	}
+
+	size_t runStart = 0;
+	size_t runLength = 0;
+	bool pastEnd = false;
+	for(size_t i = 0; i < offsets.size() && runLength < count; i++) {
+		const uint8_t* slot = _diskImage.data() + offsets[i];
+		// 0x00 表示目录结束，之后的项都视为空闲
+		pastEnd = pastEnd || slot[0] == 0x00;
+		if(!pastEnd && slot[0] != 0xE5) {
+			runLength = 0;
+			continue;
+		}
+		if(runLength == 0) {
+			// 没有 LFN 的目录项不能紧跟在未删除的 LFN 项之后，否则重新解析时会被当成同一个文件
+			const uint8_t* prev = i > 0 ? _diskImage.data() + offsets[i - 1] : nullptr;
+			if(count == 1 && prev && prev[11] == 0x0F && prev[0] != 0xE5) {
+				continue;
 			}
+			runStart = i;
+		}
+		runLength++;
+	}
+
+	if(runLength < count) {
+		if(dirIndex == Fat12Volume::RootIndex) {
+			return false; // 根目录大小固定
 		}
 
-		// 若未通过簇/大小定位到目录项，则回退使用长名/短名解析匹配（复制 ParseDirectoryData 的解析方式）
-		if(entryIndex == -1) {
-			vector<std::u16string> longNameParts;
-			for(uint32_t i = 0; i < ctx.rootEntryCount; ++i) {
-				const uint8_t* entry = rootBuffer.data() + i * 32;
-				uint8_t first = entry[0];
-				if(first == 0x00) break;
-				uint8_t attr = entry[11];
-				if(attr == 0x0F) {
-					uint8_t sequence = entry[0] & 0x1F;
-					if((entry[0] & 0x40) != 0) {
-						longNameParts.clear();
-						longNameParts.resize(sequence);
-					}
-					if(sequence >= 1 && sequence <= longNameParts.size()) {
-						longNameParts[sequence - 1] = ExtractLongNameSegment(entry);
-					}
-					continue;
-				}
-				if(first == 0xE5) { longNameParts.clear(); continue; }
-				if(attr & 0x08) { longNameParts.clear(); continue; }
+		// 只有位于目录末尾的空闲项可以与新簇连成一段
+		bool trailing = runLength > 0 && runStart + runLength == offsets.size();
+		if(!trailing) {
+			runStart = offsets.size();
+			runLength = 0;
+		}
 
-				string name;
-				if(!longNameParts.empty()) {
-					name = BuildLongName(longNameParts);
-				}
-				if(name.empty()) {
-					name = BuildShortName(entry, entry + 8);
-				}
-				longNameParts.clear();
+		const Fat12Layout& ctx = _fatVolume.GetLayout();
+		uint32_t slotsPerCluster = ctx.bytesPerCluster / 32;
+		vector<uint16_t> clusters;
+		if(!AllocateClusters((uint32_t)((count - runLength + slotsPerCluster - 1) / slotsPerCluster), clusters)) {
+			return false;
+		}
 
-				if(name == filename) {
-					entryIndex = (int)i;
-					break;
-				}
+		// 把新簇链接到目录簇链的末尾
+		uint16_t lastCluster = _fatVolume.GetEntry(dirIndex).FirstCluster;
+		for(uint32_t i = 0; i < ctx.totalClusters; i++) {
+			uint16_t next = _fatVolume.GetFatValue(lastCluster);
+			if(next < 2 || next >= 0xFF0) {
+				break;
 			}
+			lastCluster = next;
 		}
+		_fatVolume.SetFatValue(lastCluster, clusters[0]);
 
-		if(entryIndex == -1) return 0; // 仍未找到
-
-		// 释放簇链（若存在首簇）
-		if(firstCluster >= 2) {
-			uint16_t cluster = firstCluster;
-			uint32_t maxIter = ctx.totalClusters + 2;
-			uint32_t iter = 0;
-			while(cluster >= 2 && cluster < 0xFF0 && iter++ < maxIter) {
-				uint16_t next = ReadFatValue(fatData, cluster);
-				if(!WriteFatValue(fatData, cluster, 0)) return 0;
-				if(next >= 0xFF8 || next == 0) break;
-				cluster = next;
+		vector<uint8_t> zero(ctx.bytesPerCluster, 0);
+		for(uint16_t cluster : clusters) {
+			uint32_t offset = _fatVolume.GetClusterOffset(cluster);
+			if(offset == 0) {
+				return false;
+			}
+			WriteImageBytes(offset, zero.data(), zero.size());
+			_fatVolume.AddDirectoryCluster(cluster);
+			for(uint32_t i = 0; i < slotsPerCluster; i++) {
+				offsets.push_back(offset + i * 32);
 			}
 		}
+	}
 
-		// 标记目录项为已删除
-		rootBuffer[entryIndex * 32] = 0xE5;
+	slots.assign(offsets.begin() + runStart, offsets.begin() + runStart + count);
+	return true;
+}
 
-		// 将修改后的根目录写回
-		if(::fseek(pDiskFile, ctx.rootDirOffset, SEEK_SET) != 0) return 0;
-		if(::fwrite(rootBuffer.data(), 1, rootBuffer.size(), pDiskFile) != rootBuffer.size()) return 0;
+// 描述：在目录中新建一个目录项（按 VFAT 规则生成短文件名，需要时写入 LFN 项），并加入卷索引。
+// 返回：新目录项在卷索引中的索引，失败返回 -1。
+int32_t FloppyDriveController::CreateDirectoryEntry(int32_t dirIndex, const string& name, uint8_t attributes, uint16_t firstCluster, uint32_t size)
+{
+	uint8_t entry[32];
+	memset(entry, 0, sizeof(entry));
+	bool needLongName = false;
+	if(!_fatVolume.GenerateShortName(dirIndex, name, entry, needLongName)) {
+		return -1;
+	}
 
-		// 将修改后的 FAT 写回所有副本
-		uint32_t fatSize = ctx.sectorsPerFat * ctx.bytesPerSector;
-		for(uint32_t copy = 0; copy < ctx.fatCount; ++copy) {
-			long fatPos = (long)(ctx.fatOffset + copy * fatSize);
-			if(::fseek(pDiskFile, fatPos, SEEK_SET) != 0) return 0;
-			if(::fwrite(fatData.data(), 1, fatData.size(), pDiskFile) != fatData.size()) return 0;
-		}
+	vector<uint8_t> lfnEntries;
+	if(needLongName && !Fat12Volume::BuildLongNameEntries(name, entry, lfnEntries)) {
+		return -1;
+	}
 
-		::fflush(pDiskFile);
+	uint32_t lfnCount = (uint32_t)(lfnEntries.size() / 32);
+	vector<uint32_t> slots;
+	if(!FindFreeDirectorySlots(dirIndex, lfnCount + 1, slots)) {
+		return -1; // 没有可用目录项
+	}
 
-		return 1;
-	}
\ No newline at end of file
+	entry[11] = attributes;
+	entry[26] = (uint8_t)(firstCluster & 0xFF);
+	entry[27] = (uint8_t)((firstCluster >> 8) & 0xFF);
+	entry[28] = (uint8_t)(size & 0xFF);
+	entry[29] = (uint8_t)((size >> 8) & 0xFF);
+	entry[30] = (uint8_t)((size >> 16) & 0xFF);
+	entry[31] = (uint8_t)((size >> 24) & 0xFF);
+	SetFatTimestampFields(entry);
+
+	for(uint32_t i = 0; i < lfnCount; i++) {
+		WriteImageBytes(slots[i], lfnEntries.data() + i * 32, 32);
+	}
+	WriteImageBytes(slots[lfnCount], entry, sizeof(entry));
+
+	Fat12Volume::Entry newEntry;
+	newEntry.ShortName = Fat12Volume::BuildShortName(entry);
+	newEntry.Name = needLongName ? name : newEntry.ShortName;
+	newEntry.IsDirectory = (attributes & 0x10) != 0;
+	newEntry.Size = size;
+	newEntry.FirstCluster = firstCluster;
+	newEntry.WriteTime = (uint16_t)(entry[22] | (entry[23] << 8));
+	newEntry.WriteDate = (uint16_t)(entry[24] | (entry[25] << 8));
+	newEntry.EntryOffset = slots[lfnCount];
+	newEntry.LfnOffsets.assign(slots.begin(), slots.begin() + lfnCount);
+	return _fatVolume.AddEntry(dirIndex, std::move(newEntry));
+}
+
+// 描述：创建子目录：分配一个簇并写入 "." 与 ".." 目录项，再在父目录中新建目录项。
+int32_t FloppyDriveController::CreateSubdirectory(int32_t parentIndex, const string& name)
+{
+	const Fat12Layout& ctx = _fatVolume.GetLayout();
+	vector<uint16_t> clusters;
+	if(!AllocateClusters(1, clusters)) {
+		return -1;
+	}
+	uint32_t offset = _fatVolume.GetClusterOffset(clusters[0]);
+	if(offset == 0) {
+		return -1;
+	}
+
+	vector<uint8_t> dirData(ctx.bytesPerCluster, 0);
+	uint16_t parentCluster = parentIndex == Fat12Volume::RootIndex ? 0 : _fatVolume.GetEntry(parentIndex).FirstCluster;
+	for(int i = 0; i < 2; i++) {
+		uint8_t* entry = dirData.data() + i * 32;
+		uint16_t cluster = i == 0 ? clusters[0] : parentCluster;
+		memset(entry, ' ', 11);
+		memset(entry, '.', i + 1);
+		entry[11] = 0x10;
+		entry[26] = (uint8_t)(cluster & 0xFF);
+		entry[27] = (uint8_t)((cluster >> 8) & 0xFF);
+		SetFatTimestampFields(entry);
+	}
+	WriteImageBytes(offset, dirData.data(), dirData.size());
+	_fatVolume.AddDirectoryCluster(clusters[0]);
+
+	return CreateDirectoryEntry(parentIndex, name, 0x10, clusters[0], 0);
+}
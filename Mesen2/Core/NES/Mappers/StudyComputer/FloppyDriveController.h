@@ -1,10 +1,14 @@
 ﻿#include <stdio.h>
 #include <string>
+#include <vector>
+#include "Utilities/ISerializable.h"
+#include "NES/Mappers/StudyComputer/Fat12Volume.h"
+#include "NES/Mappers/StudyComputer/FloppyImage.h"
 
 // 预声明 Emulator，用于发送通知
 class Emulator;
 
-class FloppyDriveController
+class FloppyDriveController : public ISerializable
 {
 public:
 	/**
@@ -14,8 +18,18 @@ public:
 	FloppyDriveController(Emulator* emu);
 	~FloppyDriveController();
 
-	// 加载磁盘
+	// 加载磁盘（原始镜像、IMD 镜像或 zip/7z 压缩包中的镜像，见 FloppyImageLoader）
+	// 只有未压缩的原始镜像会回写修改，其它格式以只保存在内存中的覆盖层方式加载，可用 ExportDiskImage 另存
 	int LoadDiskImage(const char* fname);
+	/**
+	 * 以覆盖层（写时复制）模式加载磁盘：基础镜像只读打开，模拟器与宿主侧的写入只保存在覆盖层中，
+	 * 多个模拟器实例可以同时使用同一个基础镜像。
+	 * @param basePath 基础镜像路径
+	 * @param deltaPath 差异文件路径，为空时覆盖层只保存在内存中；文件已存在时继续使用其中的修改
+	 *                  （文件头记录的基础镜像大小与 CRC 不匹配时加载失败）
+	 * @return 返回 1 表示成功，0 表示失败
+	 */
+	int LoadDiskImageOverlay(const char* basePath, const char* deltaPath);
 	// 弹出磁盘
 	int Eject();
 	// 保存磁盘
@@ -26,12 +40,20 @@ public:
 	int GetDirectoryTreeJson(std::string& outJson);
 
 	int IsPresent() { return (pDiskFile != nullptr); }
+	int IsOverlayMode() { return _overlayMode ? 1 : 0; }
+
+	// 覆盖层操作（仅覆盖层模式）：提交 - 把覆盖层写入基础镜像后清空（基础镜像不是原始镜像时失败）；丢弃 - 恢复为基础镜像的内容
+	int CommitOverlay();
+	int DiscardOverlay();
+	// 把当前磁盘内容（含覆盖层）导出为完整的镜像文件
+	int ExportDiskImage(const char* filePath);
+	const FloppyGeometry& GetGeometry() const { return _geometry; }
 	// 返回当前软驱是否处于读/写活动中（1: 活动中, 0: 空闲）
 	int IsActive();
 
 	/**
 	 * 将主机内存中的文件数据写入当前加载的 FAT12 镜像（根目录下）。
-	 * @param filename 要在镜像中创建/覆盖的目标文件名（仅文件名，不含路径），会被转换为短文件名 (8.3)
+	 * @param filename 要在镜像中创建/覆盖的目标文件名（仅文件名，不含路径），按 VFAT 规则生成短文件名并保存长文件名
 	 * @param data 指向文件内容的字节缓冲区
 	 * @param length 缓冲区长度（字节）
 	 * @return 返回 1 表示成功，0 表示失败
@@ -55,13 +77,26 @@ public:
 	int ReadFileToBuffer(const char* filename, unsigned char* outBuffer, uint32_t maxLength);
 
 	/**
-	 * 从镜像中删除指定文件（仅支持根目录，支持短/长名匹配）。
-	 * 不递归删除子目录，也不额外处理长文件名条目的复杂清理（与现有写入行为保持一致）。
-	 * @param filename 要删除的文件名（与 GetFileSize/ReadFileToBuffer 支持相同的匹配规则）
+	 * 从镜像中删除指定文件（可位于任意目录，支持短/长名匹配），同时将其长文件名目录项标记为已删除。
+	 * 不删除目录。
+	 * @param filename 要删除的文件名或相对根目录的路径（与 GetFileSize/ReadFileToBuffer 支持相同的匹配规则）
 	 * @return 返回 1 表示成功，0 表示失败（例如镜像未加载、正在 I/O、文件不存在或写回失败）。
 	 */
 	int DeleteFileByName(const char* filename);
 
+	/**
+	 * 批量文件操作：BeginFileBatch 之后排队的写入/删除/建目录操作只在 CommitFileBatch 时按顺序执行，
+	 * FAT 与镜像文件各只回写一次；任一操作失败时整批回滚，镜像保持提交前的状态。
+	 * 路径相对根目录，以 '/' 或 '\' 分隔，写入时自动创建不存在的子目录，同名文件被覆盖。
+	 * 以下函数均返回 1 表示成功，0 表示失败（未调用 BeginFileBatch 时排队操作失败）。
+	 */
+	int BeginFileBatch();
+	int QueueWriteFile(const char* path, const unsigned char* data, unsigned int length);
+	int QueueDeleteFile(const char* path);
+	int QueueCreateDirectory(const char* path);
+	int CommitFileBatch();
+	void CancelFileBatch();
+
 	/**
 	 * 获取当前加载的磁盘镜像路径（UTF-8 编码）。
 	 * 返回指向内部缓冲区的只读 C 字符串，调用者不得释放或修改该指针所指向的数据。
@@ -69,13 +104,29 @@ public:
 	const char* GetDiskImagePath() const { return szDiskName; }
 
 	// IO: nPort: 0-7
-	unsigned char Read(unsigned char nPort);
-	void Write(unsigned char nPort, unsigned nData);
+	// cycle: 访问发生时的 CPU 周期计数（NesConsole::GetMasterClock），用于精确时序模式下判断命令是否已完成
+	unsigned char Read(unsigned char nPort, uint64_t cycle);
+	void Write(unsigned char nPort, unsigned nData, uint64_t cycle);
+
+	/**
+	 * 设置时序模式。
+	 * 即时模式（默认）下所有命令在写入最后一个命令字节时立即完成；
+	 * 精确模式下按 Specify 设置的步进时间寻道、按 300 RPM 计算旋转延迟、按端口 0x3F7 设置的数据速率逐字节传输，
+	 * 在此之前 IRQ、主状态寄存器的 RQM 与 DRQ 保持无效。
+	 * clockRate: 每秒的 CPU 周期数（NesConsole::GetMasterClockRate）
+	 */
+	void SetTimingMode(bool accurate, uint32_t clockRate);
 
 	int SetWriteProtect(int bWP) { return 0; }
 	int CheckIRQ() { return bFdcIrq; }
 	void FdcHardReset(void);
 
+	/**
+	 * 保存/恢复控制器状态（相位、命令/结果缓冲、柱面、数据偏移等）以及自加载镜像以来内容发生变化的扇区。
+	 * 读档时只有当前镜像与存档时加载的是同一镜像（大小与 CRC 一致）才会恢复扇区内容。
+	 */
+	void Serialize(Serializer& s) override;
+
 	// Commands
 	static void FdcNop(FloppyDriveController* thiz);
 	static void FdcReadTrack(FloppyDriveController* thiz);
@@ -200,7 +251,7 @@ protected:
 
 	int			   nCurrentLBA;
 
-	// 使用文件句柄 pDiskFile 代替内存镜像缓冲区
+	// pDiskFile 仅用于加载与回写，扇区读写均在内存镜像 _diskImage 上完成
 
 	// 磁盘变更标志：插入或弹出时设置，读取端口 0x3F7 时报告并清除
 	int            bDiskChanged;
@@ -217,4 +268,126 @@ private:
 
 	// 当 I/O 活动状态变化时调用，负责发送 FloppyIoStarted/FloppyIoStopped 通知
 	void UpdateActiveState();
+
+	static constexpr uint32_t SectorSize = 512;
+
+	// 时序模拟：以下截止时间均为绝对 CPU 周期计数，随存档保存
+	bool _accurateTiming = false;
+	uint32_t _clockRate = 1789773;
+	// 最近一次端口访问时的 CPU 周期
+	uint64_t _cycle = 0;
+	// 执行阶段下一个数据字节就绪（最后一个字节之后为结果就绪）的周期
+	uint64_t _dataReadyCycle = 0;
+	// Seek/Recalibrate 完成并产生 IRQ 的周期
+	uint64_t _seekEndCycle = 0;
+	// 超过该周期后磁头卸载，下次读写需要重新加载磁头
+	uint64_t _headUnloadCycle = 0;
+	// 磁头实际所在的柱面（nFdcCylinder 为 Seek 命令设置的逻辑柱面）
+	uint8_t _headCylinder = 0;
+	// Specify 命令的 SRT/HUT/HLT 字段，默认值与 BIOS 常用的 "03 DF 02" 相同
+	uint8_t _stepRateTime = 0x0D;
+	uint8_t _headUnloadTime = 0x0F;
+	uint8_t _headLoadTime = 0x01;
+
+	static constexpr uint32_t DiskRpm = 300;
+	static constexpr uint32_t HeadSettleMs = 15;
+
+	void SyncClock(uint64_t cycle);
+	bool IsTimingPending(uint64_t deadline) const { return _accurateTiming && _cycle < deadline; }
+	uint32_t GetDataRate() const;
+	// 把 500kbps 下的毫秒数按当前数据速率换算为 CPU 周期（Specify 的时间参数与数据速率成反比）
+	uint64_t GetScaledCycles(uint32_t msAt500k) const;
+	uint64_t GetByteCycles() const;
+	uint64_t GetStepCycles() const;
+	// 描述：计算寻道到 cylinder、加载磁头并等待扇区 sector 转到磁头下所需的时间。
+	// 返回：扇区第一个字节就绪的周期。
+	uint64_t ScheduleSectorAccess(uint8_t cylinder, uint8_t sector);
+	void AdvanceDataByte();
+
+	// 整个磁盘镜像的内存副本（加载时一次性读入）
+	std::vector<uint8_t> _diskImage;
+	// 每个扇区一个脏标记，SaveDiskImage 时只回写被修改的扇区
+	std::vector<uint8_t> _dirtySectors;
+	uint32_t _dirtySectorCount = 0;
+
+	// 加载时的镜像内容与其 CRC，用于生成/应用存档中的扇区差异
+	std::vector<uint8_t> _originalImage;
+	uint32_t _originalImageCrc = 0;
+	// 自加载以来被写过的扇区（与 _dirtySectors 不同，回写文件后不会清除）
+	std::vector<uint8_t> _modifiedSectors;
+
+	uint8_t ReadImageByte(uint32_t offset);
+	void WriteImageByte(uint32_t offset, uint8_t value);
+	// 将数据写入内存镜像并标记所覆盖的扇区为脏，越界部分被忽略
+	bool WriteImageBytes(uint32_t offset, const void* data, size_t length);
+	void MarkSectorsDirty(uint32_t offset, size_t length);
+
+	void SerializeDiskDelta(Serializer& s);
+
+	// FAT12 卷索引：宿主侧文件操作直接更新索引，模拟器写入元数据扇区时索引失效并在下次使用时重新加载
+	Fat12Volume _fatVolume;
+	// 上次生成的目录树 JSON 及其对应的索引版本
+	std::string _dirTreeJson;
+	uint32_t _dirTreeJsonVersion = 0;
+
+	bool EnsureFatVolume();
+	bool WriteFatCopies();
+
+	// 覆盖层模式：pDiskFile 只读，写入的扇区保存在 _overlaySectors 中（有差异文件时同时写入 _overlayFile）
+	bool _overlayMode = false;
+	FILE* _overlayFile = nullptr;
+	std::string _overlayPath;
+	// 当前基础镜像内容的 CRC32，写在差异文件头中
+	uint32_t _overlayBaseCrc = 0;
+	// 每个扇区在差异文件中的记录序号，-1 表示没有记录
+	std::vector<int32_t> _overlayRecords;
+	uint32_t _overlayRecordCount = 0;
+	// 内容来自覆盖层（与基础镜像可能不同）的扇区
+	std::vector<uint8_t> _overlaySectors;
+
+	// 当前磁盘的磁道格式，决定 CHS 到 LBA 的换算
+	FloppyGeometry _geometry;
+	// 镜像可以原样写回文件（未压缩的原始镜像）
+	bool _sourceWritable = false;
+	// 解码后的基础镜像（仅用于不能直接从文件按偏移读取的格式，DiscardOverlay 时从这里恢复）
+	std::vector<uint8_t> _baseImage;
+
+	static constexpr uint32_t OverlayRecordSize = 4 + SectorSize;
+
+	int OpenDiskImage(const char* filePath, bool overlay, const char* deltaPath);
+	void CloseDiskFiles();
+	static FILE* OpenOverlayFile(const char* deltaPath, uint32_t baseCrc, std::vector<uint8_t>& image, std::vector<int32_t>& records, std::vector<uint8_t>& overlaySectors, uint32_t& recordCount);
+	int SaveOverlay();
+	bool ResetOverlay(uint32_t baseCrc);
+
+	enum class FileBatchOpType
+	{
+		WriteFile,
+		DeleteFile,
+		CreateDirectory
+	};
+
+	struct FileBatchOp
+	{
+		FileBatchOpType Type = FileBatchOpType::WriteFile;
+		std::string Path;
+		std::vector<uint8_t> Data;
+	};
+
+	std::vector<FileBatchOp> _fileBatch;
+	bool _fileBatchOpen = false;
+
+	// ResolveDirectory 失败时的返回值（RootIndex 为 -1）
+	static constexpr int32_t InvalidDirectory = -2;
+
+	int ApplyFileOps(const std::vector<FileBatchOp>& ops);
+	static bool SplitImagePath(const std::string& path, std::vector<std::string>& parts);
+	int32_t ResolveDirectory(const std::vector<std::string>& parts, size_t count, bool create);
+	bool ApplyWriteFile(const std::vector<std::string>& parts, const std::vector<uint8_t>& data);
+	bool ApplyDeleteFile(const std::vector<std::string>& parts);
+	bool AllocateClusters(uint32_t count, std::vector<uint16_t>& clusters);
+	bool WriteClusterChain(const uint8_t* data, uint32_t length, uint16_t& firstCluster);
+	bool FindFreeDirectorySlots(int32_t dirIndex, uint32_t count, std::vector<uint32_t>& slots);
+	int32_t CreateDirectoryEntry(int32_t dirIndex, const std::string& name, uint8_t attributes, uint16_t firstCluster, uint32_t size);
+	int32_t CreateSubdirectory(int32_t parentIndex, const std::string& name);
 };
\ No newline at end of file
@@ -0,0 +1,206 @@
+﻿#include "pch.h"
+#include <algorithm>
+#include "NES/Mappers/StudyComputer/FloppyImage.h"
+#include "Utilities/ArchiveReader.h"
+#include "Utilities/StringUtilities.h"
+
+static constexpr uint32_t SectorSize = 512;
+
+const std::initializer_list<string> FloppyImageLoader::Extensions = { ".img", ".ima", ".imd", ".vfd", ".flp" };
+
+bool FloppyGeometry::FromImageSize(size_t size, FloppyGeometry& geometry)
+{
+	static constexpr FloppyGeometry standardGeometries[] = {
+		{ 40, 1, 8 },   // 160K
+		{ 40, 1, 9 },   // 180K
+		{ 40, 2, 8 },   // 320K
+		{ 40, 2, 9 },   // 360K
+		{ 80, 2, 9 },   // 720K
+		{ 80, 2, 15 },  // 1.2M
+		{ 80, 2, 18 },  // 1.44M
+		{ 80, 2, 36 },  // 2.88M
+	};
+
+	for(const FloppyGeometry& g : standardGeometries) {
+		if((size_t)g.GetSectorCount() * SectorSize == size) {
+			geometry = g;
+			return true;
+		}
+	}
+	return false;
+}
+
+bool FloppyImageLoader::Load(const string& path, FloppyImage& image)
+{
+	vector<uint8_t> data;
+	if(!ReadSource(path, data, image)) {
+		return false;
+	}
+	return Decode(data, image);
+}
+
+bool FloppyImageLoader::Decode(vector<uint8_t>& data, FloppyImage& image)
+{
+	// 按顺序尝试，原始镜像没有文件头，必须放在最后
+	static const FormatDesc formatTable[] = {
+		{ FloppyImageFormat::Imd, FloppyImageLoader::IsImd, FloppyImageLoader::DecodeImd },
+		{ FloppyImageFormat::Raw, FloppyImageLoader::IsRaw, FloppyImageLoader::DecodeRaw },
+	};
+
+	for(const FormatDesc& desc : formatTable) {
+		if(desc.IsMatch(data)) {
+			image.Format = desc.Format;
+			return desc.Decode(data, image);
+		}
+	}
+	return false;
+}
+
+// 描述：读取镜像文件的全部内容。zip/7z 压缩包中的镜像在这里一次性解压到内存。
+bool FloppyImageLoader::ReadSource(const string& path, vector<uint8_t>& data, FloppyImage& image)
+{
+	vector<string> tokens = StringUtilities::Split(path, '\x1');
+	image.FilePath = tokens[0];
+	image.InnerFile.clear();
+
+	unique_ptr<ArchiveReader> reader = ArchiveReader::GetReader(image.FilePath);
+	if(reader) {
+		string innerFile = tokens.size() > 1 ? tokens[1] : "";
+		if(innerFile.empty()) {
+			vector<string> files = reader->GetFileList(Extensions);
+			if(files.empty()) {
+				return false;
+			}
+			innerFile = files[0];
+		}
+		image.InnerFile = innerFile;
+		return reader->ExtractFile(innerFile, data);
+	}
+
+	ifstream input(image.FilePath, std::ios::in | std::ios::binary);
+	if(!input) {
+		return false;
+	}
+	input.seekg(0, std::ios::end);
+	std::streamoff size = input.tellg();
+	input.seekg(0, std::ios::beg);
+	data.resize(size > 0 ? (size_t)size : 0);
+	input.read((char*)data.data(), data.size());
+	return (size_t)input.gcount() == data.size();
+}
+
+bool FloppyImageLoader::IsRaw(const vector<uint8_t>& data)
+{
+	return true;
+}
+
+bool FloppyImageLoader::DecodeRaw(vector<uint8_t>& data, FloppyImage& image)
+{
+	// 非标准大小的镜像按 1.44M 的磁道格式访问（超出镜像的部分读出 0）
+	image.Geometry = FloppyGeometry();
+	FloppyGeometry::FromImageSize(data.size(), image.Geometry);
+	image.Data = std::move(data);
+	return true;
+}
+
+bool FloppyImageLoader::IsImd(const vector<uint8_t>& data)
+{
+	return data.size() >= 4 && memcmp(data.data(), "IMD ", 4) == 0;
+}
+
+// 描述：解码 ImageDisk 镜像。文件头是以 0x1A 结尾的 ASCII 注释，之后每个磁道为：
+//       模式、柱面、磁头（D7/D6 表示带有柱面/磁头映射表）、扇区数、扇区大小代码、扇区编号表、[柱面映射表]、[磁头映射表]，
+//       然后是每个扇区的记录：类型 0 表示无数据，奇数类型后跟完整扇区数据，偶数类型后跟一个填充字节（整个扇区相同）。
+//       只支持 512 字节扇区，缺失的扇区填 0。
+bool FloppyImageLoader::DecodeImd(vector<uint8_t>& data, FloppyImage& image)
+{
+	struct ImdSector
+	{
+		uint8_t Cylinder;
+		uint8_t Head;
+		uint8_t Id;
+		bool Compressed;
+		size_t Offset;
+	};
+
+	size_t pos = 0;
+	while(pos < data.size() && data[pos] != 0x1A) {
+		pos++;
+	}
+	if(pos >= data.size()) {
+		return false;
+	}
+	pos++;
+
+	vector<ImdSector> sectors;
+	uint8_t maxCylinder = 0;
+	uint8_t maxHead = 0;
+	uint8_t maxId = 0;
+	while(pos < data.size()) {
+		if(pos + 5 > data.size()) {
+			return false;
+		}
+		uint8_t cylinder = data[pos + 1];
+		uint8_t head = data[pos + 2];
+		uint8_t sectorCount = data[pos + 3];
+		uint8_t sizeCode = data[pos + 4];
+		pos += 5;
+
+		if(sizeCode != 2) {
+			// 2 = 512 字节
+			return false;
+		}
+
+		size_t mapSize = sectorCount * (1 + ((head & 0x80) ? 1 : 0) + ((head & 0x40) ? 1 : 0));
+		if(pos + mapSize > data.size()) {
+			return false;
+		}
+		const uint8_t* idMap = data.data() + pos;
+		pos += mapSize;
+		head &= 0x01;
+
+		for(uint8_t i = 0; i < sectorCount; i++) {
+			if(pos >= data.size()) {
+				return false;
+			}
+			uint8_t type = data[pos++];
+			if(type == 0) {
+				continue;
+			} else if(type > 8) {
+				return false;
+			}
+
+			bool compressed = (type & 1) == 0;
+			size_t length = compressed ? 1 : SectorSize;
+			if(pos + length > data.size() || idMap[i] == 0) {
+				return false;
+			}
+			sectors.push_back({ cylinder, head, idMap[i], compressed, pos });
+			pos += length;
+
+			maxCylinder = std::max(maxCylinder, cylinder);
+			maxHead = std::max(maxHead, head);
+			maxId = std::max(maxId, idMap[i]);
+		}
+	}
+
+	if(sectors.empty()) {
+		return false;
+	}
+
+	image.Geometry.Cylinders = maxCylinder + 1;
+	image.Geometry.Heads = maxHead + 1;
+	image.Geometry.SectorsPerTrack = maxId;
+
+	vector<uint8_t> output((size_t)image.Geometry.GetSectorCount() * SectorSize, 0);
+	for(const ImdSector& sector : sectors) {
+		uint8_t* dst = output.data() + (size_t)image.Geometry.GetLba(sector.Cylinder, sector.Head, sector.Id) * SectorSize;
+		if(sector.Compressed) {
+			memset(dst, data[sector.Offset], SectorSize);
+		} else {
+			memcpy(dst, data.data() + sector.Offset, SectorSize);
+		}
+	}
+	image.Data = std::move(output);
+	return true;
+}
@@ -0,0 +1,71 @@
+﻿#pragma once
+#include "pch.h"
+
+// 软盘物理格式（柱面/磁头/每磁道扇区数），扇区大小固定为 512 字节
+struct FloppyGeometry
+{
+	uint8_t Cylinders = 80;
+	uint8_t Heads = 2;
+	uint8_t SectorsPerTrack = 18;
+
+	uint32_t GetSectorCount() const { return (uint32_t)Cylinders * Heads * SectorsPerTrack; }
+	uint32_t GetLba(uint8_t c, uint8_t h, uint8_t r) const { return ((uint32_t)c * Heads + h) * SectorsPerTrack + (r ? r - 1 : 0); }
+
+	// 描述：按原始镜像的大小识别标准格式（160K/180K/320K/360K/720K/1.2M/1.44M/2.88M）。
+	// 返回：不是标准大小时返回 false，geometry 保持不变。
+	static bool FromImageSize(size_t size, FloppyGeometry& geometry);
+};
+
+enum class FloppyImageFormat
+{
+	Raw,
+	Imd
+};
+
+// 解码后的软盘镜像：统一为按 LBA 顺序排列的扇区数据
+struct FloppyImage
+{
+	vector<uint8_t> Data;
+	FloppyGeometry Geometry;
+	FloppyImageFormat Format = FloppyImageFormat::Raw;
+	// 镜像实际所在的文件（压缩包中的镜像为压缩包本身）
+	string FilePath;
+	// 压缩包中的文件名，镜像不在压缩包中时为空
+	string InnerFile;
+
+	// 只有未压缩的原始镜像可以把修改原样写回文件，其它格式只能以覆盖层方式加载
+	bool IsWritable() const { return Format == FloppyImageFormat::Raw && InnerFile.empty(); }
+};
+
+/**
+ * 软盘镜像加载层：把各种格式的镜像一次性解码为内存中的原始扇区数据，供 FloppyDriveController 使用。
+ * 支持原始镜像（.img/.ima 等）、ImageDisk（.imd），以及放在 zip/7z 压缩包中的上述镜像。
+ * 压缩包路径可以用 "压缩包路径\x1内部文件名" 指定内部文件（与 VirtualFile 相同），未指定时使用第一个软盘镜像。
+ * 新格式只需实现一个解码函数并加入 FloppyImageLoader.cpp 中的格式表。
+ */
+class FloppyImageLoader
+{
+public:
+	static const std::initializer_list<string> Extensions;
+
+	static bool Load(const string& path, FloppyImage& image);
+	static bool Decode(vector<uint8_t>& data, FloppyImage& image);
+
+	typedef bool (*MatchFunc)(const vector<uint8_t>& data);
+	typedef bool (*DecodeFunc)(vector<uint8_t>& data, FloppyImage& image);
+
+	struct FormatDesc
+	{
+		FloppyImageFormat Format;
+		MatchFunc IsMatch;
+		DecodeFunc Decode;
+	};
+
+private:
+	static bool ReadSource(const string& path, vector<uint8_t>& data, FloppyImage& image);
+
+	static bool IsImd(const vector<uint8_t>& data);
+	static bool DecodeImd(vector<uint8_t>& data, FloppyImage& image);
+	static bool IsRaw(const vector<uint8_t>& data);
+	static bool DecodeRaw(vector<uint8_t>& data, FloppyImage& image);
+};
@@ -610,4 +610,92 @@ void lpc_d6_delete(void* lpc)
 	s = (LPC*)lpc;
 
 	free(s);
-}
\ No newline at end of file
+}
+
+static int* lpc_save_frame(const LPC_FRAME* f, int* out)
+{
+	int i;
+
+	*out++ = f->energy;
+	*out++ = f->pitch;
+	for (i = 0; i < LPC_ORDER; i++)
+		*out++ = f->k[i];
+
+	return out;
+}
+
+static const int* lpc_load_frame(LPC_FRAME* f, const int* in)
+{
+	int i;
+
+	f->energy = (short)*in++;
+	f->pitch = (short)*in++;
+	for (i = 0; i < LPC_ORDER; i++)
+		f->k[i] = (short)*in++;
+
+	return in;
+}
+
+// the whole synth state is plain data, so a snapshot can be used both for
+// save states and for rolling back a frame that could not be completed
+int lpc_d6_save_state(void* lpc, int* state)
+{
+	LPC* s;
+	int* out;
+	int i;
+
+	if (!lpc || !state) return -1;
+
+	s = (LPC*)lpc;
+	out = state;
+
+	out = lpc_save_frame(&s->frame_prev, out);
+	out = lpc_save_frame(&s->frame_curr, out);
+	out = lpc_save_frame(&s->frame_next, out);
+
+	*out++ = s->need_interp;
+	*out++ = s->random_seed;
+	*out++ = s->curr_pitch;
+	*out++ = s->sample_index;
+
+	for (i = 0; i < LPC_ORDER + 1; i++)
+		*out++ = s->x[i];
+
+	*out++ = s->synth_out;
+	*out++ = s->state;
+	*out++ = s->bits_left;
+	*out++ = s->data_cache;
+
+	return (int)(out - state);
+}
+
+int lpc_d6_load_state(void* lpc, const int* state)
+{
+	LPC* s;
+	const int* in;
+	int i;
+
+	if (!lpc || !state) return -1;
+
+	s = (LPC*)lpc;
+	in = state;
+
+	in = lpc_load_frame(&s->frame_prev, in);
+	in = lpc_load_frame(&s->frame_curr, in);
+	in = lpc_load_frame(&s->frame_next, in);
+
+	s->need_interp = (short)*in++;
+	s->random_seed = (short)*in++;
+	s->curr_pitch = (short)*in++;
+	s->sample_index = (short)*in++;
+
+	for (i = 0; i < LPC_ORDER + 1; i++)
+		s->x[i] = (short)*in++;
+
+	s->synth_out = (short)*in++;
+	s->state = *in++;
+	s->bits_left = *in++;
+	s->data_cache = (unsigned short)*in++;
+
+	return (int)(in - state);
+}
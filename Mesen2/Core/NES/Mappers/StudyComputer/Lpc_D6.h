@@ -15,10 +15,15 @@ typedef int (*lpc_feed_t)(void* host, unsigned char* food);
 #define LPC_STD_VARIANT_BBK		0
 #define LPC_STD_VARIANT_SB2K	1
 
+// number of ints used by lpc_d6_save_state/lpc_d6_load_state (feed/host/variant are not included)
+#define LPC_D6_STATE_SIZE		55
+
 void* lpc_d6_new(lpc_feed_t feed, void* host, int variant);
 int   lpc_d6_do(void* lpc, short* pcm, int* pcm_size, int* restart);
 int   lpc_d6_reset(void* lpc);
 void  lpc_d6_delete(void* lpc);
+int   lpc_d6_save_state(void* lpc, int* state);
+int   lpc_d6_load_state(void* lpc, const int* state);
 
 #ifdef __cplusplus
 }
@@ -147,6 +147,9 @@ void MapperBbk::InitMapper()
 		_bbkInput->SetKeyMappings(mappings);
 	}
 
+	// $8000-$FEFF 由 UpdatePrgMapping 设置的页表直接访问，只有 $FF00-$FFFF 的 Holtek/FDC IO 页需要拦截
+	RemoveRegisterRange(0x8000, 0xFEFF, MemoryOperation::Any);
+
 	InitializeLpcAudio();
 	ResetLpcAudioState();
 }
@@ -154,6 +157,9 @@ void MapperBbk::InitMapper()
 MapperBbk::~MapperBbk()
 {
 	ShutdownLpcAudio();
+	if(_fdcFastForward) {
+		_emu->GetSettings()->ClearFlag(EmulationFlags::MaximumSpeedOverride);
+	}
 }
 
 // 描述：重置 Mapper 状态并更新映射表。
@@ -171,15 +177,6 @@ void MapperBbk::Reset(bool softReset)
 		SetCpuMemoryMapping(0x4000, 0x5FFF, _mapperRam + 0x78000, 0, _mapperRamSize, MemoryAccessType::ReadWrite);
 		// 6xxx - 7xxx  -> mapper RAM + 0x7A000  (8KB)
 		SetCpuMemoryMapping(0x6000, 0x7FFF, _mapperRam + 0x7A000, 0, _mapperRamSize, MemoryAccessType::ReadWrite);
-		// 8xxx - 9xxx  -> mapper RAM + 0x0000  (8KB)
-		SetCpuMemoryMapping(0x8000, 0x9FFF, _mapperRam + 0x0000, 0, _mapperRamSize, MemoryAccessType::ReadWrite);
-		// Axxx - Bxxx  -> mapper RAM + 0x2000  (8KB)
-		SetCpuMemoryMapping(0xA000, 0xBFFF, _mapperRam + 0x2000, 0, _mapperRamSize, MemoryAccessType::ReadWrite);
-
-		// 将 CPU 地址 0xC000-0xDFFF 映射到 PRG ROM 的偏移 0x1C000 处（8KB，作为 ROM 读取）
-		SetCpuMemoryMapping(0xC000, 0xDFFF, _prgRom + 0x1C000, 0, _prgSize, MemoryAccessType::Read);
-		// 将 CPU 地址 0xE000-0xFFFF 映射到 PRG ROM 的偏移 0x1E000 处（8KB，作为 ROM 读取）
-		SetCpuMemoryMapping(0xE000, 0xFFFF, _prgRom + 0x1E000, 0, _prgSize, MemoryAccessType::Read);
 
 		// Nametables（使用整合到 _mapperRam 的 EVRAM 段）
 		SetPpuMemoryMapping(0x2000, 0x23FF, _mapperRam, BBK_EVRAM_BASE + 0x0000, _mapperRamSize, MemoryAccessType::ReadWrite);
@@ -212,11 +209,41 @@ void MapperBbk::Reset(bool softReset)
 		nCurScanLine = 0;
 		bDiskAccess = false;
 
+		// 8xxx-Bxxx -> ROM bank 0，C000-FFFF -> ROM 0x1C000-0x1FFFF
+		UpdatePrgMapping();
 	}
 
 	ResetLpcAudioState();
 }
 
+// 描述：按当前寄存器状态设置 $8000-$FFFF 的 CPU 页表（8KB 为单位，与 MapAddr 的读写规则一致）。
+// ROM 页只读（写入被忽略），DRAM 页可读写。$FF00-$FFFF 仍被注册为寄存器地址，页表仅供调试器读取。
+void MapperBbk::UpdatePrgMapping()
+{
+	auto mapSlot = [this](uint16_t start, bool useDram, uint8_t dramBank, uint32_t romOffset) {
+		if(useDram) {
+			SetCpuMemoryMapping(start, start + 0x1FFF, PrgMemoryType::MapperRam, dramBank * 0x2000, MemoryAccessType::ReadWrite);
+		} else {
+			SetCpuMemoryMapping(start, start + 0x1FFF, PrgMemoryType::PrgRom, romOffset, MemoryAccessType::Read);
+		}
+
+		// EDRAM 0x7FFFE 写入 0x9B 时会被改写为 0x96，包含该地址的页面需要继续经由 WriteRegister
+		if(start < 0xE000) {
+			if(useDram && dramBank == 0x3F) {
+				AddRegisterRange(start + 0x1F00, start + 0x1FFF, MemoryOperation::Write);
+			} else {
+				RemoveRegisterRange(start + 0x1F00, start + 0x1FFF, MemoryOperation::Write);
+			}
+		}
+	};
+
+	bool dram89AB = (nRegFF14 & 0x40) != 0;
+	mapSlot(0x8000, dram89AB, nRegFF14 & 0x3F, (nRegFF14 & 0x0F) * 0x2000);
+	mapSlot(0xA000, dram89AB, nRegFF1C & 0x3F, (nRegFF1C & 0x0F) * 0x2000);
+	mapSlot(0xC000, bMapRam, nRegFF24 & 0x3F, 0x1C000);
+	mapSlot(0xE000, bMapRam, nRegFF2C & 0x3F, 0x1E000);
+}
+
 // 描述：将 CPU 地址映射到物理 EDRAM/BIOS/IO 地址。
 // 参数：addr - CPU 地址；cs_type - 输出芯片选择；is_write - 是否写操作。
 // 返回：物理地址（uint32_t），并在 cs_type 中填入 INNO_CS_* 值。
@@ -340,7 +367,7 @@ uint8_t MapperBbk::ReadLow(uint16_t addr)
 
 void MapperBbk::WriteRegister(uint16_t addr, uint8_t value)
 {
-	// 写高: 0x8000-0xFFFF
+	// 写高: 0xFF00-0xFFFF，以及映射了 EDRAM 末尾 bank（0x3F）时的 $9F00/$BF00/$DF00 页
 	int cs_type;
 	uint32_t phy = MapAddr(addr, &cs_type, true);
 
@@ -360,7 +387,10 @@ void MapperBbk::WriteRegister(uint16_t addr, uint8_t value)
 		FloppyDriveController* fdc = _console->GetFdc();
 		if(fdc) {
 			bDiskAccess = true;
-			fdc->Write(nPort, value);
+			fdc->Write(nPort, value, _console->GetMasterClock());
+			if(fdc->IsActive()) {
+				_fdcIdleFrames = 0;
+			}
 		}
 
 		return;
@@ -393,17 +423,8 @@ void MapperBbk::WriteRegister(uint16_t addr, uint8_t value)
 			bFF01_D4 = !!(value & 0x10);
 
 			// C000-FFFF 到 EDRAM/ROM 的映射
-			if(value & 8) {
-				// map C000-FFFF 到 mapper RAM
-				SetCpuMemoryMapping(0xC000, 0xDFFF, _mapperRam + nRegFF24 * 0x2000, 0, _mapperRamSize, MemoryAccessType::ReadWrite);
-				SetCpuMemoryMapping(0xE000, 0xFFFF, _mapperRam + nRegFF2C * 0x2000, 0, _mapperRamSize, MemoryAccessType::ReadWrite);
-				bMapRam = true;
-			} else {
-				// map C000-FFFF 到 ROM
-				SetCpuMemoryMapping(0xC000, 0xDFFF, _prgRom + 0x1C000, 0, _prgSize, MemoryAccessType::Read);
-				SetCpuMemoryMapping(0xE000, 0xFFFF, _prgRom + 0x1E000, 0, _prgSize, MemoryAccessType::Read);
-				bMapRam = false;
-			}
+			bMapRam = (value & 8) != 0;
+			UpdatePrgMapping();
 			break;
 
 		case 0xFF02: // IntCountPortL
@@ -419,44 +440,31 @@ void MapperBbk::WriteRegister(uint16_t addr, uint8_t value)
 			nRegFF14 = (value << 1) & 0x7F;
 			nRegFF1C = ((value << 1) & 0x3F) | 1;
 
+			// D5=0: 8000-BFFF 映射 ROM（128K），D5=1: 映射 DRAM（512K）
 			bRomSel_89AB = !(value & 0x20);
-
-			if(bRomSel_89AB) {
-				// ROM
-				value &= 0x07;	//  128K
-				SetCpuMemoryMapping(0x8000, 0x9FFF, _prgRom + value * 0x4000 + 0x0000, 0, _prgSize, MemoryAccessType::Read);
-				SetCpuMemoryMapping(0xA000, 0xBFFF, _prgRom + value * 0x4000 + 0x2000, 0, _prgSize, MemoryAccessType::Read);
-			} else {
-				// DRAM
-				value &= 0x1F; // 512K
-				SetCpuMemoryMapping(0x8000, 0x9FFF, _mapperRam + value * 0x4000 + 0x0000, 0, _mapperRamSize, MemoryAccessType::ReadWrite);
-				SetCpuMemoryMapping(0xA000, 0xBFFF, _mapperRam + value * 0x4000 + 0x2000, 0, _mapperRamSize, MemoryAccessType::ReadWrite);
-			}
+			UpdatePrgMapping();
 			break;
 
 		case 0xFF14:
-			value &= 0x3F;
-			nRegFF14 = value | 0x40;
+			nRegFF14 = (value & 0x3F) | 0x40;
 			bRomSel_89AB = 0;
-			SetCpuMemoryMapping(0x8000, 0x9FFF, _mapperRam + value * 0x2000, 0, _mapperRamSize, MemoryAccessType::ReadWrite);
+			UpdatePrgMapping();
 			break;
 
 		case 0xFF1C:
 			nRegFF1C = value & 0x3F;
 			bRomSel_89AB = 0;
-			SetCpuMemoryMapping(0xA000, 0xBFFF, _mapperRam + nRegFF1C * 0x2000, 0, _mapperRamSize, MemoryAccessType::ReadWrite);
+			UpdatePrgMapping();
 			break;
 
 		case 0xFF24:
 			nRegFF24 = value & 0x3F;
-			if(bMapRam)
-				SetCpuMemoryMapping(0xC000, 0xDFFF, _mapperRam + nRegFF24 * 0x2000, 0, _mapperRamSize, MemoryAccessType::ReadWrite);
+			UpdatePrgMapping();
 			break;
 
 		case 0xFF2C:
 			nRegFF2C = value & 0x3F;
-			if(bMapRam)
-				SetCpuMemoryMapping(0xE000, 0xFFFF, _mapperRam + nRegFF2C * 0x2000, 0, _mapperRamSize, MemoryAccessType::ReadWrite);
+			UpdatePrgMapping();
 			break;
 
 		case 0xFF12: // Init
@@ -581,7 +589,7 @@ void MapperBbk::WriteRegister(uint16_t addr, uint8_t value)
 
 uint8_t MapperBbk::ReadRegister(uint16_t addr)
 {
-	// 读高: 0x8000 - 0xFFFF
+	// 读高: 0xFF00 - 0xFFFF（其余地址由 UpdatePrgMapping 设置的页表直接读取）
 	uint8_t data = 0;
 	int cs_type;
 	uint32_t phy_addr;
@@ -600,8 +608,11 @@ uint8_t MapperBbk::ReadRegister(uint16_t addr)
 
 		FloppyDriveController* fdc = _console->GetFdc();
 		if(fdc) {
-			data = fdc->Read(nPort);
+			data = fdc->Read(nPort, _console->GetMasterClock());
 			bDiskAccess = true;
+			if(fdc->IsActive()) {
+				_fdcIdleFrames = 0;
+			}
 		} else {
 			data = 0;
 		}
@@ -625,8 +636,12 @@ uint8_t MapperBbk::ReadRegister(uint16_t addr)
 			return 0; // PC Card
 		case 0xFF18:
 		{
-			std::unique_lock<std::mutex> lock(_lpcMutex);
-			bool bufferFull = _lpcThreadRunning && _lpcDataCount >= (LpcDataBufferSize - 1);
+			bool bufferFull;
+			if(_lpcSyncMode) {
+				bufferFull = _lpcSyncInputCount >= (LpcDataBufferSize - 1);
+			} else {
+				bufferFull = _lpcThreadRunning && _lpcInput.Size() >= (LpcDataBufferSize - 1);
+			}
 			return bufferFull ? 0x00 : 0x8F;
 		}
 		default:
@@ -645,15 +660,22 @@ void MapperBbk::ProcessCpuClock()
 		UpdateLpcSampleStep();
 	}
 
+	// 每个 CPU 周期都会执行，直接读取 PPU 的帧计数（Emulator::GetFrameCount 需要锁定 weak_ptr 并调用虚函数）
+	uint32_t currentFrame = _console->GetPpu()->GetFrameCount();
+	if(currentFrame != _fdcPreviousFrame) {
+		_fdcPreviousFrame = currentFrame;
+		UpdateFdcTiming();
+	}
+
 	NesApu* apu = _console->GetApu();
-	if(!_lpcThreadRunning || !_lpcSynth || !apu) {
+	if((!_lpcSyncMode && !_lpcThreadRunning) || !_lpcSynth || !apu) {
 		return;
 	}
 
 	_lpcCycleAccumulator += 1.0;
 	while(_lpcCycleAccumulator >= _lpcCyclesPerSample) {
 		_lpcCycleAccumulator -= _lpcCyclesPerSample;
-		int16_t sample = PopLpcSample();
+		int16_t sample = _lpcSyncMode ? PopLpcSyncSample() : PopLpcSample();
 		if(sample != _lpcLastMixedSample) {
 			int32_t delta = static_cast<int32_t>(sample) - static_cast<int32_t>(_lpcLastMixedSample);
 			delta = std::clamp(delta, static_cast<int32_t>(std::numeric_limits<int16_t>::min()), static_cast<int32_t>(std::numeric_limits<int16_t>::max()));
@@ -663,119 +685,145 @@ void MapperBbk::ProcessCpuClock()
 	}
 }
 
+void MapperBbk::UpdateFdcTiming()
+{
+	FloppyDriveController* fdc = _console->GetFdc();
+	if(!fdc) {
+		return;
+	}
+
+	NesConfig& cfg = _console->GetNesConfig();
+	// 时钟频率只随区域变化（区域由 ProcessCpuClock 记录在 _lpcCachedRegion）
+	if(fdc != _fdcTimingTarget || cfg.BbkAccurateFdcTiming != _fdcAccurateTiming || _lpcCachedRegion != _fdcTimingRegion) {
+		_fdcTimingTarget = fdc;
+		_fdcAccurateTiming = cfg.BbkAccurateFdcTiming;
+		_fdcTimingRegion = _lpcCachedRegion;
+		fdc->SetTimingMode(_fdcAccurateTiming, _console->GetMasterClockRate());
+	}
+
+	if(fdc->IsActive()) {
+		_fdcIdleFrames = 0;
+	} else if(_fdcIdleFrames < FdcFastForwardHoldFrames) {
+		_fdcIdleFrames++;
+	}
+
+	// 使用独立的 MaximumSpeedOverride 标志，不修改用户的 MaximumSpeed 标志（读盘结束时不会关闭用户手动开启的快进）
+	bool fastForward = cfg.BbkFastForwardOnDiskAccess && _fdcIdleFrames < FdcFastForwardHoldFrames;
+	if(fastForward != _fdcFastForward) {
+		_fdcFastForward = fastForward;
+		_emu->GetSettings()->SetFlagState(EmulationFlags::MaximumSpeedOverride, fastForward);
+	}
+}
+
 int MapperBbk::LpcFeed(void* host, unsigned char* food)
 {
 	MapperBbk* self = reinterpret_cast<MapperBbk*>(host);
-	std::unique_lock<std::mutex> lock(self->_lpcMutex);
+	if(self->_lpcSyncMode) {
+		return self->FeedLpcSyncByte(food);
+	}
+
 	while(true) {
-		if(!self->_lpcThreadRunning || self->_lpcStopRequested) {
+		if(self->_lpcStopRequested) {
 			return LPC_CMD_STOP;
 		}
 
-		if(self->_lpcResetRequested) {
+		// 先确认有数据再检查复位请求：若队首字节是在复位请求之后写入的，此时一定能看到该请求
+		if(!self->_lpcInput.IsEmpty()) {
+			if(self->IsLpcResetPending()) {
+				return LPC_CMD_RESET;
+			}
+			uint8_t value = 0;
+			self->_lpcInput.Pop(value);
+			*food = value;
+			return LPC_CMD_PAYLOAD;
+		}
+
+		if(self->IsLpcResetPending()) {
 			return LPC_CMD_RESET;
 		}
 
-		if(self->_lpcDataCount > 0) {
-			uint8_t value = self->_lpcDataBuffer[self->_lpcDataReadPos];
-			self->_lpcDataReadPos = (self->_lpcDataReadPos + 1) % LpcDataBufferSize;
-			self->_lpcDataCount--;
-			lock.unlock();
-			self->_lpcCond.notify_all();
-			*food = value;
-			return LPC_CMD_PAYLOAD;
+		self->_lpcFeedWaiting = true;
+		if(self->_lpcInput.IsEmpty() && !self->_lpcStopRequested && !self->IsLpcResetPending()) {
+			self->_lpcWakeEvent.Wait(LpcWaitTimeoutMs);
 		}
+		self->_lpcFeedWaiting = false;
+	}
+}
+
+// 描述：线程模式下，运行前置（run-ahead）的隐藏帧不与解码线程交互。
+// 说明：解码线程的队列无法随读档回滚，每个模拟帧的写入与取样只在显示的那一帧中进行一次，否则同一段语音会被重复送入解码器。
+bool MapperBbk::IsLpcRunAheadFrame()
+{
+	return _emu->IsRunAheadFrame();
+}
 
-		self->_lpcCond.wait(lock);
+// 描述：解码线程检查是否有未处理的复位请求。
+bool MapperBbk::IsLpcResetPending()
+{
+	return _lpcResetRequest.load(std::memory_order_acquire) != _lpcResetAck.load(std::memory_order_relaxed);
+}
+
+// 描述：解码线程在安全点处理复位请求（复位解码器，完整复位时同时丢弃请求之前的输入与已生成的 PCM），然后应答。
+void MapperBbk::ProcessLpcResetRequest()
+{
+	uint32_t request = _lpcResetRequest.load(std::memory_order_acquire);
+	if(request == _lpcResetAck.load(std::memory_order_relaxed)) {
+		return;
+	}
+
+	if(_lpcResetFlush.exchange(false, std::memory_order_acq_rel)) {
+		_lpcInput.SkipTo(_lpcResetInputPos.load(std::memory_order_relaxed));
+		_lpcResetPcmPos.store(_lpcPcm.GetWritePosition(), std::memory_order_relaxed);
 	}
+
+	lpc_d6_reset(_lpcSynth);
+	_lpcResetAck.store(request, std::memory_order_release);
+}
+
+// 描述：解码线程写入一个 PCM 样本；队列满时休眠等待模拟线程取走一半样本。
+// 返回：false 表示因停止或复位请求而放弃写入（与原实现一致，剩余样本被丢弃）。
+bool MapperBbk::PushLpcSample(int16_t sample)
+{
+	while(!_lpcPcm.Push(sample)) {
+		if(_lpcStopRequested || IsLpcResetPending()) {
+			return false;
+		}
+		_lpcPcmWaiting = true;
+		if(_lpcPcm.IsFull() && !_lpcStopRequested && !IsLpcResetPending()) {
+			_lpcWakeEvent.Wait(LpcWaitTimeoutMs);
+		}
+		_lpcPcmWaiting = false;
+	}
+	return true;
 }
 
 void MapperBbk::LpcThreadRoutine()
 {
 	std::array<int16_t, 1024> pcmBuffer = {};
-	while(true) {
-		{
-			std::unique_lock<std::mutex> lock(_lpcMutex);
-			if(!_lpcThreadRunning || _lpcStopRequested || !_lpcSynth) {
-				break;
-			}
-		}
+	while(!_lpcStopRequested && _lpcSynth) {
+		ProcessLpcResetRequest();
 
 		int pcmSize = 0;
 		int eos = lpc_d6_do(_lpcSynth, pcmBuffer.data(), &pcmSize, nullptr);
 
-		if(pcmSize > 0) {
-			for(int i = 0; i < pcmSize; i++) {
-				int32_t rawSample = pcmBuffer[i];
-				rawSample /= 4; // 缩放到与 VirtuaNES 相近的幅度，避免混音端过载
-				bool queued = false;
-				while(!queued) {
-					bool shouldStop = false;
-					{
-						std::unique_lock<std::mutex> stateLock(_lpcMutex);
-						shouldStop = !_lpcThreadRunning || _lpcStopRequested || _lpcResetRequested;
-					}
-					if(shouldStop) {
-						queued = true;
-						break;
-					}
-					{
-						std::lock_guard<std::mutex> pcmLock(_pcmMutex);
-						if(_lpcPcmQueue.size() < LpcPcmMaxSize) {
-							_lpcPcmQueue.push_back(static_cast<int16_t>(rawSample));
-							queued = true;
-						}
-					}
-					if(!queued) {
-						std::this_thread::sleep_for(std::chrono::milliseconds(1));
-					}
-				}
-				if(!_lpcThreadRunning || _lpcStopRequested) {
-					break;
-				}
-			}
-			_pcmCond.notify_all();
-		}
-
-		bool needReset = false;
-		{
-			std::unique_lock<std::mutex> lock(_lpcMutex);
-			needReset = _lpcResetRequested;
-			if(_lpcStopRequested) {
+		for(int i = 0; i < pcmSize; i++) {
+			int32_t rawSample = pcmBuffer[i];
+			rawSample /= 4; // 缩放到与 VirtuaNES 相近的幅度，避免混音端过载
+			if(!PushLpcSample(static_cast<int16_t>(rawSample))) {
 				break;
 			}
 		}
 
-		if(needReset && _lpcSynth) {
-			lpc_d6_reset(_lpcSynth);
-			std::unique_lock<std::mutex> lock(_lpcMutex);
-			_lpcResetAck = true;
-			_lpcResetRequested = false;
-			lock.unlock();
-			_lpcAckCond.notify_all();
-		}
-
 		if(eos) {
 			std::this_thread::yield();
 		}
 	}
 
-	{
-		std::lock_guard<std::mutex> pcmLock(_pcmMutex);
-		_lpcPcmQueue.clear();
-	}
-	{
-		std::unique_lock<std::mutex> lock(_lpcMutex);
-		_lpcThreadRunning = false;
-	}
-	_pcmCond.notify_all();
-	_lpcCond.notify_all();
-	_lpcAckCond.notify_all();
+	_lpcThreadRunning = false;
 }
 
 void MapperBbk::InitializeLpcAudio()
 {
-	std::unique_lock<std::mutex> lock(_lpcMutex);
 	if(_lpcThreadRunning) {
 		return;
 	}
@@ -783,14 +831,22 @@ void MapperBbk::InitializeLpcAudio()
 	_lpcCachedRegion = _console->GetRegion();
 	UpdateLpcSampleStep();
 	_lpcStopRequested = false;
-	_lpcResetRequested = false;
-	_lpcResetAck = false;
+	_lpcResetRequest = 0;
+	_lpcResetAck = 0;
+	_lpcResetFlush = false;
+	_lpcFlushPending = false;
 
 	_lpcSynth = lpc_d6_new(LpcFeed, this, LPC_STD_VARIANT_BBK);
 	if(!_lpcSynth) {
 		return;
 	}
 
+	// 同步模式在上电时确定，运行中修改设置需重新加载游戏才会生效
+	_lpcSyncMode = _console->GetNesConfig().BbkSyncLpcDecode;
+	if(_lpcSyncMode) {
+		return;
+	}
+
 	_lpcThreadRunning = true;
 	try {
 		_lpcThread = std::thread(&MapperBbk::LpcThreadRoutine, this);
@@ -804,24 +860,11 @@ void MapperBbk::InitializeLpcAudio()
 
 void MapperBbk::ShutdownLpcAudio()
 {
-	std::thread worker;
-	{
-		std::unique_lock<std::mutex> lock(_lpcMutex);
-		if(!_lpcThreadRunning) {
-			if(_lpcSynth) {
-				lpc_d6_delete(_lpcSynth);
-				_lpcSynth = nullptr;
-			}
-			return;
-		}
-		_lpcStopRequested = true;
-		_lpcCond.notify_all();
-		worker = std::move(_lpcThread);
-	}
-	_pcmCond.notify_all();
+	_lpcStopRequested = true;
+	_lpcWakeEvent.Signal();
 
-	if(worker.joinable()) {
-		worker.join();
+	if(_lpcThread.joinable()) {
+		_lpcThread.join();
 	}
 
 	if(_lpcSynth) {
@@ -829,20 +872,15 @@ void MapperBbk::ShutdownLpcAudio()
 		_lpcSynth = nullptr;
 	}
 
-	{
-		std::lock_guard<std::mutex> pcmLock(_pcmMutex);
-		_lpcPcmQueue.clear();
-	}
-	{
-		std::unique_lock<std::mutex> lock(_lpcMutex);
-		_lpcThreadRunning = false;
-		_lpcStopRequested = false;
-		_lpcResetRequested = false;
-		_lpcResetAck = false;
-	}
-	_lpcCond.notify_all();
-	_lpcAckCond.notify_all();
-	_pcmCond.notify_all();
+	// 解码线程已退出，此时可以安全地从任意一端清空两个队列
+	_lpcInput.Clear();
+	_lpcPcm.Clear();
+	_lpcThreadRunning = false;
+	_lpcStopRequested = false;
+	_lpcResetFlush = false;
+	_lpcResetAck = _lpcResetRequest.load();
+	_lpcFlushPending = false;
+	_lpcSyncMode = false;
 }
 
 void MapperBbk::ResetLpcAudioState()
@@ -850,60 +888,54 @@ void MapperBbk::ResetLpcAudioState()
 	_lpcCachedRegion = _console->GetRegion();
 	UpdateLpcSampleStep();
 
-	{
-		std::lock_guard<std::mutex> pcmLock(_pcmMutex);
-		_lpcPcmQueue.clear();
-	}
 	_lpcLastSample = 0;
 	_lpcLastMixedSample = 0;
 	_lpcCycleAccumulator = 0.0;
 
-	std::unique_lock<std::mutex> lock(_lpcMutex);
-	_lpcDataReadPos = 0;
-	_lpcDataWritePos = 0;
-	_lpcDataCount = 0;
-
-	if(_lpcThreadRunning && !_lpcStopRequested) {
-		_lpcResetRequested = true;
-		_lpcResetAck = false;
-		lock.unlock();
-		_lpcCond.notify_all();
-		lock.lock();
-		_lpcAckCond.wait(lock, [this]() {
-			return !_lpcThreadRunning || _lpcResetAck || _lpcStopRequested;
-		});
-		_lpcResetRequested = false;
-		_lpcResetAck = false;
+	if(_lpcSyncMode) {
+		_lpcSyncInputPos = 0;
+		_lpcSyncInputCount = 0;
+		_lpcSyncPcmPos = 0;
+		_lpcSyncPcmSize = 0;
+		_lpcSyncStalled = false;
+		if(_lpcSynth) {
+			lpc_d6_reset(_lpcSynth);
+		}
+	} else if(_lpcThreadRunning && !_lpcStopRequested) {
+		// 输入队列只能由解码线程丢弃：记录当前写位置，解码线程复位时跳过此前写入的字节。
+		// PCM 队列在解码线程应答后由 PopLpcSample 跳过复位前生成的样本，期间输出静音，模拟线程无需等待。
+		_lpcResetInputPos.store(_lpcInput.GetWritePosition(), std::memory_order_relaxed);
+		_lpcResetFlush.store(true, std::memory_order_relaxed);
+		_lpcFlushRequest = _lpcResetRequest.fetch_add(1, std::memory_order_release) + 1;
+		_lpcFlushPending = true;
+		_lpcWakeEvent.Signal();
 	} else {
-		_lpcResetRequested = false;
-		_lpcResetAck = false;
+		_lpcInput.Clear();
+		_lpcPcm.Clear();
+		_lpcFlushPending = false;
 	}
-
-	lock.unlock();
-	_lpcCond.notify_all();
-	_pcmCond.notify_all();
 }
 
 // 描述：仅复位 LPC 解码器内部状态，不丢弃已经排队等待混音的 PCM 样本。
 // 说明：模拟 VirtuaNES 行为，避免在一段语音中途因 0xFF10 上升沿导致剩余样本被清空造成“跳句”。
+// 请求之后写入的字节一定在解码器复位之后才会被读取（见 LpcFeed），因此无需等待解码线程应答。
 void MapperBbk::RequestLpcDecoderReset()
 {
-	std::unique_lock<std::mutex> lock(_lpcMutex);
-	if(!_lpcThreadRunning || !_lpcSynth || _lpcStopRequested) {
+	if(_lpcSyncMode) {
+		// 同步模式下解码器只在模拟线程中运行，直接复位即可；输入缓冲中尚未读取的字节保留给复位后的解码器
+		if(_lpcSynth) {
+			lpc_d6_reset(_lpcSynth);
+		}
+		_lpcSyncStalled = false;
+		return;
+	}
+
+	if(!_lpcThreadRunning || !_lpcSynth || _lpcStopRequested || IsLpcRunAheadFrame()) {
 		return; // 线程未运行或已停止，忽略
 	}
 
-	// 标记复位请求，让解码线程在安全点调用 lpc_d6_reset。
-	_lpcResetRequested = true;
-	_lpcResetAck = false;
-	lock.unlock();
-	_lpcCond.notify_all();
-	lock.lock();
-	_lpcAckCond.wait(lock, [this]() {
-		return !_lpcThreadRunning || _lpcResetAck || _lpcStopRequested; });
-	// 清除标志（线程已置位 _lpcResetAck）。
-	_lpcResetRequested = false;
-	_lpcResetAck = false;
+	_lpcResetRequest.fetch_add(1, std::memory_order_release);
+	_lpcWakeEvent.Signal();
 }
 
 void MapperBbk::UpdateLpcSampleStep()
@@ -917,44 +949,201 @@ void MapperBbk::UpdateLpcSampleStep()
 
 int16_t MapperBbk::PopLpcSample()
 {
-	int16_t sample = _lpcLastSample;
-	bool popped = false;
-	{
-		std::lock_guard<std::mutex> lock(_pcmMutex);
-		if(!_lpcPcmQueue.empty()) {
-			sample = _lpcPcmQueue.front();
-			_lpcPcmQueue.pop_front();
-			_lpcLastSample = sample;
-			popped = true;
+	if(IsLpcRunAheadFrame()) {
+		return _lpcLastSample;
+	}
+
+	if(_lpcFlushPending) {
+		if((int32_t)(_lpcResetAck.load(std::memory_order_acquire) - _lpcFlushRequest) < 0) {
+			// 解码线程尚未完成完整复位，继续输出静音
+			return _lpcLastSample;
 		}
+		_lpcPcm.SkipTo(_lpcResetPcmPos.load(std::memory_order_relaxed));
+		_lpcFlushPending = false;
 	}
-	if(popped) {
-		_pcmCond.notify_all();
+
+	int16_t sample;
+	if(_lpcPcm.Pop(sample)) {
+		_lpcLastSample = sample;
+		// 解码线程因队列满而休眠时，待队列消耗到一半再唤醒，避免每个样本都产生一次唤醒
+		if(_lpcPcmWaiting.load(std::memory_order_relaxed) && _lpcPcm.Size() <= LpcPcmMaxSize / 2 && _lpcPcmWaiting.exchange(false)) {
+			_lpcWakeEvent.Signal();
+		}
 	}
-	return sample;
+	return _lpcLastSample;
 }
 
 void MapperBbk::EnqueueLpcByte(uint8_t value)
 {
-	std::unique_lock<std::mutex> lock(_lpcMutex);
-	if(!_lpcThreadRunning || !_lpcSynth || _lpcStopRequested) {
+	if(_lpcSyncMode) {
+		// 缓冲已满时丢弃（软件应先查询 $FF18 状态），同步模式下不能等待
+		if(_lpcSyncInputCount < LpcDataBufferSize) {
+			_lpcSyncInput[(_lpcSyncInputPos + _lpcSyncInputCount) % LpcDataBufferSize] = value;
+			_lpcSyncInputCount++;
+			_lpcSyncStalled = false;
+		}
 		return;
 	}
 
-	_lpcCond.wait(lock, [this]() {
-		return _lpcStopRequested || !_lpcThreadRunning || (!_lpcResetRequested && _lpcDataCount < LpcDataBufferSize);
-	});
-
-	if(_lpcStopRequested || !_lpcThreadRunning) {
+	if(!_lpcThreadRunning || !_lpcSynth || _lpcStopRequested || IsLpcRunAheadFrame()) {
 		return;
 	}
 
-	_lpcDataBuffer[_lpcDataWritePos] = value;
-	_lpcDataWritePos = (_lpcDataWritePos + 1) % LpcDataBufferSize;
-	_lpcDataCount++;
+	// 软件通常会先查询 $FF18 状态再写入，队列满的情况很少见；此时短暂让出 CPU 等待解码线程读取。
+	// 若 PCM 队列也已满，解码线程正等待模拟线程取样，继续等待会死锁，因此丢弃该字节。
+	while(!_lpcInput.Push(value)) {
+		if(!_lpcThreadRunning || _lpcStopRequested || _lpcPcm.IsFull()) {
+			return;
+		}
+		std::this_thread::yield();
+	}
+
+	// 与 LpcFeed 中“置位等待标志后再检查队列”配对，保证不会漏掉唤醒
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+	if(_lpcFeedWaiting.load(std::memory_order_relaxed) && _lpcFeedWaiting.exchange(false)) {
+		_lpcWakeEvent.Signal();
+	}
+}
+
+// 描述：同步模式下的解码器数据源，只读取输入缓冲中的字节，由 DecodeLpcSyncFrame 决定是否真正消耗。
+// 返回：有数据时返回 LPC_CMD_PAYLOAD；数据不足时标记欠载并返回 LPC_CMD_STOP，本次解码随后会被回滚。
+int MapperBbk::FeedLpcSyncByte(unsigned char* food)
+{
+	if(_lpcSyncConsumed >= _lpcSyncInputCount) {
+		_lpcSyncUnderrun = true;
+		return LPC_CMD_STOP;
+	}
+
+	*food = _lpcSyncInput[(_lpcSyncInputPos + _lpcSyncConsumed) % LpcDataBufferSize];
+	_lpcSyncConsumed++;
+	return LPC_CMD_PAYLOAD;
+}
 
-	lock.unlock();
-	_lpcCond.notify_all();
+// 描述：同步模式下尝试解码下一帧。lpc_d6_do 在输出一帧样本后会继续读取下一帧的参数，
+//       与线程模式相同，只有下一帧的数据全部到达后本帧的样本才会被输出。
+// 返回：解码成功（包括预读阶段不产生样本的情况）返回 true；输入不足、已回滚时返回 false。
+bool MapperBbk::DecodeLpcSyncFrame()
+{
+	int savedState[LPC_D6_STATE_SIZE];
+	lpc_d6_save_state(_lpcSynth, savedState);
+
+	_lpcSyncConsumed = 0;
+	_lpcSyncUnderrun = false;
+
+	int pcmSize = 0;
+	lpc_d6_do(_lpcSynth, _lpcSyncPcm, &pcmSize, nullptr);
+
+	if(_lpcSyncUnderrun) {
+		// 数据不足：恢复解码器状态，输入缓冲保持不变，等待软件写入更多字节
+		lpc_d6_load_state(_lpcSynth, savedState);
+		_lpcSyncPcmPos = 0;
+		_lpcSyncPcmSize = 0;
+		_lpcSyncStalled = true;
+		return false;
+	}
+
+	_lpcSyncInputPos = (_lpcSyncInputPos + _lpcSyncConsumed) % LpcDataBufferSize;
+	_lpcSyncInputCount -= _lpcSyncConsumed;
+
+	pcmSize = std::clamp(pcmSize, 0, (int)LpcFrameMaxSize);
+	for(int i = 0; i < pcmSize; i++) {
+		_lpcSyncPcm[i] = static_cast<int16_t>(_lpcSyncPcm[i] / 4); // 与线程模式相同的缩放
+	}
+	_lpcSyncPcmPos = 0;
+	_lpcSyncPcmSize = static_cast<uint16_t>(pcmSize);
+	return true;
+}
+
+// 描述：同步模式下按 10kHz 取出一个样本，当前帧播放完毕时在此处解码下一帧。
+int16_t MapperBbk::PopLpcSyncSample()
+{
+	// 预读阶段（读取 0xD6 标记与前两帧参数）不产生样本，最多再尝试几次以便在同一个样本周期内得到输出
+	for(int i = 0; i < 4 && _lpcSyncPcmPos >= _lpcSyncPcmSize && !_lpcSyncStalled; i++) {
+		if(!DecodeLpcSyncFrame()) {
+			break;
+		}
+	}
+
+	if(_lpcSyncPcmPos < _lpcSyncPcmSize) {
+		_lpcLastSample = _lpcSyncPcm[_lpcSyncPcmPos++];
+	}
+	return _lpcLastSample;
+}
+
+void MapperBbk::Serialize(Serializer& s)
+{
+	BaseMapper::Serialize(s);
+
+	SV(bMapRam);
+	SV(bFF01_D4);
+	SV(bRomSel_89AB);
+	SV(nRegFF14);
+	SV(nRegFF1C);
+	SV(nRegFF24);
+	SV(nRegFF2C);
+	SV(nRegSPInt);
+
+	SV(bSplitMode);
+	SV(bEnableIRQ);
+	SV(nLineCount);
+	SV(nNrOfSR);
+	SV(nNrOfVR);
+	SVArray(QueueSR, 32);
+	SVArray(QueueVR, 32);
+	SV(nQIndex);
+	SV(nCurScanLine);
+	SV(bDiskAccess);
+	SV(_a12Watcher);
+
+	// 软驱控制器由宿主持有（不随 Mapper 重建），其状态与自加载以来被修改的扇区一并保存在 Mapper 的存档数据中
+	FloppyDriveController* fdcPtr = _console->GetFdc();
+	if(fdcPtr) {
+		FloppyDriveController& fdc = *fdcPtr;
+		SV(fdc);
+	}
+
+	if(!s.IsSaving()) {
+		// BaseMapper 已恢复页表，这里根据寄存器重新建立 $7FFFE 写入特例所需的寄存器区间
+		UpdatePrgMapping();
+	}
+
+	SV(_lpcCycleAccumulator);
+	SV(_lpcLastSample);
+	SV(_lpcLastMixedSample);
+
+	// 线程模式下解码器与 PCM 队列的内容取决于宿主线程调度，无法保存；读档时直接清空，避免播放存档前的残留语音。
+	// 存档与当前运行的模式不一致时同样只做清空处理。
+	// 运行前置（run-ahead）每帧都会读档，此时不能清空，否则语音会被反复截断（前置帧不会影响解码线程，见 IsLpcRunAheadFrame）。
+	bool lpcSyncMode = _lpcSyncMode;
+	SV(lpcSyncMode);
+	if(lpcSyncMode && _lpcSyncMode && _lpcSynth) {
+		int lpcState[LPC_D6_STATE_SIZE] = {};
+		if(s.IsSaving()) {
+			lpc_d6_save_state(_lpcSynth, lpcState);
+		}
+		SVArray(lpcState, LPC_D6_STATE_SIZE);
+		SVArray(_lpcSyncInput, LpcDataBufferSize);
+		SV(_lpcSyncInputPos);
+		SV(_lpcSyncInputCount);
+		SVArray(_lpcSyncPcm, LpcFrameMaxSize);
+		SV(_lpcSyncPcmPos);
+		SV(_lpcSyncPcmSize);
+		SV(_lpcSyncStalled);
+
+		if(!s.IsSaving()) {
+			lpc_d6_load_state(_lpcSynth, lpcState);
+			_lpcSyncInputPos %= LpcDataBufferSize;
+			_lpcSyncInputCount = std::min<uint8_t>(_lpcSyncInputCount, LpcDataBufferSize);
+			_lpcSyncPcmSize = std::min<uint16_t>(_lpcSyncPcmSize, LpcFrameMaxSize);
+		}
+	} else if(!s.IsSaving() && !_emu->IsRunAheadFrame()) {
+		double cycleAccumulator = _lpcCycleAccumulator;
+		int16_t lastMixedSample = _lpcLastMixedSample;
+		ResetLpcAudioState();
+		_lpcCycleAccumulator = cycleAccumulator;
+		_lpcLastSample = 0;
+		_lpcLastMixedSample = lastMixedSample;
+	}
 }
 
 // 描述：检查并触发/清除 Mapper IRQ。
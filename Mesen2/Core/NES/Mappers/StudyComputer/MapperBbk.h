@@ -10,19 +10,21 @@
 
 #include "pch.h"
 #include <array>
-#include <deque>
-#include <mutex>
-#include <condition_variable>
 #include <thread>
 #include "NES/BaseMapper.h"
+#include "Utilities/SpscRingBuffer.h"
+#include "Utilities/AutoResetEvent.h"
 #include "NES/Mappers/StudyComputer/Bbk_Fd1.h"
 // A12 事件监视器，用于检测 PPU VRAM 地址的 A12 上升沿
 #include "NES/Mappers/A12Watcher.h"
 
+class FloppyDriveController;
+
 class MapperBbk final : public BaseMapper
 {
 public:
 	void Reset(bool softReset) override;
+	void Serialize(Serializer& s) override;
 	~MapperBbk() override;
 
 protected:
@@ -83,6 +85,18 @@ protected:
 	int     nCurScanLine = 0;
 	bool    bDiskAccess = false;
 
+	// 软驱时序与读盘快进（NesConfig.BbkAccurateFdcTiming / BbkFastForwardOnDiskAccess），每帧更新一次
+	void UpdateFdcTiming();
+	// 软驱空闲超过该帧数后才停止快进，避免在连续读取的扇区之间反复切换速度
+	static constexpr uint32_t FdcFastForwardHoldFrames = 30;
+	uint32_t _fdcPreviousFrame = 0;
+	uint32_t _fdcIdleFrames = FdcFastForwardHoldFrames;
+	bool _fdcFastForward = false;
+	// 上次应用到软驱控制器的时序设置，只在变化时重新设置
+	FloppyDriveController* _fdcTimingTarget = nullptr;
+	bool _fdcAccurateTiming = false;
+	ConsoleRegion _fdcTimingRegion = ConsoleRegion::Auto;
+
 	// MapAddr 返回类型常量
 	enum InnoCsType
 	{
@@ -96,6 +110,10 @@ protected:
 	// 参数：addr - CPU 地址；cs_type - 输出芯片选择类型；is_write - 是否写访问。
 	uint32_t MapAddr(uint16_t addr, int* cs_type, bool is_write);
 
+	// 根据 nRegFF14/1C/24/2C 与 bMapRam 更新 $8000-$FFFF 的 CPU 页表，使普通读写走直接指针路径。
+	// 映射结果与 MapAddr 保持一致；仅 $FF00-$FFFF IO 页及包含 $7FFFE 写入特例的页面仍由 ReadRegister/WriteRegister 处理。
+	void UpdatePrgMapping();
+
 	// Mapper 所属的 BBK FD1 输入设备（作为 Mapper 附属的输入设备）
 	std::shared_ptr<BbkFd1> _bbkInput;
 
@@ -112,32 +130,71 @@ protected:
 	int16_t PopLpcSample();
 	void EnqueueLpcByte(uint8_t value);
 
+	// 以下仅由解码线程调用
+	bool IsLpcResetPending();
+	bool IsLpcRunAheadFrame();
+	void ProcessLpcResetRequest();
+	bool PushLpcSample(int16_t sample);
+
+	// 同步解码模式（NesConfig.BbkSyncLpcDecode）：不创建解码线程，由 ProcessCpuClock 按 CPU 周期在模拟线程中驱动解码器。
+	// 解码器一次需要取得一整帧的数据，输入不足时回滚到解码前的状态并等待新数据，因此输出只取决于模拟状态，可随即时存档/倒带/录像精确重现。
+	int FeedLpcSyncByte(unsigned char* food);
+	bool DecodeLpcSyncFrame();
+	int16_t PopLpcSyncSample();
+
 	static constexpr uint32_t LpcSampleRate = 10000;
 	static constexpr size_t LpcDataBufferSize = 16;
 	static constexpr size_t LpcPcmMaxSize = 4096;
-
-	std::array<uint8_t, LpcDataBufferSize> _lpcDataBuffer = {};
-	size_t _lpcDataReadPos = 0;
-	size_t _lpcDataWritePos = 0;
-	size_t _lpcDataCount = 0;
-
-	std::mutex _lpcMutex;
-	std::condition_variable _lpcCond;
-	std::condition_variable _lpcAckCond;
-	bool _lpcThreadRunning = false;
-	bool _lpcStopRequested = false;
-	bool _lpcResetRequested = false;
-	bool _lpcResetAck = false;
+	// 解码线程等待输入/输出空间时的最长休眠时间，作为漏掉唤醒时的兜底
+	static constexpr int LpcWaitTimeoutMs = 10;
+	// lpc_d6_do 每次最多输出一帧（200 个样本）
+	static constexpr size_t LpcFrameMaxSize = 256;
+
+	// 两个方向均为单生产者/单消费者无锁环形缓冲：
+	// _lpcInput：模拟线程（$FF18 写入）-> 解码线程（LpcFeed）
+	// _lpcPcm：解码线程（LpcThreadRoutine）-> 模拟线程（ProcessCpuClock）
+	SpscRingBuffer<uint8_t, LpcDataBufferSize> _lpcInput;
+	SpscRingBuffer<int16_t, LpcPcmMaxSize> _lpcPcm;
+
+	std::atomic<bool> _lpcThreadRunning = false;
+	std::atomic<bool> _lpcStopRequested = false;
+
+	// 复位握手：模拟线程递增 _lpcResetRequest，解码线程在安全点复位解码器后把 _lpcResetAck 写为相同的值。
+	// _lpcResetFlush 表示完整复位（丢弃 _lpcResetInputPos 之前的输入字节，以及解码线程复位前已生成的 PCM）。
+	std::atomic<uint32_t> _lpcResetRequest = 0;
+	std::atomic<uint32_t> _lpcResetAck = 0;
+	std::atomic<bool> _lpcResetFlush = false;
+	std::atomic<size_t> _lpcResetInputPos = 0;
+	std::atomic<size_t> _lpcResetPcmPos = 0;
+	// 仅模拟线程使用：等待完整复位完成期间输出静音
+	bool _lpcFlushPending = false;
+	uint32_t _lpcFlushRequest = 0;
+
+	// 解码线程休眠时置位，对端在有新数据/腾出空间时据此决定是否唤醒
+	std::atomic<bool> _lpcFeedWaiting = false;
+	std::atomic<bool> _lpcPcmWaiting = false;
+	AutoResetEvent _lpcWakeEvent;
 
 	void* _lpcSynth = nullptr;
 	std::thread _lpcThread;
 
-	std::mutex _pcmMutex;
-	std::condition_variable _pcmCond;
-	std::deque<int16_t> _lpcPcmQueue;
 	int16_t _lpcLastSample = 0;
 	int16_t _lpcLastMixedSample = 0;
 	double _lpcCycleAccumulator = 0.0;
 	double _lpcCyclesPerSample = 1.0;
 	ConsoleRegion _lpcCachedRegion = ConsoleRegion::Auto;
+
+	// 以下仅在同步解码模式下使用，全部由模拟线程访问并随存档保存
+	bool _lpcSyncMode = false;
+	uint8_t _lpcSyncInput[LpcDataBufferSize] = {};
+	uint8_t _lpcSyncInputPos = 0;
+	uint8_t _lpcSyncInputCount = 0;
+	int16_t _lpcSyncPcm[LpcFrameMaxSize] = {};
+	uint16_t _lpcSyncPcmPos = 0;
+	uint16_t _lpcSyncPcmSize = 0;
+	// 上一次解码因输入不足而回滚，收到新字节或复位前不再尝试
+	bool _lpcSyncStalled = false;
+	// 解码过程中的临时状态（不需要保存）
+	uint8_t _lpcSyncConsumed = 0;
+	bool _lpcSyncUnderrun = false;
 };
\ No newline at end of file
@@ -700,7 +700,7 @@ void NesConsole::StartRecordingHdPack(HdPackBuilderOptions options)
 	_emu->GetVideoDecoder()->WaitForAsyncFrameDecode();
 
 	std::stringstream saveState;
-	_emu->Serialize(saveState, false, 0);
+	_emu->Serialize(saveState, false, CompressionCodec::Uncompressed);
 
 	_hdPackBuilder.reset();
 	_hdPackBuilder.reset(new HdPackBuilder(_emu, _ppu->GetPpuModel(), !_mapper->HasChrRom(), options));
@@ -723,7 +723,7 @@ void NesConsole::StopRecordingHdPack()
 		_emu->GetVideoDecoder()->WaitForAsyncFrameDecode();
 
 		std::stringstream saveState;
-		_emu->Serialize(saveState, false, 0);
+		_emu->Serialize(saveState, false, CompressionCodec::Uncompressed);
 
 		_memoryManager->UnregisterIODevice(_ppu.get());
 		if(_hdData) {
@@ -6,6 +6,7 @@
 #include "NES/NesConstants.h"
 #include "NES/NesPpu.h"
 #include "Shared/Video/BaseVideoFilter.h"
+#include "Shared/Video/PixelKernels.h"
 #include "Shared/EmuSettings.h"
 #include "Shared/Emulator.h"
 
@@ -171,10 +172,8 @@ void NesDefaultVideoFilter::DecodePpuBuffer(uint16_t* ppuOutputBuffer, uint32_t*
 	}
 
 	for(uint32_t i = 0; i < frame.Height; i++) {
-		for(uint32_t j = 0; j < frame.Width; j++) {
-			*out = _calculatedPalette[ppuOutputBuffer[(i + overscan.Top) * _baseFrameInfo.Width + j + overscan.Left]];
-			out++;
-		}
+		PixelKernels::ConvertPalette(ppuOutputBuffer + (i + overscan.Top) * _baseFrameInfo.Width + overscan.Left, out, frame.Width, _calculatedPalette);
+		out += frame.Width;
 	}
 }
 
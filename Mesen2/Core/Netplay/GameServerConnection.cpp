@@ -190,7 +190,7 @@ void GameServerConnection::ProcessNotification(ConsoleNotificationType type, voi
 			EmuSettings* settings = _emu->GetSettings();
 			s.Stream(*settings, "", -1);
 			stringstream currentConfig;
-			s.SaveTo(currentConfig, 0);
+			s.SaveTo(currentConfig, CompressionCodec::Uncompressed);
 
 			if(_previousConfig != currentConfig.str()) {
 				SendGameInformation();
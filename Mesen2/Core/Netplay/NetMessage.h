@@ -46,7 +46,7 @@ public:
 		Serialize(s);
 
 		stringstream out;
-		s.SaveTo(out);
+		s.SaveTo(out, CompressionCodec::Lz4);
 
 		string data = out.str();
 		uint32_t messageLength = (uint32_t)data.size() + 1;
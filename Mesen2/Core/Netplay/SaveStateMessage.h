@@ -29,7 +29,8 @@ public:
 		{
 			auto lock = emu->AcquireLock();
 			_activeCheats = emu->GetCheatManager()->GetCheats();
-			emu->Serialize(state, true);
+			//The whole message is compressed when sent, no need to compress the state itself
+			emu->Serialize(state, true, CompressionCodec::Uncompressed);
 		}
 
 		uint32_t dataSize = (uint32_t)state.tellp();
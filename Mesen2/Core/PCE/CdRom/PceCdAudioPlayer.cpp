@@ -33,6 +33,9 @@ void PceCdAudioPlayer::Play(uint32_t startSector, bool pause)
 		_state.CurrentSector = startSector;
 
 		_clockCounter = 0;
+
+		//Start loading the sectors while the seek delay is emulated
+		_cdrom->GetSectorPrefetcher().Prefetch(CdReadStream::Audio, startSector);
 	}
 }
 
@@ -47,11 +50,28 @@ void PceCdAudioPlayer::SetEndPosition(uint32_t endSector, CdPlayEndBehavior endB
 	_state.Status = CdAudioStatus::Playing;
 }
 
+void PceCdAudioPlayer::LoadSector()
+{
+	CdSectorPrefetcher& prefetcher = _cdrom->GetSectorPrefetcher();
+	prefetcher.ReadAudioSector(_state.CurrentSector, _sectorData);
+	_loadedSector = _state.CurrentSector;
+
+	if(_state.EndBehavior == CdPlayEndBehavior::Loop && _state.CurrentSector >= _state.EndSector) {
+		//Playback is about to restart at the start sector
+		prefetcher.Prefetch(CdReadStream::Audio, _state.StartSector);
+	}
+}
+
 void PceCdAudioPlayer::PlaySample()
 {
 	if(_state.Status == CdAudioStatus::Playing) {
-		_state.LeftSample = _disc->ReadLeftSample(_state.CurrentSector, _state.CurrentSample);
-		_state.RightSample = _disc->ReadRightSample(_state.CurrentSector, _state.CurrentSample);
+		if(_loadedSector != _state.CurrentSector) {
+			LoadSector();
+		}
+
+		uint8_t* sample = _sectorData + _state.CurrentSample * 4;
+		_state.LeftSample = (int16_t)(sample[0] | (sample[1] << 8));
+		_state.RightSample = (int16_t)(sample[2] | (sample[3] << 8));
 		_samplesToPlay.push_back(_state.LeftSample);
 		_samplesToPlay.push_back(_state.RightSample);
 		_state.CurrentSample++;
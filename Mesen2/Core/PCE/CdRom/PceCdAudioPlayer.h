@@ -24,9 +24,14 @@ class PceCdAudioPlayer final : public IAudioProvider, public ISerializable
 	uint32_t _subcodeSector = 0;
 	uint32_t _nextSubcodeSector = 0;
 	uint32_t _seekDelay = 0;
+
+	//Copy of the sector being played (588 stereo samples)
+	uint8_t _sectorData[2352] = {};
+	uint32_t _loadedSector = UINT32_MAX;
 	
 	HermiteResampler _resampler;
 	
+	void LoadSector();
 	void PlaySample();
 	void ProcessAudioPlaybackStart();
 
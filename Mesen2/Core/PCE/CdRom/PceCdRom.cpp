@@ -14,7 +14,7 @@
 
 using namespace ScsiSignal;
 
-PceCdRom::PceCdRom(Emulator* emu, PceConsole* console, DiscInfo& disc) : _disc(disc), _scsi(emu, console, this, _disc), _adpcm(console, emu, this, &_scsi), _audioFader(console), _audioPlayer(emu, this, _disc)
+PceCdRom::PceCdRom(Emulator* emu, PceConsole* console, DiscInfo& disc) : _disc(disc), _prefetcher(_disc), _scsi(emu, console, this, _disc), _adpcm(console, emu, this, &_scsi), _audioFader(console), _audioPlayer(emu, this, _disc)
 {
 	_emu = emu;
 	_console = console;
@@ -61,6 +61,11 @@ PceCdRom::~PceCdRom()
 	_emu->GetSoundMixer()->UnregisterAudioProvider(&_audioPlayer);
 	_emu->GetSoundMixer()->UnregisterAudioProvider(&_adpcm);
 
+	CdSectorPrefetchStats stats = _prefetcher.GetStats();
+	if(stats.Hits + stats.Misses > 0) {
+		MessageManager::Log("[CD-ROM] Sector reads: " + std::to_string(stats.Hits) + " prefetched, " + std::to_string(stats.Misses) + " read on demand");
+	}
+
 	delete[] _saveRam;
 	delete[] _orgSaveRam;
 	delete[] _cdromRam;
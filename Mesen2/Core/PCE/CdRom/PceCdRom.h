@@ -7,6 +7,7 @@
 #include "PCE/PceTypes.h"
 #include "Shared/MemoryType.h"
 #include "Shared/CdReader.h"
+#include "Shared/CdSectorPrefetcher.h"
 #include "Utilities/ISerializable.h"
 
 class Emulator;
@@ -20,6 +21,7 @@ private:
 	PceConsole* _console = nullptr;
 
 	DiscInfo _disc;
+	CdSectorPrefetcher _prefetcher;
 	PceScsiBus _scsi;
 	PceAdpcm _adpcm;
 	PceAudioFader _audioFader;
@@ -61,6 +63,7 @@ public:
 
 	PceCdAudioPlayer& GetAudioPlayer() { return _audioPlayer; }
 	PceAudioFader& GetAudioFader() { return _audioFader; }
+	CdSectorPrefetcher& GetSectorPrefetcher() { return _prefetcher; }
 	
 	uint32_t GetCurrentSector();
 
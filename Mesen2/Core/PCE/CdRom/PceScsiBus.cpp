@@ -253,6 +253,9 @@ void PceScsiBus::CmdRead()
 	_state.Sector = sector;
 	_state.SectorsToRead = sectorsToRead;
 
+	//Start loading the sectors while the seek delay is emulated
+	_cdrom->GetSectorPrefetcher().Prefetch(CdReadStream::Data, sector);
+
 	//Set the phase to "data in" right away
 	//Ys IV appears to expect this to happen relatively quickly after
 	//sending the read command to the drive. Otherwise it keeps waiting in a loop
@@ -487,7 +490,7 @@ void PceScsiBus::ProcessDiscRead()
 			if(_dataBuffer.empty()) {
 				//read disc data
 				_dataBuffer.clear();
-				_disc->ReadDataSector(_state.Sector, _dataBuffer);
+				_cdrom->GetSectorPrefetcher().ReadDataSector(_state.Sector, _dataBuffer);
 
 				LogDebug("[SCSI] Sector #" + std::to_string(_state.Sector) + " finished reading.");
 
@@ -675,6 +678,10 @@ void PceScsiBus::Serialize(Serializer& s)
 		_dataBuffer.clear();
 		_dataBuffer.insert(_dataBuffer.end(), dataBuffer.begin(), dataBuffer.end());
 
+		if(_state.SectorsToRead > 0) {
+			_cdrom->GetSectorPrefetcher().Prefetch(CdReadStream::Data, _state.Sector);
+		}
+
 		_needExec = true;
 	}
 }
@@ -238,6 +238,134 @@ bool CdReader::LoadCue(VirtualFile& cueFile, DiscInfo& disc)
 		lastTrk.LastSector = lastTrk.EndPosition.ToLba();
 	}
 
+	InitDiscInfo(disc);
+	LoadSubcodeFile(cueFile, disc);
+
+	return disc.Tracks.size() > 0;
+}
+
+struct ChdTrackEntry
+{
+	int Number = 0;
+	string Type;
+	uint32_t Frames = 0;
+	uint32_t Pregap = 0;
+	bool PregapInImage = false;
+};
+
+bool CdReader::LoadChd(VirtualFile& file, DiscInfo& disc)
+{
+	shared_ptr<ChdFile> chd(new ChdFile());
+	if(!chd->Load(file)) {
+		return false;
+	}
+
+	if(chd->GetUnitSize() != DiscInfo::ChdFrameSize) {
+		MessageManager::Log("[CHD] Not a CD-ROM image");
+		return false;
+	}
+
+	//Track list: "TRACK:%d TYPE:%s SUBTYPE:%s FRAMES:%d PREGAP:%d PGTYPE:%s PGSUB:%s POSTGAP:%d" (older images only contain the first 4 values)
+	vector<string> trackMetadata = chd->GetMetadata(ChdFile::MakeTag('C', 'H', 'T', '2'));
+	if(trackMetadata.empty()) {
+		trackMetadata = chd->GetMetadata(ChdFile::MakeTag('C', 'H', 'T', 'R'));
+	}
+
+	vector<ChdTrackEntry> entries;
+	for(string& metadata : trackMetadata) {
+		ChdTrackEntry entry = {};
+		for(string& value : StringUtilities::Split(metadata, ' ')) {
+			size_t separator = value.find(':');
+			if(separator == string::npos) {
+				continue;
+			}
+
+			string name = value.substr(0, separator);
+			value = value.substr(separator + 1);
+			try {
+				if(name == "TRACK") {
+					entry.Number = std::stoi(value);
+				} else if(name == "TYPE") {
+					entry.Type = value;
+				} else if(name == "FRAMES") {
+					entry.Frames = std::stoi(value);
+				} else if(name == "PREGAP") {
+					entry.Pregap = std::stoi(value);
+				} else if(name == "PGTYPE") {
+					//Pregap types that start with V are stored in the image (as part of the track's frames)
+					entry.PregapInImage = !value.empty() && value[0] == 'V';
+				}
+			} catch(const std::exception&) {
+				MessageManager::Log("[CHD] Invalid track metadata: " + metadata);
+				return false;
+			}
+		}
+		entries.push_back(entry);
+	}
+
+	std::sort(entries.begin(), entries.end(), [](const ChdTrackEntry& a, const ChdTrackEntry& b) { return a.Number < b.Number; });
+
+	disc.Files.push_back(file);
+	disc.Chd = chd;
+
+	uint32_t frame = 0;
+	uint32_t sector = 0;
+	for(size_t i = 0; i < entries.size(); i++) {
+		ChdTrackEntry& entry = entries[i];
+		TrackInfo trk = {};
+
+		if(entry.Type == "AUDIO") {
+			trk.Format = TrackFormat::Audio;
+		} else if(entry.Type == "MODE1_RAW") {
+			trk.Format = TrackFormat::Mode1_2352;
+		} else if(entry.Type == "MODE1") {
+			trk.Format = TrackFormat::Mode1_2048;
+		} else {
+			MessageManager::Log("[CHD] Unsupported track format: " + entry.Type);
+			return false;
+		}
+
+		uint32_t pregapFrames = entry.PregapInImage ? std::min(entry.Pregap, entry.Frames) : 0;
+		if(entry.Pregap > 0 && (i > 0 || entry.PregapInImage)) {
+			//Same as the cue sheet's INDEX 00 (pregap in the image) or PREGAP (pregap not in the image) entries
+			//The first track's pregap is only used if it's stored in the image (the disc's 2-second lead-in is implicit)
+			trk.HasLeadIn = true;
+			trk.LeadInPosition = DiscPosition::FromLba(sector);
+			sector += entry.Pregap;
+		}
+
+		trk.FirstSector = sector;
+		trk.StartPosition = DiscPosition::FromLba(sector);
+		trk.SectorCount = entry.Frames - pregapFrames;
+		trk.LastSector = trk.FirstSector + trk.SectorCount - 1;
+		trk.EndPosition = DiscPosition::FromLba(trk.LastSector);
+		trk.FileIndex = 0;
+		trk.FileOffset = (frame + pregapFrames) * DiscInfo::ChdFrameSize;
+		trk.Size = trk.SectorCount * DiscInfo::ChdFrameSize;
+
+		if(trk.SectorCount == 0 || (uint64_t)trk.FileOffset + trk.Size > chd->GetSize()) {
+			MessageManager::Log("[CHD] Invalid track metadata");
+			return false;
+		}
+
+		disc.Tracks.push_back(trk);
+		sector = trk.LastSector + 1;
+
+		//Each track's frames are padded to a multiple of 4 frames
+		frame += (entry.Frames + 3) / 4 * 4;
+	}
+
+	if(disc.Tracks.empty()) {
+		MessageManager::Log("[CHD] No tracks found");
+		return false;
+	}
+
+	InitDiscInfo(disc);
+	return true;
+}
+
+void CdReader::InitDiscInfo(DiscInfo& disc)
+{
 	TrackInfo& discLastTrk = disc.Tracks[disc.Tracks.size() - 1];
 	disc.DiscSize = discLastTrk.FileOffset + discLastTrk.Size;
 	disc.DiscSectorCount = discLastTrk.LastSector + 1;
@@ -256,10 +384,6 @@ bool CdReader::LoadCue(VirtualFile& cueFile, DiscInfo& disc)
 		i++;
 	}
 	MessageManager::Log("---- END TRACKS ----");
-
-	LoadSubcodeFile(cueFile, disc);
-
-	return disc.Tracks.size() > 0;
 }
 
 void CdReader::LoadSubcodeFile(VirtualFile& cueFile, DiscInfo& disc)
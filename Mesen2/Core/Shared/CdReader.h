@@ -2,6 +2,7 @@
 #include "pch.h"
 #include "Utilities/VirtualFile.h"
 #include "Shared/MessageManager.h"
+#include "Shared/ChdFile.h"
 
 enum class TrackFormat
 {
@@ -58,7 +59,7 @@ struct TrackInfo
 
 	TrackFormat Format;
 	uint32_t FileIndex;
-	uint32_t FileOffset;
+	uint32_t FileOffset; //For CHD images, this is the offset in the image's decompressed data
 	
 	uint32_t FirstSector;
 	uint32_t LastSector;
@@ -77,8 +78,13 @@ struct TrackInfo
 struct DiscInfo
 {
 	static constexpr int SectorSize = 2352;
+	static constexpr int DataSectorSize = 2048;
+
+	//CHD images store each sector followed by its subchannel data
+	static constexpr int ChdFrameSize = 2352 + 96;
 
 	vector<VirtualFile> Files;
+	shared_ptr<ChdFile> Chd;
 	vector<TrackInfo> Tracks;
 	vector<uint8_t> SubCode;
 	vector<uint8_t> DecodedSubCode;
@@ -118,8 +124,27 @@ struct DiscInfo
 		return -1;
 	}
 
-	template<typename T>
-	void ReadDataSector(uint32_t sector, T& outData)
+	//Reads data from a sector - offset is relative to the start of the sector, as it is stored in the image
+	bool ReadSectorData(TrackInfo& trk, uint32_t sector, uint32_t offset, uint8_t* outData, uint32_t length)
+	{
+		uint32_t index = sector - trk.FirstSector;
+		if(Chd) {
+			if(!Chd->ReadBytes((uint64_t)trk.FileOffset + (uint64_t)index * ChdFrameSize + offset, outData, length)) {
+				return false;
+			}
+			if(trk.Format == TrackFormat::Audio) {
+				//CHD images store audio samples as big-endian values (reads are always aligned to a sample)
+				for(uint32_t i = 0; i + 1 < length; i += 2) {
+					std::swap(outData[i], outData[i + 1]);
+				}
+			}
+			return true;
+		}
+		return Files[trk.FileIndex].ReadBytes(trk.FileOffset + index * trk.GetSectorSize() + offset, outData, length);
+	}
+
+	//Reads the 2048 bytes of user data of a data sector - returns false when the sector's data could not be read
+	bool ReadUserData(uint32_t sector, uint8_t* outData)
 	{
 		constexpr int Mode1_2352_SectorHeaderSize = 16;
 
@@ -127,16 +152,39 @@ struct DiscInfo
 		if(track < 0) {
 			//TODO support reading pregap when it's available
 			LogDebug("Invalid sector/track (or inside pregap)");
-			outData.insert(outData.end(), 2048, 0);
-		} else {
-			TrackInfo& trk = Tracks[track];
-			uint32_t sectorSize = trk.GetSectorSize();
-			uint32_t sectorHeaderSize = trk.Format == TrackFormat::Mode1_2352 ? Mode1_2352_SectorHeaderSize : 0;
-			uint32_t byteOffset = trk.FileOffset + (sector - trk.FirstSector) * sectorSize;
-			if(!Files[trk.FileIndex].ReadChunk(outData, byteOffset + sectorHeaderSize, 2048)) {
-				LogDebug("Invalid read offsets");
-			}
+			memset(outData, 0, DataSectorSize);
+			return true;
 		}
+
+		TrackInfo& trk = Tracks[track];
+		uint32_t sectorHeaderSize = trk.Format == TrackFormat::Mode1_2352 ? Mode1_2352_SectorHeaderSize : 0;
+		if(!ReadSectorData(trk, sector, sectorHeaderSize, outData, DataSectorSize)) {
+			LogDebug("Invalid read offsets");
+			return false;
+		}
+		return true;
+	}
+
+	template<typename T>
+	void ReadDataSector(uint32_t sector, T& outData)
+	{
+		uint8_t data[DataSectorSize];
+		if(ReadUserData(sector, data)) {
+			outData.insert(outData.end(), data, data + DataSectorSize);
+		}
+	}
+
+	//Reads a whole 2352-byte sector (588 stereo samples) - returns false (and fills the sector with silence) when it could not be read
+	bool ReadAudioSector(uint32_t sector, uint8_t* outData)
+	{
+		int32_t track = GetTrack(sector);
+		if(track >= 0 && ReadSectorData(Tracks[track], sector, 0, outData, DiscInfo::SectorSize)) {
+			return true;
+		}
+
+		LogDebug("Invalid sector/track");
+		memset(outData, 0, DiscInfo::SectorSize);
+		return false;
 	}
 
 	int16_t ReadAudioSample(uint32_t sector, uint32_t sample, uint32_t byteOffset)
@@ -147,9 +195,11 @@ struct DiscInfo
 			return 0;
 		}
 
-		uint32_t fileIndex = Tracks[track].FileIndex;
-		uint32_t startByte = Tracks[track].FileOffset + (sector - Tracks[track].FirstSector) * DiscInfo::SectorSize;
-		return (int16_t)(Files[fileIndex].ReadByte(startByte + sample * 4 + byteOffset) | (Files[fileIndex].ReadByte(startByte + sample * 4 + 1 + byteOffset) << 8));
+		uint8_t sampleData[2];
+		if(!ReadSectorData(Tracks[track], sector, sample * 4 + byteOffset, sampleData, 2)) {
+			return 0;
+		}
+		return (int16_t)(sampleData[0] | (sampleData[1] << 8));
 	}
 
 	int16_t ReadLeftSample(uint32_t sector, uint32_t sample)
@@ -175,9 +225,11 @@ struct DiscInfo
 class CdReader
 {
 	static void LoadSubcodeFile(VirtualFile& cueFile, DiscInfo& disc);
+	static void InitDiscInfo(DiscInfo& disc);
 
 public:
 	static bool LoadCue(VirtualFile& file, DiscInfo& disc);
+	static bool LoadChd(VirtualFile& file, DiscInfo& disc);
 
 	static uint8_t ToBcd(uint8_t value)
 	{
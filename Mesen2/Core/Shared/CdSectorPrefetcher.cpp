@@ -0,0 +1,177 @@
+#include "pch.h"
+#include "Shared/CdSectorPrefetcher.h"
+
+CdSectorPrefetcher::CdSectorPrefetcher(DiscInfo& disc)
+{
+	_disc = &disc;
+	_hits = 0;
+	_misses = 0;
+}
+
+CdSectorPrefetcher::~CdSectorPrefetcher()
+{
+	{
+		std::lock_guard<std::mutex> lock(_lock);
+		_stopFlag = true;
+	}
+	_signal.notify_one();
+
+	if(_thread) {
+		_thread->join();
+	}
+}
+
+bool CdSectorPrefetcher::ReadSector(CdReadStream stream, uint32_t sector, uint8_t* out)
+{
+	std::lock_guard<std::mutex> lock(_readLock);
+	if(stream == CdReadStream::Data) {
+		return _disc->ReadUserData(sector, out);
+	} else {
+		return _disc->ReadAudioSector(sector, out);
+	}
+}
+
+CdSectorPrefetcher::SectorRing& CdSectorPrefetcher::GetRing(CdReadStream stream)
+{
+	//The rings are only allocated once they are used (no memory is used when no disc is loaded, or when no CD audio is played)
+	unique_ptr<SectorRing>& ring = _rings[(int)stream];
+	if(!ring) {
+		ring.reset(new SectorRing());
+	}
+	return *ring;
+}
+
+void CdSectorPrefetcher::SetCursor(SectorRing& ring, uint32_t sector)
+{
+	//Must be called while holding _lock
+	ring.Cursor = sector;
+	ring.Active = true;
+	_wakeUp = true;
+
+	if(!_thread) {
+		_thread.reset(new thread(&CdSectorPrefetcher::PrefetchThread, this));
+	}
+}
+
+bool CdSectorPrefetcher::FindNextSector(CdReadStream& stream, uint32_t& sector)
+{
+	//Must be called while holding _lock
+	//The sectors closest to either cursor are read first, alternating between both streams
+	for(uint32_t distance = 0; distance < RingSize; distance++) {
+		for(uint32_t i = 0; i < StreamCount; i++) {
+			SectorRing* ring = _rings[i].get();
+			if(!ring || !ring->Active) {
+				continue;
+			}
+
+			uint32_t nextSector = ring->Cursor + distance;
+			if(nextSector >= _disc->DiscSectorCount) {
+				continue;
+			}
+
+			CachedSector& entry = ring->Sectors[nextSector % RingSize];
+			if(!entry.Loaded || entry.Sector != nextSector) {
+				stream = (CdReadStream)i;
+				sector = nextSector;
+				return true;
+			}
+		}
+	}
+	return false;
+}
+
+void CdSectorPrefetcher::PrefetchThread()
+{
+	uint8_t buffer[DiscInfo::SectorSize];
+
+	std::unique_lock<std::mutex> lock(_lock);
+	while(!_stopFlag) {
+		CdReadStream stream;
+		uint32_t sector;
+		if(!FindNextSector(stream, sector)) {
+			_signal.wait(lock, [this] { return _wakeUp || _stopFlag; });
+			_wakeUp = false;
+			continue;
+		}
+
+		lock.unlock();
+		bool valid = ReadSector(stream, sector, buffer);
+		lock.lock();
+
+		SectorRing& ring = *_rings[(int)stream];
+		if(sector - ring.Cursor < RingSize) {
+			//Only keep the sector if the cursor hasn't moved away from it while it was being read
+			CachedSector& entry = ring.Sectors[sector % RingSize];
+			memcpy(entry.Data, buffer, DiscInfo::SectorSize);
+			entry.Sector = sector;
+			entry.Valid = valid;
+			entry.Loaded = true;
+		}
+	}
+}
+
+bool CdSectorPrefetcher::GetSector(CdReadStream stream, uint32_t sector, uint8_t* out)
+{
+	uint32_t size = stream == CdReadStream::Data ? DiscInfo::DataSectorSize : DiscInfo::SectorSize;
+	bool hit = false;
+	bool valid = false;
+
+	if(_disc->DiscSectorCount > 0) {
+		{
+			std::lock_guard<std::mutex> lock(_lock);
+			SectorRing& ring = GetRing(stream);
+			CachedSector& entry = ring.Sectors[sector % RingSize];
+			if(entry.Loaded && entry.Sector == sector) {
+				memcpy(out, entry.Data, size);
+				valid = entry.Valid;
+				hit = true;
+			}
+
+			//Sectors are read sequentially, start reading the next ones
+			SetCursor(ring, sector + 1);
+		}
+		_signal.notify_one();
+	}
+
+	if(hit) {
+		_hits++;
+		return valid;
+	}
+
+	_misses++;
+	return ReadSector(stream, sector, out);
+}
+
+void CdSectorPrefetcher::Prefetch(CdReadStream stream, uint32_t sector)
+{
+	if(_disc->DiscSectorCount == 0) {
+		return;
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(_lock);
+		SetCursor(GetRing(stream), sector);
+	}
+	_signal.notify_one();
+}
+
+void CdSectorPrefetcher::ReadDataSector(uint32_t sector, deque<uint8_t>& outData)
+{
+	uint8_t data[DiscInfo::DataSectorSize];
+	if(GetSector(CdReadStream::Data, sector, data)) {
+		outData.insert(outData.end(), data, data + DiscInfo::DataSectorSize);
+	}
+}
+
+void CdSectorPrefetcher::ReadAudioSector(uint32_t sector, uint8_t* outData)
+{
+	GetSector(CdReadStream::Audio, sector, outData);
+}
+
+CdSectorPrefetchStats CdSectorPrefetcher::GetStats()
+{
+	CdSectorPrefetchStats stats = {};
+	stats.Hits = _hits;
+	stats.Misses = _misses;
+	return stats;
+}
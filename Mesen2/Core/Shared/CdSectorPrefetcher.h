@@ -0,0 +1,82 @@
+#pragma once
+#include "pch.h"
+#include <condition_variable>
+#include <mutex>
+#include "Shared/CdReader.h"
+
+enum class CdReadStream
+{
+	Data = 0,
+	Audio = 1
+};
+
+struct CdSectorPrefetchStats
+{
+	uint64_t Hits;
+	uint64_t Misses;
+};
+
+//Reads the disc's sectors ahead of the emulation, on a worker thread.
+//Each stream (data sectors read by the drive, audio sectors played back by the CD-DA player) has a cursor set by the emulation
+//(when a read/playback is started, and after each sector is read) and the worker fills a ring of the sectors that follow it.
+//Sectors that are not in the ring when the emulation needs them (misses) are read synchronously.
+class CdSectorPrefetcher
+{
+private:
+	static constexpr uint32_t RingSize = 32;
+	static constexpr uint32_t StreamCount = 2;
+
+	struct CachedSector
+	{
+		uint32_t Sector = 0;
+		bool Loaded = false;
+		bool Valid = false;
+		uint8_t Data[DiscInfo::SectorSize];
+	};
+
+	struct SectorRing
+	{
+		//Direct-mapped (sector % RingSize), so the sectors following the cursor never evict each other
+		CachedSector Sectors[RingSize];
+		uint32_t Cursor = 0;
+		bool Active = false;
+	};
+
+	DiscInfo* _disc = nullptr;
+	unique_ptr<SectorRing> _rings[StreamCount];
+
+	unique_ptr<thread> _thread;
+	std::mutex _lock;
+	std::condition_variable _signal;
+	bool _wakeUp = false;
+	bool _stopFlag = false;
+
+	//VirtualFile isn't thread-safe - the worker and the synchronous reads done on misses both go through this lock
+	std::mutex _readLock;
+
+	atomic<uint64_t> _hits;
+	atomic<uint64_t> _misses;
+
+	bool ReadSector(CdReadStream stream, uint32_t sector, uint8_t* out);
+	bool FindNextSector(CdReadStream& stream, uint32_t& sector);
+	SectorRing& GetRing(CdReadStream stream);
+	void SetCursor(SectorRing& ring, uint32_t sector);
+	bool GetSector(CdReadStream stream, uint32_t sector, uint8_t* out);
+
+	void PrefetchThread();
+
+public:
+	CdSectorPrefetcher(DiscInfo& disc);
+	~CdSectorPrefetcher();
+
+	//Lets the worker start reading the sectors that follow the given sector (e.g when a seek starts)
+	void Prefetch(CdReadStream stream, uint32_t sector);
+
+	//Same result as DiscInfo::ReadDataSector - appends the sector's 2048 bytes of user data
+	void ReadDataSector(uint32_t sector, deque<uint8_t>& outData);
+
+	//Same result as DiscInfo::ReadAudioSector - fills the 2352 bytes of the sector
+	void ReadAudioSector(uint32_t sector, uint8_t* outData);
+
+	CdSectorPrefetchStats GetStats();
+};
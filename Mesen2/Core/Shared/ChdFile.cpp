@@ -0,0 +1,611 @@
+#include "pch.h"
+#include "Shared/ChdFile.h"
+#include "Shared/MessageManager.h"
+#include "Utilities/miniz.h"
+#include "SevenZip/7zAlloc.h"
+#include "SevenZip/LzmaDec.h"
+
+//Reads the compressed map's bitstream (most significant bits first)
+class ChdBitReader
+{
+private:
+	const uint8_t* _data;
+	uint32_t _size;
+	uint32_t _offset = 0;
+	uint32_t _buffer = 0;
+	int _bits = 0;
+
+public:
+	ChdBitReader(const uint8_t* data, uint32_t size)
+	{
+		_data = data;
+		_size = size;
+	}
+
+	uint32_t Peek(int count)
+	{
+		if(count == 0) {
+			return 0;
+		}
+
+		if(count > _bits) {
+			while(_bits <= 24) {
+				if(_offset < _size) {
+					_buffer |= (uint32_t)_data[_offset] << (24 - _bits);
+				}
+				_offset++;
+				_bits += 8;
+			}
+		}
+		return _buffer >> (32 - count);
+	}
+
+	void Remove(int count)
+	{
+		_buffer = count >= 32 ? 0 : (_buffer << count);
+		_bits -= count;
+	}
+
+	uint32_t Read(int count)
+	{
+		uint32_t value = Peek(count);
+		Remove(count);
+		return value;
+	}
+
+	bool IsOverflow()
+	{
+		return _offset - _bits / 8 > _size;
+	}
+};
+
+static uint16_t ReadBe16(const uint8_t* data) { return (data[0] << 8) | data[1]; }
+static uint32_t ReadBe24(const uint8_t* data) { return (data[0] << 16) | (data[1] << 8) | data[2]; }
+static uint32_t ReadBe32(const uint8_t* data) { return ((uint32_t)data[0] << 24) | (data[1] << 16) | (data[2] << 8) | data[3]; }
+static uint64_t ReadBe48(const uint8_t* data) { return ((uint64_t)ReadBe16(data) << 32) | ReadBe32(data + 2); }
+static uint64_t ReadBe64(const uint8_t* data) { return ((uint64_t)ReadBe32(data) << 32) | ReadBe32(data + 4); }
+
+static void WriteBe(uint8_t* out, uint64_t value, int size)
+{
+	for(int i = size - 1; i >= 0; i--) {
+		out[i] = (uint8_t)value;
+		value >>= 8;
+	}
+}
+
+static uint16_t Crc16(const uint8_t* data, size_t length)
+{
+	//CRC-16/CCITT (polynomial 0x1021, initial value 0xFFFF)
+	uint16_t crc = 0xFFFF;
+	for(size_t i = 0; i < length; i++) {
+		crc ^= data[i] << 8;
+		for(int j = 0; j < 8; j++) {
+			crc = (crc & 0x8000) ? ((crc << 1) ^ 0x1021) : (crc << 1);
+		}
+	}
+	return crc;
+}
+
+static string TagToString(uint32_t tag)
+{
+	string str;
+	for(int i = 24; i >= 0; i -= 8) {
+		char c = (char)(tag >> i);
+		str += (c >= 0x20 && c < 0x7F) ? c : '?';
+	}
+	return str;
+}
+
+static bool InflateData(const uint8_t* src, uint32_t srcSize, uint8_t* out, uint32_t outSize)
+{
+	//Raw deflate stream (no zlib header)
+	return tinfl_decompress_mem_to_mem(out, outSize, src, srcSize, 0) == outSize;
+}
+
+static bool DecodeLzmaData(const uint8_t* src, uint32_t srcSize, uint8_t* out, uint32_t outSize)
+{
+	//The streams have no header - chdman always uses the encoder's default properties (lc=3, lp=0, pb=2)
+	//The dictionary can't be larger than a hunk
+	uint32_t dictSize = std::max<uint32_t>(outSize, 1 << 12);
+	uint8_t props[LZMA_PROPS_SIZE] = { (2 * 5 + 0) * 9 + 3, (uint8_t)dictSize, (uint8_t)(dictSize >> 8), (uint8_t)(dictSize >> 16), (uint8_t)(dictSize >> 24) };
+
+	ISzAlloc allocImp { SzAlloc, SzFree };
+	SizeT destLen = outSize;
+	SizeT srcLen = srcSize;
+	ELzmaStatus status;
+	SRes result = LzmaDecode(out, &destLen, src, &srcLen, props, LZMA_PROPS_SIZE, LZMA_FINISH_ANY, &status, &allocImp);
+	return result == SZ_OK && destLen == outSize;
+}
+
+bool ChdFile::Load(VirtualFile& file)
+{
+	_file = file;
+
+	uint8_t header[HeaderSize];
+	if(!_file.IsValid() || !ReadFileData(0, header, HeaderSize) || memcmp(header, "MComprHD", 8) != 0) {
+		MessageManager::Log("[CHD] Invalid file: " + file.GetFileName());
+		return false;
+	}
+
+	uint32_t version = ReadBe32(header + 12);
+	if(version != 5) {
+		MessageManager::Log("[CHD] Unsupported version: " + std::to_string(version) + " (only v5 images are supported)");
+		return false;
+	}
+
+	for(int i = 0; i < 4; i++) {
+		_codecs[i] = ReadBe32(header + 16 + i * 4);
+	}
+	_logicalSize = ReadBe64(header + 32);
+	uint64_t mapOffset = ReadBe64(header + 40);
+	uint64_t metadataOffset = ReadBe64(header + 48);
+	_hunkSize = ReadBe32(header + 56);
+	_unitSize = ReadBe32(header + 60);
+
+	if(_hunkSize == 0 || _unitSize == 0 || _hunkSize % _unitSize != 0 || (_logicalSize + _hunkSize - 1) / _hunkSize > UINT32_MAX) {
+		MessageManager::Log("[CHD] Invalid header");
+		return false;
+	}
+	_hunkCount = (uint32_t)((_logicalSize + _hunkSize - 1) / _hunkSize);
+
+	for(int i = 104; i < 124; i++) {
+		if(header[i] != 0) {
+			MessageManager::Log("[CHD] Images that depend on a parent image are not supported");
+			return false;
+		}
+	}
+
+	if(!ReadMap(mapOffset) || !ReadMetadata(metadataOffset)) {
+		return false;
+	}
+
+	//Hunks are never moved in memory once they are in the cache
+	_cache.reserve(MaxCachedHunks);
+	return true;
+}
+
+bool ChdFile::ReadFileData(uint64_t offset, uint8_t* out, uint32_t length)
+{
+	if(offset + length > _file.GetSize() || offset > UINT32_MAX) {
+		return false;
+	}
+	return _file.ReadBytes((uint32_t)offset, out, length);
+}
+
+bool ChdFile::ReadMap(uint64_t mapOffset)
+{
+	_hunks.resize(_hunkCount);
+
+	if(_codecs[0] == 0) {
+		//Uncompressed image - each map entry is the hunk's position in the file (in hunks), 0 when the hunk only contains zeroes
+		vector<uint8_t> map((size_t)_hunkCount * 4);
+		if(!ReadFileData(mapOffset, map.data(), (uint32_t)map.size())) {
+			MessageManager::Log("[CHD] Invalid map");
+			return false;
+		}
+
+		for(uint32_t i = 0; i < _hunkCount; i++) {
+			uint32_t position = ReadBe32(&map[i * 4]);
+			_hunks[i] = { position ? (uint8_t)HunkType::Uncompressed : (uint8_t)HunkType::ZeroFilled, _hunkSize, (uint64_t)position * _hunkSize };
+		}
+		return true;
+	}
+
+	if(!ReadCompressedMap(mapOffset)) {
+		MessageManager::Log("[CHD] Invalid map");
+		return false;
+	}
+
+	for(uint32_t i = 0; i < _hunkCount; i++) {
+		HunkInfo& hunk = _hunks[i];
+		if(hunk.Type < HunkType::Uncompressed && !IsCodecSupported(_codecs[hunk.Type])) {
+			MessageManager::Log("[CHD] Unsupported compression codec: " + TagToString(_codecs[hunk.Type]) + " (recompress the image with: chdman createcd -c cdlz,cdzl)");
+			return false;
+		} else if(hunk.Type == HunkType::Parent) {
+			MessageManager::Log("[CHD] Images that depend on a parent image are not supported");
+			return false;
+		} else if(hunk.Type == HunkType::Self && hunk.Offset >= i) {
+			return false;
+		}
+	}
+	return true;
+}
+
+bool ChdFile::ReadCompressedMap(uint64_t mapOffset)
+{
+	enum MapEntryType
+	{
+		Compressed0 = 0,
+		Compressed3 = 3,
+		None = 4,
+		Self = 5,
+		Parent = 6,
+		RleSmall = 7,
+		RleLarge = 8,
+		Self0 = 9,
+		Self1 = 10,
+		ParentSelf = 11,
+		Parent0 = 12,
+		Parent1 = 13
+	};
+
+	uint8_t mapHeader[16];
+	if(!ReadFileData(mapOffset, mapHeader, sizeof(mapHeader))) {
+		return false;
+	}
+
+	uint32_t mapSize = ReadBe32(mapHeader);
+	uint64_t hunkOffset = ReadBe48(mapHeader + 4);
+	uint16_t mapCrc = ReadBe16(mapHeader + 10);
+	uint8_t lengthBits = mapHeader[12];
+	uint8_t selfBits = mapHeader[13];
+	uint8_t parentBits = mapHeader[14];
+
+	vector<uint8_t> mapData(mapSize);
+	if(!ReadFileData(mapOffset + sizeof(mapHeader), mapData.data(), mapSize)) {
+		return false;
+	}
+	ChdBitReader reader(mapData.data(), mapSize);
+
+	//The type of each hunk is huffman-coded (16 codes, up to 8 bits long)
+	//The code lengths are stored first, run-length encoded
+	constexpr int CodeCount = 16;
+	constexpr int MaxCodeBits = 8;
+	uint8_t codeLengths[CodeCount] = {};
+	for(int code = 0; code < CodeCount;) {
+		uint8_t length = reader.Read(4);
+		if(length != 1) {
+			codeLengths[code++] = length;
+		} else {
+			length = reader.Read(4);
+			if(length == 1) {
+				codeLengths[code++] = length;
+			} else {
+				int repeatCount = reader.Read(4) + 3;
+				if(code + repeatCount > CodeCount) {
+					return false;
+				}
+				while(repeatCount--) {
+					codeLengths[code++] = length;
+				}
+			}
+		}
+	}
+
+	//Assign canonical codes (starting with the longest codes) and fill a lookup table indexed by the next 8 bits of the stream
+	uint32_t firstCode[MaxCodeBits + 1] = {};
+	uint32_t lengthCount[MaxCodeBits + 1] = {};
+	for(int code = 0; code < CodeCount; code++) {
+		if(codeLengths[code] > MaxCodeBits) {
+			return false;
+		}
+		lengthCount[codeLengths[code]]++;
+	}
+
+	uint32_t start = 0;
+	for(int length = MaxCodeBits; length > 0; length--) {
+		uint32_t nextStart = (start + lengthCount[length]) >> 1;
+		if(length != 1 && nextStart * 2 != start + lengthCount[length]) {
+			return false;
+		}
+		firstCode[length] = start;
+		start = nextStart;
+	}
+
+	uint16_t lookup[1 << MaxCodeBits] = {};
+	for(int code = 0; code < CodeCount; code++) {
+		uint8_t length = codeLengths[code];
+		if(length > 0) {
+			uint32_t bits = firstCode[length]++;
+			int shift = MaxCodeBits - length;
+			for(uint32_t i = bits << shift; i < ((bits + 1) << shift); i++) {
+				lookup[i] = (code << 5) | length;
+			}
+		}
+	}
+
+	auto decodeType = [&]() -> uint8_t {
+		uint16_t entry = lookup[reader.Peek(MaxCodeBits)];
+		reader.Remove(entry & 0x1F);
+		return (uint8_t)(entry >> 5);
+	};
+
+	//Hunk types - runs of identical types are run-length encoded
+	vector<uint8_t> types(_hunkCount);
+	uint8_t lastType = 0;
+	uint32_t repeatCount = 0;
+	for(uint32_t i = 0; i < _hunkCount; i++) {
+		if(repeatCount > 0) {
+			types[i] = lastType;
+			repeatCount--;
+		} else {
+			uint8_t type = decodeType();
+			if(type == MapEntryType::RleSmall) {
+				types[i] = lastType;
+				repeatCount = 2 + decodeType();
+			} else if(type == MapEntryType::RleLarge) {
+				types[i] = lastType;
+				repeatCount = 2 + 16 + (decodeType() << 4);
+				repeatCount += decodeType();
+			} else {
+				types[i] = lastType = type;
+			}
+		}
+	}
+
+	//Hunk lengths/offsets, followed by their crc - the map's crc is calculated on the decoded map (12 bytes per hunk)
+	vector<uint8_t> rawMap((size_t)_hunkCount * 12);
+	uint64_t lastSelf = 0;
+	uint64_t lastParent = 0;
+	for(uint32_t i = 0; i < _hunkCount; i++) {
+		uint8_t type = types[i];
+		uint64_t offset = hunkOffset;
+		uint32_t length = 0;
+		uint16_t crc = 0;
+
+		switch(type) {
+			case MapEntryType::None:
+				length = _hunkSize;
+				hunkOffset += length;
+				crc = reader.Read(16);
+				break;
+
+			case MapEntryType::Self: lastSelf = offset = reader.Read(selfBits); break;
+			case MapEntryType::Parent: lastParent = offset = reader.Read(parentBits); break;
+
+			case MapEntryType::Self1: lastSelf++; [[fallthrough]];
+			case MapEntryType::Self0:
+				type = MapEntryType::Self;
+				offset = lastSelf;
+				break;
+
+			case MapEntryType::ParentSelf:
+				type = MapEntryType::Parent;
+				lastParent = offset = (uint64_t)i * _hunkSize / _unitSize;
+				break;
+
+			case MapEntryType::Parent1: lastParent += _hunkSize / _unitSize; [[fallthrough]];
+			case MapEntryType::Parent0:
+				type = MapEntryType::Parent;
+				offset = lastParent;
+				break;
+
+			default:
+				if(type > MapEntryType::Compressed3) {
+					return false;
+				}
+				length = reader.Read(lengthBits);
+				hunkOffset += length;
+				crc = reader.Read(16);
+				break;
+		}
+
+		uint8_t* entry = &rawMap[i * 12];
+		entry[0] = type;
+		WriteBe(entry + 1, length, 3);
+		WriteBe(entry + 4, offset, 6);
+		WriteBe(entry + 10, crc, 2);
+
+		_hunks[i] = { type, length, offset };
+	}
+
+	return !reader.IsOverflow() && Crc16(rawMap.data(), rawMap.size()) == mapCrc;
+}
+
+bool ChdFile::ReadMetadata(uint64_t offset)
+{
+	//Linked list of entries: uint32 tag, uint8 flags, uint24 length, uint64 next entry's offset, followed by the data
+	while(offset != 0) {
+		uint8_t header[16];
+		if(_metadata.size() >= 10000 || !ReadFileData(offset, header, sizeof(header))) {
+			MessageManager::Log("[CHD] Invalid metadata");
+			return false;
+		}
+
+		uint32_t length = ReadBe24(header + 5);
+		vector<uint8_t> data(length);
+		if(!ReadFileData(offset + sizeof(header), data.data(), length)) {
+			MessageManager::Log("[CHD] Invalid metadata");
+			return false;
+		}
+
+		MetadataEntry entry = { ReadBe32(header), string(data.begin(), data.end()) };
+		size_t end = entry.Value.find('\0');
+		if(end != string::npos) {
+			entry.Value.resize(end);
+		}
+		_metadata.push_back(entry);
+
+		offset = ReadBe64(header + 8);
+	}
+	return true;
+}
+
+vector<string> ChdFile::GetMetadata(uint32_t tag)
+{
+	vector<string> values;
+	for(MetadataEntry& entry : _metadata) {
+		if(entry.Tag == tag) {
+			values.push_back(entry.Value);
+		}
+	}
+	return values;
+}
+
+bool ChdFile::IsCodecSupported(uint32_t codec)
+{
+	switch(codec) {
+		case MakeTag('z', 'l', 'i', 'b'):
+		case MakeTag('l', 'z', 'm', 'a'):
+			return true;
+
+		case MakeTag('c', 'd', 'z', 'l'):
+		case MakeTag('c', 'd', 'l', 'z'):
+			return _hunkSize % CdFrameSize == 0;
+
+		default:
+			return false;
+	}
+}
+
+bool ChdFile::DecompressHunk(uint32_t codec, const vector<uint8_t>& src, uint8_t* out)
+{
+	switch(codec) {
+		case MakeTag('z', 'l', 'i', 'b'): return InflateData(src.data(), (uint32_t)src.size(), out, _hunkSize);
+		case MakeTag('l', 'z', 'm', 'a'): return DecodeLzmaData(src.data(), (uint32_t)src.size(), out, _hunkSize);
+		case MakeTag('c', 'd', 'z', 'l'): return DecompressCdHunk(false, src, out);
+		case MakeTag('c', 'd', 'l', 'z'): return DecompressCdHunk(true, src, out);
+		default: return false;
+	}
+}
+
+bool ChdFile::DecompressCdHunk(bool useLzma, const vector<uint8_t>& src, uint8_t* out)
+{
+	//The sectors of all frames are compressed first (with deflate or lzma), followed by the subchannel data (always with deflate)
+	//Header: 1 bit per frame (set when the sector's sync header and ECC were removed before compression), then the size of the compressed sectors
+	uint32_t frameCount = _hunkSize / CdFrameSize;
+	uint32_t eccBytes = (frameCount + 7) / 8;
+	uint32_t sizeBytes = _hunkSize < 65536 ? 2 : 3;
+	uint32_t headerSize = eccBytes + sizeBytes;
+	if(src.size() < headerSize) {
+		return false;
+	}
+
+	uint32_t sectorDataSize = sizeBytes == 2 ? ReadBe16(&src[eccBytes]) : ReadBe24(&src[eccBytes]);
+	if(headerSize + sectorDataSize > src.size()) {
+		return false;
+	}
+
+	vector<uint8_t> buffer(frameCount * CdFrameSize);
+	uint8_t* sectors = buffer.data();
+	uint8_t* subcode = buffer.data() + frameCount * CdSectorSize;
+	const uint8_t* compressedSectors = src.data() + headerSize;
+	const uint8_t* compressedSubcode = compressedSectors + sectorDataSize;
+	uint32_t subcodeDataSize = (uint32_t)src.size() - headerSize - sectorDataSize;
+
+	bool result = useLzma ? DecodeLzmaData(compressedSectors, sectorDataSize, sectors, frameCount * CdSectorSize) : InflateData(compressedSectors, sectorDataSize, sectors, frameCount * CdSectorSize);
+	if(!result || !InflateData(compressedSubcode, subcodeDataSize, subcode, frameCount * CdSubcodeSize)) {
+		return false;
+	}
+
+	static constexpr uint8_t syncHeader[12] = { 0x00, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x00 };
+	for(uint32_t i = 0; i < frameCount; i++) {
+		uint8_t* frame = out + i * CdFrameSize;
+		memcpy(frame, sectors + i * CdSectorSize, CdSectorSize);
+		memcpy(frame + CdSectorSize, subcode + i * CdSubcodeSize, CdSubcodeSize);
+		if(src[i / 8] & (1 << (i % 8))) {
+			//Only the sync header is restored - the ECC bytes are left empty, the emulated drives only use the sector's user data
+			memcpy(frame, syncHeader, sizeof(syncHeader));
+		}
+	}
+	return true;
+}
+
+ChdFile::CachedHunk& ChdFile::AllocateHunk(uint32_t hunk)
+{
+	CachedHunk* entry = nullptr;
+	if(_cache.size() < MaxCachedHunks) {
+		_cache.push_back({});
+		entry = &_cache.back();
+	} else {
+		//Replace the least recently used hunk
+		entry = &_cache[0];
+		for(CachedHunk& cachedHunk : _cache) {
+			if(cachedHunk.LastUse < entry->LastUse) {
+				entry = &cachedHunk;
+			}
+		}
+	}
+
+	entry->Id = hunk;
+	entry->LastUse = ++_hunkUseCounter;
+	entry->Data.resize(_hunkSize);
+	return *entry;
+}
+
+const uint8_t* ChdFile::GetHunk(uint32_t hunk, uint32_t depth)
+{
+	//Must be called while holding _lock
+	for(CachedHunk& entry : _cache) {
+		if(entry.Id == hunk && entry.LastUse) {
+			entry.LastUse = ++_hunkUseCounter;
+			return entry.Data.data();
+		}
+	}
+
+	HunkInfo& info = _hunks[hunk];
+	switch(info.Type) {
+		case HunkType::Uncompressed: {
+			CachedHunk& entry = AllocateHunk(hunk);
+			if(!ReadFileData(info.Offset, entry.Data.data(), _hunkSize)) {
+				entry.LastUse = 0;
+				return nullptr;
+			}
+			return entry.Data.data();
+		}
+
+		case HunkType::ZeroFilled: {
+			CachedHunk& entry = AllocateHunk(hunk);
+			std::fill(entry.Data.begin(), entry.Data.end(), 0);
+			return entry.Data.data();
+		}
+
+		case HunkType::Self: {
+			//Same data as a previous hunk (which has just been used, so it won't be the one replaced by AllocateHunk)
+			const uint8_t* src = depth < 16 ? GetHunk((uint32_t)info.Offset, depth + 1) : nullptr;
+			if(!src) {
+				return nullptr;
+			}
+			CachedHunk& entry = AllocateHunk(hunk);
+			memcpy(entry.Data.data(), src, _hunkSize);
+			return entry.Data.data();
+		}
+
+		case HunkType::Parent:
+			return nullptr;
+	}
+
+	//Compressed hunk - only the requested hunk is decompressed (on the calling thread),
+	//reading ahead is done by the callers that need it (e.g the CD sector prefetcher's worker thread)
+	vector<uint8_t>& compressedData = _compressedData;
+	compressedData.resize(info.Length);
+	if(!ReadFileData(info.Offset, compressedData.data(), info.Length)) {
+		MessageManager::Log("[CHD] Could not read hunk #" + std::to_string(hunk));
+		return nullptr;
+	}
+
+	CachedHunk& entry = AllocateHunk(hunk);
+	if(!DecompressHunk(_codecs[info.Type], compressedData, entry.Data.data())) {
+		//Free the cache entry
+		entry.LastUse = 0;
+		MessageManager::Log("[CHD] Could not decompress hunk #" + std::to_string(hunk));
+		return nullptr;
+	}
+
+	return entry.Data.data();
+}
+
+bool ChdFile::ReadBytes(uint64_t offset, uint8_t* out, uint32_t length)
+{
+	if(offset + length > _logicalSize) {
+		return false;
+	}
+
+	std::lock_guard<std::mutex> lock(_lock);
+	while(length > 0) {
+		uint32_t hunk = (uint32_t)(offset / _hunkSize);
+		uint32_t hunkOffset = (uint32_t)(offset % _hunkSize);
+		uint32_t count = std::min(length, _hunkSize - hunkOffset);
+
+		const uint8_t* data = GetHunk(hunk);
+		if(!data) {
+			return false;
+		}
+
+		memcpy(out, data + hunkOffset, count);
+		out += count;
+		offset += count;
+		length -= count;
+	}
+	return true;
+}
@@ -0,0 +1,93 @@
+#pragma once
+#include "pch.h"
+#include <mutex>
+#include "Utilities/VirtualFile.h"
+
+//Reads CHD (v5) images, as created by chdman (e.g "chdman createcd -c cdlz,cdzl")
+//The image's data is split in hunks that are compressed individually - hunks are decompressed when they are read,
+//and the most recently used hunks are kept in a small cache, so the image is never decompressed as a whole.
+//Supported compression codecs: zlib, lzma and their CD-ROM variants (cdzl, cdlz)
+//Not supported: flac/huff/zstd-compressed hunks (e.g cdfl) and images that depend on a parent image
+class ChdFile
+{
+private:
+	static constexpr uint32_t HeaderSize = 124;
+	static constexpr uint32_t MaxCachedHunks = 16;
+
+	//CD-ROM hunks contain frames made of a 2352-byte sector followed by 96 bytes of subchannel data
+	static constexpr uint32_t CdSectorSize = 2352;
+	static constexpr uint32_t CdSubcodeSize = 96;
+	static constexpr uint32_t CdFrameSize = CdSectorSize + CdSubcodeSize;
+
+	enum HunkType : uint8_t
+	{
+		//0-3: compressed with one of the 4 codecs listed in the header
+		Uncompressed = 4,
+		Self = 5, //Copy of another hunk
+		Parent = 6, //Copy of a hunk in the parent image
+		ZeroFilled = 0xFF //Uncompressed images only
+	};
+
+	struct HunkInfo
+	{
+		uint8_t Type;
+		uint32_t Length;
+		uint64_t Offset;
+	};
+
+	struct CachedHunk
+	{
+		uint32_t Id = 0;
+		uint64_t LastUse = 0;
+		vector<uint8_t> Data;
+	};
+
+	struct MetadataEntry
+	{
+		uint32_t Tag;
+		string Value;
+	};
+
+	VirtualFile _file;
+	uint32_t _codecs[4] = {};
+	uint64_t _logicalSize = 0;
+	uint32_t _hunkSize = 0;
+	uint32_t _unitSize = 0;
+	uint32_t _hunkCount = 0;
+	vector<HunkInfo> _hunks;
+	vector<MetadataEntry> _metadata;
+
+	std::mutex _lock;
+	vector<CachedHunk> _cache;
+	uint64_t _hunkUseCounter = 0;
+	vector<uint8_t> _compressedData;
+
+	bool ReadFileData(uint64_t offset, uint8_t* out, uint32_t length);
+	bool ReadMap(uint64_t mapOffset);
+	bool ReadCompressedMap(uint64_t mapOffset);
+	bool ReadMetadata(uint64_t offset);
+
+	bool IsCodecSupported(uint32_t codec);
+	bool DecompressHunk(uint32_t codec, const vector<uint8_t>& src, uint8_t* out);
+	bool DecompressCdHunk(bool useLzma, const vector<uint8_t>& src, uint8_t* out);
+
+	CachedHunk& AllocateHunk(uint32_t hunk);
+	const uint8_t* GetHunk(uint32_t hunk, uint32_t depth = 0);
+
+public:
+	static constexpr uint32_t MakeTag(char a, char b, char c, char d)
+	{
+		return ((uint32_t)(uint8_t)a << 24) | ((uint32_t)(uint8_t)b << 16) | ((uint32_t)(uint8_t)c << 8) | (uint8_t)d;
+	}
+
+	bool Load(VirtualFile& file);
+
+	uint64_t GetSize() { return _logicalSize; }
+	uint32_t GetUnitSize() { return _unitSize; }
+
+	//Returns the value of every metadata entry with the given tag (e.g "CHT2" for CD-ROM tracks), in the order they are stored
+	vector<string> GetMetadata(uint32_t tag);
+
+	//Reads decompressed data - can be called from any thread
+	bool ReadBytes(uint64_t offset, uint8_t* out, uint32_t length);
+};
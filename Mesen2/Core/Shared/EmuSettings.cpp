@@ -450,7 +450,7 @@ OverscanDimensions EmuSettings::GetOverscan()
 
 uint32_t EmuSettings::GetEmulationSpeed()
 {
-	if(CheckFlag(EmulationFlags::MaximumSpeed)) {
+	if(CheckFlag(EmulationFlags::MaximumSpeed) || CheckFlag(EmulationFlags::MaximumSpeedOverride)) {
 		return 0;
 	} else if(CheckFlag(EmulationFlags::Turbo)) {
 		return _emulation.TurboSpeed;
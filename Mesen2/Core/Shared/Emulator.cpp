@@ -203,13 +203,12 @@ bool Emulator::ProcessSystemActions()
 
 void Emulator::RunFrameWithRunAhead()
 {
-	stringstream runAheadState;
 	uint32_t frameCount = _settings->GetEmulationConfig().RunAheadFrames;
 
 	//Run a single frame and save the state (no audio/video)
 	_isRunAheadFrame = true;
 	_console->RunFrame();
-	Serialize(runAheadState, false, 0);
+	SerializeRaw(_runAheadState);
 
 	while(frameCount > 1) {
 		//Run extra frames if the requested run ahead frame count is higher than 1
@@ -227,7 +226,9 @@ void Emulator::RunFrameWithRunAhead()
 	if(!wasReset) {
 		//Load the state we saved earlier
 		_isRunAheadFrame = true;
-		Deserialize(runAheadState, SaveStateManager::FileFormatVersion, false);
+		if(!DeserializeRaw(_runAheadState)) {
+			MessageManager::Log("[Run-ahead] Invalid state layout");
+		}
 		_isRunAheadFrame = false;
 	}
 }
@@ -910,14 +911,14 @@ void Emulator::WaitForLock()
 	}
 }
 
-void Emulator::Serialize(ostream& out, bool includeSettings, int compressionLevel)
+void Emulator::Serialize(ostream& out, bool includeSettings, CompressionCodec codec)
 {
 	Serializer s(SaveStateManager::FileFormatVersion, true);
 	if(includeSettings) {
 		SV(_settings);
 	}
 	s.Stream(_console, "");
-	s.SaveTo(out, compressionLevel);
+	s.SaveTo(out, codec);
 }
 
 DeserializeResult Emulator::Deserialize(istream& in, uint32_t fileFormatVersion, bool includeSettings, optional<ConsoleType> srcConsoleType, bool sendNotification)
@@ -964,6 +965,20 @@ DeserializeResult Emulator::Deserialize(istream& in, uint32_t fileFormatVersion,
 	return DeserializeResult::Success;
 }
 
+void Emulator::SerializeRaw(vector<uint8_t>& out)
+{
+	Serializer s(SaveStateManager::FileFormatVersion, true, out);
+	s.Stream(_console, "");
+	s.EndRawData();
+}
+
+bool Emulator::DeserializeRaw(vector<uint8_t>& in)
+{
+	Serializer s(SaveStateManager::FileFormatVersion, false, in);
+	s.Stream(_console, "");
+	return s.EndRawData();
+}
+
 BaseVideoFilter* Emulator::GetVideoFilter(bool getDefaultFilter)
 {
 	shared_ptr<IConsole> console = GetConsole();
@@ -10,6 +10,7 @@
 #include "Utilities/safe_ptr.h"
 #include "Utilities/SimpleLock.h"
 #include "Utilities/VirtualFile.h"
+#include "Utilities/CompressionHelper.h"
 
 class Debugger;
 class DebugHud;
@@ -103,6 +104,7 @@ private:
 	atomic<int> _blockDebuggerRequestCount;
 
 	atomic<bool> _isRunAheadFrame;
+	vector<uint8_t> _runAheadState;
 	bool _frameRunning = false;
 
 	RomInfo _rom;
@@ -184,9 +186,13 @@ public:
 	bool IsDebuggerBlocked() { return _blockDebuggerRequestCount > 0; }
 	void SuspendDebugger(bool release);
 
-	void Serialize(ostream& out, bool includeSettings, int compressionLevel = 1);
+	void Serialize(ostream& out, bool includeSettings, CompressionCodec codec = CompressionCodec::Deflate);
 	DeserializeResult Deserialize(istream& in, uint32_t fileFormatVersion, bool includeSettings, optional<ConsoleType> consoleType = std::nullopt, bool sendNotification = true);
 
+	//Keyless state (no settings) - much faster, but can only be loaded back for the same game in the same session
+	void SerializeRaw(vector<uint8_t>& out);
+	bool DeserializeRaw(vector<uint8_t>& in);
+
 	SoundMixer* GetSoundMixer() { return _soundMixer.get(); }
 	VideoRenderer* GetVideoRenderer() { return _videoRenderer.get(); }
 	VideoDecoder* GetVideoDecoder() { return _videoDecoder.get(); }
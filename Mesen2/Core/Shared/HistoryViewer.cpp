@@ -140,7 +140,7 @@ bool HistoryViewer::SaveMovie(string movieFile, uint32_t startPosition, uint32_t
 	//(the movie generation uses the console's inputs, which could affect the emulation otherwise)
 	stringstream state;
 	auto lock = _emu->AcquireLock();
-	_emu->Serialize(state, true, false);
+	_emu->Serialize(state, true, CompressionCodec::Uncompressed);
 
 	//Convert the rewind data to a .mmo file
 	unique_ptr<MovieRecorder> recorder(new MovieRecorder(_emu));
@@ -102,7 +102,7 @@ void MovieRecorder::GetGameSettings(stringstream &out)
 	s.Stream(*settings, "", -1);
 
 	std::stringstream settingsOut;
-	s.SaveTo(settingsOut, 0);
+	s.SaveTo(settingsOut, CompressionCodec::Uncompressed);
 
 	out << settingsOut.str();
 
@@ -0,0 +1,181 @@
+#include "pch.h"
+#include "Shared/RewindCompressor.h"
+#include "Shared/RewindData.h"
+#include "Utilities/CompressionHelper.h"
+
+void RewindBlock::Compress()
+{
+	vector<uint8_t> compressedData;
+	CompressionHelper::Compress(RawData.data(), RawData.size(), CompressionCodec::Lz4, compressedData);
+
+	auto lock = Lock.AcquireSafe();
+	CompressedData = std::move(compressedData);
+	IsCompressed = true;
+	RawData = {};
+	Size = (uint32_t)CompressedData.size();
+}
+
+bool RewindBlock::GetData(vector<uint8_t>& output)
+{
+	{
+		auto lock = Lock.AcquireSafe();
+		if(!PrefetchedData.empty()) {
+			output = PrefetchedData;
+			return true;
+		} else if(!IsCompressed) {
+			output = RawData;
+			return !output.empty();
+		}
+	}
+
+	//CompressedData can be read without holding the lock once IsCompressed is set
+	return CompressionHelper::Decompress(CompressedData, output);
+}
+
+RewindCompressor::RewindCompressor()
+{
+	_stopFlag = false;
+	_pendingBytes = 0;
+}
+
+RewindCompressor::~RewindCompressor()
+{
+	_stopFlag = true;
+	if(_thread) {
+		_signal.Signal();
+		_thread->join();
+		_thread.reset();
+	}
+}
+
+void RewindCompressor::StartThread()
+{
+	if(!_thread) {
+		_thread.reset(new thread(&RewindCompressor::WorkerThread, this));
+	}
+}
+
+void RewindCompressor::Compress(shared_ptr<RewindBlock> block)
+{
+	uint32_t size = (uint32_t)block->RawData.size();
+	if(_pendingBytes + size > MaxPendingBytes) {
+		//Compression thread can't keep up, compress on this thread to keep memory usage bounded
+		block->Compress();
+		return;
+	}
+
+	{
+		auto lock = _queueLock.AcquireSafe();
+		_pendingBytes += size;
+		_compressQueue.push_back({ block, size });
+	}
+	StartThread();
+	_signal.Signal();
+}
+
+void RewindCompressor::Prefetch(std::deque<RewindData>& history, uint32_t count)
+{
+	vector<shared_ptr<RewindBlock>> blocks;
+	for(int32_t i = (int32_t)history.size() - 1; i >= 0 && (int32_t)history.size() - i <= (int32_t)count; i--) {
+		RewindData& data = history[i];
+		if(data._block) {
+			blocks.push_back(data._block);
+		}
+
+		if(!data.IsFullState) {
+			RewindData* fullState = data.FindFullState(history, i - 1);
+			if(fullState && fullState->_block && fullState->_uncompressedData.empty()) {
+				blocks.push_back(fullState->_block);
+			}
+		}
+	}
+
+	for(shared_ptr<RewindBlock>& block : _prefetchedBlocks) {
+		if(std::find(blocks.begin(), blocks.end(), block) == blocks.end()) {
+			auto lock = block->Lock.AcquireSafe();
+			block->PrefetchRequested = false;
+			block->PrefetchedData = {};
+		}
+	}
+	for(shared_ptr<RewindBlock>& block : blocks) {
+		auto lock = block->Lock.AcquireSafe();
+		block->PrefetchRequested = true;
+	}
+	_prefetchedBlocks = blocks;
+
+	{
+		auto lock = _queueLock.AcquireSafe();
+		_prefetchQueue.clear();
+		for(shared_ptr<RewindBlock>& block : blocks) {
+			_prefetchQueue.push_back(block);
+		}
+	}
+	StartThread();
+	_signal.Signal();
+}
+
+void RewindCompressor::Clear()
+{
+	for(shared_ptr<RewindBlock>& block : _prefetchedBlocks) {
+		auto lock = block->Lock.AcquireSafe();
+		block->PrefetchRequested = false;
+		block->PrefetchedData = {};
+	}
+	_prefetchedBlocks.clear();
+
+	auto lock = _queueLock.AcquireSafe();
+	_prefetchQueue.clear();
+}
+
+void RewindCompressor::WorkerThread()
+{
+	while(!_stopFlag.load()) {
+		shared_ptr<RewindBlock> block;
+		bool prefetch = false;
+		uint32_t compressSize = 0;
+		{
+			auto lock = _queueLock.AcquireSafe();
+			//Blocks needed for rewinding take priority over compression
+			while(!block && !_prefetchQueue.empty()) {
+				block = _prefetchQueue.front().lock();
+				_prefetchQueue.pop_front();
+				prefetch = true;
+			}
+			while(!block && !_compressQueue.empty()) {
+				block = _compressQueue.front().first.lock();
+				compressSize = _compressQueue.front().second;
+				_compressQueue.pop_front();
+				prefetch = false;
+				if(!block) {
+					//Block was removed from the history before it was compressed
+					_pendingBytes -= compressSize;
+				}
+			}
+		}
+
+		if(!block) {
+			_signal.Wait();
+			continue;
+		}
+
+		if(prefetch) {
+			bool needData;
+			{
+				auto lock = block->Lock.AcquireSafe();
+				needData = block->PrefetchRequested && block->IsCompressed && block->PrefetchedData.empty();
+			}
+			if(needData) {
+				vector<uint8_t> data;
+				if(CompressionHelper::Decompress(block->CompressedData, data)) {
+					auto lock = block->Lock.AcquireSafe();
+					if(block->PrefetchRequested) {
+						block->PrefetchedData = std::move(data);
+					}
+				}
+			}
+		} else {
+			block->Compress();
+			_pendingBytes -= compressSize;
+		}
+	}
+}
@@ -0,0 +1,66 @@
+#pragma once
+#include "pch.h"
+#include <deque>
+#include "Utilities/SimpleLock.h"
+#include "Utilities/AutoResetEvent.h"
+
+class RewindData;
+
+//State data for a single rewind block, shared between all copies of the RewindData that owns it
+struct RewindBlock
+{
+	SimpleLock Lock;
+
+	//Uncompressed block data, released once the compression thread is done with it
+	vector<uint8_t> RawData;
+	//Never modified once set
+	vector<uint8_t> CompressedData;
+	bool IsCompressed = false;
+
+	//Decompressed copy of the block, prepared ahead of time while rewinding
+	vector<uint8_t> PrefetchedData;
+	bool PrefetchRequested = false;
+
+	atomic<uint32_t> Size = 0;
+
+	void Compress();
+	bool GetData(vector<uint8_t>& output);
+};
+
+//Compresses rewind blocks on a background thread, so that recording rewind history doesn't
+//compress anything on the emulation thread, and decompresses the blocks that are about to be
+//loaded while rewinding.
+class RewindCompressor
+{
+private:
+	//Max amount of uncompressed data waiting for the compression thread, blocks are compressed
+	//on the emulation thread when this is exceeded
+	static constexpr uint32_t MaxPendingBytes = 64 * 1024 * 1024;
+
+	unique_ptr<thread> _thread;
+	atomic<bool> _stopFlag;
+	AutoResetEvent _signal;
+
+	SimpleLock _queueLock;
+	std::deque<std::pair<weak_ptr<RewindBlock>, uint32_t>> _compressQueue;
+	std::deque<weak_ptr<RewindBlock>> _prefetchQueue;
+	atomic<uint32_t> _pendingBytes;
+
+	//Blocks that currently hold prefetched data (only accessed by the emulation thread)
+	vector<shared_ptr<RewindBlock>> _prefetchedBlocks;
+
+	void StartThread();
+	void WorkerThread();
+
+public:
+	RewindCompressor();
+	~RewindCompressor();
+
+	void Compress(shared_ptr<RewindBlock> block);
+
+	//Decompresses the last "count" blocks of the history (and the full states they depend on)
+	//and releases the prefetched data of blocks that are no longer in that range
+	void Prefetch(std::deque<RewindData>& history, uint32_t count);
+
+	void Clear();
+};
@@ -2,58 +2,155 @@
 #include "Shared/RewindData.h"
 #include "Shared/Emulator.h"
 #include "Shared/SaveStateManager.h"
-#include "Utilities/CompressionHelper.h"
+#include "Shared/RewindCompressor.h"
 
 void RewindData::GetStateData(stringstream &stateData, deque<RewindData>& prevStates, int32_t position)
 {
 	vector<uint8_t> data;
-	CompressionHelper::Decompress(_saveStateData, data);
-
-	if(!IsFullState) {
-		position = (position > 0 ? position : (int32_t)prevStates.size()) - 1;
-		ProcessXorState(data, prevStates, position);
+	if(DecodeState(data, prevStates, position)) {
+		stateData.write((char*)data.data(), data.size());
 	}
+}
 
-	stateData.write((char*)data.data(), data.size());
+uint32_t RewindData::GetStateSize()
+{
+	return _block ? _block->Size.load() : 0;
 }
 
-template<typename T>
-void RewindData::ProcessXorState(T& data, deque<RewindData>& prevStates, int32_t position)
+RewindData* RewindData::FindFullState(deque<RewindData>& prevStates, int32_t position)
 {
-	//Find last full state and XOR with it
-	while(position >= 0 && position < prevStates.size()) {
-		RewindData& prevState = prevStates[position];
-		if(prevState.IsFullState) {
-			//XOR with previous state to restore state data to its initial state
-			if(!prevState._uncompressedData.empty()) {
-				for(size_t i = 0, len = std::min(prevState._uncompressedData.size(), data.size()); i < len; i++) {
-					data[i] ^= prevState._uncompressedData[i];
-				}
-			} else {
-				vector<uint8_t> prevStateData;
-				CompressionHelper::Decompress(prevState._saveStateData, prevStateData);
-				for(size_t i = 0, len = std::min(prevStateData.size(), data.size()); i < len; i++) {
-					data[i] ^= prevStateData[i];
-				}
-			}
-			break;
+	while(position >= 0 && position < (int32_t)prevStates.size()) {
+		if(prevStates[position].IsFullState) {
+			return &prevStates[position];
 		}
 		position--;
 	}
+	return nullptr;
 }
 
-void RewindData::LoadState(Emulator* emu, deque<RewindData>& prevStates, int32_t position, bool sendNotification)
+const vector<uint8_t>& RewindData::GetFullStateData(vector<uint8_t>& buffer)
 {
-	if(_saveStateData.size() == 0) {
-		return;
+	if(!_uncompressedData.empty()) {
+		return _uncompressedData;
 	}
-		
-	vector<uint8_t> data;
-	CompressionHelper::Decompress(_saveStateData, data);
+	if(!_block || !_block->GetData(buffer)) {
+		buffer.clear();
+	}
+	return buffer;
+}
+
+bool RewindData::DecodeState(vector<uint8_t>& output, deque<RewindData>& prevStates, int32_t position)
+{
+	if(!_block) {
+		return false;
+	}
+
+	if(IsFullState) {
+		if(!_uncompressedData.empty()) {
+			output = _uncompressedData;
+			return true;
+		}
+		return _block->GetData(output);
+	}
+
+	vector<uint8_t> delta;
+	if(!_block->GetData(delta)) {
+		return false;
+	}
+
+	position = (position > 0 ? position : (int32_t)prevStates.size()) - 1;
+	RewindData* fullState = FindFullState(prevStates, position);
+	if(!fullState) {
+		return false;
+	}
+
+	vector<uint8_t> buffer;
+	return ApplyDelta(delta, fullState->GetFullStateData(buffer), output);
+}
+
+//Delta block format: state size, number of changed pages, the changed pages' indexes,
+//then the content of each changed page XORed with the same page in the full state.
+//Pages that are identical to the full state (most of the RAM/VRAM from one block to the next) are skipped
+//entirely, which makes both the encoding and the compression of the block proportional to the amount
+//of memory that actually changed.
+void RewindData::EncodeDelta(const uint8_t* data, uint32_t size, const vector<uint8_t>& fullState, vector<uint8_t>& output)
+{
+	uint32_t pageCount = (size + PageSize - 1) / PageSize;
+	uint32_t fullStateSize = (uint32_t)fullState.size();
+
+	vector<uint32_t> changedPages;
+	changedPages.reserve(pageCount);
+	for(uint32_t page = 0; page < pageCount; page++) {
+		uint32_t start = page * PageSize;
+		uint32_t length = std::min(PageSize, size - start);
+		if(start + length > fullStateSize || memcmp(data + start, fullState.data() + start, length) != 0) {
+			changedPages.push_back(page);
+		}
+	}
+
+	uint32_t changedCount = (uint32_t)changedPages.size();
+	output.clear();
+	output.reserve(sizeof(uint32_t) * (2 + changedCount) + changedCount * PageSize);
+	output.insert(output.end(), (uint8_t*)&size, (uint8_t*)&size + sizeof(uint32_t));
+	output.insert(output.end(), (uint8_t*)&changedCount, (uint8_t*)&changedCount + sizeof(uint32_t));
+	output.insert(output.end(), (uint8_t*)changedPages.data(), (uint8_t*)(changedPages.data() + changedCount));
 
-	if(!IsFullState) {
-		position = (position > 0 ? position : (int32_t)prevStates.size()) - 1;
-		ProcessXorState(data, prevStates, position);
+	for(uint32_t page : changedPages) {
+		uint32_t start = page * PageSize;
+		uint32_t length = std::min(PageSize, size - start);
+		size_t pos = output.size();
+		output.insert(output.end(), data + start, data + start + length);
+		for(uint32_t i = 0; i < length && start + i < fullStateSize; i++) {
+			output[pos + i] ^= fullState[start + i];
+		}
+	}
+}
+
+bool RewindData::ApplyDelta(const vector<uint8_t>& delta, const vector<uint8_t>& fullState, vector<uint8_t>& output)
+{
+	if(delta.size() < sizeof(uint32_t) * 2) {
+		return false;
+	}
+
+	uint32_t size;
+	uint32_t changedCount;
+	memcpy(&size, delta.data(), sizeof(uint32_t));
+	memcpy(&changedCount, delta.data() + sizeof(uint32_t), sizeof(uint32_t));
+
+	size_t pos = sizeof(uint32_t) * 2;
+	if(delta.size() < pos + (size_t)changedCount * sizeof(uint32_t)) {
+		return false;
+	}
+	const uint8_t* pageList = delta.data() + pos;
+	pos += (size_t)changedCount * sizeof(uint32_t);
+
+	output.assign(fullState.begin(), fullState.begin() + std::min<size_t>(size, fullState.size()));
+	output.resize(size, 0);
+
+	for(uint32_t i = 0; i < changedCount; i++) {
+		uint32_t page;
+		memcpy(&page, pageList + i * sizeof(uint32_t), sizeof(uint32_t));
+		size_t start = (size_t)page * PageSize;
+		if(start >= size) {
+			return false;
+		}
+		size_t length = std::min<size_t>(PageSize, size - start);
+		if(pos + length > delta.size()) {
+			return false;
+		}
+		for(size_t j = 0; j < length; j++) {
+			output[start + j] ^= delta[pos + j];
+		}
+		pos += length;
+	}
+	return true;
+}
+
+void RewindData::LoadState(Emulator* emu, deque<RewindData>& prevStates, int32_t position, bool sendNotification)
+{
+	vector<uint8_t> data;
+	if(!DecodeState(data, prevStates, position)) {
+		return;
 	}
 
 	stringstream stream;
@@ -63,18 +160,24 @@ void RewindData::LoadState(Emulator* emu, deque<RewindData>& prevStates, int32_t
 	emu->Deserialize(stream, SaveStateManager::FileFormatVersion, true, std::nullopt, sendNotification);
 }
 
-void RewindData::SaveState(Emulator* emu, deque<RewindData>& prevStates, int32_t position)
+void RewindData::SaveState(Emulator* emu, deque<RewindData>& prevStates, int32_t position, RewindCompressor* compressor)
 {
 	std::stringstream state;
-	emu->Serialize(state, true, 0);
+	emu->Serialize(state, true, CompressionCodec::Uncompressed);
 
 	string data = state.str();
 
 	position = position > 0 ? position : (int32_t)prevStates.size();
 
+	RewindData* fullState = nullptr;
 	if(position > 0 && (position % 30) != 0) {
-		position--;
-		ProcessXorState(data, prevStates, position);
+		fullState = FindFullState(prevStates, position - 1);
+	}
+
+	_block.reset(new RewindBlock());
+	if(fullState) {
+		vector<uint8_t> buffer;
+		EncodeDelta((uint8_t*)data.data(), (uint32_t)data.size(), fullState->GetFullStateData(buffer), _block->RawData);
 	} else {
 		IsFullState = true;
 		while(position > 0) {
@@ -89,8 +192,15 @@ void RewindData::SaveState(Emulator* emu, deque<RewindData>& prevStates, int32_t
 
 		//Keep uncompressed data for the next 30 states - this avoids having to decompress the state 30 times
 		_uncompressedData = vector<uint8_t>(data.begin(), data.end());
+		_block->RawData = _uncompressedData;
+	}
+
+	_block->Size = (uint32_t)_block->RawData.size();
+	if(compressor) {
+		compressor->Compress(_block);
+	} else {
+		_block->Compress();
 	}
 
-	CompressionHelper::Compress(data, 1, _saveStateData);
 	FrameCount = 0;
 }
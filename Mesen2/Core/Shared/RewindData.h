@@ -4,15 +4,27 @@
 #include "Shared/BaseControlDevice.h"
 
 class Emulator;
+class RewindCompressor;
+struct RewindBlock;
 
 class RewindData
 {
 private:
-	vector<uint8_t> _saveStateData;
+	//Delta blocks only store the pages that differ from the previous full state
+	static constexpr uint32_t PageSize = 0x1000;
+
+	friend class RewindCompressor;
+
+	//Compressed asynchronously by the RewindCompressor, shared by all copies of this RewindData
+	shared_ptr<RewindBlock> _block;
 	vector<uint8_t> _uncompressedData;
 
-	template<typename T>
-	void ProcessXorState(T& data, deque<RewindData>& prevStates, int32_t position);
+	RewindData* FindFullState(deque<RewindData>& prevStates, int32_t position);
+	const vector<uint8_t>& GetFullStateData(vector<uint8_t>& buffer);
+	bool DecodeState(vector<uint8_t>& output, deque<RewindData>& prevStates, int32_t position);
+
+	static void EncodeDelta(const uint8_t* data, uint32_t size, const vector<uint8_t>& fullState, vector<uint8_t>& output);
+	static bool ApplyDelta(const vector<uint8_t>& delta, const vector<uint8_t>& fullState, vector<uint8_t>& output);
 
 public:
 	std::deque<ControlDeviceState> InputLogs[BaseControlDevice::PortCount];
@@ -21,8 +33,8 @@ public:
 	bool IsFullState = false;
 
 	void GetStateData(stringstream& stateData, deque<RewindData>& prevStates, int32_t position);
-	uint32_t GetStateSize() { return (uint32_t)_saveStateData.size(); }
+	uint32_t GetStateSize();
 
 	void LoadState(Emulator* emu, deque<RewindData>& prevStates, int32_t position = -1, bool sendNotification = true);
-	void SaveState(Emulator* emu, deque<RewindData>& prevStates, int32_t position = -1);
+	void SaveState(Emulator* emu, deque<RewindData>& prevStates, int32_t position = -1, RewindCompressor* compressor = nullptr);
 };
@@ -52,6 +52,7 @@ void RewindManager::ClearBuffer()
 	_audioHistoryBuilder.clear();
 	_rewindState = RewindState::Stopped;
 	_currentHistory = {};
+	_compressor.Clear();
 }
 
 void RewindManager::ProcessNotification(ConsoleNotificationType type, void * parameter)
@@ -143,7 +144,7 @@ void RewindManager::AddHistoryBlock()
 			_history.push_back(_currentHistory);
 		}
 		_currentHistory = RewindData();
-		_currentHistory.SaveState(_emu, _history);
+		_currentHistory.SaveState(_emu, _history, -1, &_compressor);
 	}
 }
 
@@ -167,6 +168,9 @@ void RewindManager::PopHistory()
 		_historyBackup.push_front(_currentHistory);
 		_currentHistory.LoadState(_emu, _history, -1, false);
 
+		//Decompress the next blocks in the background while the current one is being played back
+		_compressor.Prefetch(_history, RewindManager::PrefetchBlockCount);
+
 		if(!_audioHistoryBuilder.empty()) {
 			_audioHistory.insert(_audioHistory.begin(), _audioHistoryBuilder.begin(), _audioHistoryBuilder.end());
 			_audioHistoryBuilder.clear();
@@ -243,6 +247,7 @@ void RewindManager::ForceStop(bool deleteFutureData)
 			_historyBackup.clear();
 		}
 
+		_compressor.Clear();
 		_rewindState = RewindState::Stopped;
 		_settings->ClearFlag(EmulationFlags::MaximumSpeed);
 		_settings->ClearFlag(EmulationFlags::Rewind);
@@ -278,6 +283,7 @@ void RewindManager::Stop()
 		}
 
 		_currentHistory.LoadState(_emu, _history);
+		_compressor.Clear();
 		if(_framesToFastForward > 0) {
 			_rewindState = RewindState::Stopping;
 			_currentHistory.FrameCount = 0;
@@ -3,6 +3,7 @@
 #include <deque>
 #include "Shared/Interfaces/INotificationListener.h"
 #include "Shared/RewindData.h"
+#include "Shared/RewindCompressor.h"
 #include "Shared/Interfaces/IInputProvider.h"
 #include "Shared/Interfaces/IInputRecorder.h"
 
@@ -40,6 +41,7 @@ class RewindManager : public INotificationListener, public IInputProvider, publi
 {
 public:
 	static constexpr int32_t BufferSize = 30; //Number of frames between each save state
+	static constexpr uint32_t PrefetchBlockCount = 4; //Number of blocks decompressed ahead of time while rewinding
 
 private:
 	Emulator* _emu = nullptr;
@@ -50,6 +52,7 @@ private:
 	deque<RewindData> _history;
 	deque<RewindData> _historyBackup;
 	RewindData _currentHistory = {};
+	RewindCompressor _compressor;
 
 	RewindState _rewindState = RewindState::Stopped;
 	int32_t _framesToFastForward = 0;
@@ -12,6 +12,9 @@ enum class EmulationFlags
 	ConsoleMode = 0x10,
 	TestMode = 0x20,
 	OutputToStdout = 0x40,
+
+	//Set by the emulation itself (e.g fast-forward during disk access), separately from the user's MaximumSpeed flag
+	MaximumSpeedOverride = 0x80,
 };
 
 enum class ScaleFilterType
@@ -620,6 +623,9 @@ struct NesConfig
 	bool FdsAutoLoadDisk = true;
 	bool FdsFastForwardOnLoad = false;
 	bool FdsAutoInsertDisk = false;
+	bool BbkSyncLpcDecode = false;
+	bool BbkAccurateFdcTiming = false;
+	bool BbkFastForwardOnDiskAccess = false;
 	VsDualOutputOption VsDualVideoOutput = VsDualOutputOption::Both;
 	VsDualOutputOption VsDualAudioOutput = VsDualOutputOption::Both;
 
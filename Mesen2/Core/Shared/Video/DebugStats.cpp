@@ -7,6 +7,7 @@
 #include "Shared/Emulator.h"
 #include "Shared/RewindManager.h"
 #include "Shared/EmuSettings.h"
+#include "Shared/Video/VideoDecoder.h"
 
 void DebugStats::DisplayStats(Emulator *emu, double lastFrameTime)
 {
@@ -50,10 +51,16 @@ void DebugStats::DisplayStats(Emulator *emu, double lastFrameTime)
 	const int videoBoxLeft = audioBoxLeft + audioBoxWidth + boxGap;
 	const int videoBoxTop = audioBoxTop;
 	const int videoBoxWidth = audioBoxWidth;
-	const int videoDataLines = 4;
+	const int videoDataLines = 6;
 	int videoBoxHeight = std::max<int>(64, 2 * innerPadding + (int)lineHeight + videoDataLines * lineSpacing);
 
-	int topRowHeight = std::max(audioBoxHeight, videoBoxHeight);
+	const int filterBoxLeft = videoBoxLeft + videoBoxWidth + boxGap;
+	const int filterBoxTop = audioBoxTop;
+	const int filterBoxWidth = audioBoxWidth;
+	const int filterDataLines = 4;
+	int filterBoxHeight = std::max<int>(64, 2 * innerPadding + (int)lineHeight + filterDataLines * lineSpacing);
+
+	int topRowHeight = std::max(audioBoxHeight, std::max(videoBoxHeight, filterBoxHeight));
 
 	_frameDurations[_frameDurationIndex] = lastFrameTime;
 	_frameDurationIndex = (_frameDurationIndex + 1) % 60;
@@ -131,11 +138,15 @@ void DebugStats::DisplayStats(Emulator *emu, double lastFrameTime)
 	ss << std::fixed << std::setprecision(2) << _lastFrameMax << " ms";
 	std::string maxLatencyValue = ss.str();
 
+	VideoFrameStats frameStats = emu->GetVideoRenderer() ? emu->GetVideoRenderer()->GetFrameStats() : VideoFrameStats {};
+
 	StatLine videoLines[] = {
 		{ utf8::utf8::encode(L"帧率"), frameRateValue, 0xFFFFFF },
 		{ utf8::utf8::encode(L"上一帧"), lastFrameValue, 0xFFFFFF },
 		{ utf8::utf8::encode(L"最小延迟"), minLatencyValue, 0xFFFFFF },
-		{ utf8::utf8::encode(L"最大延迟"), maxLatencyValue, 0xFFFFFF }
+		{ utf8::utf8::encode(L"最大延迟"), maxLatencyValue, 0xFFFFFF },
+		{ utf8::utf8::encode(L"丢弃帧"), std::to_string(frameStats.DroppedFrames), 0xFFFFFF },
+		{ utf8::utf8::encode(L"重复帧"), std::to_string(frameStats.DuplicatedFrames), 0xFFFFFF }
 	};
 
 	uint32_t videoLabelWidth = 0;
@@ -156,6 +167,46 @@ void DebugStats::DisplayStats(Emulator *emu, double lastFrameTime)
 		videoLineY += lineSpacing;
 	}
 
+	// 滤镜各阶段耗时（最后一帧）
+	hud->DrawRectangle(filterBoxLeft, filterBoxTop, filterBoxWidth, filterBoxHeight, 0x40000000, true, 1, startFrame);
+	hud->DrawRectangle(filterBoxLeft, filterBoxTop, filterBoxWidth, filterBoxHeight, 0xFFFFFF, false, 1, startFrame);
+
+	int filterTextY = filterBoxTop + innerPadding;
+	int filterTextX = filterBoxLeft + innerPadding;
+	VideoFilterStats filterStats = emu->GetVideoDecoder()->GetFilterStats();
+	hud->DrawString(filterTextX, filterTextY, utf8::utf8::encode(L"滤镜耗时") + " (" + std::to_string(filterStats.ThreadCount) + ")", 0xFFFFFF, 0xFF000000, 1, startFrame);
+	filterTextY += lineSpacing;
+
+	auto formatTime = [](double time) {
+		std::stringstream timeStream;
+		timeStream << std::fixed << std::setprecision(2) << time << " ms";
+		return timeStream.str();
+	};
+
+	StatLine filterLines[] = {
+		{ utf8::utf8::encode(L"主机滤镜"), formatTime(filterStats.ConsoleFilterTime), 0xFFFFFF },
+		{ utf8::utf8::encode(L"旋转"), formatTime(filterStats.RotateTime), 0xFFFFFF },
+		{ utf8::utf8::encode(L"缩放"), formatTime(filterStats.ScaleTime), 0xFFFFFF },
+		{ utf8::utf8::encode(L"扫描线"), formatTime(filterStats.ScanlineTime), 0xFFFFFF }
+	};
+
+	uint32_t filterLabelWidth = 0;
+	for(const StatLine& line : filterLines) {
+		filterLabelWidth = std::max<uint32_t>(filterLabelWidth, hud->MeasureString(line.Label).X);
+	}
+	int filterColonX = filterTextX + (int)filterLabelWidth;
+	int filterValueX = filterColonX + (int)colonWidth;
+
+	int filterLineY = filterTextY;
+	for(const StatLine& line : filterLines) {
+		uint32_t labelWidth = hud->MeasureString(line.Label).X;
+		int labelX = filterColonX - (int)labelWidth;
+		hud->DrawString(labelX, filterLineY, line.Label, 0xFFFFFF, 0xFF000000, 1, startFrame);
+		hud->DrawString(filterColonX, filterLineY, colonText, 0xFFFFFF, 0xFF000000, 1, startFrame);
+		hud->DrawString(filterValueX, filterLineY, line.Value, line.ValueColor, 0xFF000000, 1, startFrame);
+		filterLineY += lineSpacing;
+	}
+
 	int secondRowTop = videoBoxTop + topRowHeight + boxGap;
 
 	// 提前计算杂项框尺寸（在使用 miscBoxHeight 前必须定义）
@@ -0,0 +1,106 @@
+#include "pch.h"
+#include "Shared/Video/FrameFilterScheduler.h"
+
+FrameFilterScheduler::FrameFilterScheduler()
+{
+	//Leave a core for the emulation thread and one for the decode thread (which also processes bands)
+	int workerCount = std::clamp((int)std::thread::hardware_concurrency() - 2, 0, 7);
+	for(int i = 0; i < workerCount; i++) {
+		_workers.push_back(std::thread(&FrameFilterScheduler::WorkerThread, this));
+	}
+}
+
+FrameFilterScheduler::~FrameFilterScheduler()
+{
+	{
+		std::unique_lock<std::mutex> lock(_mutex);
+		_stopFlag = true;
+	}
+	_workSignal.notify_all();
+
+	for(std::thread& worker : _workers) {
+		worker.join();
+	}
+}
+
+void FrameFilterScheduler::ProcessJob(Job& job)
+{
+	uint32_t band;
+	while((band = job.NextBand++) < job.BandCount) {
+		uint32_t startRow = band * job.BandRows;
+		uint32_t endRow = std::min(job.RowCount, startRow + job.BandRows);
+		(*job.Process)(startRow, endRow);
+	}
+}
+
+void FrameFilterScheduler::WorkerThread()
+{
+	std::unique_lock<std::mutex> lock(_mutex);
+	while(true) {
+		_workSignal.wait(lock, [this] { return _stopFlag || !_jobs.empty(); });
+		if(_stopFlag) {
+			return;
+		}
+
+		Job* job = _jobs.front();
+		job->ThreadCount++;
+
+		lock.unlock();
+		ProcessJob(*job);
+		lock.lock();
+
+		//All bands have been claimed, no other thread needs to pick up this job
+		auto result = std::find(_jobs.begin(), _jobs.end(), job);
+		if(result != _jobs.end()) {
+			_jobs.erase(result);
+		}
+
+		job->ThreadCount--;
+		if(job->ThreadCount == 0) {
+			_doneSignal.notify_all();
+		}
+	}
+}
+
+void FrameFilterScheduler::ProcessBands(uint32_t rowCount, uint32_t minBandRows, const std::function<void(uint32_t startRow, uint32_t endRow)>& process)
+{
+	if(rowCount == 0) {
+		return;
+	} else if(_workers.empty()) {
+		process(0, rowCount);
+		return;
+	}
+
+	//Use a few bands per thread to balance the load when some bands are slower than others
+	uint32_t bandCount = std::min(GetThreadCount() * 3, rowCount / std::max<uint32_t>(minBandRows, 1));
+	if(bandCount <= 1) {
+		process(0, rowCount);
+		return;
+	}
+
+	Job job;
+	job.Process = &process;
+	job.RowCount = rowCount;
+	job.BandRows = (rowCount + bandCount - 1) / bandCount;
+	job.BandCount = (rowCount + job.BandRows - 1) / job.BandRows;
+	job.NextBand = 0;
+	job.ThreadCount = 1;
+
+	{
+		std::unique_lock<std::mutex> lock(_mutex);
+		_jobs.push_back(&job);
+	}
+	_workSignal.notify_all();
+
+	ProcessJob(job);
+
+	std::unique_lock<std::mutex> lock(_mutex);
+	auto result = std::find(_jobs.begin(), _jobs.end(), &job);
+	if(result != _jobs.end()) {
+		_jobs.erase(result);
+	}
+
+	//Wait for the bands being processed by the worker threads
+	job.ThreadCount--;
+	_doneSignal.wait(lock, [&job] { return job.ThreadCount == 0; });
+}
@@ -0,0 +1,43 @@
+#pragma once
+#include "pch.h"
+#include <functional>
+#include <condition_variable>
+#include <mutex>
+
+//Splits a frame into horizontal bands of rows that are processed in parallel by a pool of worker threads
+//The calling thread also processes bands, and ProcessBands only returns once every band is done.
+//Can be called from several threads at once (e.g by 2 stages of the video pipeline)
+class FrameFilterScheduler
+{
+private:
+	struct Job
+	{
+		const std::function<void(uint32_t, uint32_t)>* Process = nullptr;
+		uint32_t RowCount = 0;
+		uint32_t BandRows = 0;
+		uint32_t BandCount = 0;
+		atomic<uint32_t> NextBand;
+
+		//Number of threads currently processing bands for this job (protected by _mutex)
+		uint32_t ThreadCount = 0;
+	};
+
+	vector<std::thread> _workers;
+	std::mutex _mutex;
+	std::condition_variable _workSignal;
+	std::condition_variable _doneSignal;
+	deque<Job*> _jobs;
+	bool _stopFlag = false;
+
+	void WorkerThread();
+	static void ProcessJob(Job& job);
+
+public:
+	FrameFilterScheduler();
+	~FrameFilterScheduler();
+
+	uint32_t GetThreadCount() { return (uint32_t)_workers.size() + 1; }
+
+	//Calls process(startRow, endRow) for every band of [0, rowCount) - bands are at least minBandRows rows tall
+	void ProcessBands(uint32_t rowCount, uint32_t minBandRows, const std::function<void(uint32_t startRow, uint32_t endRow)>& process);
+};
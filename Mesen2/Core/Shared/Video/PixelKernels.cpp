@@ -0,0 +1,259 @@
+#include "pch.h"
+#include "Shared/Video/PixelKernels.h"
+
+#if defined(_M_X64) || defined(__x86_64__) || defined(_M_IX86) || defined(__i386__)
+	#define PIXELKERNELS_X86
+	#include <emmintrin.h>
+	#include <immintrin.h>
+	#ifdef _MSC_VER
+		#include <intrin.h>
+	#endif
+
+	#if defined(__GNUC__) || defined(__clang__)
+		//AVX2 functions are compiled for AVX2 even though the rest of the code isn't, and only called when the CPU supports it
+		#define AVX2_FUNC __attribute__((target("avx2")))
+	#else
+		#define AVX2_FUNC
+	#endif
+#elif defined(__aarch64__) || defined(_M_ARM64)
+	#define PIXELKERNELS_NEON
+	#include <arm_neon.h>
+#endif
+
+//Scalar versions, also used for the pixels left over at the end of each buffer by the SIMD versions
+static void ConvertPaletteScalar(const uint16_t* input, uint32_t* output, uint32_t count, const uint32_t* palette)
+{
+	for(uint32_t i = 0; i < count; i++) {
+		output[i] = palette[input[i]];
+	}
+}
+
+static void ApplyBrightnessScalar(const uint32_t* input, uint32_t* output, uint32_t count, uint8_t brightness)
+{
+	for(uint32_t i = 0; i < count; i++) {
+		output[i] = PixelKernels::ApplyBrightness(input[i], brightness);
+	}
+}
+
+static void ApplyBrightnessPairsScalar(const uint32_t* input, uint32_t* output, uint32_t count, uint8_t leftBrightness, uint8_t rightBrightness)
+{
+	for(uint32_t i = 0; i < count; i++) {
+		output[i * 2] = PixelKernels::ApplyBrightness(input[i], leftBrightness);
+		output[i * 2 + 1] = PixelKernels::ApplyBrightness(input[i], rightBrightness);
+	}
+}
+
+//The SIMD versions multiply 8-bit channels in 16-bit lanes, and divide by 255 with: x/255 = (x + 1 + (x >> 8)) >> 8
+//This is exact for all products of 2 8-bit values, so the result matches the scalar version
+#ifdef PIXELKERNELS_X86
+static __forceinline __m128i ApplyBrightnessSse2(__m128i pixels, __m128i brightness)
+{
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i one = _mm_set1_epi16(1);
+
+	__m128i lo = _mm_mullo_epi16(_mm_unpacklo_epi8(pixels, zero), brightness);
+	__m128i hi = _mm_mullo_epi16(_mm_unpackhi_epi8(pixels, zero), brightness);
+	lo = _mm_srli_epi16(_mm_add_epi16(_mm_add_epi16(lo, one), _mm_srli_epi16(lo, 8)), 8);
+	hi = _mm_srli_epi16(_mm_add_epi16(_mm_add_epi16(hi, one), _mm_srli_epi16(hi, 8)), 8);
+
+	return _mm_or_si128(_mm_packus_epi16(lo, hi), _mm_set1_epi32((int)0xFF000000));
+}
+
+static void ApplyBrightnessSse2(const uint32_t* input, uint32_t* output, uint32_t count, uint8_t brightness)
+{
+	__m128i factor = _mm_set1_epi16(brightness);
+	uint32_t i = 0;
+	for(; i + 4 <= count; i += 4) {
+		__m128i pixels = _mm_loadu_si128((const __m128i*)(input + i));
+		_mm_storeu_si128((__m128i*)(output + i), ApplyBrightnessSse2(pixels, factor));
+	}
+	ApplyBrightnessScalar(input + i, output + i, count - i, brightness);
+}
+
+static void ApplyBrightnessPairsSse2(const uint32_t* input, uint32_t* output, uint32_t count, uint8_t leftBrightness, uint8_t rightBrightness)
+{
+	__m128i leftFactor = _mm_set1_epi16(leftBrightness);
+	__m128i rightFactor = _mm_set1_epi16(rightBrightness);
+	uint32_t i = 0;
+	for(; i + 4 <= count; i += 4) {
+		__m128i pixels = _mm_loadu_si128((const __m128i*)(input + i));
+		__m128i left = ApplyBrightnessSse2(pixels, leftFactor);
+		__m128i right = ApplyBrightnessSse2(pixels, rightFactor);
+		_mm_storeu_si128((__m128i*)(output + i * 2), _mm_unpacklo_epi32(left, right));
+		_mm_storeu_si128((__m128i*)(output + i * 2 + 4), _mm_unpackhi_epi32(left, right));
+	}
+	ApplyBrightnessPairsScalar(input + i, output + i * 2, count - i, leftBrightness, rightBrightness);
+}
+
+AVX2_FUNC static __forceinline __m256i ApplyBrightnessAvx2(__m256i pixels, __m256i brightness)
+{
+	const __m256i zero = _mm256_setzero_si256();
+	const __m256i one = _mm256_set1_epi16(1);
+
+	//Unpack/pack operate within each 128-bit lane, so the pixels end up in their original order
+	__m256i lo = _mm256_mullo_epi16(_mm256_unpacklo_epi8(pixels, zero), brightness);
+	__m256i hi = _mm256_mullo_epi16(_mm256_unpackhi_epi8(pixels, zero), brightness);
+	lo = _mm256_srli_epi16(_mm256_add_epi16(_mm256_add_epi16(lo, one), _mm256_srli_epi16(lo, 8)), 8);
+	hi = _mm256_srli_epi16(_mm256_add_epi16(_mm256_add_epi16(hi, one), _mm256_srli_epi16(hi, 8)), 8);
+
+	return _mm256_or_si256(_mm256_packus_epi16(lo, hi), _mm256_set1_epi32((int)0xFF000000));
+}
+
+AVX2_FUNC static void ConvertPaletteAvx2(const uint16_t* input, uint32_t* output, uint32_t count, const uint32_t* palette)
+{
+	uint32_t i = 0;
+	for(; i + 8 <= count; i += 8) {
+		__m256i indexes = _mm256_cvtepu16_epi32(_mm_loadu_si128((const __m128i*)(input + i)));
+		_mm256_storeu_si256((__m256i*)(output + i), _mm256_i32gather_epi32((const int*)palette, indexes, 4));
+	}
+	ConvertPaletteScalar(input + i, output + i, count - i, palette);
+}
+
+AVX2_FUNC static void ApplyBrightnessAvx2(const uint32_t* input, uint32_t* output, uint32_t count, uint8_t brightness)
+{
+	__m256i factor = _mm256_set1_epi16(brightness);
+	uint32_t i = 0;
+	for(; i + 8 <= count; i += 8) {
+		__m256i pixels = _mm256_loadu_si256((const __m256i*)(input + i));
+		_mm256_storeu_si256((__m256i*)(output + i), ApplyBrightnessAvx2(pixels, factor));
+	}
+	ApplyBrightnessScalar(input + i, output + i, count - i, brightness);
+}
+
+AVX2_FUNC static void ApplyBrightnessPairsAvx2(const uint32_t* input, uint32_t* output, uint32_t count, uint8_t leftBrightness, uint8_t rightBrightness)
+{
+	__m256i leftFactor = _mm256_set1_epi16(leftBrightness);
+	__m256i rightFactor = _mm256_set1_epi16(rightBrightness);
+	uint32_t i = 0;
+	for(; i + 8 <= count; i += 8) {
+		__m256i pixels = _mm256_loadu_si256((const __m256i*)(input + i));
+		__m256i left = ApplyBrightnessAvx2(pixels, leftFactor);
+		__m256i right = ApplyBrightnessAvx2(pixels, rightFactor);
+
+		//Interleaving is done per 128-bit lane: lo = pixels 0,1,4,5 and hi = pixels 2,3,6,7
+		__m256i lo = _mm256_unpacklo_epi32(left, right);
+		__m256i hi = _mm256_unpackhi_epi32(left, right);
+		_mm256_storeu_si256((__m256i*)(output + i * 2), _mm256_permute2x128_si256(lo, hi, 0x20));
+		_mm256_storeu_si256((__m256i*)(output + i * 2 + 8), _mm256_permute2x128_si256(lo, hi, 0x31));
+	}
+	ApplyBrightnessPairsScalar(input + i, output + i * 2, count - i, leftBrightness, rightBrightness);
+}
+
+static bool IsAvx2Supported()
+{
+#ifdef _MSC_VER
+	int cpuInfo[4];
+	__cpuid(cpuInfo, 0);
+	if(cpuInfo[0] < 7) {
+		return false;
+	}
+
+	//AVX2 instructions also require the OS to save the YMM registers (OSXSAVE + XCR0)
+	__cpuid(cpuInfo, 1);
+	bool osxsave = (cpuInfo[2] & (1 << 27)) != 0;
+	bool avx = (cpuInfo[2] & (1 << 28)) != 0;
+	if(!osxsave || !avx || (_xgetbv(0) & 0x06) != 0x06) {
+		return false;
+	}
+
+	__cpuidex(cpuInfo, 7, 0);
+	return (cpuInfo[1] & (1 << 5)) != 0;
+#else
+	__builtin_cpu_init();
+	return __builtin_cpu_supports("avx2");
+#endif
+}
+#endif
+
+#ifdef PIXELKERNELS_NEON
+static inline uint32x4_t ApplyBrightnessNeon(uint32x4_t pixels, uint8x8_t brightness)
+{
+	const uint16x8_t one = vdupq_n_u16(1);
+	uint8x16_t channels = vreinterpretq_u8_u32(pixels);
+
+	uint16x8_t lo = vmull_u8(vget_low_u8(channels), brightness);
+	uint16x8_t hi = vmull_u8(vget_high_u8(channels), brightness);
+	lo = vshrq_n_u16(vaddq_u16(vaddq_u16(lo, one), vshrq_n_u16(lo, 8)), 8);
+	hi = vshrq_n_u16(vaddq_u16(vaddq_u16(hi, one), vshrq_n_u16(hi, 8)), 8);
+
+	uint32x4_t result = vreinterpretq_u32_u8(vcombine_u8(vmovn_u16(lo), vmovn_u16(hi)));
+	return vorrq_u32(result, vdupq_n_u32(0xFF000000));
+}
+
+static void ApplyBrightnessNeon(const uint32_t* input, uint32_t* output, uint32_t count, uint8_t brightness)
+{
+	uint8x8_t factor = vdup_n_u8(brightness);
+	uint32_t i = 0;
+	for(; i + 4 <= count; i += 4) {
+		vst1q_u32(output + i, ApplyBrightnessNeon(vld1q_u32(input + i), factor));
+	}
+	ApplyBrightnessScalar(input + i, output + i, count - i, brightness);
+}
+
+static void ApplyBrightnessPairsNeon(const uint32_t* input, uint32_t* output, uint32_t count, uint8_t leftBrightness, uint8_t rightBrightness)
+{
+	uint8x8_t leftFactor = vdup_n_u8(leftBrightness);
+	uint8x8_t rightFactor = vdup_n_u8(rightBrightness);
+	uint32_t i = 0;
+	for(; i + 4 <= count; i += 4) {
+		uint32x4_t pixels = vld1q_u32(input + i);
+		uint32x4x2_t interleaved = { { ApplyBrightnessNeon(pixels, leftFactor), ApplyBrightnessNeon(pixels, rightFactor) } };
+		vst2q_u32(output + i * 2, interleaved);
+	}
+	ApplyBrightnessPairsScalar(input + i, output + i * 2, count - i, leftBrightness, rightBrightness);
+}
+#endif
+
+bool PixelKernels::IsSupported(SimdLevel level)
+{
+	switch(level) {
+		case SimdLevel::Scalar: return true;
+
+#ifdef PIXELKERNELS_X86
+		case SimdLevel::Sse2: return true;
+		case SimdLevel::Avx2: return IsAvx2Supported();
+#endif
+
+#ifdef PIXELKERNELS_NEON
+		case SimdLevel::Neon: return true;
+#endif
+
+		default: return false;
+	}
+}
+
+PixelKernels::KernelTable PixelKernels::GetKernels(SimdLevel level)
+{
+	switch(level) {
+		default:
+		case SimdLevel::Scalar:
+			return { SimdLevel::Scalar, ConvertPaletteScalar, ApplyBrightnessScalar, ApplyBrightnessPairsScalar };
+
+#ifdef PIXELKERNELS_X86
+		case SimdLevel::Sse2:
+			//SSE2 has no gather instruction, a table lookup is just as fast with the scalar loop
+			return { SimdLevel::Sse2, ConvertPaletteScalar, ApplyBrightnessSse2, ApplyBrightnessPairsSse2 };
+
+		case SimdLevel::Avx2:
+			return { SimdLevel::Avx2, ConvertPaletteAvx2, ApplyBrightnessAvx2, ApplyBrightnessPairsAvx2 };
+#endif
+
+#ifdef PIXELKERNELS_NEON
+		case SimdLevel::Neon:
+			return { SimdLevel::Neon, ConvertPaletteScalar, ApplyBrightnessNeon, ApplyBrightnessPairsNeon };
+#endif
+	}
+}
+
+const PixelKernels::KernelTable& PixelKernels::GetKernels()
+{
+	static KernelTable kernels = []() {
+		for(SimdLevel level : { SimdLevel::Avx2, SimdLevel::Sse2, SimdLevel::Neon }) {
+			if(IsSupported(level)) {
+				return GetKernels(level);
+			}
+		}
+		return GetKernels(SimdLevel::Scalar);
+	}();
+	return kernels;
+}
@@ -0,0 +1,61 @@
+#pragma once
+#include "pch.h"
+
+enum class SimdLevel
+{
+	Scalar,
+	Sse2,
+	Avx2,
+	Neon
+};
+
+//Per-pixel loops shared by the video filters
+//SSE2/AVX2 (x86) or NEON (ARM) versions are selected at runtime based on the CPU's features, and give the same result as the scalar versions
+class PixelKernels
+{
+public:
+	struct KernelTable
+	{
+		SimdLevel Level;
+		void (*ConvertPalette)(const uint16_t* input, uint32_t* output, uint32_t count, const uint32_t* palette);
+		void (*ApplyBrightness)(const uint32_t* input, uint32_t* output, uint32_t count, uint8_t brightness);
+		void (*ApplyBrightnessPairs)(const uint32_t* input, uint32_t* output, uint32_t count, uint8_t leftBrightness, uint8_t rightBrightness);
+	};
+
+	//Returns the kernels for a specific level (used to compare them against the scalar versions) - level must be supported
+	static KernelTable GetKernels(SimdLevel level);
+
+private:
+	static const KernelTable& GetKernels();
+
+public:
+	static SimdLevel GetSimdLevel() { return GetKernels().Level; }
+	static bool IsSupported(SimdLevel level);
+
+	//output[i] = palette[input[i]]
+	static void ConvertPalette(const uint16_t* input, uint32_t* output, uint32_t count, const uint32_t* palette)
+	{
+		GetKernels().ConvertPalette(input, output, count, palette);
+	}
+
+	//Multiplies each RGB channel by brightness/255 (rounded down), alpha is set to 0xFF - input and output can be the same buffer
+	static void ApplyBrightness(const uint32_t* input, uint32_t* output, uint32_t count, uint8_t brightness)
+	{
+		GetKernels().ApplyBrightness(input, output, count, brightness);
+	}
+
+	//Same as ApplyBrightness, but writes 2 pixels for each input pixel (with the left & right brightness) - output must hold count*2 pixels
+	static void ApplyBrightnessPairs(const uint32_t* input, uint32_t* output, uint32_t count, uint8_t leftBrightness, uint8_t rightBrightness)
+	{
+		GetKernels().ApplyBrightnessPairs(input, output, count, leftBrightness, rightBrightness);
+	}
+
+	static uint32_t ApplyBrightness(uint32_t argb, uint8_t brightness)
+	{
+		uint8_t r = ((argb & 0xFF0000) >> 16) * brightness / 255;
+		uint8_t g = ((argb & 0xFF00) >> 8) * brightness / 255;
+		uint8_t b = (argb & 0xFF) * brightness / 255;
+
+		return 0xFF000000 | (r << 16) | (g << 8) | b;
+	}
+};
@@ -1,5 +1,6 @@
 #include "pch.h"
 #include "Shared/Video/RotateFilter.h"
+#include "Shared/Video/FrameFilterScheduler.h"
 
 RotateFilter::RotateFilter(uint32_t angle)
 {
@@ -31,33 +32,46 @@ uint32_t RotateFilter::GetAngle()
 	return _angle;
 }
 
-uint32_t* RotateFilter::ApplyFilter(uint32_t* inputArgbBuffer, uint32_t width, uint32_t height)
+void RotateFilter::ApplyFilter(uint32_t* inputArgbBuffer, uint32_t width, uint32_t height, uint32_t startRow, uint32_t endRow)
 {
-	UpdateOutputBuffer(width, height);
-
-	uint32_t* input = inputArgbBuffer;
+	uint32_t* input = inputArgbBuffer + startRow * width;
 	if(_angle == 90) {
-		for(int i = (int)height - 1; i >= 0; i--) {
+		for(uint32_t y = startRow; y < endRow; y++) {
+			uint32_t i = height - 1 - y;
 			for(uint32_t j = 0; j < width; j++) {
 				_outputBuffer[j * height + i] = *input;
 				input++;
 			}
 		}
 	} else if(_angle == 180) {
-		for(int i = (int)height - 1; i >= 0; i--) {
+		for(uint32_t y = startRow; y < endRow; y++) {
+			uint32_t* output = _outputBuffer + (height - 1 - y) * width;
 			for(int j = (int)width - 1; j >= 0; j--) {
-				_outputBuffer[i * width + j] = *input;
+				output[j] = *input;
 				input++;
 			}
 		}
 	} else if(_angle == 270) {
-		for(uint32_t i = 0; i < height; i++) {
+		for(uint32_t y = startRow; y < endRow; y++) {
 			for(int j = (int)width - 1; j >= 0; j--) {
-				_outputBuffer[j * height + i] = *input;
+				_outputBuffer[j * height + y] = *input;
 				input++;
 			}
 		}
 	}
+}
+
+uint32_t* RotateFilter::ApplyFilter(uint32_t* inputArgbBuffer, uint32_t width, uint32_t height, FrameFilterScheduler* scheduler)
+{
+	UpdateOutputBuffer(width, height);
+
+	if(scheduler) {
+		scheduler->ProcessBands(height, 16, [=](uint32_t startRow, uint32_t endRow) {
+			ApplyFilter(inputArgbBuffer, width, height, startRow, endRow);
+		});
+	} else {
+		ApplyFilter(inputArgbBuffer, width, height, 0, height);
+	}
 
 	return _outputBuffer;
 }
@@ -2,6 +2,8 @@
 #include "pch.h"
 #include "Shared/SettingTypes.h"
 
+class FrameFilterScheduler;
+
 class RotateFilter
 {
 private:
@@ -11,12 +13,13 @@ private:
 	uint32_t _height = 0;
 
 	void UpdateOutputBuffer(uint32_t width, uint32_t height);
+	void ApplyFilter(uint32_t* inputArgbBuffer, uint32_t width, uint32_t height, uint32_t startRow, uint32_t endRow);
 
 public:
 	RotateFilter(uint32_t angle);
 	~RotateFilter();
 
 	uint32_t GetAngle();
-	uint32_t* ApplyFilter(uint32_t* inputArgbBuffer, uint32_t width, uint32_t height);
+	uint32_t* ApplyFilter(uint32_t* inputArgbBuffer, uint32_t width, uint32_t height, FrameFilterScheduler* scheduler = nullptr);
 	FrameInfo GetFrameInfo(FrameInfo baseFrameInfo);
 };
\ No newline at end of file
@@ -2,6 +2,9 @@
 #include "Shared/Emulator.h"
 #include "Shared/EmuSettings.h"
 #include "Shared/Video/ScaleFilter.h"
+#include "Shared/Video/VideoDecoder.h"
+#include "Shared/Video/FrameFilterScheduler.h"
+#include "Shared/Video/PixelKernels.h"
 #include "Utilities/xBRZ/xbrz.h"
 #include "Utilities/HQX/hqx.h"
 #include "Utilities/Scale2x/scalebit.h"
@@ -31,16 +34,7 @@ uint32_t ScaleFilter::GetScale()
 	return _filterScale;
 }
 
-uint32_t ScaleFilter::ApplyBrightness(uint32_t argb, uint8_t brightness)
-{
-	uint8_t r = ((argb & 0xFF0000) >> 16) * brightness / 255;
-	uint8_t g = ((argb & 0xFF00) >> 8) * brightness / 255;
-	uint8_t b = (argb & 0xFF) * brightness / 255;
-
-	return 0xFF000000 | (r << 16) | (g << 8) | b;
-}
-
-void ScaleFilter::ApplyLcdGridFilter(uint32_t* inputArgbBuffer)
+void ScaleFilter::ApplyLcdGridFilter(uint32_t* inputArgbBuffer, uint32_t startRow, uint32_t endRow)
 {
 	VideoConfig& cfg = _emu->GetSettings()->GetVideoConfig();
 	uint8_t topLeft = (uint8_t)(cfg.LcdGridTopLeftBrightness * 255);
@@ -61,24 +55,20 @@ void ScaleFilter::ApplyLcdGridFilter(uint32_t* inputArgbBuffer)
 		bottomLeft = orgTopLeft;
 	}
 
-	for(uint32_t y = 0; y < _height; y++) {
-		for(uint32_t x = 0; x < _width; x++) {
-			uint32_t srcColor = inputArgbBuffer[y * _width + x];
-			
-			uint32_t pos = y * _width * _filterScale * 2 + x * _filterScale;
-			_outputBuffer[pos] = ApplyBrightness(srcColor, topLeft);
-			_outputBuffer[pos + 1] = ApplyBrightness(srcColor, topRight);
-			_outputBuffer[pos + _width * _filterScale] = ApplyBrightness(srcColor, bottomLeft);
-			_outputBuffer[pos + _width * _filterScale + 1] = ApplyBrightness(srcColor, bottomRight);
-		}
+	for(uint32_t y = startRow; y < endRow; y++) {
+		uint32_t* topRow = _outputBuffer + y * _width * _filterScale * 2;
+		uint32_t* bottomRow = topRow + _width * _filterScale;
+		PixelKernels::ApplyBrightnessPairs(inputArgbBuffer + y * _width, topRow, _width, topLeft, topRight);
+		PixelKernels::ApplyBrightnessPairs(inputArgbBuffer + y * _width, bottomRow, _width, bottomLeft, bottomRight);
 	}
 }
 
-void ScaleFilter::ApplyPrescaleFilter(uint32_t *inputArgbBuffer)
+void ScaleFilter::ApplyPrescaleFilter(uint32_t *inputArgbBuffer, uint32_t startRow, uint32_t endRow)
 {
-	uint32_t* outputBuffer = _outputBuffer;
+	uint32_t* outputBuffer = _outputBuffer + startRow * _width * _filterScale * _filterScale;
+	inputArgbBuffer += startRow * _width;
 
-	for(uint32_t y = 0; y < _height; y++) {
+	for(uint32_t y = startRow; y < endRow; y++) {
 		for(uint32_t x = 0; x < _width; x++) {
 			for(uint32_t i = 0; i < _filterScale; i++) {
 				*(outputBuffer++) = *inputArgbBuffer;
@@ -102,27 +92,61 @@ void ScaleFilter::UpdateOutputBuffer(uint32_t width, uint32_t height)
 	}
 }
 
-uint32_t* ScaleFilter::ApplyFilter(uint32_t *inputArgbBuffer, uint32_t width, uint32_t height)
+void ScaleFilter::ApplyKernel(uint32_t* inputArgbBuffer, uint32_t* outputBuffer, uint32_t height)
 {
-	UpdateOutputBuffer(width, height);
-
-	if(_scaleFilterType == ScaleFilterType::xBRZ) {
-		xbrz::scale(_filterScale, inputArgbBuffer, _outputBuffer, width, height, xbrz::ColorFormat::ARGB);
-	} else if(_scaleFilterType == ScaleFilterType::HQX) {
-		hqx(_filterScale, inputArgbBuffer, _outputBuffer, width, height);
+	uint32_t width = _width;
+	if(_scaleFilterType == ScaleFilterType::HQX) {
+		hqx(_filterScale, inputArgbBuffer, outputBuffer, width, height);
 	} else if(_scaleFilterType == ScaleFilterType::Scale2x) {
-		scale(_filterScale, _outputBuffer, width*sizeof(uint32_t)*_filterScale, inputArgbBuffer, width*sizeof(uint32_t), 4, width, height);
+		scale(_filterScale, outputBuffer, width*sizeof(uint32_t)*_filterScale, inputArgbBuffer, width*sizeof(uint32_t), 4, width, height);
 	} else if(_scaleFilterType == ScaleFilterType::_2xSai) {
-		twoxsai_generic_xrgb8888(width, height, inputArgbBuffer, width, _outputBuffer, width * _filterScale);
+		twoxsai_generic_xrgb8888(width, height, inputArgbBuffer, width, outputBuffer, width * _filterScale);
 	} else if(_scaleFilterType == ScaleFilterType::Super2xSai) {
-		supertwoxsai_generic_xrgb8888(width, height, inputArgbBuffer, width, _outputBuffer, width * _filterScale);
+		supertwoxsai_generic_xrgb8888(width, height, inputArgbBuffer, width, outputBuffer, width * _filterScale);
 	} else if(_scaleFilterType == ScaleFilterType::SuperEagle) {
-		supereagle_generic_xrgb8888(width, height, inputArgbBuffer, width, _outputBuffer, width * _filterScale);
+		supereagle_generic_xrgb8888(width, height, inputArgbBuffer, width, outputBuffer, width * _filterScale);
+	}
+}
+
+void ScaleFilter::ApplyHaloKernel(uint32_t* inputArgbBuffer, uint32_t startRow, uint32_t endRow)
+{
+	if(startRow == 0 && endRow == _height) {
+		ApplyKernel(inputArgbBuffer, _outputBuffer, _height);
+		return;
+	}
+
+	//These kernels treat the first/last rows of their input as the edges of the image, so each band is
+	//scaled with a few extra rows above and below it, and only the band's own rows are kept
+	uint32_t haloStart = startRow - std::min(startRow, HaloRows);
+	uint32_t haloEnd = std::min(_height, endRow + HaloRows);
+	uint32_t rowSize = _width * _filterScale * _filterScale;
+
+	thread_local vector<uint32_t> bandBuffer;
+	bandBuffer.resize((size_t)rowSize * (haloEnd - haloStart));
+	ApplyKernel(inputArgbBuffer + haloStart * _width, bandBuffer.data(), haloEnd - haloStart);
+	memcpy(_outputBuffer + startRow * rowSize, bandBuffer.data() + (startRow - haloStart) * rowSize, (endRow - startRow) * rowSize * sizeof(uint32_t));
+}
+
+void ScaleFilter::ApplyFilterBand(uint32_t* inputArgbBuffer, uint32_t startRow, uint32_t endRow)
+{
+	if(_scaleFilterType == ScaleFilterType::xBRZ) {
+		xbrz::scale(_filterScale, inputArgbBuffer, _outputBuffer, _width, _height, xbrz::ColorFormat::ARGB, xbrz::ScalerCfg(), startRow, endRow);
 	} else if(_scaleFilterType == ScaleFilterType::Prescale) {
-		ApplyPrescaleFilter(inputArgbBuffer);
+		ApplyPrescaleFilter(inputArgbBuffer, startRow, endRow);
 	} else if(_scaleFilterType == ScaleFilterType::LcdGrid) {
-		ApplyLcdGridFilter(inputArgbBuffer);
+		ApplyLcdGridFilter(inputArgbBuffer, startRow, endRow);
+	} else {
+		ApplyHaloKernel(inputArgbBuffer, startRow, endRow);
 	}
+}
+
+uint32_t* ScaleFilter::ApplyFilter(uint32_t *inputArgbBuffer, uint32_t width, uint32_t height)
+{
+	UpdateOutputBuffer(width, height);
+
+	_emu->GetVideoDecoder()->GetFilterScheduler()->ProcessBands(height, MinBandRows, [=](uint32_t startRow, uint32_t endRow) {
+		ApplyFilterBand(inputArgbBuffer, startRow, endRow);
+	});
 
 	return _outputBuffer;
 }
@@ -18,10 +18,16 @@ private:
 	uint32_t _width = 0;
 	uint32_t _height = 0;
 
-	uint32_t ApplyBrightness(uint32_t argb, uint8_t brightness);
-	void ApplyLcdGridFilter(uint32_t* inputArgbBuffer);
+	//Rows of context above/below a band needed by the HQX, Scale2x & 2xSaI kernels
+	static constexpr uint32_t HaloRows = 2;
+	static constexpr uint32_t MinBandRows = 16;
 
-	void ApplyPrescaleFilter(uint32_t *inputArgbBuffer);
+	void ApplyLcdGridFilter(uint32_t* inputArgbBuffer, uint32_t startRow, uint32_t endRow);
+
+	void ApplyPrescaleFilter(uint32_t *inputArgbBuffer, uint32_t startRow, uint32_t endRow);
+	void ApplyKernel(uint32_t* inputArgbBuffer, uint32_t* outputBuffer, uint32_t height);
+	void ApplyHaloKernel(uint32_t* inputArgbBuffer, uint32_t startRow, uint32_t endRow);
+	void ApplyFilterBand(uint32_t* inputArgbBuffer, uint32_t startRow, uint32_t endRow);
 	void UpdateOutputBuffer(uint32_t width, uint32_t height);
 
 public:
@@ -1,20 +1,12 @@
 #pragma once
 #include "pch.h"
+#include "Shared/Video/FrameFilterScheduler.h"
+#include "Shared/Video/PixelKernels.h"
 
 class ScanlineFilter
 {
-private:
-	static uint32_t ApplyScanlineEffect(uint32_t argb, uint8_t scanlineIntensity)
-	{
-		uint8_t r = ((argb & 0xFF0000) >> 16) * scanlineIntensity / 255;
-		uint8_t g = ((argb & 0xFF00) >> 8) * scanlineIntensity / 255;
-		uint8_t b = (argb & 0xFF) * scanlineIntensity / 255;
-
-		return 0xFF000000 | (r << 16) | (g << 8) | b;
-	}
-
 public:
-	static void ApplyFilter(uint32_t* buffer, uint32_t width, uint32_t height, double scanlineIntensity, uint8_t scale)
+	static void ApplyFilter(uint32_t* buffer, uint32_t width, uint32_t height, double scanlineIntensity, uint8_t scale, FrameFilterScheduler* scheduler = nullptr)
 	{
 		if(scanlineIntensity <= 0) {
 			return;
@@ -25,13 +17,18 @@ public:
 
 		uint8_t intensity = (uint8_t)((1.0 - scanlineIntensity) * 255);
 
-		for(uint32_t i = 0, len = height / scale; i < len; i++) {
-			buffer += width * linesToSkip;
-			
-			for(uint32_t j = 0; j < width; j++) {
-				*buffer = ApplyScanlineEffect(*buffer, intensity);
-				buffer++;
+		auto applyLines = [=](uint32_t start, uint32_t end) {
+			for(uint32_t i = start; i < end; i++) {
+				uint32_t* line = buffer + width * (i * scale + linesToSkip);
+				PixelKernels::ApplyBrightness(line, line, width, intensity);
 			}
+		};
+
+		uint32_t lineCount = height / scale;
+		if(scheduler) {
+			scheduler->ProcessBands(lineCount, 16, applyLines);
+		} else {
+			applyLines(0, lineCount);
 		}
 	}
 };
\ No newline at end of file
@@ -11,17 +11,26 @@
 #include "Shared/Video/ScaleFilter.h"
 #include "Shared/Video/RotateFilter.h"
 #include "Shared/Video/ScanlineFilter.h"
+#include "Shared/Video/FrameFilterScheduler.h"
 #include "Shared/Video/DebugHud.h"
 #include "Shared/InputHud.h"
 #include "Shared/RenderedFrame.h"
 #include "Shared/Video/SystemHud.h"
 #include "SNES/CartTypes.h"
+#include "Utilities/Timer.h"
 
 VideoDecoder::VideoDecoder(Emulator* emu)
 {
 	_emu = emu;
-	_frameChanged = false;
 	_stopFlag = false;
+	_publishedFrameId = 0;
+	_decodedFrameId = 0;
+	_droppedFrames = 0;
+	_consoleFilterTime = 0;
+	_rotateTime = 0;
+	_scaleTime = 0;
+	_scanlineTime = 0;
+	_filterScheduler.reset(new FrameFilterScheduler());
 	_baseFrameSize = { 256, 239 };
 	_lastFrameSize = _baseFrameSize;
 }
@@ -92,7 +101,7 @@ void VideoDecoder::UpdateVideoFilter()
 	}
 }
 
-void VideoDecoder::DecodeFrame(bool forRewind)
+void VideoDecoder::DecodeFrame(bool forRewind, bool pipelineScaling)
 {
 	UpdateVideoFilter();
 
@@ -106,37 +115,90 @@ void VideoDecoder::DecodeFrame(bool forRewind)
 		_baseFrameSize.Height = _frame.Height;
 	}
 
+	Timer timer;
 	_videoFilter->SetBaseFrameInfo(_baseFrameSize);
 	FrameInfo frameSize = _videoFilter->SendFrame((uint16_t*)_frame.FrameBuffer, _frame.FrameNumber, _frame.VideoPhase, _frame.Data);
+	_consoleFilterTime = timer.GetElapsedMS();
 
 	uint32_t* outputBuffer = _videoFilter->GetOutputBuffer();
 	
 	OverscanDimensions overscan = _videoFilter->GetOverscan();
 
+	timer.Reset();
 	if(_rotateFilter && !isAudioPlayer) {
-		outputBuffer = _rotateFilter->ApplyFilter(outputBuffer, frameSize.Width, frameSize.Height);
+		outputBuffer = _rotateFilter->ApplyFilter(outputBuffer, frameSize.Width, frameSize.Height, _filterScheduler.get());
 		if((_rotateFilter->GetAngle() % 180) != 0) {
 			//90 or 270 rotation, swap height & width
 			std::swap(_baseFrameSize.Width, _baseFrameSize.Height);
 			frameSize = _rotateFilter->GetFrameInfo(frameSize);
 		}
 	}
+	_rotateTime = timer.GetElapsedMS();
 
 	_emu->GetDebugHud()->Draw(outputBuffer, frameSize, overscan, _frame.FrameNumber, _videoFilter->GetScaleFactor());
 
-	if(_scaleFilter && !isAudioPlayer) {
-		outputBuffer = _scaleFilter->ApplyFilter(outputBuffer, frameSize.Width, frameSize.Height);
-		frameSize = _scaleFilter->GetFrameInfo(frameSize);
+	shared_ptr<ScaleFilter> scaleFilter = isAudioPlayer ? nullptr : _scaleFilter;
+	if(pipelineScaling && scaleFilter && _scaleThread) {
+		//Copy the frame to let the scale thread work on it while the next frame is decoded
+		ScaleStageFrame& stageFrame = _scaleStageFrames[_scaleStageIndex ^ 1];
+		stageFrame.Buffer.assign(outputBuffer, outputBuffer + frameSize.Width * frameSize.Height);
+		stageFrame.Source = stageFrame.Buffer.data();
+		stageFrame.Size = frameSize;
+		stageFrame.BaseSize = _baseFrameSize;
+		stageFrame.Overscan = overscan;
+		stageFrame.Filter = scaleFilter;
+		stageFrame.IsAudioPlayer = isAudioPlayer;
+		stageFrame.ForRewind = forRewind;
+		stageFrame.Frame = _frame;
+
+		{
+			std::unique_lock<std::mutex> lock(_scaleStageLock);
+			_scaleStageSignal.wait(lock, [this] { return !_scaleStagePending; });
+			_scaleStageIndex ^= 1;
+			_scaleStagePending = true;
+		}
+		_scaleStageSignal.notify_all();
+	} else {
+		//Frames must be sent in order, and the scale filter's buffer may still be in use by the scale thread
+		WaitForScaleStage();
+
+		ScaleStageFrame stageFrame;
+		stageFrame.Source = outputBuffer;
+		stageFrame.Size = frameSize;
+		stageFrame.BaseSize = _baseFrameSize;
+		stageFrame.Overscan = overscan;
+		stageFrame.Filter = scaleFilter;
+		stageFrame.IsAudioPlayer = isAudioPlayer;
+		stageFrame.ForRewind = forRewind;
+		stageFrame.Frame = _frame;
+		ApplyScaleStage(stageFrame);
 	}
+}
 
-	if(!isAudioPlayer) {
-		uint8_t scale = std::max<uint8_t>(1, (uint8_t)((double)frameSize.Height / (_frame.Height - overscan.Top - overscan.Bottom)));
-		ScanlineFilter::ApplyFilter(outputBuffer, frameSize.Width, frameSize.Height, _emu->GetSettings()->GetVideoConfig().ScanlineIntensity, scale);
+void VideoDecoder::ApplyScaleStage(ScaleStageFrame& stageFrame)
+{
+	uint32_t* outputBuffer = stageFrame.Source;
+	FrameInfo frameSize = stageFrame.Size;
+	RenderedFrame& frame = stageFrame.Frame;
+
+	Timer timer;
+	if(stageFrame.Filter) {
+		outputBuffer = stageFrame.Filter->ApplyFilter(outputBuffer, frameSize.Width, frameSize.Height);
+		frameSize = stageFrame.Filter->GetFrameInfo(frameSize);
 	}
+	_scaleTime = timer.GetElapsedMS();
 
-	RenderedFrame convertedFrame((void*)outputBuffer, frameSize.Width, frameSize.Height, _frame.Scale, _frame.FrameNumber, _frame.InputData);
+	timer.Reset();
+	if(!stageFrame.IsAudioPlayer) {
+		OverscanDimensions& overscan = stageFrame.Overscan;
+		uint8_t scale = std::max<uint8_t>(1, (uint8_t)((double)frameSize.Height / (frame.Height - overscan.Top - overscan.Bottom)));
+		ScanlineFilter::ApplyFilter(outputBuffer, frameSize.Width, frameSize.Height, _emu->GetSettings()->GetVideoConfig().ScanlineIntensity, scale, _filterScheduler.get());
+	}
+	_scanlineTime = timer.GetElapsedMS();
+
+	RenderedFrame convertedFrame((void*)outputBuffer, frameSize.Width, frameSize.Height, frame.Scale, frame.FrameNumber, frame.InputData);
 
-	double aspectRatio = _emu->GetSettings()->GetAspectRatio(_emu->GetRegion(), _baseFrameSize);
+	double aspectRatio = _emu->GetSettings()->GetAspectRatio(_emu->GetRegion(), stageFrame.BaseSize);
 	if(frameSize.Height != _lastFrameSize.Height || frameSize.Width != _lastFrameSize.Width || aspectRatio != _lastAspectRatio) {
 		_emu->GetNotificationManager()->SendNotification(ConsoleNotificationType::ResolutionChanged);
 	}
@@ -144,24 +206,61 @@ void VideoDecoder::DecodeFrame(bool forRewind)
 	_lastFrameSize = frameSize;
 	
 	//Rewind manager will take care of sending the correct frame to the video renderer
-	_emu->GetRewindManager()->SendFrame(convertedFrame, forRewind);
+	_emu->GetRewindManager()->SendFrame(convertedFrame, stageFrame.ForRewind);
+}
 
-	_frameChanged = false;
+void VideoDecoder::WaitForScaleStage()
+{
+	std::unique_lock<std::mutex> lock(_scaleStageLock);
+	_scaleStageSignal.wait(lock, [this] { return !_scaleStagePending; });
+}
+
+void VideoDecoder::ScaleThread()
+{
+	std::unique_lock<std::mutex> lock(_scaleStageLock);
+	while(true) {
+		_scaleStageSignal.wait(lock, [this] { return _scaleStagePending || _stopScaleThread; });
+		if(!_scaleStagePending) {
+			return;
+		}
+
+		ScaleStageFrame& stageFrame = _scaleStageFrames[_scaleStageIndex];
+		lock.unlock();
+		ApplyScaleStage(stageFrame);
+		lock.lock();
+
+		_scaleStagePending = false;
+		_scaleStageSignal.notify_all();
+	}
+}
+
+VideoFilterStats VideoDecoder::GetFilterStats()
+{
+	VideoFilterStats stats = {};
+	stats.ConsoleFilterTime = _consoleFilterTime;
+	stats.RotateTime = _rotateTime;
+	stats.ScaleTime = _scaleTime;
+	stats.ScanlineTime = _scanlineTime;
+	stats.ThreadCount = _filterScheduler->GetThreadCount();
+	return stats;
 }
 
 void VideoDecoder::DecodeThread()
 {
 	//This thread will decode the PPU's output (color ID to RGB, intensify r/g/b and produce a HD version of the frame if needed)
 	while(!_stopFlag.load()) {
-		//DecodeFrame returns the final ARGB frame we want to display in the emulator window
-		while(!_frameChanged) {
+		if(!_pendingFrames.Read()) {
 			_waitForFrame.Wait();
-			if(_stopFlag.load()) {
-				return;
-			}
+			continue;
 		}
 
-		DecodeFrame();
+		//Only the latest frame is decoded, frames published while the previous frame was being decoded are skipped
+		PendingFrame& pendingFrame = _pendingFrames.GetReadBuffer();
+		_frame = pendingFrame.Frame;
+
+		//DecodeFrame returns the final ARGB frame we want to display in the emulator window
+		DecodeFrame(false, true);
+		_decodedFrameId = pendingFrame.Id;
 	}
 }
 
@@ -172,10 +271,11 @@ uint32_t VideoDecoder::GetFrameCount()
 
 void VideoDecoder::WaitForAsyncFrameDecode()
 {
-	while(_frameChanged) {
+	while(IsDecodePending()) {
 		//Spin until decode is done
 		std::this_thread::sleep_for(std::chrono::duration<int, std::milli>(15));
 	}
+	WaitForScaleStage();
 }
 
 void VideoDecoder::UpdateFrame(RenderedFrame frame, bool sync, bool forRewind)
@@ -184,9 +284,11 @@ void VideoDecoder::UpdateFrame(RenderedFrame frame, bool sync, bool forRewind)
 		return;
 	}
 
-	if(_frameChanged) {
+	//The frame can't be dropped when it's recorded, and HD pack data belongs to the console (it must not change until the frame is decoded)
+	bool waitForDecode = sync || frame.Data || _emu->GetVideoRenderer()->IsRecording();
+	if(waitForDecode && IsDecodePending()) {
 		//Last frame isn't done decoding yet - sometimes Signal() introduces a 25-30ms delay
-		while(_frameChanged) {
+		while(IsDecodePending()) {
 			//Spin until decode is done
 		}
 		//At this point, we are sure that the decode thread is no longer busy
@@ -194,11 +296,23 @@ void VideoDecoder::UpdateFrame(RenderedFrame frame, bool sync, bool forRewind)
 
 	_emu->OnBeforeSendFrame();
 
-	_frame = frame;
 	if(sync) {
+		_frame = frame;
 		DecodeFrame(forRewind);
 	} else {
-		_frameChanged = true;
+		//The console keeps drawing in its buffer, so the decode thread works on a copy
+		PendingFrame& pendingFrame = _pendingFrames.GetWriteBuffer();
+		uint16_t* frameBuffer = (uint16_t*)frame.FrameBuffer;
+		pendingFrame.Buffer.assign(frameBuffer, frameBuffer + frame.Width * frame.Height);
+		pendingFrame.Frame = std::move(frame);
+		pendingFrame.Frame.FrameBuffer = pendingFrame.Buffer.data();
+		uint32_t frameId = ++_lastFrameId;
+		pendingFrame.Id = frameId;
+
+		if(_pendingFrames.Publish()) {
+			_droppedFrames++;
+		}
+		_publishedFrameId = frameId;
 		_waitForFrame.Signal();
 	}
 	_frameCount++;
@@ -212,12 +326,15 @@ void VideoDecoder::StartThread()
 		UpdateVideoFilter();
 		_videoFilter->SetBaseFrameInfo(_baseFrameSize);
 		_stopFlag = false;
-		_frameChanged = false;
 		_frameCount = 0;
+		_droppedFrames = 0;
 		_waitForFrame.Reset();
 		
 		_emu->GetVideoRenderer()->ClearFrame();
 
+		_stopScaleThread = false;
+		_scaleStagePending = false;
+		_scaleThread.reset(new thread(&VideoDecoder::ScaleThread, this));
 		_decodeThread.reset(new thread(&VideoDecoder::DecodeThread, this));
 	}
 }
@@ -232,6 +349,18 @@ void VideoDecoder::StopThread()
 
 		_decodeThread.reset();
 
+		//Frames that were never picked up by the decode thread are dropped
+		_decodedFrameId = _publishedFrameId.load();
+
+		//Let the scale thread finish its last frame
+		{
+			std::unique_lock<std::mutex> scaleLock(_scaleStageLock);
+			_stopScaleThread = true;
+		}
+		_scaleStageSignal.notify_all();
+		_scaleThread->join();
+		_scaleThread.reset();
+
 		//Clear whole screen
 		_emu->GetVideoRenderer()->ClearFrame();
 	}
@@ -2,15 +2,29 @@
 #include "pch.h"
 #include "Utilities/SimpleLock.h"
 #include "Utilities/AutoResetEvent.h"
+#include "Utilities/TripleBuffer.h"
 #include "Shared/SettingTypes.h"
 #include "Shared/RenderedFrame.h"
+#include <condition_variable>
+#include <mutex>
 
 class BaseVideoFilter;
 class ScaleFilter;
 class RotateFilter;
+class FrameFilterScheduler;
 class IRenderingDevice;
 class Emulator;
 
+//Time spent in each stage of the video filter pipeline for the last frame, in milliseconds
+struct VideoFilterStats
+{
+	double ConsoleFilterTime;
+	double RotateTime;
+	double ScaleTime;
+	double ScanlineTime;
+	uint32_t ThreadCount;
+};
+
 class VideoDecoder
 {
 private:
@@ -19,11 +33,11 @@ private:
 	ConsoleType _consoleType = ConsoleType::Snes;
 
 	unique_ptr<thread> _decodeThread;
+	unique_ptr<FrameFilterScheduler> _filterScheduler;
 
 	SimpleLock _stopStartLock;
 	AutoResetEvent _waitForFrame;
 	
-	atomic<bool> _frameChanged;
 	atomic<bool> _stopFlag;
 	uint32_t _frameCount = 0;
 	bool _forceFilterUpdate = false;
@@ -34,14 +48,65 @@ private:
 	FrameInfo _lastFrameSize = {};
 	RenderedFrame _frame = {};
 
+	//Copy of a frame sent by the emulation thread, waiting for the decode thread
+	struct PendingFrame
+	{
+		RenderedFrame Frame;
+		vector<uint16_t> Buffer;
+		uint32_t Id = 0;
+	};
+
+	//The emulation thread doesn't wait for the decode thread, unless the frame can't be dropped
+	//(when the frame is replaced by a newer one before the decode thread gets to it, it is dropped)
+	TripleBuffer<PendingFrame> _pendingFrames;
+	uint32_t _lastFrameId = 0;
+	atomic<uint32_t> _publishedFrameId;
+	atomic<uint32_t> _decodedFrameId;
+	atomic<uint32_t> _droppedFrames;
+
 	VideoFilterType _videoFilterType = VideoFilterType::None;
 	unique_ptr<BaseVideoFilter> _videoFilter;
-	unique_ptr<ScaleFilter> _scaleFilter;
+	shared_ptr<ScaleFilter> _scaleFilter;
 	unique_ptr<RotateFilter> _rotateFilter;
 
+	//Input of the second stage of the pipeline (scale & scanline filters)
+	struct ScaleStageFrame
+	{
+		vector<uint32_t> Buffer;
+		uint32_t* Source = nullptr;
+		FrameInfo Size = {};
+		FrameInfo BaseSize = {};
+		OverscanDimensions Overscan = {};
+		shared_ptr<ScaleFilter> Filter;
+		bool IsAudioPlayer = false;
+		bool ForRewind = false;
+		RenderedFrame Frame;
+	};
+
+	//When a scale filter is used, the scale stage of a frame runs on its own thread while the decode
+	//thread runs the console's filter on the next frame. Each stage uses one of the 2 frames, alternately
+	unique_ptr<thread> _scaleThread;
+	ScaleStageFrame _scaleStageFrames[2];
+	uint8_t _scaleStageIndex = 0;
+	std::mutex _scaleStageLock;
+	std::condition_variable _scaleStageSignal;
+	bool _scaleStagePending = false;
+	bool _stopScaleThread = false;
+
+	atomic<double> _consoleFilterTime;
+	atomic<double> _rotateTime;
+	atomic<double> _scaleTime;
+	atomic<double> _scanlineTime;
+
 	void UpdateVideoFilter();
 
+	void ApplyScaleStage(ScaleStageFrame& frame);
+	void WaitForScaleStage();
+
 	void DecodeThread();
+	void ScaleThread();
+
+	bool IsDecodePending() { return _decodedFrameId != _publishedFrameId; }
 
 public:
 	VideoDecoder(Emulator* console);
@@ -49,7 +114,7 @@ public:
 
 	void Init();
 
-	void DecodeFrame(bool synchronous = false);
+	void DecodeFrame(bool forRewind = false, bool pipelineScaling = false);
 	void TakeScreenshot();
 	void TakeScreenshot(std::stringstream &stream);
 	
@@ -60,6 +125,10 @@ public:
 	FrameInfo GetFrameInfo();
 	double GetLastFrameScale() { return _frame.Scale; }
 
+	FrameFilterScheduler* GetFilterScheduler() { return _filterScheduler.get(); }
+	VideoFilterStats GetFilterStats();
+	uint32_t GetDroppedFrameCount() { return _droppedFrames; }
+
 	void UpdateFrame(RenderedFrame frame, bool sync, bool forRewind);
 
 	void WaitForAsyncFrameDecode();
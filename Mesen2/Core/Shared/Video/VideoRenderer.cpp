@@ -3,6 +3,7 @@
 #include <algorithm>
 #include <limits>
 #include "Shared/Video/VideoDecoder.h"
+#include "Shared/Video/FrameFilterScheduler.h"
 #include "Shared/Interfaces/IRenderingDevice.h"
 #include "Shared/Emulator.h"
 #include "Shared/EmuSettings.h"
@@ -13,11 +14,15 @@
 #include "Utilities/Video/IVideoRecorder.h"
 #include "Utilities/Video/AviRecorder.h"
 #include "Utilities/Video/GifRecorder.h"
+#include "Utilities/Video/RawStreamRecorder.h"
 
 VideoRenderer::VideoRenderer(Emulator* emu)
 {
 	_emu = emu;
 	_stopFlag = false;
+	_discardRenderFrame = false;
+	_droppedFrames = 0;
+	_duplicatedFrames = 0;
 
 	_rendererHud.reset(new DebugHud());
 	_systemHud.reset(new SystemHud(_emu));
@@ -79,6 +84,16 @@ void VideoRenderer::RenderThread()
 		//Wait until a frame is ready, or until 32ms have passed (to allow HUD to update at ~30fps when paused)
 		bool forceRender = !_waitForRender.Wait(32);
 		if(_renderer) {
+			bool newFrame = false;
+			if(_discardRenderFrame.exchange(false)) {
+				//The screen was cleared, don't display a frame that was sent before that
+				_renderFrames.Read();
+			} else if(_renderFrames.Read()) {
+				_renderer->UpdateFrame(_renderFrames.GetReadBuffer().Frame);
+				_needRedraw = true;
+				newFrame = true;
+			}
+
 			FrameInfo baseSize = _emu->GetVideoDecoder()->GetBaseFrameInfo(true);
 			_scriptHudSurface.UpdateSize(baseSize.Width * _scriptHudScale, baseSize.Height * _scriptHudScale);
 
@@ -107,11 +122,7 @@ void VideoRenderer::RenderThread()
 			}
 			_rendererHud->SetVirtualResolution(virtualHudSize.Width, virtualHudSize.Height, actualHudSize.Width, actualHudSize.Height);
 
-			RenderedFrame frame;
-			{
-				auto lock = _frameLock.AcquireSafe();
-				frame = _lastFrame;
-			}
+			RenderedFrame& frame = _renderFrames.GetReadBuffer().Frame;
 
 			_inputHud->DrawControllers(virtualHudSize, frame.InputData);
 			{
@@ -123,6 +134,9 @@ void VideoRenderer::RenderThread()
 			_scriptHudSurface.IsDirty = DrawScriptHud(frame);
 
 			if(forceRender || _needRedraw || _emuHudSurface.IsDirty || _scriptHudSurface.IsDirty) {
+				if(!newFrame && _emu->IsRunning() && !_emu->IsPaused()) {
+					_duplicatedFrames++;
+				}
 				_needRedraw = false;
 				_renderer->Render(_emuHudSurface, _scriptHudSurface);
 			}
@@ -190,14 +204,18 @@ void VideoRenderer::UpdateFrame(RenderedFrame& frame)
 
 	ProcessAviRecording(frame);
 
-	{
-		auto lock = _frameLock.AcquireSafe();
-		_lastFrame = frame;
-	}
-
 	if(_renderer) {
-		_renderer->UpdateFrame(frame);
-		_needRedraw = true;
+		//The frame is copied, the renderer's buffer is updated by the render thread
+		auto lock = _frameLock.AcquireSafe();
+		RenderFrame& renderFrame = _renderFrames.GetWriteBuffer();
+		uint32_t* frameBuffer = (uint32_t*)frame.FrameBuffer;
+		renderFrame.Buffer.assign(frameBuffer, frameBuffer + frame.Width * frame.Height);
+		renderFrame.Frame = frame;
+		renderFrame.Frame.FrameBuffer = renderFrame.Buffer.data();
+
+		if(_renderFrames.Publish()) {
+			_droppedFrames++;
+		}
 		_waitForRender.Signal();
 	}
 }
@@ -205,8 +223,11 @@ void VideoRenderer::UpdateFrame(RenderedFrame& frame)
 void VideoRenderer::ClearFrame()
 {
 	if(_renderer) {
+		_discardRenderFrame = true;
 		_renderer->ClearFrame();
 	}
+	_droppedFrames = 0;
+	_duplicatedFrames = 0;
 }
 
 void VideoRenderer::RegisterRenderingDevice(IRenderingDevice *renderer)
@@ -277,7 +298,12 @@ void VideoRenderer::StartRecording(string filename, RecordAviOptions options)
 	if(options.Codec == VideoCodec::GIF) {
 		recorder.reset(new GifRecorder());
 	} else {
-		recorder.reset(new AviRecorder(options.Codec, options.CompressionLevel));
+		//Video encoding (motion search) shares the video filters' worker threads
+		FrameFilterScheduler* scheduler = _emu->GetVideoDecoder()->GetFilterScheduler();
+		ParallelForFunc parallelFor = [scheduler](uint32_t count, uint32_t minBatchSize, const std::function<void(uint32_t, uint32_t)>& process) {
+			scheduler->ProcessBands(count, minBatchSize, process);
+		};
+		recorder.reset(new AviRecorder(options.Codec, options.CompressionLevel, options.OfflineMode, parallelFor));
 	}
 
 	if(recorder->Init(filename)) {
@@ -292,6 +318,20 @@ void VideoRenderer::StartRecording(string filename, RecordAviOptions options)
 	}
 }
 
+void VideoRenderer::StartRawStream(string target, string audioTarget)
+{
+	//Only the game screen is written (no HUD)
+	_recorderOptions = {};
+
+	shared_ptr<IVideoRecorder> recorder(new RawStreamRecorder(audioTarget));
+	if(recorder->Init(target)) {
+		_recorder.reset(recorder);
+		MessageManager::DisplayMessage("VideoRecorder", "VideoRecorderStarted", target);
+	} else {
+		MessageManager::DisplayMessage("VideoRecorder", "CouldNotWriteToFile", target);
+	}
+}
+
 void VideoRenderer::AddRecordingSound(int16_t* soundBuffer, uint32_t sampleCount, uint32_t sampleRate)
 {
 	shared_ptr<IVideoRecorder> recorder = _recorder.lock();
@@ -315,4 +355,12 @@ void VideoRenderer::StopRecording()
 bool VideoRenderer::IsRecording()
 {
 	return _recorder != nullptr;
+}
+
+VideoFrameStats VideoRenderer::GetFrameStats()
+{
+	VideoFrameStats stats = {};
+	stats.DroppedFrames = _emu->GetVideoDecoder()->GetDroppedFrameCount() + _droppedFrames;
+	stats.DuplicatedFrames = _duplicatedFrames;
+	return stats;
 }
\ No newline at end of file
@@ -6,6 +6,7 @@
 #include "Shared/Interfaces/IRenderingDevice.h"
 #include "Utilities/AutoResetEvent.h"
 #include "Utilities/SimpleLock.h"
+#include "Utilities/TripleBuffer.h"
 #include "Utilities/safe_ptr.h"
 
 class IRenderingDevice;
@@ -23,6 +24,18 @@ struct RecordAviOptions
 	uint32_t CompressionLevel;
 	bool RecordSystemHud;
 	bool RecordInputHud;
+
+	//Emulation waits for the encoder instead of dropping frames when the encoder can't keep up
+	bool OfflineMode;
+};
+
+struct VideoFrameStats
+{
+	//Frames replaced by a newer frame before being decoded or displayed
+	uint32_t DroppedFrames;
+
+	//Frames displayed again because no new frame was ready
+	uint32_t DuplicatedFrames;
 };
 
 class VideoRenderer
@@ -54,8 +67,19 @@ private:
 	uint32_t _lastScriptHudFrameNumber = 0;
 	bool _needRedraw = true;
 
-	RenderedFrame _lastFrame;
-	SimpleLock _frameLock;
+	//Copy of a decoded frame, waiting for the render thread
+	struct RenderFrame
+	{
+		RenderedFrame Frame;
+		vector<uint32_t> Buffer;
+	};
+
+	//Frames are sent to the render thread without waiting for it (e.g while the GPU driver blocks in present)
+	TripleBuffer<RenderFrame> _renderFrames;
+	SimpleLock _frameLock; //Taken by the threads that send frames (decode, scale or emulation thread)
+	atomic<bool> _discardRenderFrame;
+	atomic<uint32_t> _droppedFrames;
+	atomic<uint32_t> _duplicatedFrames;
 
 	safe_ptr<IVideoRecorder> _recorder;
 
@@ -85,9 +109,14 @@ public:
 	void UnregisterRenderingDevice(IRenderingDevice *renderer);
 
 	void StartRecording(string filename, RecordAviOptions options);
+	
+	//Writes the unencoded frames & audio to a file, named pipe or file descriptor ("fd:N") - see RawStreamRecorder for the format
+	void StartRawStream(string target, string audioTarget);
 	void AddRecordingSound(int16_t* soundBuffer, uint32_t sampleCount, uint32_t sampleRate);
 	void StopRecording();
 	bool IsRecording();
+
+	VideoFrameStats GetFrameStats();
 	/// <summary>返回渲染线程使用的高分辨率调试HUD。</summary>
 	DebugHud* GetRendererHud() { return _rendererHud.get(); }
 };
\ No newline at end of file
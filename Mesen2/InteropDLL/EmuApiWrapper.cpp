@@ -1,8 +1,10 @@
 ﻿#include "Common.h"
+#include <iomanip>
 #include "Core/Shared/Emulator.h"
 #include "Core/Shared/EmuSettings.h"
 #include "Core/Shared/Video/VideoDecoder.h"
 #include "Core/Shared/Video/VideoRenderer.h"
+#include "Core/Shared/Video/PixelKernels.h"
 #include "Core/Shared/SystemActionManager.h"
 #include "Core/Shared/MessageManager.h"
 #include "Core/Shared/SaveStateManager.h"
@@ -12,11 +14,20 @@
 #include "Core/Shared/TimingInfo.h"
 #include "Core/Shared/CheatManager.h"
 #include "Core/Shared/DebuggerRequest.h"
+#include "Core/Debugger/Debugger.h"
+#include "Core/Debugger/Breakpoint.h"
+#include "Core/Debugger/DebugTypes.h"
+#include "Core/Debugger/DebugUtilities.h"
+#include "Core/Debugger/ExpressionEvaluator.h"
+#include "Core/Debugger/MemoryDumper.h"
 #include "Core/Netplay/GameClient.h"
 #include "Core/Netplay/GameServer.h"
 #include "Utilities/ArchiveReader.h"
+#include "Utilities/CompressionHelper.h"
 #include "Utilities/FolderUtilities.h"
 #include "Utilities/StringUtilities.h"
+#include "Utilities/Timer.h"
+#include "Utilities/magic_enum.hpp"
 #include "InteropNotificationListeners.h"
 
 #ifdef _WIN32
@@ -313,6 +324,40 @@ extern "C" {
 		return 0;
 	}
 
+	// 以覆盖层模式加载磁盘：基础镜像只读，写入保存在内存中（deltaPath 为空）或差异文件中
+	DllExport int __stdcall Floppy_LoadDiskImageOverlay(char* basePath, char* deltaPath)
+	{
+		if(!basePath) return 0;
+		if(!_fdc) {
+			_fdc.reset(new FloppyDriveController(_emu.get()));
+		}
+		return _fdc->LoadDiskImageOverlay(basePath, deltaPath);
+	}
+
+	DllExport int __stdcall Floppy_IsOverlayMode()
+	{
+		return _fdc ? _fdc->IsOverlayMode() : 0;
+	}
+
+	// 把覆盖层中的修改写入基础镜像
+	DllExport int __stdcall Floppy_CommitOverlay()
+	{
+		return _fdc ? _fdc->CommitOverlay() : 0;
+	}
+
+	// 丢弃覆盖层中的修改，恢复为基础镜像的内容
+	DllExport int __stdcall Floppy_DiscardOverlay()
+	{
+		return _fdc ? _fdc->DiscardOverlay() : 0;
+	}
+
+	// 把当前磁盘内容（含覆盖层）导出为完整的镜像文件
+	DllExport int __stdcall Floppy_ExportDiskImage(char* filename)
+	{
+		if(!_fdc || !filename) return 0;
+		return _fdc->ExportDiskImage(filename);
+	}
+
 	DllExport int __stdcall Floppy_Eject()
 	{
 		if(_fdc) {
@@ -376,7 +421,7 @@ extern "C" {
 		return _fdc->ReadFileToBuffer(filename, outBuffer, maxLength);
 	}
 
-// 从当前加载的软盘镜像中删除指定文件（仅根目录）。
+// 从当前加载的软盘镜像中删除指定文件（文件名或相对根目录的路径）。
 DllExport int __stdcall Floppy_DeleteFile(char* filename)
 {
     if(!_fdc) return 0;
@@ -384,6 +429,47 @@ DllExport int __stdcall Floppy_DeleteFile(char* filename)
     return _fdc->DeleteFileByName(filename);
 }
 
+	// 批量文件操作：Floppy_BeginBatch 之后排队的操作在 Floppy_CommitBatch 时一次性写入镜像（路径相对根目录）
+	DllExport int __stdcall Floppy_BeginBatch()
+	{
+		if(!_fdc) return 0;
+		return _fdc->BeginFileBatch();
+	}
+
+	DllExport int __stdcall Floppy_QueueWriteFile(char* path, uint8_t* data, uint32_t length)
+	{
+		if(!_fdc) return 0;
+		if(!path) return 0;
+		return _fdc->QueueWriteFile(path, data, length);
+	}
+
+	DllExport int __stdcall Floppy_QueueDeleteFile(char* path)
+	{
+		if(!_fdc) return 0;
+		if(!path) return 0;
+		return _fdc->QueueDeleteFile(path);
+	}
+
+	DllExport int __stdcall Floppy_QueueCreateDirectory(char* path)
+	{
+		if(!_fdc) return 0;
+		if(!path) return 0;
+		return _fdc->QueueCreateDirectory(path);
+	}
+
+	DllExport int __stdcall Floppy_CommitBatch()
+	{
+		if(!_fdc) return 0;
+		return _fdc->CommitFileBatch();
+	}
+
+	DllExport void __stdcall Floppy_CancelBatch()
+	{
+		if(_fdc) {
+			_fdc->CancelFileBatch();
+		}
+	}
+
 	class PgoKeyManager : public IKeyManager
 	{
 	public:
@@ -445,6 +531,290 @@ DllExport int __stdcall Floppy_DeleteFile(char* filename)
 			_emu->Release();
 		}
 	}
+
+	DllExport void __stdcall PgoRunCompressionBenchmark(vector<string> testRoms)
+	{
+		//Measures the throughput/ratio of each compression codec on real save states (one per rom)
+		FolderUtilities::SetHomeFolder("../PGOMesenHome");
+		std::cout << std::fixed << std::setprecision(2);
+
+		for(size_t i = 0; i < testRoms.size(); i++) {
+			KeyManager::SetSettings(_emu->GetSettings());
+			_emu->Initialize();
+			_emu->GetSettings()->SetFlag(EmulationFlags::MaximumSpeed);
+			if(!_emu->LoadRom((VirtualFile)testRoms[i], VirtualFile())) {
+				_emu->Release();
+				continue;
+			}
+
+			std::this_thread::sleep_for(std::chrono::duration<int, std::milli>(2000));
+
+			stringstream stateStream;
+			{
+				auto lock = _emu->AcquireLock();
+				_emu->Serialize(stateStream, true, CompressionCodec::Uncompressed);
+			}
+			string state = stateStream.str();
+
+			std::cout << "[" << magic_enum::enum_name(_emu->GetConsoleType()) << "] " << FolderUtilities::GetFilename(testRoms[i], true) << " - " << state.size() << " bytes" << std::endl;
+
+			for(CompressionCodec codec : { CompressionCodec::Deflate, CompressionCodec::Lz4 }) {
+				vector<uint8_t> compressed;
+				vector<uint8_t> decompressed;
+				uint32_t iterations = 0;
+				Timer timer;
+				do {
+					compressed.clear();
+					CompressionHelper::Compress((uint8_t*)state.data(), state.size(), codec, compressed);
+					iterations++;
+				} while(timer.GetElapsedMS() < 500);
+				double compressMs = timer.GetElapsedMS() / iterations;
+
+				iterations = 0;
+				bool valid = true;
+				timer.Reset();
+				do {
+					valid &= CompressionHelper::Decompress(compressed, decompressed);
+					iterations++;
+				} while(timer.GetElapsedMS() < 500);
+				double decompressMs = timer.GetElapsedMS() / iterations;
+				valid &= decompressed.size() == state.size() && memcmp(decompressed.data(), state.data(), state.size()) == 0;
+
+				double sizeMb = state.size() / (1024.0 * 1024.0);
+				std::cout << "  " << magic_enum::enum_name(codec) << ": ";
+				std::cout << "ratio " << (double)state.size() / compressed.size() << "x, ";
+				std::cout << "compress " << sizeMb / (compressMs / 1000) << " MB/s, ";
+				std::cout << "decompress " << sizeMb / (decompressMs / 1000) << " MB/s";
+				std::cout << (valid ? "" : " (DECOMPRESSION FAILED)") << std::endl;
+			}
+
+			_emu->Stop(false);
+			_emu->Release();
+		}
+	}
+
+	DllExport void __stdcall PgoRunPixelKernelBenchmark()
+	{
+		//Checks that each SIMD version of the video filters' pixel kernels gives the exact same output as the scalar version,
+		//and measures the throughput of each version (on a frame-sized buffer of random pixels)
+		std::cout << std::fixed << std::setprecision(1);
+
+		constexpr uint32_t pixelCount = 256 * 240 + 7;
+		vector<uint16_t> indexes(pixelCount);
+		vector<uint32_t> pixels(pixelCount);
+		vector<uint32_t> palette(0x8000);
+		uint32_t seed = 0x12345678;
+		auto getRandom = [&]() {
+			seed = seed * 1103515245 + 12345;
+			return (seed >> 16) | (seed << 16);
+		};
+		for(uint32_t i = 0; i < pixelCount; i++) {
+			indexes[i] = getRandom() & 0x7FFF;
+			pixels[i] = getRandom();
+		}
+		for(uint32_t& color : palette) {
+			color = getRandom();
+		}
+
+		PixelKernels::KernelTable scalar = PixelKernels::GetKernels(SimdLevel::Scalar);
+		std::cout << "Selected level: " << magic_enum::enum_name(PixelKernels::GetSimdLevel()) << std::endl;
+
+		for(SimdLevel level : { SimdLevel::Scalar, SimdLevel::Sse2, SimdLevel::Avx2, SimdLevel::Neon }) {
+			if(!PixelKernels::IsSupported(level)) {
+				continue;
+			}
+
+			PixelKernels::KernelTable kernels = PixelKernels::GetKernels(level);
+			vector<uint32_t> expected(pixelCount * 2);
+			vector<uint32_t> output(pixelCount * 2);
+			bool valid = true;
+
+			//Use counts that aren't multiples of the SIMD width, to also check the scalar loop that handles the last pixels
+			for(uint32_t count : { 0u, 1u, 3u, 7u, 8u, 15u, 16u, 17u, 31u, 33u, 63u, 64u, pixelCount }) {
+				scalar.ConvertPalette(indexes.data(), expected.data(), count, palette.data());
+				kernels.ConvertPalette(indexes.data(), output.data(), count, palette.data());
+				valid &= memcmp(expected.data(), output.data(), count * sizeof(uint32_t)) == 0;
+			}
+
+			for(int brightness = 0; brightness < 256; brightness++) {
+				for(uint32_t count : { 1u, 17u, 63u, pixelCount }) {
+					scalar.ApplyBrightness(pixels.data(), expected.data(), count, (uint8_t)brightness);
+					kernels.ApplyBrightness(pixels.data(), output.data(), count, (uint8_t)brightness);
+					valid &= memcmp(expected.data(), output.data(), count * sizeof(uint32_t)) == 0;
+
+					//In-place (input and output are the same buffer)
+					memcpy(output.data(), pixels.data(), count * sizeof(uint32_t));
+					kernels.ApplyBrightness(output.data(), output.data(), count, (uint8_t)brightness);
+					valid &= memcmp(expected.data(), output.data(), count * sizeof(uint32_t)) == 0;
+
+					scalar.ApplyBrightnessPairs(pixels.data(), expected.data(), count, (uint8_t)brightness, (uint8_t)(255 - brightness));
+					kernels.ApplyBrightnessPairs(pixels.data(), output.data(), count, (uint8_t)brightness, (uint8_t)(255 - brightness));
+					valid &= memcmp(expected.data(), output.data(), count * 2 * sizeof(uint32_t)) == 0;
+				}
+			}
+
+			auto measure = [&](auto runKernel) {
+				uint32_t iterations = 0;
+				Timer timer;
+				do {
+					runKernel();
+					iterations++;
+				} while(timer.GetElapsedMS() < 250);
+				return (double)pixelCount * iterations / (timer.GetElapsedMS() * 1000);
+			};
+
+			double paletteSpeed = measure([&]() { kernels.ConvertPalette(indexes.data(), output.data(), pixelCount, palette.data()); });
+			double brightnessSpeed = measure([&]() { kernels.ApplyBrightness(pixels.data(), output.data(), pixelCount, 200); });
+			double pairsSpeed = measure([&]() { kernels.ApplyBrightnessPairs(pixels.data(), output.data(), pixelCount, 255, 200); });
+
+			std::cout << "  " << magic_enum::enum_name(level) << ": ";
+			std::cout << "palette " << paletteSpeed << " Mpixels/s, ";
+			std::cout << "brightness " << brightnessSpeed << " Mpixels/s, ";
+			std::cout << "brightness pairs " << pairsSpeed << " Mpixels/s";
+			std::cout << (valid ? "" : " (OUTPUT DOES NOT MATCH SCALAR VERSION)") << std::endl;
+		}
+	}
+
+	DllExport void __stdcall PgoRunBreakpointBenchmark(vector<string> testRoms)
+	{
+		//Measures the emulation speed with the debugger enabled, for an increasing number of breakpoints on the main CPU's memory
+		FolderUtilities::SetHomeFolder("../PGOMesenHome");
+		std::cout << std::fixed << std::setprecision(1);
+
+		for(size_t i = 0; i < testRoms.size(); i++) {
+			KeyManager::SetSettings(_emu->GetSettings());
+			_emu->Initialize();
+			_emu->GetSettings()->SetFlag(EmulationFlags::MaximumSpeed);
+			if(!_emu->LoadRom((VirtualFile)testRoms[i], VirtualFile())) {
+				_emu->Release();
+				continue;
+			}
+
+			std::cout << "[" << magic_enum::enum_name(_emu->GetConsoleType()) << "] " << FolderUtilities::GetFilename(testRoms[i], true) << std::endl;
+
+			{
+				DebuggerRequest request = _emu->GetDebugger(true);
+				Debugger* debugger = request.GetDebugger();
+				CpuType cpuType = _emu->GetCpuTypes()[0];
+				MemoryType memType = DebugUtilities::GetCpuMemoryType(cpuType);
+				uint32_t memSize = debugger->GetMemoryDumper()->GetMemorySize(memType);
+				BreakpointTypeFlags bpType = (BreakpointTypeFlags)((int)BreakpointTypeFlags::Read | (int)BreakpointTypeFlags::Write | (int)BreakpointTypeFlags::Execute);
+
+				for(uint32_t count : { 0, 10, 50, 100, 250, 500 }) {
+					//Marked (but disabled) breakpoints are checked on every access like regular ones, but never pause the emulation
+					vector<Breakpoint> breakpoints;
+					for(uint32_t j = 0; j < count; j++) {
+						int32_t addr = (int32_t)((uint64_t)memSize * j / count);
+						breakpoints.push_back(Breakpoint(j, cpuType, memType, bpType, addr, addr + 3, false, true));
+					}
+					debugger->SetBreakpoints(breakpoints.data(), (uint32_t)breakpoints.size());
+
+					std::this_thread::sleep_for(std::chrono::duration<int, std::milli>(500));
+					uint32_t startFrame = _emu->GetFrameCount();
+					Timer timer;
+					std::this_thread::sleep_for(std::chrono::duration<int, std::milli>(2000));
+					double fps = (_emu->GetFrameCount() - startFrame) / (timer.GetElapsedMS() / 1000);
+
+					std::cout << "  " << count << " breakpoints: " << fps << " FPS" << std::endl;
+				}
+			}
+
+			_emu->Stop(false);
+			_emu->Release();
+		}
+	}
+
+	DllExport void __stdcall PgoRunExpressionBenchmark(vector<string> testRoms)
+	{
+		//Measures the time taken to evaluate a few typical breakpoint conditions, for each CPU of each rom,
+		//with the compiled form of the expressions and with the RPN interpreter
+		FolderUtilities::SetHomeFolder("../PGOMesenHome");
+		std::cout << std::fixed << std::setprecision(1);
+
+		vector<string> expressions = {
+			"{0} == $20 && [$0300] > 5",
+			"{0} + {1} * 2 >= $80 || {2} != 0",
+			"[$10 + {1}] == $FF && {$20} & $8000",
+			"value == $42 && address >= $2000 && iswrite",
+			"(($1234 * 3) >> 2) + $10 == [$0300]",
+			"{0}"
+		};
+
+		for(size_t i = 0; i < testRoms.size(); i++) {
+			KeyManager::SetSettings(_emu->GetSettings());
+			_emu->Initialize();
+			if(!_emu->LoadRom((VirtualFile)testRoms[i], VirtualFile())) {
+				_emu->Release();
+				continue;
+			}
+
+			std::cout << "[" << magic_enum::enum_name(_emu->GetConsoleType()) << "] " << FolderUtilities::GetFilename(testRoms[i], true) << std::endl;
+
+			{
+				DebuggerRequest request = _emu->GetDebugger(true);
+				auto lock = _emu->AcquireLock();
+
+				for(CpuType cpuType : _emu->GetCpuTypes()) {
+					ExpressionEvaluator* evaluator = request.GetDebugger()->GetExpressionEvaluator(cpuType);
+					if(!evaluator) {
+						continue;
+					}
+
+					//Use the first tokens of the CPU's token list (usually its main registers)
+					char tokenList[1000] = {};
+					evaluator->GetTokenList(tokenList);
+					vector<string> tokens = StringUtilities::Split(tokenList, '|');
+					tokens.erase(std::remove(tokens.begin(), tokens.end(), ""), tokens.end());
+					if(tokens.empty()) {
+						continue;
+					}
+
+					std::cout << "  " << magic_enum::enum_name(cpuType) << std::endl;
+					for(string expression : expressions) {
+						for(int j = 0; j < 3; j++) {
+							string placeholder = "{" + std::to_string(j) + "}";
+							size_t pos;
+							while((pos = expression.find(placeholder)) != string::npos) {
+								expression.replace(pos, placeholder.size(), tokens[j % tokens.size()]);
+							}
+						}
+
+						bool success = false;
+						ExpressionData compiled = evaluator->GetRpnList(expression, success);
+						if(!success) {
+							continue;
+						}
+						ExpressionData interpreted = compiled;
+						interpreted.Program.clear();
+
+						MemoryOperationInfo operation(0x2000, 0x42, MemoryOperationType::Write, DebugUtilities::GetCpuMemoryType(cpuType));
+						AddressInfo address = {};
+						EvalResultType resultType;
+
+						auto measure = [&](ExpressionData& data) {
+							uint32_t iterations = 0;
+							Timer timer;
+							do {
+								for(int k = 0; k < 1000; k++) {
+									evaluator->Evaluate(data, resultType, operation, address);
+								}
+								iterations += 1000;
+							} while(timer.GetElapsedMS() < 250);
+							return timer.GetElapsedMS() * 1000000 / iterations;
+						};
+
+						double compiledNs = measure(compiled);
+						double interpretedNs = measure(interpreted);
+						std::cout << "    " << expression << ": " << compiledNs << " ns (" << compiled.Program.size() << " instructions), ";
+						std::cout << "interpreted " << interpretedNs << " ns (" << compiled.RpnQueue.size() << " tokens)" << std::endl;
+					}
+				}
+			}
+
+			_emu->Stop(false);
+			_emu->Release();
+		}
+	}
 }
 
 // Interop accessor used by other modules to obtain the global wrapper-managed FDC instance.
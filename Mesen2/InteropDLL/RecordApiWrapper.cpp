@@ -11,6 +11,7 @@ extern "C"
 	DllExport void __stdcall AviRecord(char* filename, RecordAviOptions options) { _emu->GetVideoRenderer()->StartRecording(filename, options); }
 	DllExport void __stdcall AviStop() { _emu->GetVideoRenderer()->StopRecording(); }
 	DllExport bool __stdcall AviIsRecording() { return _emu->GetVideoRenderer()->IsRecording(); }
+	DllExport void __stdcall RawStreamRecord(char* target, char* audioTarget) { _emu->GetVideoRenderer()->StartRawStream(target, audioTarget ? audioTarget : ""); }
 
 	DllExport void __stdcall WaveRecord(char* filename) { _emu->GetSoundMixer()->StartRecording(filename); }
 	DllExport void __stdcall WaveStop() { _emu->GetSoundMixer()->StopRecording(); }
@@ -15,6 +15,10 @@ using std::vector;
 
 extern "C" {
 	void __stdcall PgoRunTest(vector<string> testRoms, bool enableDebugger);
+	void __stdcall PgoRunCompressionBenchmark(vector<string> testRoms);
+	void __stdcall PgoRunBreakpointBenchmark(vector<string> testRoms);
+	void __stdcall PgoRunExpressionBenchmark(vector<string> testRoms);
+	void __stdcall PgoRunPixelKernelBenchmark();
 }
 
 vector<string> GetFilesInFolder(string rootFolder, std::unordered_set<string> extensions)
@@ -42,13 +46,38 @@ vector<string> GetFilesInFolder(string rootFolder, std::unordered_set<string> ex
 
 int main(int argc, char* argv[])
 {
+	//Usage: pgohelper [--compression-benchmark | --breakpoint-benchmark | --expression-benchmark | --pixel-kernel-benchmark] [romFolder]
+	bool compressionBenchmark = false;
+	bool breakpointBenchmark = false;
+	bool expressionBenchmark = false;
+	bool pixelKernelBenchmark = false;
 	string romFolder = "../PGOGames";
-	if(argc >= 2) {
-		romFolder = argv[1];
+	for(int i = 1; i < argc; i++) {
+		if(string(argv[i]) == "--compression-benchmark") {
+			compressionBenchmark = true;
+		} else if(string(argv[i]) == "--breakpoint-benchmark") {
+			breakpointBenchmark = true;
+		} else if(string(argv[i]) == "--expression-benchmark") {
+			expressionBenchmark = true;
+		} else if(string(argv[i]) == "--pixel-kernel-benchmark") {
+			pixelKernelBenchmark = true;
+		} else {
+			romFolder = argv[i];
+		}
 	}
 
 	vector<string> testRoms = GetFilesInFolder(romFolder, { ".sfc", ".gb", ".gbc", ".gbx", ".nes", ".pce", ".cue", ".sms", ".gg", ".sg", ".gba", ".col", ".ws", ".wsc" });
-	PgoRunTest(testRoms, true);
+	if(compressionBenchmark) {
+		PgoRunCompressionBenchmark(testRoms);
+	} else if(breakpointBenchmark) {
+		PgoRunBreakpointBenchmark(testRoms);
+	} else if(expressionBenchmark) {
+		PgoRunExpressionBenchmark(testRoms);
+	} else if(pixelKernelBenchmark) {
+		PgoRunPixelKernelBenchmark();
+	} else {
+		PgoRunTest(testRoms, true);
+	}
 	return 0;
 }
 
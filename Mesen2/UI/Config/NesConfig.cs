@@ -43,6 +43,9 @@ namespace Mesen.Config
 		[Reactive] public bool FdsAutoLoadDisk { get; set; } = true;
 		[Reactive] public bool FdsFastForwardOnLoad { get; set; } = false;
 		[Reactive] public bool FdsAutoInsertDisk { get; set; } = false;
+		[Reactive] public bool BbkSyncLpcDecode { get; set; } = false;
+		[Reactive] public bool BbkAccurateFdcTiming { get; set; } = false;
+		[Reactive] public bool BbkFastForwardOnDiskAccess { get; set; } = false;
 		[Reactive] public VsDualOutputOption VsDualVideoOutput { get; set; } = VsDualOutputOption.Both;
 		[Reactive] public VsDualOutputOption VsDualAudioOutput { get; set; } = VsDualOutputOption.Both;
 
@@ -165,6 +168,9 @@ namespace Mesen.Config
 				FdsAutoLoadDisk = FdsAutoLoadDisk,
 				FdsFastForwardOnLoad = FdsFastForwardOnLoad,
 				FdsAutoInsertDisk = FdsAutoInsertDisk,
+				BbkSyncLpcDecode = BbkSyncLpcDecode,
+				BbkAccurateFdcTiming = BbkAccurateFdcTiming,
+				BbkFastForwardOnDiskAccess = BbkFastForwardOnDiskAccess,
 				VsDualVideoOutput = VsDualVideoOutput,
 				VsDualAudioOutput = VsDualAudioOutput,
 
@@ -302,6 +308,9 @@ namespace Mesen.Config
 		[MarshalAs(UnmanagedType.I1)] public bool FdsAutoLoadDisk;
 		[MarshalAs(UnmanagedType.I1)] public bool FdsFastForwardOnLoad;
 		[MarshalAs(UnmanagedType.I1)] public bool FdsAutoInsertDisk;
+		[MarshalAs(UnmanagedType.I1)] public bool BbkSyncLpcDecode;
+		[MarshalAs(UnmanagedType.I1)] public bool BbkAccurateFdcTiming;
+		[MarshalAs(UnmanagedType.I1)] public bool BbkFastForwardOnDiskAccess;
 		public VsDualOutputOption VsDualVideoOutput;
 		public VsDualOutputOption VsDualAudioOutput;
 
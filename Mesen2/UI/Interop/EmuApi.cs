@@ -139,6 +139,24 @@ namespace Mesen.Interop
 		/// <returns>返回 1 表示成功，0 表示失败。</returns>
 		[DllImport(DllPath, EntryPoint = "Floppy_LoadDiskImage")] public static extern int FloppyLoadDiskImage([MarshalAs(UnmanagedType.LPStr)] string filePath);
 		/// <summary>
+		/// 以覆盖层（写时复制）模式加载磁盘镜像：基础镜像只读，写入保存在差异文件中（deltaPath 为空时仅保存在内存中）。
+		/// </summary>
+		/// <returns>返回 1 表示成功，0 表示失败。</returns>
+		[DllImport(DllPath, EntryPoint = "Floppy_LoadDiskImageOverlay")] public static extern int FloppyLoadDiskImageOverlay([MarshalAs(UnmanagedType.LPStr)] string basePath, [MarshalAs(UnmanagedType.LPStr)] string deltaPath);
+		[DllImport(DllPath, EntryPoint = "Floppy_IsOverlayMode")] public static extern int FloppyIsOverlayMode();
+		/// <summary>
+		/// 把覆盖层中的修改写入基础镜像。
+		/// </summary>
+		[DllImport(DllPath, EntryPoint = "Floppy_CommitOverlay")] public static extern int FloppyCommitOverlay();
+		/// <summary>
+		/// 丢弃覆盖层中的修改，恢复为基础镜像的内容。
+		/// </summary>
+		[DllImport(DllPath, EntryPoint = "Floppy_DiscardOverlay")] public static extern int FloppyDiscardOverlay();
+		/// <summary>
+		/// 把当前磁盘内容（含覆盖层）导出为完整的镜像文件。
+		/// </summary>
+		[DllImport(DllPath, EntryPoint = "Floppy_ExportDiskImage")] public static extern int FloppyExportDiskImage([MarshalAs(UnmanagedType.LPStr)] string filePath);
+		/// <summary>
 		/// 弹出磁盘镜像。
 		/// </summary>
 		/// <returns>返回 1 表示成功，0 表示失败。</returns>
@@ -176,7 +194,7 @@ namespace Mesen.Interop
 		/// 返回 true 表示成功。
 		/// </summary>
 		[DllImport(DllPath, EntryPoint = "Floppy_WriteFile")]
-		private static extern int FloppyWriteFileNative([MarshalAs(UnmanagedType.LPStr)] string filename, [In] byte[] data, UInt32 length);
+		private static extern int FloppyWriteFileNative([MarshalAs(UnmanagedType.LPUTF8Str)] string filename, [In] byte[] data, UInt32 length);
 
 		public static bool FloppyWriteFile(string filename, byte[] data)
 		{
@@ -190,10 +208,10 @@ namespace Mesen.Interop
 		}
 
 		[DllImport(DllPath, EntryPoint = "Floppy_GetFileSize")]
-		private static extern int FloppyGetFileSizeNative([MarshalAs(UnmanagedType.LPStr)] string filename);
+		private static extern int FloppyGetFileSizeNative([MarshalAs(UnmanagedType.LPUTF8Str)] string filename);
 
 		[DllImport(DllPath, EntryPoint = "Floppy_ReadFile")]
-		private static extern int FloppyReadFileNative([MarshalAs(UnmanagedType.LPStr)] string filename, [Out] byte[] outBuffer, UInt32 maxLength);
+		private static extern int FloppyReadFileNative([MarshalAs(UnmanagedType.LPUTF8Str)] string filename, [Out] byte[] outBuffer, UInt32 maxLength);
 
 		/// <summary>
 		/// 从当前加载的软盘镜像读取指定文件的字节内容（托管封装）。
@@ -220,7 +238,7 @@ namespace Mesen.Interop
 			/// 返回 true 表示成功，false 表示失败。
 			/// </summary>
 			[DllImport(DllPath, EntryPoint = "Floppy_DeleteFile")]
-			private static extern int FloppyDeleteFileNative([MarshalAs(UnmanagedType.LPStr)] string filename);
+			private static extern int FloppyDeleteFileNative([MarshalAs(UnmanagedType.LPUTF8Str)] string filename);
 
 			public static bool FloppyDeleteFile(string filename)
 			{
@@ -232,6 +250,53 @@ namespace Mesen.Interop
 					return false;
 				}
 			}
+
+		/// <summary>
+		/// 开始一批软盘镜像文件操作：之后排队的写入/删除/建目录操作在 FloppyCommitBatch 时一次性写入镜像，
+		/// 任一操作失败时整批回滚。路径相对镜像根目录，以 '/' 分隔，写入时自动创建不存在的子目录。
+		/// </summary>
+		[DllImport(DllPath, EntryPoint = "Floppy_BeginBatch")] private static extern int FloppyBeginBatchNative();
+		[DllImport(DllPath, EntryPoint = "Floppy_QueueWriteFile")] private static extern int FloppyQueueWriteFileNative([MarshalAs(UnmanagedType.LPUTF8Str)] string path, [In] byte[] data, UInt32 length);
+		[DllImport(DllPath, EntryPoint = "Floppy_QueueDeleteFile")] private static extern int FloppyQueueDeleteFileNative([MarshalAs(UnmanagedType.LPUTF8Str)] string path);
+		[DllImport(DllPath, EntryPoint = "Floppy_QueueCreateDirectory")] private static extern int FloppyQueueCreateDirectoryNative([MarshalAs(UnmanagedType.LPUTF8Str)] string path);
+		[DllImport(DllPath, EntryPoint = "Floppy_CommitBatch")] private static extern int FloppyCommitBatchNative();
+		[DllImport(DllPath, EntryPoint = "Floppy_CancelBatch")] public static extern void FloppyCancelBatch();
+
+		public static bool FloppyBeginBatch()
+		{
+			try {
+				return FloppyBeginBatchNative() == 1;
+			} catch {
+				return false;
+			}
+		}
+
+		public static bool FloppyQueueWriteFile(string path, byte[] data)
+		{
+			if(string.IsNullOrEmpty(path) || data == null) return false;
+			return FloppyQueueWriteFileNative(path, data, (uint)data.Length) == 1;
+		}
+
+		public static bool FloppyQueueDeleteFile(string path)
+		{
+			if(string.IsNullOrEmpty(path)) return false;
+			return FloppyQueueDeleteFileNative(path) == 1;
+		}
+
+		public static bool FloppyQueueCreateDirectory(string path)
+		{
+			if(string.IsNullOrEmpty(path)) return false;
+			return FloppyQueueCreateDirectoryNative(path) == 1;
+		}
+
+		public static bool FloppyCommitBatch()
+		{
+			try {
+				return FloppyCommitBatchNative() == 1;
+			} catch {
+				return false;
+			}
+		}
 	}
 
 	public struct TimingInfo
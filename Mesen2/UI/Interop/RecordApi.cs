@@ -15,6 +15,7 @@ namespace Mesen.Interop
 		[DllImport(DllPath)] public static extern void AviRecord([MarshalAs(UnmanagedType.LPUTF8Str)]string filename, RecordAviOptions options);
 		[DllImport(DllPath)] public static extern void AviStop();
 		[DllImport(DllPath)] [return: MarshalAs(UnmanagedType.I1)] public static extern bool AviIsRecording();
+		[DllImport(DllPath)] public static extern void RawStreamRecord([MarshalAs(UnmanagedType.LPUTF8Str)]string target, [MarshalAs(UnmanagedType.LPUTF8Str)]string audioTarget);
 
 		[DllImport(DllPath)] public static extern void WaveRecord([MarshalAs(UnmanagedType.LPUTF8Str)]string filename);
 		[DllImport(DllPath)] public static extern void WaveStop();
@@ -75,6 +76,7 @@ namespace Mesen.Interop
 		public UInt32 CompressionLevel;
 		[MarshalAs(UnmanagedType.I1)] public bool RecordSystemHud;
 		[MarshalAs(UnmanagedType.I1)] public bool RecordInputHud;
+		[MarshalAs(UnmanagedType.I1)] public bool OfflineMode;
 	};
 
 }
@@ -29,6 +29,8 @@ public class CommandLineHelper
 	public bool LoadLastSessionRequested { get; private set; }
 	public string? MovieToRecord { get; private set; } = null;
 	public int TestRunnerTimeout { get; private set; } = 100;
+	public string? RawStreamTarget { get; private set; } = null;
+	public string RawAudioTarget { get; private set; } = "";
 	public List<string> LuaScriptsToLoad { get; private set; } = new();
 	public List<string> FilesToLoad { get; private set; } = new();
 
@@ -84,6 +86,19 @@ public class CommandLineHelper
 								moviePath += "." + FileDialogHelper.MesenMovieExt;
 							}
 							MovieToRecord = moviePath;
+						} else if(switchArg.StartsWith("rawstream=") || switchArg.StartsWith("rawaudio=")) {
+							//Keep the value's case (file paths)
+							string value = ConvertArg(arg);
+							value = value.Substring(value.IndexOf('=') + 1).Trim('"');
+							if(value.Length == 0) {
+								//invalid
+								continue;
+							}
+							if(switchArg.StartsWith("rawstream=")) {
+								RawStreamTarget = value;
+							} else {
+								RawAudioTarget = value;
+							}
 						} else if(switchArg.StartsWith("timeout=")) {
 							string[] values = switchArg.Split('=');
 							if(values.Length <= 1) {
@@ -189,6 +204,8 @@ public class CommandLineHelper
 --loadLastSession - Resumes the game in the state it was left in when it was last played.
 --recordMovie=""filename.mmo"" - Start recording a movie after the specified game is loaded.
 --testRunner [lua script] [rom file] - Runs a Lua script in headless mode (use emu.exit(...) to stop execution)
+--rawStream=""target"" - With --testRunner, writes the unencoded frames and audio to a file, a named pipe or an open file descriptor (e.g ""fd:1"" for stdout)
+--rawAudio=""target"" - With --rawStream, writes the audio samples (16-bit stereo) to this output and only the frames' pixels (BGRA) to the --rawStream output
 ";
 
 		result["General"] = general;
@@ -14,7 +14,7 @@ namespace Mesen.Utilities
 			".sfc", ".smc", ".fig", ".swc", ".bs", ".st",
 			".gb", ".gbc", ".gbx",
 			".nes", ".unif", ".unf", ".fds", ".qd", ".studybox",
-			".pce", ".sgx", ".cue",
+			".pce", ".sgx", ".cue", ".chd",
 			".sms", ".gg", ".sg", ".col",
 			".gba",
 			".ws", ".wsc"
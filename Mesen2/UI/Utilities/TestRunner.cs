@@ -39,6 +39,10 @@ namespace Mesen.Utilities
 
 			DebugWorkspaceManager.Load();
 
+			if(commandLineHelper.RawStreamTarget != null) {
+				RecordApi.RawStreamRecord(commandLineHelper.RawStreamTarget, commandLineHelper.RawAudioTarget);
+			}
+
 			foreach(string luaScript in commandLineHelper.LuaScriptsToLoad) {
 				try {
 					string script = File.ReadAllText(luaScript);
@@ -61,6 +65,10 @@ namespace Mesen.Utilities
 			}
 
 			EmuApi.Stop();
+			if(commandLineHelper.RawStreamTarget != null) {
+				//Flush and close the outputs (the reader gets the end of the stream)
+				RecordApi.AviStop();
+			}
 			EmuApi.Release();
 			return result;
 		}
@@ -124,8 +124,8 @@ namespace Mesen.Views
 
 			floppyPanel.PointerReleased += async (s, e) => {
 				if(e.InitialPressMouseButton == MouseButton.Left) {
-					// 支持 .ima 和 .img 镜像格式
-					string? filePath = await FileDialogHelper.OpenFile(null, ApplicationHelper.GetMainWindow(), "ima", "img");
+					// 支持 .ima/.img/.imd 镜像格式，以及 zip/7z 压缩包中的镜像
+					string? filePath = await FileDialogHelper.OpenFile(null, ApplicationHelper.GetMainWindow(), "ima", "img", "imd", "zip", "7z");
 					if(!string.IsNullOrEmpty(filePath)) {
 						if(File.Exists(filePath)) {
 							// 弹出对话框选择进来的装载软盘。
@@ -281,8 +281,8 @@ namespace Mesen.Views
 		private async void InsertFloppy_Click(object? sender, RoutedEventArgs e)
 		{
 			try {
-				// 打开文件对话框以选择 .ima/.img 镜像并加载为软盘
-				string? filePath = await FileDialogHelper.OpenFile(null, ApplicationHelper.GetMainWindow(), "ima", "img");
+				// 打开文件对话框以选择 .ima/.img/.imd 镜像（或包含镜像的压缩包）并加载为软盘
+				string? filePath = await FileDialogHelper.OpenFile(null, ApplicationHelper.GetMainWindow(), "ima", "img", "imd", "zip", "7z");
 				if(!string.IsNullOrEmpty(filePath)) {
 					if(File.Exists(filePath)) {
 						try {
@@ -188,24 +188,52 @@ namespace Mesen.Windows
                     }
                 } catch { }
 
-                foreach(var path in paths) {
-                    if(!File.Exists(path)) {
-                        DisplayMessageHelper.DisplayMessage("Error", ResourceHelper.GetMessage("FileNotFound", path));
-                        continue;
-                    }
+                // 所有文件在一次批量提交中写入镜像（FAT 与镜像文件只回写一次），任一文件失败时镜像保持不变
+                if(!EmuApi.FloppyBeginBatch()) {
+                    DisplayMessageHelper.DisplayMessage("Error", "写入镜像失败");
+                    return;
+                }
 
-                    string fileName = Path.GetFileName(path);
-                    byte[] buffer = File.ReadAllBytes(path);
+                bool queued = false;
+                try {
+                    foreach(var path in paths) {
+                        if(Directory.Exists(path)) {
+                            // 拖入文件夹时保留其目录结构（包括空目录）
+                            string dirName = Path.GetFileName(Path.TrimEndingDirectorySeparator(path));
+                            queued |= EmuApi.FloppyQueueCreateDirectory(dirName);
+                            foreach(string subDir in Directory.EnumerateDirectories(path, "*", SearchOption.AllDirectories)) {
+                                queued |= EmuApi.FloppyQueueCreateDirectory(dirName + "/" + Path.GetRelativePath(path, subDir).Replace('\\', '/'));
+                            }
+                            foreach(string file in Directory.EnumerateFiles(path, "*", SearchOption.AllDirectories)) {
+                                queued |= EmuApi.FloppyQueueWriteFile(dirName + "/" + Path.GetRelativePath(path, file).Replace('\\', '/'), File.ReadAllBytes(file));
+                            }
+                            continue;
+                        }
 
-                    bool ok = EmuApi.FloppyWriteFile(fileName, buffer);
-                    if(!ok) {
-                        DisplayMessageHelper.DisplayMessage("Error", "写入镜像失败: " + fileName);
-                    } else {
-                        // 刷新视图
-                        Dispatcher.UIThread.Post(() => {
-                            try { _model?.Refresh(); } catch { }
-                        });
+                        if(!File.Exists(path)) {
+                            DisplayMessageHelper.DisplayMessage("Error", ResourceHelper.GetMessage("FileNotFound", path));
+                            continue;
+                        }
+
+                        queued |= EmuApi.FloppyQueueWriteFile(Path.GetFileName(path), File.ReadAllBytes(path));
                     }
+                } catch {
+                    EmuApi.FloppyCancelBatch();
+                    throw;
+                }
+
+                if(!queued) {
+                    EmuApi.FloppyCancelBatch();
+                    return;
+                }
+
+                if(!EmuApi.FloppyCommitBatch()) {
+                    DisplayMessageHelper.DisplayMessage("Error", "写入镜像失败: " + string.Join(", ", paths.Select(p => Path.GetFileName(p))));
+                } else {
+                    // 刷新视图
+                    Dispatcher.UIThread.Post(() => {
+                        try { _model?.Refresh(); } catch { }
+                    });
                 }
             } catch(Exception ex) {
                 DisplayMessageHelper.DisplayMessage("Error", ex.Message);
@@ -428,21 +456,14 @@ namespace Mesen.Windows
                 return;
             }
 
-            if(!EmuApi.FloppyDeleteFile(node.Name)) {
-                DisplayMessageHelper.DisplayMessage("Error", "无法删除旧文件: " + node.Name);
-                return;
-            }
-
-            if(!EmuApi.FloppyWriteFile(newName, data)) {
-                bool restored = EmuApi.FloppyWriteFile(node.Name, data);
-                if(restored) {
-                    DisplayMessageHelper.DisplayMessage("Error", "重命名失败，新文件写入失败，已恢复原文件。");
-                } else {
-                    DisplayMessageHelper.DisplayMessage("Error", "重命名失败且原文件无法恢复，文件可能已丢失。");
-                }
-                Dispatcher.UIThread.Post(() => {
-                    try { _model?.Refresh(); } catch { }
-                });
+            // 删除旧文件与写入新文件在同一批操作中提交，失败时镜像保持不变
+            bool ok = EmuApi.FloppyBeginBatch()
+                && EmuApi.FloppyQueueDeleteFile(node.Name)
+                && EmuApi.FloppyQueueWriteFile(newName, data)
+                && EmuApi.FloppyCommitBatch();
+            if(!ok) {
+                EmuApi.FloppyCancelBatch();
+                DisplayMessageHelper.DisplayMessage("Error", "重命名失败: " + node.Name);
                 return;
             }
 
@@ -207,10 +207,10 @@ namespace Mesen.Windows
 				if(paths.Length == 0) {
 					return;
 				}
-				// If any dropped file is an .ima or .img, treat it as a floppy image instead of a ROM
+				// If any dropped file is an .ima, .img or .imd, treat it as a floppy image instead of a ROM
 				string? filePath = paths.FirstOrDefault(p => {
 					string ext = Path.GetExtension(p);
-					return ext.Equals(".ima", StringComparison.OrdinalIgnoreCase) || ext.Equals(".img", StringComparison.OrdinalIgnoreCase);
+					return ext.Equals(".ima", StringComparison.OrdinalIgnoreCase) || ext.Equals(".img", StringComparison.OrdinalIgnoreCase) || ext.Equals(".imd", StringComparison.OrdinalIgnoreCase);
 				});
 				if(filePath != null && File.Exists(filePath)) {
 					// Save path for core and update UI status
@@ -289,13 +289,13 @@ namespace Mesen.Windows
 					cmdLine.NoInput
 				);
 
-				// 启动时：如果存在第二个参数并且为软盘镜像(.ima/.img)，则在这里加载该软盘镜像
+				// 启动时：如果存在第二个参数并且为软盘镜像(.ima/.img/.imd)，则在这里加载该软盘镜像
 				// 并从待载文件列表中移除，避免后续将其当作 ROM 载入。
 				if(startupArgs != null && startupArgs.Length >= 2) {
 					if(cmdLine.FilesToLoad.Count >= 2) {
 						string secondFile = cmdLine.FilesToLoad[1];
 						string ext = Path.GetExtension(secondFile);
-						if(ext.Equals(".ima", StringComparison.OrdinalIgnoreCase) || ext.Equals(".img", StringComparison.OrdinalIgnoreCase)) {
+						if(ext.Equals(".ima", StringComparison.OrdinalIgnoreCase) || ext.Equals(".img", StringComparison.OrdinalIgnoreCase) || ext.Equals(".imd", StringComparison.OrdinalIgnoreCase)) {
 							try {
 								// 将第二个参数作为软盘镜像载入
 								EmuApi.FloppyLoadDiskImage(secondFile);
@@ -47,7 +47,8 @@ namespace Mesen.Windows
 				Codec = model.Config.Codec,
 				CompressionLevel = model.Config.CompressionLevel,
 				RecordSystemHud = model.Config.RecordSystemHud,
-				RecordInputHud = model.Config.RecordInputHud
+				RecordInputHud = model.Config.RecordInputHud,
+				OfflineMode = model.Config.OfflineMode
 			});
 
 			Close(true);
@@ -0,0 +1,97 @@
+#include "pch.h"
+#include "CompressionHelper.h"
+#include "Lz4Codec.h"
+#include "miniz.h"
+
+bool CompressionHelper::IsValidCodec(uint8_t codec)
+{
+	switch((CompressionCodec)codec) {
+		case CompressionCodec::Uncompressed:
+		case CompressionCodec::Deflate:
+		case CompressionCodec::Lz4:
+			return true;
+	}
+	return false;
+}
+
+void CompressionHelper::Encode(const uint8_t* data, size_t dataSize, CompressionCodec codec, vector<uint8_t>& output)
+{
+	size_t start = output.size();
+	switch(codec) {
+		case CompressionCodec::Uncompressed:
+			output.insert(output.end(), data, data + dataSize);
+			break;
+
+		case CompressionCodec::Deflate: {
+			unsigned long compressedSize = compressBound((unsigned long)dataSize);
+			output.resize(start + compressedSize);
+			compress2(output.data() + start, &compressedSize, data, (unsigned long)dataSize, MZ_DEFAULT_LEVEL);
+			output.resize(start + compressedSize);
+			break;
+		}
+
+		case CompressionCodec::Lz4:
+			output.resize(start + Lz4Codec::GetMaxCompressedSize(dataSize));
+			output.resize(start + Lz4Codec::Compress(data, dataSize, output.data() + start));
+			break;
+	}
+}
+
+bool CompressionHelper::Decode(const uint8_t* data, size_t dataSize, CompressionCodec codec, uint32_t originalSize, vector<uint8_t>& output)
+{
+	if(originalSize >= MaxDataSize || dataSize >= MaxDataSize) {
+		return false;
+	}
+
+	output.resize(originalSize);
+
+	switch(codec) {
+		case CompressionCodec::Uncompressed:
+			if(dataSize != originalSize) {
+				return false;
+			}
+			memcpy(output.data(), data, dataSize);
+			return true;
+
+		case CompressionCodec::Deflate: {
+			unsigned long decompSize = originalSize;
+			return uncompress(output.data(), &decompSize, data, (unsigned long)dataSize) == MZ_OK;
+		}
+
+		case CompressionCodec::Lz4:
+			return Lz4Codec::Decompress(data, dataSize, output.data(), originalSize);
+	}
+
+	return false;
+}
+
+void CompressionHelper::Compress(const uint8_t* data, size_t dataSize, CompressionCodec codec, vector<uint8_t>& output)
+{
+	size_t start = output.size();
+	output.resize(start + HeaderSize);
+	Encode(data, dataSize, codec, output);
+
+	uint32_t originalSize = (uint32_t)dataSize;
+	uint32_t compressedSize = (uint32_t)(output.size() - start - HeaderSize);
+	output[start] = (uint8_t)codec;
+	memcpy(output.data() + start + 1, &originalSize, sizeof(uint32_t));
+	memcpy(output.data() + start + 1 + sizeof(uint32_t), &compressedSize, sizeof(uint32_t));
+}
+
+bool CompressionHelper::Decompress(const uint8_t* input, size_t inputSize, vector<uint8_t>& output)
+{
+	if(inputSize < HeaderSize || !IsValidCodec(input[0])) {
+		return false;
+	}
+
+	uint32_t originalSize;
+	uint32_t compressedSize;
+	memcpy(&originalSize, input + 1, sizeof(uint32_t));
+	memcpy(&compressedSize, input + 1 + sizeof(uint32_t), sizeof(uint32_t));
+
+	if(compressedSize > inputSize - HeaderSize) {
+		return false;
+	}
+
+	return Decode(input + HeaderSize, compressedSize, (CompressionCodec)input[0], originalSize, output);
+}
@@ -1,44 +1,36 @@
 #pragma once
 #include "pch.h"
-#include "miniz.h"
+
+//The codec's ID is stored in front of every compressed block (e.g in save state files) - existing values must not change
+enum class CompressionCodec : uint8_t
+{
+	Uncompressed = 0,
+
+	//Deflate (miniz) - slower, but higher compression ratio (used for save state files)
+	//Save states created before codec selection was added use this codec with the same header
+	Deflate = 1,
+
+	//LZ4 block format - very fast, lower compression ratio (used for rewind and netplay)
+	Lz4 = 2
+};
 
 class CompressionHelper
 {
 public:
-	static void Compress(string data, int compressionLevel, vector<uint8_t>& output)
-	{
-		unsigned long compressedSize = compressBound((unsigned long)data.size());
-		uint8_t* compressedData = new uint8_t[compressedSize];
-		compress2(compressedData, &compressedSize, (unsigned char*)data.c_str(), (unsigned long)data.size(), compressionLevel);
-
-		uint32_t size = (uint32_t)compressedSize;
-		uint32_t originalSize = (uint32_t)data.size();
-		output.insert(output.end(), (char*)&originalSize, (char*)&originalSize + sizeof(uint32_t));
-		output.insert(output.end(), (char*)&size, (char*)&size + sizeof(uint32_t));
-		output.insert(output.end(), (char*)compressedData, (char*)compressedData + compressedSize);
-		delete[] compressedData;
-	}
-
-	static bool Decompress(vector<uint8_t>& input, vector<uint8_t>& output)
-	{
-		uint32_t decompressedSize;
-		uint32_t compressedSize;
-
-		memcpy(&decompressedSize, input.data(), sizeof(uint32_t));
-		memcpy(&compressedSize, input.data() + sizeof(uint32_t), sizeof(uint32_t));
-
-		if(decompressedSize >= 1024 * 1024 * 10 || compressedSize >= 1024 * 1024 * 10) {
-			//Limit to 10mb the data's size
-			return false;
-		}
-
-		output.resize(decompressedSize, 0);
-
-		unsigned long decompSize = decompressedSize;
-		if(uncompress(output.data(), &decompSize, input.data() + sizeof(uint32_t)*2, (unsigned long)input.size() - sizeof(uint32_t) * 2) != MZ_OK) {
-			return false;
-		}
-
-		return true;
-	}
-};
\ No newline at end of file
+	//Limit to 10mb the data's size
+	static constexpr uint32_t MaxDataSize = 1024 * 1024 * 10;
+
+	//Block header: [codec (1 byte)] [original size (4 bytes)] [compressed size (4 bytes)]
+	static constexpr uint32_t HeaderSize = 1 + sizeof(uint32_t) * 2;
+
+	static bool IsValidCodec(uint8_t codec);
+
+	//Appends a tagged block (header + compressed data) to the output
+	static void Compress(const uint8_t* data, size_t dataSize, CompressionCodec codec, vector<uint8_t>& output);
+	static bool Decompress(const uint8_t* input, size_t inputSize, vector<uint8_t>& output);
+	static bool Decompress(const vector<uint8_t>& input, vector<uint8_t>& output) { return Decompress(input.data(), input.size(), output); }
+
+	//Codec payload only, without the header
+	static void Encode(const uint8_t* data, size_t dataSize, CompressionCodec codec, vector<uint8_t>& output);
+	static bool Decode(const uint8_t* data, size_t dataSize, CompressionCodec codec, uint32_t originalSize, vector<uint8_t>& output);
+};
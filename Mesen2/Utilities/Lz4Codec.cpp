@@ -0,0 +1,284 @@
+#include "pch.h"
+#include "Lz4Codec.h"
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+static __forceinline uint32_t Read32(const uint8_t* ptr)
+{
+	uint32_t value;
+	memcpy(&value, ptr, sizeof(value));
+	return value;
+}
+
+static __forceinline uint64_t Read64(const uint8_t* ptr)
+{
+	uint64_t value;
+	memcpy(&value, ptr, sizeof(value));
+	return value;
+}
+
+static __forceinline int CountTrailingZeroBytes(uint64_t value)
+{
+#if defined(_MSC_VER)
+	unsigned long index;
+	_BitScanForward64(&index, value);
+	return (int)(index >> 3);
+#else
+	return __builtin_ctzll(value) >> 3;
+#endif
+}
+
+uint8_t* Lz4Codec::WriteLength(uint8_t* out, size_t length)
+{
+	//Lengths >= 15 are stored as a series of bytes that are added together, ending with a byte that is != 255
+	while(length >= 255) {
+		*out++ = 255;
+		length -= 255;
+	}
+	*out++ = (uint8_t)length;
+	return out;
+}
+
+size_t Lz4Codec::Compress(const uint8_t* src, size_t size, uint8_t* dst)
+{
+	uint8_t* out = dst;
+	size_t anchor = 0;
+
+	if(size >= MatchFindLimit + 1) {
+		//Positions are stored as-is, 0 doesn't need to be treated as "empty" since all candidates are validated
+		//The table is too large to be kept on the stack - it is still cleared on each call to keep the output deterministic
+		thread_local vector<uint32_t> hashTableBuffer;
+		hashTableBuffer.assign(1 << HashBits, 0);
+		uint32_t* hashTable = hashTableBuffer.data();
+
+		size_t matchStartLimit = size - MatchFindLimit;
+		size_t matchEndLimit = size - LastLiterals;
+		size_t pos = 1;
+		hashTable[Hash(Read32(src))] = 0;
+
+		while(pos <= matchStartLimit) {
+			uint32_t value = Read32(src + pos);
+			uint32_t h = Hash(value);
+			size_t ref = hashTable[h];
+			hashTable[h] = (uint32_t)pos;
+
+			if(pos - ref > MaxOffset || Read32(src + ref) != value) {
+				//Skip ahead faster when no matches are found for a while (mostly incompressible data)
+				pos += 1 + ((pos - anchor) >> 6);
+				continue;
+			}
+
+			//Extend the match backwards into the pending literals
+			while(pos > anchor && ref > 0 && src[pos - 1] == src[ref - 1]) {
+				pos--;
+				ref--;
+			}
+
+			//Extend the match forward, 8 bytes at a time
+			size_t matchEnd = pos + MinMatch;
+			size_t refEnd = ref + MinMatch;
+			while(matchEnd + 8 <= matchEndLimit) {
+				uint64_t diff = Read64(src + matchEnd) ^ Read64(src + refEnd);
+				if(diff) {
+					matchEnd += CountTrailingZeroBytes(diff);
+					goto matchFound;
+				}
+				matchEnd += 8;
+				refEnd += 8;
+			}
+			while(matchEnd < matchEndLimit && src[matchEnd] == src[refEnd]) {
+				matchEnd++;
+				refEnd++;
+			}
+
+		matchFound:
+			size_t literalLength = pos - anchor;
+			size_t matchLength = matchEnd - pos - MinMatch;
+
+			uint8_t* token = out++;
+			*token = (uint8_t)((std::min<size_t>(literalLength, 15) << 4) | std::min<size_t>(matchLength, 15));
+			if(literalLength >= 15) {
+				out = WriteLength(out, literalLength - 15);
+			}
+			memcpy(out, src + anchor, literalLength);
+			out += literalLength;
+
+			uint16_t offset = (uint16_t)(pos - ref);
+			*out++ = (uint8_t)offset;
+			*out++ = (uint8_t)(offset >> 8);
+
+			if(matchLength >= 15) {
+				out = WriteLength(out, matchLength - 15);
+			}
+
+			pos = matchEnd;
+			anchor = pos;
+
+			if(pos <= matchStartLimit) {
+				//Index a position inside the match to improve the odds of finding the next match
+				hashTable[Hash(Read32(src + pos - 2))] = (uint32_t)(pos - 2);
+			}
+		}
+	}
+
+	//Last sequence only contains literals
+	size_t literalLength = size - anchor;
+	*out++ = (uint8_t)(std::min<size_t>(literalLength, 15) << 4);
+	if(literalLength >= 15) {
+		out = WriteLength(out, literalLength - 15);
+	}
+	memcpy(out, src + anchor, literalLength);
+	out += literalLength;
+
+	return out - dst;
+}
+
+bool Lz4Codec::Decompress(const uint8_t* src, size_t size, uint8_t* dst, size_t dstSize)
+{
+	const uint8_t* in = src;
+	const uint8_t* inEnd = src + size;
+	uint8_t* out = dst;
+	uint8_t* outEnd = dst + dstSize;
+
+	while(in < inEnd) {
+		uint8_t token = *in++;
+
+		size_t literalLength = token >> 4;
+		if(literalLength == 15) {
+			uint8_t value;
+			do {
+				if(in >= inEnd) {
+					return false;
+				}
+				value = *in++;
+				literalLength += value;
+			} while(value == 255);
+		}
+
+		if(literalLength > (size_t)(inEnd - in) || literalLength > (size_t)(outEnd - out)) {
+			return false;
+		}
+		if(literalLength <= 16 && inEnd - in >= 16 && outEnd - out >= 16) {
+			//Fixed-size copy is faster than a variable-size memcpy for short runs (overwritten bytes are rewritten later)
+			memcpy(out, in, 16);
+		} else {
+			memcpy(out, in, literalLength);
+		}
+		in += literalLength;
+		out += literalLength;
+
+		if(in == inEnd) {
+			//Last sequence has no match
+			return out == outEnd;
+		}
+
+		if(inEnd - in < 2) {
+			return false;
+		}
+		size_t offset = in[0] | (in[1] << 8);
+		in += 2;
+		if(offset == 0 || offset > (size_t)(out - dst)) {
+			return false;
+		}
+
+		size_t matchLength = token & 0x0F;
+		if(matchLength == 15) {
+			uint8_t value;
+			do {
+				if(in >= inEnd) {
+					return false;
+				}
+				value = *in++;
+				matchLength += value;
+			} while(value == 255);
+		}
+		matchLength += MinMatch;
+
+		if(matchLength > (size_t)(outEnd - out)) {
+			return false;
+		}
+
+		const uint8_t* ref = out - offset;
+		if(offset >= 16 && outEnd - out >= (ptrdiff_t)matchLength + 16) {
+			//Copy in 16-byte chunks, may write up to 15 bytes past the end of the match (still within the output buffer)
+			uint8_t* matchEnd = out + matchLength;
+			do {
+				memcpy(out, ref, 16);
+				out += 16;
+				ref += 16;
+			} while(out < matchEnd);
+			out = matchEnd;
+		} else if(offset >= matchLength) {
+			memcpy(out, ref, matchLength);
+			out += matchLength;
+		} else if(offset >= 8) {
+			//Overlapping copy - each 8-byte chunk only reads bytes that have already been written
+			uint8_t* matchEnd = out + matchLength;
+			while(matchEnd - out >= 8) {
+				memcpy(out, ref, 8);
+				out += 8;
+				ref += 8;
+			}
+			while(out < matchEnd) {
+				*out++ = *ref++;
+			}
+		} else {
+			for(size_t i = 0; i < matchLength; i++) {
+				*out++ = *ref++;
+			}
+		}
+	}
+
+	return false;
+}
+
+#if _DEBUG
+#include <assert.h>
+void Lz4Codec::RunTests()
+{
+	//Some basic unit tests to run in debug mode
+	auto testRoundTrip = [](const vector<uint8_t>& data) {
+		vector<uint8_t> compressed(GetMaxCompressedSize(data.size()));
+		size_t compressedSize = Compress(data.data(), data.size(), compressed.data());
+		assert(compressedSize <= compressed.size());
+
+		vector<uint8_t> decompressed(data.size());
+		assert(Decompress(compressed.data(), compressedSize, decompressed.data(), decompressed.size()));
+		assert(decompressed == data);
+
+		//The output size must match exactly
+		vector<uint8_t> largerOutput(data.size() + 1);
+		assert(!Decompress(compressed.data(), compressedSize, largerOutput.data(), largerOutput.size()));
+	};
+
+	//Inputs shorter than the minimum match length (and too short for any match to be searched for)
+	for(size_t size = 0; size <= MatchFindLimit; size++) {
+		testRoundTrip(vector<uint8_t>(size, 0x55));
+	}
+
+	//Incompressible input (pseudo-random bytes)
+	vector<uint8_t> data(100000);
+	uint32_t seed = 0x12345678;
+	for(uint8_t& value : data) {
+		seed = seed * 1103515245 + 12345;
+		value = (uint8_t)(seed >> 24);
+	}
+	testRoundTrip(data);
+
+	//Repeated data, with matches that are longer than the maximum offset and overlapping matches (short offsets)
+	for(size_t i = 0; i < data.size(); i++) {
+		data[i] = (uint8_t)(i % 3 == 0 ? i >> 10 : i % 7);
+	}
+	testRoundTrip(data);
+	testRoundTrip(vector<uint8_t>(70000, 0));
+
+	//Mix of random and repeated blocks (long literal runs followed by matches)
+	for(size_t i = 0; i < data.size(); i++) {
+		seed = seed * 1103515245 + 12345;
+		data[i] = (i / 4096) & 1 ? (uint8_t)(seed >> 24) : data[i & 0x3FF];
+	}
+	testRoundTrip(data);
+}
+#endif
@@ -0,0 +1,32 @@
+#pragma once
+#include "pch.h"
+
+//Compressor/decompressor for the LZ4 block format
+//See: https://github.com/lz4/lz4/blob/dev/doc/lz4_Block_format.md
+//Very fast, but with a lower compression ratio than deflate - used for data that is compressed often (rewind, netplay)
+class Lz4Codec
+{
+private:
+	static constexpr int MinMatch = 4;
+	//The last 5 bytes of a block are always literals, and the last match must start at least 12 bytes before the end of the block
+	static constexpr int LastLiterals = 5;
+	static constexpr int MatchFindLimit = 12;
+	static constexpr int MaxOffset = 65535;
+	static constexpr int HashBits = 14;
+
+	static uint32_t Hash(uint32_t value) { return (value * 2654435761u) >> (32 - HashBits); }
+	static uint8_t* WriteLength(uint8_t* out, size_t length);
+
+public:
+	static size_t GetMaxCompressedSize(size_t size) { return size + size / 255 + 16; }
+
+	//Output buffer must be at least GetMaxCompressedSize(size) bytes - returns the compressed size
+	static size_t Compress(const uint8_t* src, size_t size, uint8_t* dst);
+
+	//Returns false if the input is corrupted or doesn't decompress to exactly dstSize bytes
+	static bool Decompress(const uint8_t* src, size_t size, uint8_t* dst, size_t dstSize);
+
+#if _DEBUG
+	static void RunTests();
+#endif
+};
@@ -0,0 +1,29 @@
+#pragma once
+#include "pch.h"
+
+//Read-only view of a whole file, mapped in the process' address space
+//Pages are loaded by the OS when they are accessed and can be discarded under memory pressure, so large files (e.g CD images) don't need to be loaded in memory
+class MemoryMappedFile
+{
+private:
+	uint8_t* _data = nullptr;
+	size_t _size = 0;
+
+#ifdef _WIN32
+	void* _fileHandle = nullptr;
+	void* _mappingHandle = nullptr;
+#endif
+
+	void Close();
+
+public:
+	MemoryMappedFile(const string& path);
+	~MemoryMappedFile();
+
+	MemoryMappedFile(const MemoryMappedFile&) = delete;
+	MemoryMappedFile& operator=(const MemoryMappedFile&) = delete;
+
+	bool IsValid() { return _data != nullptr; }
+	const uint8_t* GetData() { return _data; }
+	size_t GetSize() { return _size; }
+};
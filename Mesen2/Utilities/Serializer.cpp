@@ -2,7 +2,7 @@
 #include <algorithm>
 #include "Serializer.h"
 #include "ISerializable.h"
-#include "miniz.h"
+#include "CompressionHelper.h"
 
 Serializer::Serializer(uint32_t version, bool forSave, SerializeFormat format)
 {
@@ -18,6 +18,31 @@ Serializer::Serializer(uint32_t version, bool forSave, SerializeFormat format)
 	}
 }
 
+Serializer::Serializer(uint32_t version, bool forSave, vector<uint8_t>& rawData)
+{
+	_version = version;
+	_saving = forSave;
+	_format = SerializeFormat::Binary;
+	_rawData = &rawData;
+	if(forSave && rawData.empty()) {
+		rawData.resize(0x50000);
+	}
+}
+
+bool Serializer::EndRawData()
+{
+	uint32_t layoutHash = _layoutHash;
+	if(_saving) {
+		StreamRaw(&layoutHash, sizeof(layoutHash));
+		_rawData->resize(_rawPos);
+		return true;
+	} else {
+		uint32_t savedHash = 0;
+		StreamRaw(&savedHash, sizeof(savedHash));
+		return !_hasError && savedHash == layoutHash && _rawPos == _rawData->size();
+	}
+}
+
 void Serializer::AddKeyPrefix(string prefix)
 {
 	vector<string> keys;
@@ -73,27 +98,26 @@ bool Serializer::LoadFrom(istream &file)
 
 	char value = 0;
 	file.get(value);
-	bool isCompressed = value == 1;
+	if(!CompressionHelper::IsValidCodec((uint8_t)value)) {
+		return false;
+	}
 
-	if(isCompressed) {
+	CompressionCodec codec = (CompressionCodec)value;
+	if(codec != CompressionCodec::Uncompressed) {
 		uint32_t decompressedSize;
 		file.read((char*)&decompressedSize, sizeof(decompressedSize));
 
 		uint32_t compressedSize;
 		file.read((char*)&compressedSize, sizeof(compressedSize));
 
-		if(decompressedSize >= 1024 * 1024 * 10 || compressedSize >= 1024 * 1024 * 10) {
-			//Limit to 10mb the data's size
+		if(decompressedSize >= CompressionHelper::MaxDataSize || compressedSize >= CompressionHelper::MaxDataSize) {
 			return false;
 		}
 
 		vector<uint8_t> compressedData(compressedSize, 0);
 		file.read((char*)compressedData.data(), compressedSize);
 
-		_data = vector<uint8_t>(decompressedSize, 0);
-
-		unsigned long decompSize = decompressedSize;
-		if(uncompress(_data.data(), &decompSize, compressedData.data(), (unsigned long)compressedData.size()) != MZ_OK) {
+		if(!CompressionHelper::Decode(compressedData.data(), compressedData.size(), codec, decompressedSize, _data)) {
 			return false;
 		}
 	} else {
@@ -204,28 +228,17 @@ bool Serializer::LoadFromTextFormat(istream& file)
 	return true;
 }
 
-void Serializer::SaveTo(ostream& file, int compressionLevel)
+void Serializer::SaveTo(ostream& file, CompressionCodec codec)
 {
 	if(_format == SerializeFormat::Text) {
 		file.write((char*)_data.data(), _data.size());
+	} else if(codec == CompressionCodec::Uncompressed) {
+		file.put((char)codec);
+		file.write((char*)_data.data(), _data.size());
 	} else {
-		bool isCompressed = compressionLevel > 0;
-		file.put((char)isCompressed);
-
-		if(isCompressed) {
-			unsigned long compressedSize = compressBound((unsigned long)_data.size());
-			uint8_t* compressedData = new uint8_t[compressedSize];
-			compress2(compressedData, &compressedSize, (unsigned char*)_data.data(), (unsigned long)_data.size(), compressionLevel);
-
-			uint32_t size = (uint32_t)compressedSize;
-			uint32_t originalSize = (uint32_t)_data.size();
-			file.write((char*)&originalSize, sizeof(uint32_t));
-			file.write((char*)&size, sizeof(uint32_t));
-			file.write((char*)compressedData, compressedSize);
-			delete[] compressedData;
-		} else {
-			file.write((char*)_data.data(), _data.size());
-		}
+		vector<uint8_t> compressedData;
+		CompressionHelper::Compress(_data.data(), _data.size(), codec, compressedData);
+		file.write((char*)compressedData.data(), compressedData.size());
 	}
 }
 
@@ -269,12 +282,18 @@ string Serializer::NormalizeName(const char* name, int index)
 
 void Serializer::PushNamePrefix(const char* name, int index)
 {
+	if(_rawData) {
+		return;
+	}
 	_prefixes.push_back(NormalizeName(name, index));
 	UpdatePrefix();
 }
 
 void Serializer::PopNamePrefix()
 {
+	if(_rawData) {
+		return;
+	}
 	_prefixes.pop_back();
 	UpdatePrefix();
 }
@@ -2,6 +2,7 @@
 
 #include "pch.h"
 #include "Utilities/ISerializable.h"
+#include "Utilities/CompressionHelper.h"
 #include "Utilities/FastString.h"
 #include "Utilities/magic_enum.hpp"
 #include "Utilities/safe_ptr.h"
@@ -72,6 +73,13 @@ enum class SerializeFormat
 class Serializer
 {
 private:
+	//Binary states are always stored in little endian order
+#if defined(__BYTE_ORDER__) && defined(__ORDER_BIG_ENDIAN__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+	static constexpr bool IsBigEndian = true;
+#else
+	static constexpr bool IsBigEndian = false;
+#endif
+
 	vector<uint8_t> _data;
 	vector<string> _prefixes;
 	string _prefix;
@@ -87,6 +95,11 @@ private:
 	SerializeFormat _format = SerializeFormat::Binary;
 	bool _hasError = false;
 
+	//Keyless binary mode (see constructor)
+	vector<uint8_t>* _rawData = nullptr;
+	uint32_t _rawPos = 0;
+	uint32_t _layoutHash = 2166136261;
+
 private:
 	bool LoadFromTextFormat(istream& file);
 	string NormalizeName(const char* name, int index);
@@ -105,10 +118,32 @@ private:
 	void WriteValue(T value)
 	{
 		uint8_t* ptr = (uint8_t*)&value;
-		constexpr bool isBigEndian = false;
-		constexpr int mask = isBigEndian ? sizeof(T) - 1 : 0;
-		for(int i = 0; i < (int)sizeof(T); i++) {
-			_data.push_back(ptr[i ^ mask]);
+		if constexpr(!IsBigEndian) {
+			_data.insert(_data.end(), ptr, ptr + sizeof(T));
+		} else {
+			constexpr int mask = sizeof(T) - 1;
+			for(int i = 0; i < (int)sizeof(T); i++) {
+				_data.push_back(ptr[i ^ mask]);
+			}
+		}
+	}
+
+	__forceinline void StreamRaw(void* data, uint32_t size)
+	{
+		//The layout hash only depends on the sequence of value sizes, used to detect save/load code paths that don't match
+		_layoutHash = (_layoutHash ^ size) * 16777619;
+
+		if(_saving) {
+			if(_rawPos + size > _rawData->size()) {
+				_rawData->resize(std::max<size_t>(_rawData->size() * 2, _rawPos + size));
+			}
+			memcpy(_rawData->data() + _rawPos, data, size);
+			_rawPos += size;
+		} else if(_rawPos + size <= _rawData->size()) {
+			memcpy(data, _rawData->data() + _rawPos, size);
+			_rawPos += size;
+		} else {
+			_hasError = true;
 		}
 	}
 
@@ -116,8 +151,7 @@ private:
 	void ReadValue(T& value, uint8_t* src)
 	{
 		uint8_t* ptr = (uint8_t*)&value;
-		constexpr bool isBigEndian = false;
-		constexpr int mask = isBigEndian ? sizeof(T) - 1 : 0;
+		constexpr int mask = IsBigEndian ? sizeof(T) - 1 : 0;
 		for(int i = 0; i < (int)sizeof(T); i++) {
 			ptr[i ^ mask] = src[i];
 		}
@@ -216,6 +250,15 @@ private:
 public:
 	Serializer(uint32_t version, bool forSave, SerializeFormat format = SerializeFormat::Binary);
 
+	//Keyless binary mode - values are copied as-is into/from rawData in the order they are streamed (no keys, lookups or allocations)
+	//The layout depends on the code path taken by each Serialize() call, so this can only be used to reload a state
+	//in the same session for the same game (e.g run-ahead) - the keyed format is used for everything else
+	Serializer(uint32_t version, bool forSave, vector<uint8_t>& rawData);
+
+	//Saving: appends the layout hash at the end of the raw data
+	//Loading: returns false if the data wasn't entirely consumed or if the layout doesn't match the one used when saving
+	bool EndRawData();
+
 	uint32_t GetVersion() { return _version; }
 	bool IsSaving() { return _saving; }
 	
@@ -245,6 +288,8 @@ public:
 		
 		if constexpr(std::is_base_of<ISerializable, T>::value) {
 			Stream((ISerializable&)value, name, index);
+		} else if(_rawData) {
+			StreamRaw(&value, sizeof(T));
 		} else {
 			string key = GetKey(name, index);
 
@@ -306,6 +351,11 @@ public:
 
 	void Stream(ISerializable& obj, const char* name, int index)
 	{
+		if(_rawData) {
+			obj.Serialize(*this);
+			return;
+		}
+
 		PushNamePrefix(name, index);
 		obj.Serialize(*this);
 		PopNamePrefix();
@@ -314,6 +364,11 @@ public:
 	template<typename T> void Stream(unique_ptr<T>& obj, const char* name, int index = -1)
 	{
 		static_assert(std::is_base_of<ISerializable, T>::value, "[Serializer] Object does not implement ISerializable");
+		if(_rawData) {
+			((ISerializable*)obj.get())->Serialize(*this);
+			return;
+		}
+
 		PushNamePrefix(name, index);
 		((ISerializable*)obj.get())->Serialize(*this);
 		PopNamePrefix();
@@ -322,6 +377,11 @@ public:
 	template<typename T> void Stream(const unique_ptr<T>& obj, const char* name, int index = -1)
 	{
 		static_assert(std::is_base_of<ISerializable, T>::value, "[Serializer] Object does not implement ISerializable");
+		if(_rawData) {
+			((ISerializable*)obj.get())->Serialize(*this);
+			return;
+		}
+
 		PushNamePrefix(name, index);
 		((ISerializable*)obj.get())->Serialize(*this);
 		PopNamePrefix();
@@ -330,6 +390,11 @@ public:
 	template<typename T> void Stream(shared_ptr<T>& obj, const char* name, int index = -1)
 	{
 		static_assert(std::is_base_of<ISerializable, T>::value, "[Serializer] Object does not implement ISerializable");
+		if(_rawData) {
+			((ISerializable*)obj.get())->Serialize(*this);
+			return;
+		}
+
 		PushNamePrefix(name, index);
 		((ISerializable*)obj.get())->Serialize(*this);
 		PopNamePrefix();
@@ -338,6 +403,11 @@ public:
 	template<typename T> void Stream(safe_ptr<T>& obj, const char* name, int index = -1)
 	{
 		static_assert(std::is_base_of<ISerializable, T>::value, "[Serializer] Object does not implement ISerializable");
+		if(_rawData) {
+			((ISerializable*)obj.get())->Serialize(*this);
+			return;
+		}
+
 		PushNamePrefix(name, index);
 		((ISerializable*)obj.get())->Serialize(*this);
 		PopNamePrefix();
@@ -345,6 +415,11 @@ public:
 
 	template<typename T> void StreamArray(T* arrayValues, uint32_t elementCount, const char* name)
 	{
+		if(_rawData) {
+			StreamRaw(arrayValues, elementCount * sizeof(T));
+			return;
+		}
+
 		string key = GetKey(name, -1);
 
 		CheckDuplicateKey(key);
@@ -364,8 +439,6 @@ public:
 			return;
 		}
 
-		//TODO detect big vs little endian
-		constexpr bool isBigEndian = false;
 		if(_saving) {
 			//Write key
 			_data.insert(_data.end(), key.begin(), key.end());
@@ -375,7 +448,7 @@ public:
 			WriteValue((uint32_t)(elementCount * sizeof(T)));
 
 			//Write array content
-			if constexpr(sizeof(T) == 1 || !isBigEndian) {
+			if constexpr(sizeof(T) == 1 || !IsBigEndian) {
 				_data.insert(_data.end(), (uint8_t*)arrayValues, (uint8_t*)(arrayValues + elementCount));
 			} else {
 				for(uint32_t i = 0; i < elementCount; i++) {
@@ -387,7 +460,7 @@ public:
 			if(result != _values.end()) {
 				SerializeValue& savedValue = result->second;
 				//Copy as much data as possible (up to the size of whichever is smaller - savedValue or arrayValues)
-				if constexpr(sizeof(T) == 1 || !isBigEndian) {
+				if constexpr(sizeof(T) == 1 || !IsBigEndian) {
 					memcpy(arrayValues, savedValue.DataPtr, std::min<int>(savedValue.Size, sizeof(T) * elementCount));
 				} else {
 					uint8_t* src = savedValue.DataPtr;
@@ -409,6 +482,20 @@ public:
 			return;
 		}
 
+		if(_rawData) {
+			uint32_t elementCount = (uint32_t)values.size();
+			StreamRaw(&elementCount, sizeof(elementCount));
+			if(!_saving) {
+				if(_hasError || elementCount > (_rawData->size() - _rawPos) / sizeof(T)) {
+					_hasError = true;
+					return;
+				}
+				values.resize(elementCount);
+			}
+			StreamRaw(values.data(), elementCount * sizeof(T));
+			return;
+		}
+
 		string key = GetKey(name, index);
 
 		CheckDuplicateKey(key);
@@ -423,8 +510,12 @@ public:
 			WriteValue((uint32_t)(elementCount * sizeof(T)));
 
 			//Write array content
-			for(uint32_t i = 0; i < elementCount; i++) {
-				WriteValue(values[i]);
+			if constexpr(!IsBigEndian) {
+				_data.insert(_data.end(), (uint8_t*)values.data(), (uint8_t*)(values.data() + elementCount));
+			} else {
+				for(uint32_t i = 0; i < elementCount; i++) {
+					WriteValue(values[i]);
+				}
 			}
 		} else {
 			auto result = _values.find(key);
@@ -446,19 +537,38 @@ public:
 
 	bool ContainsKey(const char* name)
 	{
+		if(_rawData) {
+			//Raw states are always created by the current build, keys from older versions can't exist
+			return false;
+		}
+
 		string key = GetKey(name, -1);
 		return _values.find(key) != _values.end();
 	}
 
 	void PushNamePrefix(const char* name, int index = -1);
 	void PopNamePrefix();
-	void SaveTo(ostream &file, int compressionLevel = 1);
+	void SaveTo(ostream &file, CompressionCodec codec = CompressionCodec::Deflate);
 	bool LoadFrom(istream& file);
 	void LoadFromMap(unordered_map<string, SerializeMapValue>& map);
 };
 
 template<> inline void Serializer::Stream(string& value, const char* name, int index)
 {
+	if(_rawData) {
+		uint32_t length = (uint32_t)value.size();
+		StreamRaw(&length, sizeof(length));
+		if(!_saving) {
+			if(_hasError || length > _rawData->size() - _rawPos) {
+				_hasError = true;
+				return;
+			}
+			value.resize(length);
+		}
+		StreamRaw(value.data(), length);
+		return;
+	}
+
 	string key = GetKey(name, index);
 
 	CheckDuplicateKey(key);
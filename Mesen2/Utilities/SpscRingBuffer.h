@@ -0,0 +1,142 @@
+#pragma once
+#include "pch.h"
+
+//Fixed-capacity, lock-free ring buffer for exactly one producer thread and one consumer thread.
+//Positions are free-running counters (the slot index is pos & (Capacity - 1)), so every slot is usable.
+//The producer and consumer indexes live on separate cache lines, and each side keeps a cached copy
+//of the other side's index to avoid touching the shared line on every call.
+template<typename T, size_t Capacity>
+class SpscRingBuffer
+{
+	static_assert(Capacity > 0 && (Capacity & (Capacity - 1)) == 0, "Capacity must be a power of 2");
+
+private:
+	static constexpr size_t CacheLineSize = 64;
+	static constexpr size_t Mask = Capacity - 1;
+
+	//Producer-owned
+	alignas(CacheLineSize) std::atomic<size_t> _writePos = { 0 };
+	size_t _cachedReadPos = 0;
+
+	//Consumer-owned
+	alignas(CacheLineSize) std::atomic<size_t> _readPos = { 0 };
+	size_t _cachedWritePos = 0;
+
+	alignas(CacheLineSize) T _buffer[Capacity] = {};
+
+public:
+	//Producer side
+	bool Push(const T& value)
+	{
+		size_t writePos = _writePos.load(std::memory_order_relaxed);
+		if(writePos - _cachedReadPos >= Capacity) {
+			_cachedReadPos = _readPos.load(std::memory_order_acquire);
+			if(writePos - _cachedReadPos >= Capacity) {
+				return false;
+			}
+		}
+		_buffer[writePos & Mask] = value;
+		_writePos.store(writePos + 1, std::memory_order_release);
+		return true;
+	}
+
+	//Producer side - position the next pushed value will be written to
+	size_t GetWritePosition() const
+	{
+		return _writePos.load(std::memory_order_relaxed);
+	}
+
+	//Consumer side
+	bool Pop(T& value)
+	{
+		size_t readPos = _readPos.load(std::memory_order_relaxed);
+		if((ptrdiff_t)(_cachedWritePos - readPos) <= 0) {
+			_cachedWritePos = _writePos.load(std::memory_order_acquire);
+			if((ptrdiff_t)(_cachedWritePos - readPos) <= 0) {
+				return false;
+			}
+		}
+		value = _buffer[readPos & Mask];
+		_readPos.store(readPos + 1, std::memory_order_release);
+		return true;
+	}
+
+	//Consumer side - discards every value written before the given write position
+	void SkipTo(size_t writePos)
+	{
+		size_t readPos = _readPos.load(std::memory_order_relaxed);
+		if((ptrdiff_t)(writePos - readPos) > 0) {
+			//The cached write position may be older than the new read position, refresh it so Pop doesn't read past the end
+			_cachedWritePos = _writePos.load(std::memory_order_acquire);
+			if((ptrdiff_t)(writePos - _cachedWritePos) > 0) {
+				writePos = _cachedWritePos;
+			}
+			_readPos.store(writePos, std::memory_order_release);
+		}
+	}
+
+	//Consumer side - discards everything that has been pushed so far
+	void Clear()
+	{
+		_cachedWritePos = _writePos.load(std::memory_order_acquire);
+		_readPos.store(_cachedWritePos, std::memory_order_release);
+	}
+
+	//Can be called from either side, the result may be stale by the time it is used
+	size_t Size() const
+	{
+		size_t readPos = _readPos.load(std::memory_order_acquire);
+		size_t writePos = _writePos.load(std::memory_order_acquire);
+		return writePos - readPos;
+	}
+
+	bool IsEmpty() const { return Size() == 0; }
+	bool IsFull() const { return Size() >= Capacity; }
+	static constexpr size_t GetCapacity() { return Capacity; }
+
+#if _DEBUG
+	//Some basic unit tests to run in debug mode (single-threaded)
+	static void RunTests()
+	{
+		unique_ptr<SpscRingBuffer> ring(new SpscRingBuffer());
+		T value = {};
+
+		//Wrap around the buffer a few times
+		for(size_t i = 0; i < Capacity * 3; i++) {
+			assert(ring->Push((T)i));
+			assert(ring->Pop(value) && value == (T)i);
+		}
+		assert(ring->IsEmpty() && !ring->Pop(value));
+
+		//Fill the buffer completely
+		for(size_t i = 0; i < Capacity; i++) {
+			assert(ring->Push((T)i));
+		}
+		assert(ring->IsFull() && !ring->Push((T)0));
+		ring->Clear();
+		assert(ring->IsEmpty() && !ring->Pop(value));
+
+		//Skipping past the consumer's cached write position must not allow reading slots that were never written
+		assert(ring->Push((T)1));
+		assert(ring->Pop(value) && value == (T)1);
+		size_t skipPos = ring->GetWritePosition() + 2;
+		assert(ring->Push((T)2) && ring->Push((T)3) && ring->Push((T)4));
+		ring->SkipTo(skipPos);
+		assert(ring->Size() == 1);
+		assert(ring->Pop(value) && value == (T)4);
+		assert(ring->Size() == 0 && !ring->Pop(value));
+		assert(ring->Push((T)5));
+		assert(ring->Size() == 1 && ring->Pop(value) && value == (T)5);
+
+		//Positions beyond the write position are clamped
+		ring->SkipTo(ring->GetWritePosition() + 10);
+		assert(ring->Size() == 0 && !ring->Pop(value));
+		assert(ring->Push((T)6) && ring->Pop(value) && value == (T)6);
+
+		//Skipping to an older position does nothing
+		assert(ring->Push((T)7));
+		ring->SkipTo(ring->GetWritePosition() - 5);
+		assert(ring->Size() == 1 && ring->Pop(value) && value == (T)7);
+	}
+#endif
+};
@@ -0,0 +1,57 @@
+#pragma once
+#include "pch.h"
+
+//Lock-free handoff of the latest value from one producer thread to one consumer thread.
+//The producer fills the back buffer and publishes it, which swaps it with the middle buffer - it never waits for the consumer.
+//The consumer swaps its front buffer with the middle buffer when a new value was published since its last read.
+//Values that are replaced by a newer value before the consumer reads them are dropped.
+template<typename T>
+class TripleBuffer
+{
+private:
+	static constexpr uint8_t IndexMask = 0x03;
+	static constexpr uint8_t NewValueFlag = 0x04;
+
+	T _buffers[3] = {};
+
+	//Index of the middle buffer, with NewValueFlag set when it hasn't been read yet
+	std::atomic<uint8_t> _middle = { 1 };
+
+	//Producer-owned
+	uint8_t _back = 0;
+
+	//Consumer-owned
+	uint8_t _front = 2;
+
+public:
+	//Producer side - buffer to fill before calling Publish
+	T& GetWriteBuffer() { return _buffers[_back]; }
+
+	//Producer side - returns true when the previously published value was never read (and has been dropped)
+	bool Publish()
+	{
+		uint8_t previous = _middle.exchange(_back | NewValueFlag, std::memory_order_acq_rel);
+		_back = previous & IndexMask;
+		return (previous & NewValueFlag) != 0;
+	}
+
+	//Consumer side - returns false (and keeps the current front buffer) when nothing was published since the last read
+	bool Read()
+	{
+		if(!(_middle.load(std::memory_order_relaxed) & NewValueFlag)) {
+			return false;
+		}
+		uint8_t previous = _middle.exchange(_front, std::memory_order_acq_rel);
+		_front = previous & IndexMask;
+		return true;
+	}
+
+	//Consumer side - latest value returned by Read
+	T& GetReadBuffer() { return _buffers[_front]; }
+
+	//Can be called from either side, the result may be stale by the time it is used
+	bool HasNewValue() const
+	{
+		return (_middle.load(std::memory_order_acquire) & NewValueFlag) != 0;
+	}
+};
@@ -1,16 +1,12 @@
 #include "pch.h"
 #include "AviRecorder.h"
 
-AviRecorder::AviRecorder(VideoCodec codec, uint32_t compressionLevel)
+AviRecorder::AviRecorder(VideoCodec codec, uint32_t compressionLevel, bool offlineMode, ParallelForFunc parallelFor)
 {
-	_recording = false;
-	_stopFlag = false;
-	_framePending = false;
-	_frameBuffer = nullptr;
-	_frameBufferLength = 0;
-	_sampleRate = 0;
 	_codec = codec;
 	_compressionLevel = compressionLevel;
+	_offlineMode = offlineMode;
+	_parallelFor = parallelFor;
 }
 
 AviRecorder::~AviRecorder()
@@ -18,11 +14,6 @@ AviRecorder::~AviRecorder()
 	if(_recording) {
 		StopRecording();
 	}
-
-	if(_frameBuffer) {
-		delete[] _frameBuffer;
-		_frameBuffer = nullptr;
-	}
 }
 
 bool AviRecorder::Init(string filename)
@@ -45,43 +36,80 @@ bool AviRecorder::StartRecording(uint32_t width, uint32_t height, uint32_t bpp,
 		_height = height;
 		_fps = fps;
 		_frameBufferLength = height * width * bpp;
-		_frameBuffer = new uint8_t[_frameBufferLength];
+		_maxQueuedFrames = std::clamp<uint32_t>(MaxQueueMemory / std::max<uint32_t>(_frameBufferLength, 1), 2, MaxQueuedFrames);
+		_stopFlag = false;
 
 		_aviWriter.reset(new AviWriter());
-		if(!_aviWriter->StartWrite(_outputFile, _codec, width, height, bpp, (uint32_t)(_fps * 1000000), audioSampleRate, _compressionLevel)) {
+		if(!_aviWriter->StartWrite(_outputFile, _codec, width, height, bpp, (uint32_t)(_fps * 1000000), audioSampleRate, _compressionLevel, _parallelFor)) {
 			_aviWriter.reset();
 			return false;
 		}
 
-		_aviWriterThread = std::thread([=]() {
-			while(!_stopFlag) {
-				_waitFrame.Wait();
-				if(_stopFlag) {
-					break;
-				}
-
-				auto lock = _lock.AcquireSafe();
-				_aviWriter->AddFrame(_frameBuffer);
-				_framePending = false;
-			}
-		});
+		_aviWriterThread = std::thread(&AviRecorder::WriterThread, this);
 
 		_recording = true;
 	}
 	return true;
 }
 
+void AviRecorder::WriterThread()
+{
+	std::unique_lock<std::mutex> lock(_queueLock);
+	while(true) {
+		_queueSignal.wait(lock, [this] { return _stopFlag || !_queue.empty(); });
+		if(_queue.empty()) {
+			//Stop requested and all pending data has been written
+			break;
+		}
+
+		PendingData data = std::move(_queue.front());
+		_queue.pop_front();
+		lock.unlock();
+
+		if(!data.IsFrame) {
+			_aviWriter->AddSound(data.AudioData.data(), (uint32_t)data.AudioData.size() / 2);
+		} else {
+			_aviWriter->AddFrame(data.IsDropped ? nullptr : data.FrameData.data());
+		}
+
+		lock.lock();
+		if(data.IsFrame && !data.IsDropped) {
+			_queuedFrames--;
+		}
+		_pool.push_back(std::move(data));
+		_queueSignal.notify_all();
+	}
+}
+
+AviRecorder::PendingData AviRecorder::GetPendingData()
+{
+	if(_pool.empty()) {
+		return {};
+	}
+
+	PendingData data = std::move(_pool.back());
+	_pool.pop_back();
+	return data;
+}
+
 void AviRecorder::StopRecording()
 {
 	if(_recording) {
 		_recording = false;
 
-		_stopFlag = true;
-		_waitFrame.Signal();
+		{
+			std::unique_lock<std::mutex> lock(_queueLock);
+			_stopFlag = true;
+		}
+		_queueSignal.notify_all();
 		_aviWriterThread.join();
 
 		_aviWriter->EndWrite();
 		_aviWriter.reset();
+
+		_queue.clear();
+		_pool.clear();
+		_queuedFrames = 0;
 	}
 }
 
@@ -91,15 +119,25 @@ bool AviRecorder::AddFrame(void* frameBuffer, uint32_t width, uint32_t height, d
 		if(_width != width || _height != height || _fps != fps) {
 			return false;
 		} else {
-			while(_framePending) {
-				//Previous frame isn't done processing yet, wait
-				std::this_thread::sleep_for(std::chrono::duration<int, std::milli>(1));
+			std::unique_lock<std::mutex> lock(_queueLock);
+			if(_offlineMode) {
+				//Wait for the encoder to catch up
+				_queueSignal.wait(lock, [this] { return _queuedFrames < _maxQueuedFrames; });
 			}
 
-			auto lock = _lock.AcquireSafe();
-			_framePending = true;
-			memcpy(_frameBuffer, frameBuffer, _frameBufferLength);
-			_waitFrame.Signal();
+			PendingData data = GetPendingData();
+			data.IsFrame = true;
+			if(_queuedFrames >= _maxQueuedFrames) {
+				//Encoder can't keep up - an empty frame is written instead, to keep the video in sync with the audio
+				data.IsDropped = true;
+			} else {
+				data.IsDropped = false;
+				data.FrameData.resize(_frameBufferLength);
+				memcpy(data.FrameData.data(), frameBuffer, _frameBufferLength);
+				_queuedFrames++;
+			}
+			_queue.push_back(std::move(data));
+			_queueSignal.notify_all();
 		}
 	}
 	return true;
@@ -111,7 +149,12 @@ bool AviRecorder::AddSound(int16_t* soundBuffer, uint32_t sampleCount, uint32_t
 		if(_sampleRate != sampleRate) {
 			return false;
 		} else {
-			_aviWriter->AddSound(soundBuffer, sampleCount);
+			std::unique_lock<std::mutex> lock(_queueLock);
+			PendingData data = GetPendingData();
+			data.IsFrame = false;
+			data.AudioData.assign(soundBuffer, soundBuffer + sampleCount * 2);
+			_queue.push_back(std::move(data));
+			_queueSignal.notify_all();
 		}
 	}
 	return true;
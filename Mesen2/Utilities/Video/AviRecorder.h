@@ -1,39 +1,63 @@
 #pragma once
 #include "pch.h"
 #include <thread>
-#include "Utilities/AutoResetEvent.h"
-#include "Utilities/SimpleLock.h"
+#include <condition_variable>
+#include <mutex>
 #include "Utilities/Video/AviWriter.h"
 #include "Utilities/Video/IVideoRecorder.h"
 
 class AviRecorder final : public IVideoRecorder
 {
 private:
+	//Frames and audio samples are written by a separate thread, in the order they were received
+	struct PendingData
+	{
+		bool IsFrame = false;
+		bool IsDropped = false;
+		vector<uint8_t> FrameData;
+		vector<int16_t> AudioData;
+	};
+
+	//Frames are dropped (or emulation is blocked, in offline mode) once the queue reaches this size
+	static constexpr uint32_t MaxQueuedFrames = 60;
+	static constexpr uint32_t MaxQueueMemory = 256 * 1024 * 1024;
+
 	std::thread _aviWriterThread;
 	
 	unique_ptr<AviWriter> _aviWriter;
 
 	string _outputFile;
-	SimpleLock _lock;
-	AutoResetEvent _waitFrame;
 
-	atomic<bool> _stopFlag;
-	atomic<bool> _framePending;
+	std::mutex _queueLock;
+	std::condition_variable _queueSignal;
+	deque<PendingData> _queue;
+
+	//Processed entries are kept to reuse their buffers, instead of allocating a new buffer for every frame
+	vector<PendingData> _pool;
 
-	bool _recording;
-	uint8_t* _frameBuffer;
-	uint32_t _frameBufferLength;
-	uint32_t _sampleRate;
+	uint32_t _queuedFrames = 0;
+	uint32_t _maxQueuedFrames = 0;
 
-	double _fps;
-	uint32_t _width;
-	uint32_t _height;
+	bool _stopFlag = false;
+	bool _recording = false;
+	uint32_t _frameBufferLength = 0;
+	uint32_t _sampleRate = 0;
+
+	double _fps = 0;
+	uint32_t _width = 0;
+	uint32_t _height = 0;
 
 	VideoCodec _codec;
 	uint32_t _compressionLevel;
+	bool _offlineMode;
+	ParallelForFunc _parallelFor;
+
+	PendingData GetPendingData();
+	void WriterThread();
 
 public:
-	AviRecorder(VideoCodec codec, uint32_t compressionLevel);
+	//In offline mode, AddFrame waits for the encoder when the queue is full instead of dropping the frame
+	AviRecorder(VideoCodec codec, uint32_t compressionLevel, bool offlineMode = false, ParallelForFunc parallelFor = nullptr);
 	virtual ~AviRecorder();
 
 	bool Init(string filename) override;
@@ -64,7 +64,7 @@ void AviWriter::host_writed(uint8_t* buffer, uint32_t value)
 	buffer[3] = value >> 24;
 }
 
-bool AviWriter::StartWrite(string filename, VideoCodec codec, uint32_t width, uint32_t height, uint32_t bpp, uint32_t fps, uint32_t audioSampleRate, uint32_t compressionLevel)
+bool AviWriter::StartWrite(string filename, VideoCodec codec, uint32_t width, uint32_t height, uint32_t bpp, uint32_t fps, uint32_t audioSampleRate, uint32_t compressionLevel, ParallelForFunc parallelFor)
 {
 	_codecType = codec;
 	_file.open(filename, std::ios::out | std::ios::binary);
@@ -79,6 +79,7 @@ bool AviWriter::StartWrite(string filename, VideoCodec codec, uint32_t width, ui
 		case VideoCodec::CSCD: _codec.reset(new CamstudioCodec()); break;
 	}
 
+	_codec->SetParallelFor(parallelFor);
 	if(!_codec->SetupCompress(width, height, compressionLevel)) {
 		return false;
 	}
@@ -242,12 +243,18 @@ void AviWriter::AddFrame(uint8_t *frameData)
 	bool isKeyFrame = (_frames % 120 == 0) ? 1 : 0;
 
 	uint8_t* compressedData = nullptr;
-	int written = _codec->CompressFrame(isKeyFrame, frameData, &compressedData);
-	if(written < 0) {
-		return;
+	int written = 0;
+	if(frameData) {
+		written = _codec->CompressFrame(isKeyFrame, frameData, &compressedData);
+		if(written < 0) {
+			return;
+		}
+	} else {
+		//Dropped frame, the next frame is still compressed against the last compressed frame
+		isKeyFrame = false;
 	}
 
-	if(_codecType == VideoCodec::None) {
+	if(_codecType == VideoCodec::None && frameData) {
 		isKeyFrame = true;
 	}
 	WriteAviChunk(_codecType == VideoCodec::None ? "00db" : "00dc", written, compressedData, isKeyFrame ? 0x10 : 0);
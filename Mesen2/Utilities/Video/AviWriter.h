@@ -49,9 +49,10 @@ private:
 	void WriteAviChunk(const char * tag, uint32_t size, void * data, uint32_t flags);
 
 public:
+	//A null frame writes an empty chunk (the previous frame is repeated during playback)
 	void AddFrame(uint8_t* frameData);
 	void AddSound(int16_t * data, uint32_t sampleCount);
 
-	bool StartWrite(string filename, VideoCodec codec, uint32_t width, uint32_t height, uint32_t bpp, uint32_t fps, uint32_t audioSampleRate, uint32_t compressionLevel);
+	bool StartWrite(string filename, VideoCodec codec, uint32_t width, uint32_t height, uint32_t bpp, uint32_t fps, uint32_t audioSampleRate, uint32_t compressionLevel, ParallelForFunc parallelFor = nullptr);
 	void EndWrite();
 };
\ No newline at end of file
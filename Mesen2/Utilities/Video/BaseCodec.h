@@ -1,9 +1,19 @@
 #pragma once
 #include "pch.h"
+#include <functional>
+
+//Calls process(start, end) on batches of [0, count) in parallel (batches contain at least minBatchSize items), returns once all batches are done
+using ParallelForFunc = std::function<void(uint32_t count, uint32_t minBatchSize, const std::function<void(uint32_t start, uint32_t end)>& process)>;
 
 class BaseCodec
 {
+protected:
+	ParallelForFunc _parallelFor;
+
 public:
+	//Lets the codec split its work across worker threads (optional)
+	void SetParallelFor(ParallelForFunc parallelFor) { _parallelFor = parallelFor; }
+
 	virtual bool SetupCompress(int width, int height, uint32_t compressionLevel) = 0;
 	virtual int CompressFrame(bool isKeyFrame, uint8_t *frameData, uint8_t** compressedData) = 0;
 	virtual const char* GetFourCC() = 0;
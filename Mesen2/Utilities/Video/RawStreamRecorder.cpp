@@ -0,0 +1,195 @@
+#include "pch.h"
+#include "RawStreamRecorder.h"
+#include "Utilities/UTF8Util.h"
+
+#ifdef _WIN32
+	#include <io.h>
+	#include <fcntl.h>
+#else
+	#include <unistd.h>
+	#include <signal.h>
+#endif
+
+RawStreamRecorder::RawStreamRecorder(string audioTarget)
+{
+	_audioOutputFile = audioTarget;
+}
+
+RawStreamRecorder::~RawStreamRecorder()
+{
+	StopRecording();
+	CloseOutputs();
+}
+
+FILE* RawStreamRecorder::OpenOutput(const string& target)
+{
+	FILE* output = nullptr;
+	if(target.size() > 3 && target.compare(0, 3, "fd:") == 0) {
+		//File descriptor inherited from the parent process (e.g fd:1 for stdout) - a copy is used to leave the original open after recording
+		int fd = -1;
+		try {
+			fd = std::stoi(target.substr(3));
+		} catch(std::exception&) {
+			return nullptr;
+		}
+
+#ifdef _WIN32
+		int copy = _dup(fd);
+		if(copy >= 0) {
+			_setmode(copy, _O_BINARY);
+			output = _fdopen(copy, "wb");
+			if(!output) {
+				_close(copy);
+			}
+		}
+#else
+		int copy = dup(fd);
+		if(copy >= 0) {
+			output = fdopen(copy, "wb");
+			if(!output) {
+				close(copy);
+			}
+		}
+#endif
+	} else {
+		//Also used for named pipes (e.g \\.\pipe\name on Windows, or a fifo created with mkfifo) - blocks until the pipe is opened by the reader
+#ifdef _WIN32
+		output = _wfopen(utf8::utf8::decode(target).c_str(), L"wb");
+#else
+		output = fopen(target.c_str(), "wb");
+#endif
+	}
+
+	if(output) {
+		setvbuf(output, nullptr, _IOFBF, OutputBufferSize);
+	}
+	return output;
+}
+
+bool RawStreamRecorder::Init(string filename)
+{
+#ifndef _WIN32
+	//Writing to a pipe that was closed by the reader must fail instead of terminating the process
+	signal(SIGPIPE, SIG_IGN);
+#endif
+
+	_outputFile = filename;
+	_videoOutput = OpenOutput(filename);
+	if(!_videoOutput) {
+		return false;
+	}
+
+	if(!_audioOutputFile.empty()) {
+		_audioOutput = OpenOutput(_audioOutputFile);
+		if(!_audioOutput) {
+			CloseOutputs();
+			return false;
+		}
+	}
+	return true;
+}
+
+bool RawStreamRecorder::Write(FILE* output, const void* data, size_t size)
+{
+	return size == 0 || fwrite(data, 1, size, output) == size;
+}
+
+bool RawStreamRecorder::WritePacket(uint32_t type, const void* header, uint32_t headerSize, const void* data, uint32_t size)
+{
+	uint32_t packetHeader[2] = { type, headerSize + size };
+	return Write(_videoOutput, packetHeader, sizeof(packetHeader)) && Write(_videoOutput, header, headerSize) && Write(_videoOutput, data, size);
+}
+
+bool RawStreamRecorder::StartRecording(uint32_t width, uint32_t height, uint32_t bpp, uint32_t audioSampleRate, double fps)
+{
+	if(!_recording && _videoOutput) {
+		_width = width;
+		_height = height;
+		_sampleRate = audioSampleRate;
+
+		if(_audioOutputFile.empty()) {
+			std::lock_guard<std::mutex> lock(_videoLock);
+			uint32_t header[4] = { 0x5741524D /* MRAW */, Version, audioSampleRate, 2 };
+			if(!Write(_videoOutput, header, sizeof(header)) || !Write(_videoOutput, &fps, sizeof(fps))) {
+				return false;
+			}
+		}
+
+		_recording = true;
+	}
+	return _recording;
+}
+
+void RawStreamRecorder::StopRecording()
+{
+	if(_recording) {
+		_recording = false;
+		CloseOutputs();
+	}
+}
+
+void RawStreamRecorder::CloseOutputs()
+{
+	{
+		std::lock_guard<std::mutex> lock(_videoLock);
+		if(_videoOutput) {
+			fclose(_videoOutput);
+			_videoOutput = nullptr;
+		}
+	}
+	{
+		std::lock_guard<std::mutex> lock(_audioLock);
+		if(_audioOutput) {
+			fclose(_audioOutput);
+			_audioOutput = nullptr;
+		}
+	}
+}
+
+bool RawStreamRecorder::AddFrame(void* frameBuffer, uint32_t width, uint32_t height, double fps)
+{
+	std::lock_guard<std::mutex> lock(_videoLock);
+	if(!_recording || !_videoOutput) {
+		return false;
+	}
+
+	uint32_t frameSize = width * height * sizeof(uint32_t);
+	if(!_audioOutputFile.empty()) {
+		if(_width != width || _height != height) {
+			//The reader can't know the new frame size without the packet headers
+			return false;
+		}
+		return Write(_videoOutput, frameBuffer, frameSize);
+	} else {
+		uint32_t header[2] = { width, height };
+		return WritePacket(VideoPacket, header, sizeof(header), frameBuffer, frameSize);
+	}
+}
+
+bool RawStreamRecorder::AddSound(int16_t* soundBuffer, uint32_t sampleCount, uint32_t sampleRate)
+{
+	if(!_recording) {
+		return true;
+	} else if(_sampleRate != sampleRate) {
+		return false;
+	}
+
+	uint32_t size = sampleCount * 2 * sizeof(int16_t);
+	if(!_audioOutputFile.empty()) {
+		std::lock_guard<std::mutex> lock(_audioLock);
+		return _audioOutput && Write(_audioOutput, soundBuffer, size);
+	} else {
+		std::lock_guard<std::mutex> lock(_videoLock);
+		return _videoOutput && WritePacket(AudioPacket, nullptr, 0, soundBuffer, size);
+	}
+}
+
+bool RawStreamRecorder::IsRecording()
+{
+	return _recording;
+}
+
+string RawStreamRecorder::GetOutputFile()
+{
+	return _outputFile;
+}
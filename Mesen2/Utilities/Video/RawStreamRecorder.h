@@ -0,0 +1,57 @@
+#pragma once
+#include "pch.h"
+#include <mutex>
+#include "Utilities/Video/IVideoRecorder.h"
+
+//Writes the frames and audio samples without encoding them, to a file, a named pipe or an open file descriptor ("fd:N")
+//Writes block when the reader (e.g an external encoder) is slower than the emulation, so no frames are dropped.
+//
+//When no audio output is given, video and audio are both written to the output as a stream of packets (all values are little-endian):
+//  Header: "MRAW", uint32 version, uint32 sample rate, uint32 channel count, double fps
+//  Packets: uint32 type, uint32 payload size, followed by the payload
+//  - "VIDF" packets: uint32 width, uint32 height, followed by width*height 32-bit pixels (B, G, R, A byte order)
+//  - "AUDS" packets: interleaved signed 16-bit stereo samples
+//Otherwise, the output only contains the frames' pixels (B, G, R, A byte order) and the audio output only contains the 16-bit stereo samples
+class RawStreamRecorder final : public IVideoRecorder
+{
+private:
+	static constexpr uint32_t Version = 1;
+	static constexpr uint32_t VideoPacket = 0x46444956; //VIDF
+	static constexpr uint32_t AudioPacket = 0x53445541; //AUDS
+	static constexpr uint32_t OutputBufferSize = 0x100000;
+
+	FILE* _videoOutput = nullptr;
+	FILE* _audioOutput = nullptr;
+
+	//AddFrame and AddSound are called by different threads - each output has its own lock to avoid blocking one stream while the other is being written
+	std::mutex _videoLock;
+	std::mutex _audioLock;
+
+	string _outputFile;
+	string _audioOutputFile;
+
+	atomic<bool> _recording = false;
+	uint32_t _width = 0;
+	uint32_t _height = 0;
+	uint32_t _sampleRate = 0;
+
+	static FILE* OpenOutput(const string& target);
+	static bool Write(FILE* output, const void* data, size_t size);
+	bool WritePacket(uint32_t type, const void* header, uint32_t headerSize, const void* data, uint32_t size);
+	void CloseOutputs();
+
+public:
+	//audioTarget: output for the audio samples - when empty, audio is written to the same output as the frames (as packets)
+	RawStreamRecorder(string audioTarget = "");
+	virtual ~RawStreamRecorder();
+
+	bool Init(string filename) override;
+	bool StartRecording(uint32_t width, uint32_t height, uint32_t bpp, uint32_t audioSampleRate, double fps) override;
+	void StopRecording() override;
+
+	bool AddFrame(void* frameBuffer, uint32_t width, uint32_t height, double fps) override;
+	bool AddSound(int16_t* soundBuffer, uint32_t sampleCount, uint32_t sampleRate) override;
+
+	bool IsRecording() override;
+	string GetOutputFile() override;
+};
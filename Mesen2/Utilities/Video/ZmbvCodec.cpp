@@ -187,36 +187,57 @@ INLINE void ZmbvCodec::AddXorBlock(int vx,int vy,FrameBlock * block) {
 	}
 }
 
+template<class P>
+void ZmbvCodec::FindBlockVector(FrameBlock * block) {
+	int bestvx = 0;
+	int bestvy = 0;
+	int bestchange=CompareBlock<P>(0,0, block);
+	int possibles=64;
+	for (int v=0;v<VectorCount && possibles;v++) {
+		if (bestchange<4) break;
+		int vx = VectorTable[v].x;
+		int vy = VectorTable[v].y;
+		if (PossibleBlock<P>(vx, vy, block) < 4) {
+			possibles--;
+			int testchange=CompareBlock<P>(vx,vy, block);
+			if (testchange<bestchange) {
+				bestchange=testchange;
+				bestvx = vx;
+				bestvy = vy;
+			}
+		}
+	}
+	block->vx = bestvx;
+	block->vy = bestvy;
+	block->change = bestchange;
+}
+
 template<class P>
 void ZmbvCodec::AddXorFrame(void) {
 	signed char * vectors=(signed char*)&work[workUsed];
 	/* Align the following xor data on 4 byte boundary*/
 	workUsed=(workUsed + blockcount*2 +3) & ~3;
+
+	//The motion search only reads the old & new frames, so blocks can be searched in parallel
+	auto findVectors = [this](uint32_t start, uint32_t end) {
+		for(uint32_t b = start; b < end; b++) {
+			FindBlockVector<P>(&blocks[b]);
+		}
+	};
+	if(_parallelFor) {
+		_parallelFor(blockcount, 32, findVectors);
+	} else {
+		findVectors(0, blockcount);
+	}
+
+	//The xor data is written in block order
 	for (int b=0;b<blockcount;b++) {
 		FrameBlock * block=&blocks[b];
-		int bestvx = 0;
-		int bestvy = 0;
-		int bestchange=CompareBlock<P>(0,0, block);
-		int possibles=64;
-		for (int v=0;v<VectorCount && possibles;v++) {
-			if (bestchange<4) break;
-			int vx = VectorTable[v].x;
-			int vy = VectorTable[v].y;
-			if (PossibleBlock<P>(vx, vy, block) < 4) {
-				possibles--;
-				int testchange=CompareBlock<P>(vx,vy, block);
-				if (testchange<bestchange) {
-					bestchange=testchange;
-					bestvx = vx;
-					bestvy = vy;
-				}
-			}
-		}
-		vectors[b*2+0]=(bestvx << 1);
-		vectors[b*2+1]=(bestvy << 1);
-		if (bestchange) {
+		vectors[b*2+0]=(block->vx << 1);
+		vectors[b*2+1]=(block->vy << 1);
+		if (block->change) {
 			vectors[b*2+0]|=1;
-			AddXorBlock<P>(bestvx, bestvy, block);
+			AddXorBlock<P>(block->vx, block->vy, block);
 		}
 	}
 }
@@ -48,6 +48,10 @@ private:
 	struct FrameBlock {
 		int start = 0;
 		int dx = 0,dy = 0;
+
+		//Result of the motion search for the current frame
+		int vx = 0,vy = 0;
+		int change = 0;
 	};
 	struct CodecVector {
 		int x = 0,y = 0;
@@ -97,6 +101,7 @@ private:
 	bool SetupBuffers(zmbv_format_t format, int blockwidth, int blockheight);
 
 	template<class P> void AddXorFrame(void);
+	template<class P> void FindBlockVector(FrameBlock * block);
 	template<class P> INLINE int PossibleBlock(int vx,int vy,FrameBlock * block);
 	template<class P> INLINE int CompareBlock(int vx,int vy,FrameBlock * block);
 	template<class P> INLINE void AddXorBlock(int vx,int vy,FrameBlock * block);
@@ -10,12 +10,13 @@
 #include "Utilities/Patches/IpsPatcher.h"
 #include "Utilities/Patches/UpsPatcher.h"
 #include "Utilities/CRC32.h"
+#include "Utilities/MemoryMappedFile.h"
 
 const std::initializer_list<string> VirtualFile::RomExtensions = {
 	".nes", ".fds", ".qd", ".unif", ".unf", ".nsf", ".nsfe", ".studybox",
 	".sfc", ".swc", ".fig", ".smc", ".bs", ".st", ".spc",
 	".gb", ".gbc", ".gbx", ".gbs",
-	".pce", ".sgx", ".cue", ".hes",
+	".pce", ".sgx", ".cue", ".chd", ".hes",
 	".sms", ".gg", ".sg", ".col",
 	".gba",
 	".ws", ".wsc"
@@ -231,8 +232,77 @@ void VirtualFile::InitChunks()
 {
 	if(!_useChunks) {
 		_useChunks = true;
-		_chunks.resize(GetSize() / VirtualFile::ChunkSize + 1);
+		if(_data.empty()) {
+			if(IsArchive()) {
+				//Compressed files can't be read at random offsets, the file is extracted once
+				LoadFile();
+			} else {
+				_mappedFile.reset(new MemoryMappedFile(_path));
+				if(!_mappedFile->IsValid()) {
+					_mappedFile.reset();
+				}
+			}
+		}
+	}
+}
+
+const uint8_t* VirtualFile::LoadChunk(uint32_t chunkId)
+{
+	_chunkUseCounter++;
+
+	CachedChunk* chunk = nullptr;
+	for(CachedChunk& cachedChunk : _chunks) {
+		if(cachedChunk.Id == chunkId) {
+			cachedChunk.LastUse = _chunkUseCounter;
+			return cachedChunk.Data.data();
+		}
+
+		if(!chunk || cachedChunk.LastUse < chunk->LastUse) {
+			chunk = &cachedChunk;
+		}
+	}
+
+	if(_chunks.size() < VirtualFile::MaxCachedChunks) {
+		_chunks.push_back({});
+		chunk = &_chunks.back();
+	}
+
+	//Replace the least recently used chunk
+	chunk->Id = chunkId;
+	chunk->LastUse = _chunkUseCounter;
+	chunk->Data.resize(VirtualFile::ChunkSize);
+
+	ifstream input(_path, std::ios::in | std::ios::binary);
+	input.seekg((std::streamoff)chunkId * VirtualFile::ChunkSize, std::ios::beg);
+	input.read((char*)chunk->Data.data(), VirtualFile::ChunkSize);
+	return chunk->Data.data();
+}
+
+const uint8_t* VirtualFile::GetReadPointer(uint32_t offset, uint32_t& available)
+{
+	if(!_data.empty()) {
+		if(offset >= _data.size()) {
+			return nullptr;
+		}
+		available = (uint32_t)std::min<size_t>(_data.size() - offset, UINT32_MAX);
+		return _data.data() + offset;
+	} else if(_mappedFile) {
+		if(offset >= _mappedFile->GetSize()) {
+			return nullptr;
+		}
+		available = (uint32_t)std::min<size_t>(_mappedFile->GetSize() - offset, UINT32_MAX);
+		return _mappedFile->GetData() + offset;
 	}
+
+	size_t size = GetSize();
+	if(offset >= size) {
+		return nullptr;
+	}
+
+	uint32_t chunkId = offset / VirtualFile::ChunkSize;
+	uint32_t chunkOffset = offset - chunkId * VirtualFile::ChunkSize;
+	available = (uint32_t)std::min<size_t>(VirtualFile::ChunkSize - chunkOffset, size - offset);
+	return LoadChunk(chunkId) + chunkOffset;
 }
 
 vector<uint8_t>& VirtualFile::GetData()
@@ -275,21 +345,38 @@ bool VirtualFile::ReadFile(uint8_t* out, uint32_t expectedSize)
 uint8_t VirtualFile::ReadByte(uint32_t offset)
 {
 	InitChunks();
-	if(offset < 0 || offset > GetSize()) {
+
+	uint32_t available = 0;
+	const uint8_t* data = GetReadPointer(offset, available);
+	if(!data) {
 		//Out of bounds
 		return 0;
 	}
+	return *data;
+}
 
-	uint32_t chunkId = offset / VirtualFile::ChunkSize;
-	uint32_t chunkStart = chunkId * VirtualFile::ChunkSize;
-	if(_chunks[chunkId].size() == 0) {
-		ifstream input(_path, std::ios::in | std::ios::binary);
-		input.seekg(chunkStart, std::ios::beg);
+bool VirtualFile::ReadBytes(uint32_t offset, uint8_t* out, uint32_t length)
+{
+	InitChunks();
+	if((size_t)offset + length > GetSize()) {
+		//Out of bounds
+		return false;
+	}
+
+	while(length > 0) {
+		uint32_t available = 0;
+		const uint8_t* data = GetReadPointer(offset, available);
+		if(!data) {
+			return false;
+		}
 
-		_chunks[chunkId].resize(VirtualFile::ChunkSize);
-		input.read((char*)_chunks[chunkId].data(), VirtualFile::ChunkSize);
+		uint32_t count = std::min(available, length);
+		memcpy(out, data, count);
+		out += count;
+		offset += count;
+		length -= count;
 	}
-	return _chunks[chunkId][offset - chunkStart];
+	return true;
 }
 
 bool VirtualFile::ApplyPatch(VirtualFile& patch)
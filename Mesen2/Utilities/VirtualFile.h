@@ -2,10 +2,20 @@
 #include "pch.h"
 #include <sstream>
 
+class MemoryMappedFile;
+
 class VirtualFile
 {
 private:
 	constexpr static int ChunkSize = 256 * 1024;
+	constexpr static int MaxCachedChunks = 16;
+
+	struct CachedChunk
+	{
+		uint32_t Id = 0;
+		uint64_t LastUse = 0;
+		vector<uint8_t> Data;
+	};
 
 	string _path = "";
 	string _innerFile = "";
@@ -13,13 +23,22 @@ private:
 	vector<uint8_t> _data;
 	int64_t _fileSize = -1;
 
-	vector<vector<uint8_t>> _chunks;
+	//Random access reads (ReadByte/ReadChunk) use a memory mapping of the file, or a small cache
+	//of the most recently used chunks of the file when the file can't be mapped
+	shared_ptr<MemoryMappedFile> _mappedFile;
+	vector<CachedChunk> _chunks;
+	uint64_t _chunkUseCounter = 0;
 	bool _useChunks = false;
 
 	void FromStream(std::istream &input, vector<uint8_t> &output);
 
 	void LoadFile();
 
+	const uint8_t* LoadChunk(uint32_t chunkId);
+
+	//Returns a pointer to the data at the given offset, and the number of bytes that can be read from it
+	const uint8_t* GetReadPointer(uint32_t offset, uint32_t& available);
+
 public:
 	static const std::initializer_list<string> RomExtensions;
 
@@ -51,6 +70,7 @@ public:
 	bool ReadFile(uint8_t* out, uint32_t expectedSize);
 
 	uint8_t ReadByte(uint32_t offset);
+	bool ReadBytes(uint32_t offset, uint8_t* out, uint32_t length);
 
 	bool ApplyPatch(VirtualFile &patch);
 
@@ -58,13 +78,25 @@ public:
 	bool ReadChunk(T& container, int start, int length)
 	{
 		InitChunks();
-		if(start < 0 || start + length > GetSize()) {
+		if(start < 0 || length < 0 || (size_t)start + length > GetSize()) {
 			//Out of bounds
 			return false;
 		}
 
-		for(int i = start, end = start + length; i < end; i++) {
-			container.push_back(ReadByte(i));
+		uint32_t offset = (uint32_t)start;
+		uint32_t remaining = (uint32_t)length;
+		while(remaining > 0) {
+			//The whole range is contiguous, unless the file is read from the chunk cache and the range covers several chunks
+			uint32_t available = 0;
+			const uint8_t* data = GetReadPointer(offset, available);
+			if(!data) {
+				return false;
+			}
+
+			uint32_t count = std::min(available, remaining);
+			container.insert(container.end(), data, data + count);
+			offset += count;
+			remaining -= count;
 		}
 
 		return true;